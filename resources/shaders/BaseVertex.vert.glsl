@@ -6,6 +6,7 @@ layout(location = 3) in vec2 iSize;
 layout(location = 4) in float iRotation;
 layout(location = 5) in vec4 iColor;
 layout(location = 6) in float iTexIndex;
+layout(location = 7) in vec4 iUVRect; // instance: atlas sub-rect (min uv, max uv)
 
 out vec2 TexCoord;
 out vec4 Color;
@@ -20,7 +21,7 @@ void main() {
     vec2 scaled = aPos * iSize;
     vec2 world = iPos + rot * scaled;
 
-    TexCoord = aTexCoord;
+    TexCoord = mix(iUVRect.xy, iUVRect.zw, aTexCoord);
     Color = iColor;
     TexIndex = iTexIndex;
 
@@ -15,7 +15,15 @@ uniform float uLightIntensities[16];   // light intensities
 uniform vec3 uLightColors[16];         // light colors
 uniform int uLightTypes[16];           // light types (0=point, 1=directional, 2=spot)
 
-// Obstacle parameters
+uniform int uLightShadowRows[16];      // occlusion map row per light (-1 = none)
+
+// Shared polar occlusion map (see ShadowMap2D)
+uniform sampler2D uShadowMap;          // one row of nearest-occluder distances per caster
+uniform float uShadowMapMaxDistance;   // distance encoded as 1.0
+uniform float uShadowMapResolution;    // angular samples per row
+uniform float uShadowMapRows;          // rows in the occlusion map
+
+// Obstacle parameters (directional lights only - they have no polar origin)
 uniform int uObstacleCount;            // number of obstacles
 uniform vec2 uObstacles[32];           // obstacle positions (up to 32)
 uniform vec2 uObstacleSizes[32];       // obstacle sizes
@@ -27,11 +35,21 @@ uniform vec3 uAmbientColor;            // ambient light color
 uniform float uShadowLength;           // how far shadows extend
 uniform int uEnableShadows;            // enable/disable shadows (0 or 1)
 
+// Baked static lighting (see LightRenderer2D::BakeStaticLights)
+uniform sampler2D uBakedLightmap;      // ambient + static lights, baked over the window
+uniform int uUseBakedLightmap;         // 1 = start from the lightmap, only uLight* are dynamic
+uniform vec2 uScreenSize;              // window size in pixels (lightmap covers it exactly)
+
+// Debug
+uniform int uShowLightPositions;       // 1 = draw a dot at each light (never set while baking)
+
 // Light type constants
 const int POINT_LIGHT = 0;
 const int DIRECTIONAL_LIGHT = 1;
 const int SPOT_LIGHT = 2;
 
+const float PI = 3.14159265;
+
 // Helper function to check if a point is in a spot light cone
 float getSpotLightAttenuation(vec2 worldPos, vec2 lightPos, vec2 lightDir, float innerAngle, float outerAngle) {
     vec2 toPoint = normalize(worldPos - lightPos);
@@ -72,57 +90,53 @@ bool rayIntersectsBox(vec2 rayStart, vec2 rayDir, vec2 boxCenter, vec2 boxSize,
     return tNear >= 0.0 && tNear <= tFar;
 }
 
+// Line of sight from a caster to a point, read from the occlusion map.
+// Neighbouring angular samples are averaged to soften shadow edges.
+float sampleOcclusion(int row, vec2 casterPos, vec2 worldPos, float softness) {
+    if (row < 0) return 1.0;
+
+    vec2 toFrag = worldPos - casterPos;
+    float dist = length(toFrag);
+    if (dist == 0.0) return 1.0; // At caster position
+
+    float u = (atan(toFrag.y, toFrag.x) + PI) / (2.0 * PI);
+    float v = (float(row) + 0.5) / uShadowMapRows;
+    float texel = 1.0 / uShadowMapResolution;
+    softness = max(softness, 0.001);
+
+    float visibility = 0.0;
+    for (int i = -2; i <= 2; i++) {
+        float occluder = texture(uShadowMap, vec2(u + float(i) * texel, v)).r * uShadowMapMaxDistance;
+        visibility += 1.0 - smoothstep(occluder, occluder + softness, dist);
+    }
+    return visibility / 5.0;
+}
+
 // Check line of sight from light to a point
-float calculateLineOfSight(vec2 worldPos, vec2 lightPos, int lightType) {
+float calculateLineOfSight(int lightIndex, vec2 worldPos) {
     if (uEnableShadows == 0) return 1.0;
     
-    // For directional lights, use the opposite direction to cast shadows
-    vec2 rayStart, rayDir;
-    float rayLength;
-    
-    if (lightType == DIRECTIONAL_LIGHT) {
-        // For directional lights, the ray goes from the point towards the light direction
-        rayStart = worldPos;
-        rayDir = -uLightDirections[0]; // Assuming we're checking the first directional light
-        rayLength = uShadowLength; // Use a large distance for directional lights
-    } else {
-        // For point and spot lights, ray goes from light to point
-        rayStart = lightPos;
-        rayDir = worldPos - lightPos;
-        rayLength = length(rayDir);
-        
-        if (rayLength == 0.0) return 1.0; // At light position
-        rayDir = normalize(rayDir);
+    if (uLightTypes[lightIndex] != DIRECTIONAL_LIGHT) {
+        // Point and spot lights read their own row of the occlusion map
+        return sampleOcclusion(uLightShadowRows[lightIndex], uLightPositions[lightIndex], worldPos, uShadowSoftness * 10.0);
     }
     
-    float visibility = 1.0;
+    // Directional lights: the ray goes from the point towards the light
+    vec2 rayStart = worldPos;
+    vec2 rayDir = -uLightDirections[lightIndex];
+    float rayLength = uShadowLength;
     
-    // Check against all obstacles
     for (int i = 0; i < uObstacleCount && i < 32; i++) {
         float hitDistance;
         if (rayIntersectsBox(rayStart, rayDir, uObstacles[i], uObstacleSizes[i], hitDistance)) {
-            if (lightType == DIRECTIONAL_LIGHT) {
-                // For directional lights, any intersection blocks the light
-                if (hitDistance >= 0.0 && hitDistance < rayLength) {
-                    visibility = 0.0;
-                    break;
-                }
-            } else {
-                // For point and spot lights, check if obstacle is between light and point
-                if (hitDistance < rayLength) {
-                    float shadowFactor = 1.0 - smoothstep(hitDistance, hitDistance + uShadowSoftness * 10.0, rayLength);
-                    visibility *= shadowFactor;
-                    
-                    if (visibility <= 0.01) {
-                        visibility = 0.0;
-                        break;
-                    }
-                }
+            // For directional lights, any intersection blocks the light
+            if (hitDistance >= 0.0 && hitDistance < rayLength) {
+                return 0.0;
             }
         }
     }
     
-    return visibility;
+    return 1.0;
 }
 
 // Calculate lighting contribution from a single light
@@ -178,7 +192,7 @@ vec3 calculateLightContribution(int lightIndex, vec2 worldPos) {
     }
     
     // Check line of sight (shadows)
-    float visibility = calculateLineOfSight(worldPos, lightPos, lightType);
+    float visibility = calculateLineOfSight(lightIndex, worldPos);
     
     // Calculate final light contribution
     float finalIntensity = lightIntensity * attenuation * spotAttenuation * visibility;
@@ -186,8 +200,13 @@ vec3 calculateLightContribution(int lightIndex, vec2 worldPos) {
 }
 
 void main() {
-    // Start with ambient lighting
+    // Start with ambient lighting, or the baked ambient + static lights
     vec3 finalColor = uAmbientColor * uAmbientLight;
+    if (uUseBakedLightmap == 1) {
+        // Lightmap rows start at the bottom, world y grows downwards
+        vec2 lightmapUV = vec2(vWorldPos.x / uScreenSize.x, 1.0 - vWorldPos.y / uScreenSize.y);
+        finalColor = texture(uBakedLightmap, lightmapUV).rgb;
+    }
     
     // Add contribution from all lights
     for (int i = 0; i < uLightCount && i < 16; i++) {
@@ -201,7 +220,7 @@ void main() {
     FragColor = vec4(finalColor, 1.0);
     
     // DEBUG: Show light positions as colored dots
-    for (int i = 0; i < uLightCount && i < 16; i++) {
+    for (int i = 0; uShowLightPositions == 1 && i < uLightCount && i < 16; i++) {
         if (uLightTypes[i] != DIRECTIONAL_LIGHT && distance(vWorldPos, uLightPositions[i]) < 8.0) {
             FragColor = vec4(uLightColors[i], 1.0); // Show light position
         }
@@ -0,0 +1,126 @@
+#version 400 core
+// One vertex per particle slot; outputs are captured by transform feedback (GpuParticle layout)
+layout(location = 0) in vec2 aPosition;
+layout(location = 1) in vec2 aSize;
+layout(location = 2) in float aRotation;
+layout(location = 3) in vec4 aColor;
+layout(location = 4) in float aTexIndex;
+layout(location = 5) in vec2 aVelocity;
+layout(location = 6) in vec2 aAcceleration;
+layout(location = 7) in vec2 aAgeLifetime;
+layout(location = 8) in vec2 aSizeRange;
+layout(location = 9) in uvec2 aColorRange;
+
+out vec2 tfPosition;
+out vec2 tfSize;
+out float tfRotation;
+out vec4 tfColor;
+out float tfTexIndex;
+out vec2 tfVelocity;
+out vec2 tfAcceleration;
+out vec2 tfAgeLifetime;
+out vec2 tfSizeRange;
+flat out uvec2 tfColorRange;
+
+struct Burst {
+    vec4 positionJitterDirection;   // xy position, z jitter radius, w direction
+    vec4 spreadSpeedLifetime;       // spread, speed min, speed max, lifetime min
+    vec4 lifetimeSizes;             // lifetime max, start size, end size
+    vec4 startColor;
+    vec4 endColor;
+    ivec4 range;                    // x: spawn offset one past the burst's last particle
+    vec4 acceleration;
+};
+
+layout(std140) uniform BurstBlock {
+    Burst uBursts[64];
+};
+
+uniform float uDeltaTime;
+uniform int uBurstCount;
+uniform int uSpawnStart;    // Ring slot of this step's first spawn
+uniform int uSpawnTotal;
+uniform int uCapacity;
+uniform int uSeed;
+
+uint Hash(uint x) {
+    x ^= x >> 16;
+    x *= 0x7feb352du;
+    x ^= x >> 15;
+    x *= 0x846ca68bu;
+    x ^= x >> 16;
+    return x;
+}
+
+float Random(inout uint state) {
+    state = Hash(state);
+    return float(state >> 8) * (1.0 / 16777216.0);
+}
+
+void Spawn(int offset) {
+    // Bursts are laid out back to back from uSpawnStart
+    int b = 0;
+    while (b < uBurstCount - 1 && offset >= uBursts[b].range.x) {
+        b++;
+    }
+
+    uint state = Hash(uint(gl_VertexID) ^ uint(uSeed));
+    vec4 pjd = uBursts[b].positionJitterDirection;
+    vec4 ssl = uBursts[b].spreadSpeedLifetime;
+    vec4 ls = uBursts[b].lifetimeSizes;
+
+    float jitterAngle = Random(state) * 6.2831853;
+    float jitterRadius = sqrt(Random(state)) * pjd.z;
+    float angle = pjd.w + (Random(state) - 0.5) * ssl.x;
+    float speed = mix(ssl.y, ssl.z, Random(state));
+
+    tfPosition = pjd.xy + vec2(cos(jitterAngle), sin(jitterAngle)) * jitterRadius;
+    tfSize = vec2(ls.y);
+    tfRotation = angle;
+    tfColor = uBursts[b].startColor;
+    tfTexIndex = 0.0;
+    tfVelocity = vec2(cos(angle), sin(angle)) * speed;
+    tfAcceleration = uBursts[b].acceleration.xy;
+    tfAgeLifetime = vec2(0.0, max(mix(ssl.w, ls.x, Random(state)), 0.001));
+    tfSizeRange = ls.yz;
+    tfColorRange = uvec2(packUnorm4x8(uBursts[b].startColor), packUnorm4x8(uBursts[b].endColor));
+}
+
+void Integrate() {
+    tfRotation = aRotation;
+    tfTexIndex = aTexIndex;
+    tfAcceleration = aAcceleration;
+    tfSizeRange = aSizeRange;
+    tfColorRange = aColorRange;
+
+    float age = aAgeLifetime.x + uDeltaTime;
+    tfAgeLifetime = vec2(age, aAgeLifetime.y);
+
+    if (age >= aAgeLifetime.y) {
+        // Dead: keep the slot but draw nothing
+        tfPosition = aPosition;
+        tfVelocity = vec2(0.0);
+        tfSize = vec2(0.0);
+        tfColor = vec4(0.0);
+        return;
+    }
+
+    float t = age / aAgeLifetime.y;
+    tfVelocity = aVelocity + aAcceleration * uDeltaTime;
+    tfPosition = aPosition + tfVelocity * uDeltaTime;
+    tfSize = vec2(mix(aSizeRange.x, aSizeRange.y, t));
+    tfColor = mix(unpackUnorm4x8(aColorRange.x), unpackUnorm4x8(aColorRange.y), t);
+}
+
+void main() {
+    int offset = gl_VertexID - uSpawnStart;
+    if (offset < 0) {
+        offset += uCapacity;
+    }
+
+    if (offset < uSpawnTotal) {
+        Spawn(offset);
+    } else {
+        Integrate();
+    }
+}
@@ -0,0 +1,35 @@
+#version 400 core
+flat in vec2 vObstaclePos;   // obstacle center (pixels, world space)
+flat in vec2 vObstacleSize;  // obstacle size
+out vec4 FragColor;
+
+uniform vec2 uCasterPos;     // light or viewer position (pixels, world space)
+uniform float uMaxDistance;  // distance stored as 1.0
+uniform float uResolution;   // angular samples per row
+
+const float PI = 3.14159265;
+
+void main() {
+    // Texel center -> angle in [-PI, PI), matching atan() in the overlay shaders
+    float angle = (gl_FragCoord.x / uResolution) * 2.0 * PI - PI;
+    vec2 rayDir = vec2(cos(angle), sin(angle));
+
+    vec2 boxMin = vObstaclePos - vObstacleSize * 0.5;
+    vec2 boxMax = vObstaclePos + vObstacleSize * 0.5;
+
+    vec2 invDir = 1.0 / rayDir;
+    vec2 t1 = (boxMin - uCasterPos) * invDir;
+    vec2 t2 = (boxMax - uCasterPos) * invDir;
+
+    vec2 tMin = min(t1, t2);
+    vec2 tMax = max(t1, t2);
+
+    float tNear = max(tMin.x, tMin.y);
+    float tFar = min(tMax.x, tMax.y);
+
+    // Missed, or caster inside the obstacle (matches the CPU line of sight rules)
+    if (tNear < 0.0 || tNear > tFar) discard;
+
+    // Blended with GL_MIN so the nearest obstacle along this angle wins
+    FragColor = vec4(min(tNear / uMaxDistance, 1.0), 0.0, 0.0, 1.0);
+}
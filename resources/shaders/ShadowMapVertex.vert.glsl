@@ -0,0 +1,19 @@
+#version 400 core
+layout(location = 0) in vec2 aPos;       // [-0.5, 0.5] quad local space
+layout(location = 1) in vec2 aTexCoord;  // texture coordinates (unused)
+layout(location = 2) in vec2 iPos;       // instance: obstacle center (pixels)
+layout(location = 3) in vec2 iSize;      // instance: obstacle size
+layout(location = 4) in float iRotation; // instance: rotation (unused)
+layout(location = 5) in vec4 iColor;     // instance: color (unused)
+layout(location = 6) in float iTexIndex; // instance: texture index (unused)
+
+flat out vec2 vObstaclePos;
+flat out vec2 vObstacleSize;
+
+void main() {
+    vObstaclePos = iPos;
+    vObstacleSize = iSize;
+
+    // Each obstacle covers the whole caster row; the viewport selects the row
+    gl_Position = vec4(aPos * 2.0, 0.0, 1.0);
+}
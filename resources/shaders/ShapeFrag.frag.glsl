@@ -0,0 +1,53 @@
+#version 400 core
+
+// Input from vertex shader
+in vec2 LocalPos;
+in vec4 Color;
+flat in vec2 HalfSize;
+flat in vec4 Params;     // radius, thickness, cornerRadius, feather
+flat in float ShapeType; // 0 circle, 1 capsule, 2 rounded rect
+
+out vec4 FragColor;
+
+float CircleDistance(vec2 p, float radius) {
+    return length(p) - radius;
+}
+
+float CapsuleDistance(vec2 p, float halfLength, float radius) {
+    p.x -= clamp(p.x, -halfLength, halfLength);
+    return length(p) - radius;
+}
+
+float RoundedRectDistance(vec2 p, vec2 halfSize, float cornerRadius) {
+    cornerRadius = min(cornerRadius, min(halfSize.x, halfSize.y));
+    vec2 q = abs(p) - halfSize + cornerRadius;
+    return length(max(q, 0.0)) + min(max(q.x, q.y), 0.0) - cornerRadius;
+}
+
+void main() {
+    float radius = Params.x;
+    float thickness = Params.y;
+    float feather = Params.w;
+
+    int shape = int(ShapeType + 0.5);
+    float dist;
+    if (shape == 0) {
+        dist = CircleDistance(LocalPos, radius);
+    } else if (shape == 1) {
+        dist = CapsuleDistance(LocalPos, max(HalfSize.x - radius, 0.0), radius);
+    } else {
+        dist = RoundedRectDistance(LocalPos, HalfSize, Params.z);
+    }
+
+    // Outlines keep a band of the given width inside the edge
+    if (thickness > 0.0) {
+        dist = abs(dist + thickness * 0.5) - thickness * 0.5;
+    }
+
+    // One pixel of anti-aliasing at any zoom, plus the requested feather
+    float edge = 0.5 * fwidth(dist) + 0.5 * feather;
+    float coverage = 1.0 - smoothstep(-edge, edge, dist);
+    if (coverage <= 0.0) discard;
+
+    FragColor = vec4(Color.rgb, Color.a * coverage);
+}
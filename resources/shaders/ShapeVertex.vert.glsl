@@ -0,0 +1,36 @@
+#version 400 core
+layout(location = 0) in vec2 aPos; // [-0.5, 0.5] quad local space
+layout(location = 1) in vec2 aTexCoord;
+layout(location = 2) in vec2 iPos; // instance: shape center (pixels)
+layout(location = 3) in vec2 iHalfSize;
+layout(location = 4) in float iRotation;
+layout(location = 5) in vec4 iColor;
+layout(location = 6) in vec4 iParams; // radius, thickness, cornerRadius, feather
+layout(location = 7) in float iShapeType;
+
+out vec2 LocalPos;
+out vec4 Color;
+flat out vec2 HalfSize;
+flat out vec4 Params;
+flat out float ShapeType;
+
+uniform mat4 uProjection;
+
+void main() {
+    // Grow the quad so the anti-aliased edge is not clipped
+    vec2 extent = iHalfSize + vec2(iParams.w + 2.0);
+    vec2 local = aPos * 2.0 * extent;
+
+    float cosR = cos(iRotation);
+    float sinR = sin(iRotation);
+    mat2 rot = mat2(cosR, -sinR, sinR, cosR);
+    vec2 world = iPos + rot * local;
+
+    LocalPos = local;
+    Color = iColor;
+    HalfSize = iHalfSize;
+    Params = iParams;
+    ShapeType = iShapeType;
+
+    gl_Position = uProjection * vec4(world, 0.0, 1.0);
+}
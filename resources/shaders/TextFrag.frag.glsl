@@ -0,0 +1,33 @@
+#version 400 core
+
+// Input from vertex shader
+in vec2 TexCoord;
+in vec4 Color;
+flat in float TexIndex;
+
+out vec4 FragColor;
+
+uniform sampler2D uAtlas;       // Signed distance field, 0.5 on the glyph edge
+uniform float uOutlineWidth;    // In distance units, 0 = no outline
+uniform vec4 uOutlineColor;
+
+void main() {
+    float distance = texture(uAtlas, TexCoord).r;
+
+    // About one screen pixel of anti-aliasing whatever the text scale
+    float smoothing = max(fwidth(distance) * 0.7, 0.0001);
+    float fill = smoothstep(0.5 - smoothing, 0.5 + smoothing, distance);
+
+    vec4 color = vec4(Color.rgb, Color.a * fill);
+    if (uOutlineWidth > 0.0) {
+        float outlineEdge = 0.5 - uOutlineWidth;
+        float outline = smoothstep(outlineEdge - smoothing, outlineEdge + smoothing, distance);
+        vec4 outlineColor = vec4(uOutlineColor.rgb, uOutlineColor.a * Color.a * outline);
+        color = mix(outlineColor, vec4(Color.rgb, Color.a), fill);
+    }
+
+    if (color.a <= 0.0) {
+        discard;
+    }
+    FragColor = color;
+}
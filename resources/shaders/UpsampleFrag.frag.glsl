@@ -0,0 +1,39 @@
+#version 400 core
+out vec4 FragColor;
+
+uniform sampler2D uOverlay;     // reduced-resolution overlay
+uniform vec2 uOverlaySize;      // overlay size in texels
+uniform vec2 uScreenSize;       // window size in pixels
+uniform float uEdgeSharpness;   // how strongly dissimilar texels are rejected
+
+vec4 fetchTexel(ivec2 coord) {
+    coord = clamp(coord, ivec2(0), ivec2(uOverlaySize) - 1);
+    return texelFetch(uOverlay, coord, 0);
+}
+
+void main() {
+    // Both textures cover the whole window, so map by window position
+    vec2 uv = gl_FragCoord.xy / uScreenSize;
+    vec2 texelPos = uv * uOverlaySize - 0.5;
+    ivec2 base = ivec2(floor(texelPos));
+    vec2 f = texelPos - vec2(base);
+
+    vec4 c00 = fetchTexel(base);
+    vec4 c10 = fetchTexel(base + ivec2(1, 0));
+    vec4 c01 = fetchTexel(base + ivec2(0, 1));
+    vec4 c11 = fetchTexel(base + ivec2(1, 1));
+
+    // The nearest low-res texel is the reference; neighbours that differ strongly
+    // from it (across a shadow edge) lose their bilinear weight
+    vec4 reference = f.x < 0.5 ? (f.y < 0.5 ? c00 : c01) : (f.y < 0.5 ? c10 : c11);
+
+    vec4 w = vec4((1.0 - f.x) * (1.0 - f.y), f.x * (1.0 - f.y), (1.0 - f.x) * f.y, f.x * f.y);
+    vec4 d = vec4(dot(c00 - reference, c00 - reference),
+                  dot(c10 - reference, c10 - reference),
+                  dot(c01 - reference, c01 - reference),
+                  dot(c11 - reference, c11 - reference));
+    w *= exp(-d * uEdgeSharpness);
+
+    float totalWeight = w.x + w.y + w.z + w.w;
+    FragColor = (c00 * w.x + c10 * w.y + c01 * w.z + c11 * w.w) / max(totalWeight, 1e-5);
+}
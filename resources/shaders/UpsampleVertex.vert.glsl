@@ -0,0 +1,15 @@
+#version 400 core
+layout(location = 0) in vec2 aPos;       // [-0.5, 0.5] quad local space
+layout(location = 1) in vec2 aTexCoord;  // texture coordinates
+layout(location = 2) in vec2 iPos;       // instance: world position (pixels)
+layout(location = 3) in vec2 iSize;      // instance: size
+layout(location = 4) in float iRotation; // instance: rotation (unused)
+layout(location = 5) in vec4 iColor;     // instance: color (unused)
+layout(location = 6) in float iTexIndex; // instance: texture index (unused)
+
+uniform mat4 uProjection;
+
+void main() {
+    vec2 world = iPos + aPos * iSize;
+    gl_Position = uProjection * vec4(world, 0.0, 1.0);
+}
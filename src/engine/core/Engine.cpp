@@ -5,6 +5,9 @@
 #include "engine/core/input/Input.h"
 #include "engine/utils/Time.h"
 #include "engine/utils/ResourcePath.h"
+#include "engine/utils/Profiler.h"
+#include "engine/renderer/GpuProfiler.h"
+#include "engine/renderer/TextureLoader.h"
 
 Engine::Engine(int width, int height, const char* title)
     : m_Width(width), m_Height(height), m_Running(true), m_isShuttingDown(false)
@@ -28,6 +31,8 @@ Engine::Engine(int width, int height, const char* title)
 
 Engine::~Engine() {
     OnShutdown();
+    TextureLoader::Shutdown();
+    GpuProfiler::Shutdown();
     glfwDestroyWindow(m_Window);
     glfwTerminate();
 }
@@ -38,16 +43,32 @@ void Engine::Run() {
     
     auto lastTime = std::chrono::high_resolution_clock::now();
     while (m_Running && !glfwWindowShouldClose(m_Window) && !m_isShuttingDown) {
+        Profiler::BeginFrame();
+        GpuProfiler::BeginFrame();
+
         // Clear the screen
         glClearColor(0.1f, 0.1f, 0.1f, 1.0f); // Dark gray background
         glClear(GL_COLOR_BUFFER_BIT);
 
-        PollEvents();
-        OnUpdate();
-        Input::Update();
-        Time::Tick();
-        OnDraw();
-        glfwSwapBuffers(m_Window);
+        {
+            PROFILE_SCOPE("PollEvents");
+            PollEvents();
+        }
+        {
+            PROFILE_SCOPE("Update");
+            OnUpdate();
+            Input::Update();
+            Time::Tick();
+        }
+        TextureLoader::Update();
+        {
+            PROFILE_SCOPE("Draw");
+            OnDraw();
+        }
+        {
+            PROFILE_SCOPE("SwapBuffers");
+            glfwSwapBuffers(m_Window);
+        }
     }
 }
 
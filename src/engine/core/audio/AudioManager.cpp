@@ -1,6 +1,7 @@
 #include "AudioManager.h"
 #include "Sound.h"
 #include <engine/utils/Logger.h>
+#include <engine/utils/Profiler.h>
 
 // Include raudio
 extern "C" {
@@ -307,6 +308,7 @@ void AudioManager::Shutdown() {
 
 void AudioManager::AudioThreadFunction() {
     Logger::Info("Audio thread started");
+    Profiler::SetThreadName("Audio");
     
     const auto frameTime = std::chrono::milliseconds(16); // ~60 FPS for smooth music streaming
     auto lastTime = std::chrono::steady_clock::now();
@@ -325,6 +327,7 @@ void AudioManager::AudioThreadFunction() {
             
             while (!commandsToProcess.empty()) {
                 try {
+                    PROFILE_SCOPE("Audio::ProcessCommand");
                     ProcessCommand(commandsToProcess.front());
                 }
                 catch (const std::exception& e) {
@@ -338,6 +341,7 @@ void AudioManager::AudioThreadFunction() {
             
             // Update music streams (critical for streaming audio)
             try {
+                PROFILE_SCOPE("Audio::UpdateMusicStreams");
                 UpdateMusicStreams();
             }
             catch (const std::exception& e) {
@@ -0,0 +1,136 @@
+#include "BitStream.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <stdexcept>
+
+namespace {
+    constexpr float TwoPi = 6.28318530717958647692f;
+
+    uint32_t Mask(int bits) {
+        return bits >= 32 ? 0xFFFFFFFFu : ((1u << bits) - 1u);
+    }
+}
+
+// Quantization
+
+uint32_t QuantizedRange::Quantize(float value) const {
+    float normalized = (std::clamp(value, min, max) - min) / (max - min);
+    return static_cast<uint32_t>(std::lround(normalized * float(Mask(bits))));
+}
+
+float QuantizedRange::Dequantize(uint32_t steps) const {
+    return min + float(steps) / float(Mask(bits)) * (max - min);
+}
+
+uint32_t QuantizeAngle(float radians, int bits) {
+    float wrapped = std::fmod(radians, TwoPi);
+    if (wrapped < 0.0f) wrapped += TwoPi;
+    // 2pi and 0 are the same angle, so the top step wraps around
+    uint32_t steps = 1u << bits;
+    return static_cast<uint32_t>(std::lround(wrapped / TwoPi * float(steps))) & (steps - 1u);
+}
+
+float DequantizeAngle(uint32_t steps, int bits) {
+    return float(steps) / float(1u << bits) * TwoPi;
+}
+
+// BitWriter
+
+void BitWriter::WriteBits(uint32_t value, int bits) {
+    m_Scratch |= uint64_t(value & Mask(bits)) << m_ScratchBits;
+    m_ScratchBits += bits;
+    while (m_ScratchBits >= 8) {
+        m_Bytes.push_back(static_cast<uint8_t>(m_Scratch));
+        m_Scratch >>= 8;
+        m_ScratchBits -= 8;
+    }
+}
+
+void BitWriter::WriteVarUint(uint32_t value) {
+    while (value >= 0x80) {
+        WriteBits((value & 0x7F) | 0x80, 8);
+        value >>= 7;
+    }
+    WriteBits(value, 8);
+}
+
+void BitWriter::WriteVarInt(int32_t value) {
+    WriteVarUint((static_cast<uint32_t>(value) << 1) ^ static_cast<uint32_t>(value >> 31));
+}
+
+void BitWriter::WriteQuantized(const glm::vec2& value, const QuantizedRange& range) {
+    WriteQuantized(value.x, range);
+    WriteQuantized(value.y, range);
+}
+
+void BitWriter::WriteQuantized(const glm::vec3& value, const QuantizedRange& range) {
+    WriteQuantized(value.x, range);
+    WriteQuantized(value.y, range);
+    WriteQuantized(value.z, range);
+}
+
+void BitWriter::WriteFloat(float value) {
+    uint32_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    WriteBits(bits, 32);
+}
+
+void BitWriter::Flush() {
+    if (m_ScratchBits > 0) {
+        m_Bytes.push_back(static_cast<uint8_t>(m_Scratch));
+        m_Scratch = 0;
+        m_ScratchBits = 0;
+    }
+}
+
+// BitReader
+
+uint32_t BitReader::ReadBits(int bits) {
+    while (m_ScratchBits < bits) {
+        if (m_BytePos >= m_Size) {
+            throw std::runtime_error("BitReader overflow: tried to read past end of data");
+        }
+        m_Scratch |= uint64_t(m_Data[m_BytePos++]) << m_ScratchBits;
+        m_ScratchBits += 8;
+    }
+    uint32_t value = static_cast<uint32_t>(m_Scratch) & Mask(bits);
+    m_Scratch >>= bits;
+    m_ScratchBits -= bits;
+    return value;
+}
+
+uint32_t BitReader::ReadVarUint() {
+    uint32_t value = 0;
+    for (int shift = 0; shift < 35; shift += 7) {
+        uint32_t byte = ReadBits(8);
+        value |= (byte & 0x7F) << shift;
+        if (!(byte & 0x80)) return value;
+    }
+    throw std::runtime_error("BitReader: malformed varint");
+}
+
+int32_t BitReader::ReadVarInt() {
+    uint32_t zigzag = ReadVarUint();
+    return static_cast<int32_t>((zigzag >> 1) ^ (~(zigzag & 1) + 1));
+}
+
+glm::vec2 BitReader::ReadQuantizedVec2(const QuantizedRange& range) {
+    float x = ReadQuantized(range);
+    float y = ReadQuantized(range);
+    return glm::vec2(x, y);
+}
+
+glm::vec3 BitReader::ReadQuantizedVec3(const QuantizedRange& range) {
+    float x = ReadQuantized(range);
+    float y = ReadQuantized(range);
+    float z = ReadQuantized(range);
+    return glm::vec3(x, y, z);
+}
+
+float BitReader::ReadFloat() {
+    uint32_t bits = ReadBits(32);
+    float value;
+    std::memcpy(&value, &bits, sizeof(value));
+    return value;
+}
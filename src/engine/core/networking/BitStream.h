@@ -0,0 +1,83 @@
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+#include <glm/glm.hpp>
+
+// Bit-level serialization for bandwidth-sensitive payloads. Values take only the bits they
+// are given: floats are quantized over a known range, integers are varint encoded and
+// angles are wrapped and quantized. Bits are packed little-endian into bytes.
+
+// Fixed-point mapping of [min, max] onto an n-bit unsigned integer (bits <= 24, the float mantissa)
+struct QuantizedRange {
+    float min;
+    float max;
+    int bits;
+
+    float Resolution() const { return (max - min) / float((1u << bits) - 1u); }
+    // Clamped to the range, rounded to the nearest step
+    uint32_t Quantize(float value) const;
+    float Dequantize(uint32_t steps) const;
+};
+
+// Radians wrapped to [0, 2pi) and split into 2^bits steps
+uint32_t QuantizeAngle(float radians, int bits);
+float DequantizeAngle(uint32_t steps, int bits);
+
+class BitWriter {
+public:
+    BitWriter() : m_Scratch(0), m_ScratchBits(0) {}
+    explicit BitWriter(size_t reserveBytes) : BitWriter() { m_Bytes.reserve(reserveBytes); }
+
+    // Low `bits` bits of value (1..32)
+    void WriteBits(uint32_t value, int bits);
+    void WriteBool(bool value) { WriteBits(value ? 1u : 0u, 1); }
+    // 7 bits per byte, so small values cost a single byte
+    void WriteVarUint(uint32_t value);
+    void WriteVarInt(int32_t value);            // Zigzag encoded
+    void WriteQuantized(float value, const QuantizedRange& range) { WriteBits(range.Quantize(value), range.bits); }
+    void WriteQuantized(const glm::vec2& value, const QuantizedRange& range);
+    void WriteQuantized(const glm::vec3& value, const QuantizedRange& range);
+    void WriteAngle(float radians, int bits) { WriteBits(QuantizeAngle(radians, bits), bits); }
+    void WriteFloat(float value);               // Full precision escape hatch
+
+    // Pads the last byte with zeros; call before GetData
+    void Flush();
+    const uint8_t* GetData() const { return m_Bytes.data(); }
+    size_t GetSize() const { return m_Bytes.size(); }
+    size_t GetBitCount() const { return m_Bytes.size() * 8 + m_ScratchBits; }
+    void Clear() { m_Bytes.clear(); m_Scratch = 0; m_ScratchBits = 0; }
+
+private:
+    std::vector<uint8_t> m_Bytes;
+    uint64_t m_Scratch;
+    int m_ScratchBits;
+};
+
+// Reads what BitWriter wrote. Reading past the end throws std::runtime_error, like Packet.
+class BitReader {
+public:
+    BitReader(const uint8_t* data, size_t size)
+        : m_Data(data), m_Size(size), m_BytePos(0), m_Scratch(0), m_ScratchBits(0) {}
+
+    uint32_t ReadBits(int bits);
+    bool ReadBool() { return ReadBits(1) != 0; }
+    uint32_t ReadVarUint();
+    int32_t ReadVarInt();
+    float ReadQuantized(const QuantizedRange& range) { return range.Dequantize(ReadBits(range.bits)); }
+    glm::vec2 ReadQuantizedVec2(const QuantizedRange& range);
+    glm::vec3 ReadQuantizedVec3(const QuantizedRange& range);
+    float ReadAngle(int bits) { return DequantizeAngle(ReadBits(bits), bits); }
+    float ReadFloat();
+
+    // Whole bytes consumed so far (the partial last byte counts)
+    size_t GetBytesRead() const { return m_BytePos; }
+
+private:
+    const uint8_t* m_Data;
+    size_t m_Size;
+    size_t m_BytePos;
+    uint64_t m_Scratch;
+    int m_ScratchBits;
+};
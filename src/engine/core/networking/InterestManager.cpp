@@ -0,0 +1,138 @@
+#include "InterestManager.h"
+#include <algorithm>
+#include <cmath>
+#include <utility>
+#include <engine/utils/Profiler.h>
+
+void InterestManager::AddClient(uint32_t peerID) {
+    m_Clients[peerID] = ClientState();
+}
+
+void InterestManager::RemoveClient(uint32_t peerID) {
+    m_Clients.erase(peerID);
+}
+
+void InterestManager::BeginTick(Snapshot world) {
+    PROFILE_SCOPE("InterestManager::BeginTick");
+    m_World = std::move(world);
+    m_HasWorld = true;
+    m_Stats = Stats();
+
+    // Keep the buckets' storage between ticks; only the contents change
+    for (auto& [key, indices] : m_Grid) {
+        indices.clear();
+    }
+    for (uint32_t i = 0; i < m_World.entities.size(); i++) {
+        const glm::vec3& position = m_World.entities[i].position;
+        int x = (int)std::floor(position.x / m_Settings.cellSize);
+        int y = (int)std::floor(position.y / m_Settings.cellSize);
+        m_Grid[CellKey(x, y)].push_back(i);
+    }
+}
+
+Snapshot InterestManager::BuildClientSnapshot(uint32_t peerID) {
+    Snapshot snapshot;
+    auto clientIt = m_Clients.find(peerID);
+    if (!m_HasWorld || clientIt == m_Clients.end()) {
+        return snapshot;
+    }
+
+    PROFILE_SCOPE("InterestManager::BuildClientSnapshot");
+    ClientState& client = clientIt->second;
+    snapshot.tick = m_World.tick;
+    snapshot.rate = m_World.rate;
+
+    // A client without an entity yet keeps its last known viewpoint
+    if (const EntityState* self = m_World.Find(peerID)) {
+        client.viewer = glm::vec2(self->position);
+    }
+
+    std::vector<uint32_t> candidates;
+    GatherCandidates(client.viewer, m_Settings.exitRadius, candidates);
+
+    struct Pending {
+        const EntityState* state;
+        Tracked* tracked;
+    };
+    std::vector<Pending> pending;
+    std::unordered_map<uint32_t, Tracked> stillTracked;
+    stillTracked.reserve(client.tracked.size());
+
+    float radiusSq = m_Settings.radius * m_Settings.radius;
+    float exitRadiusSq = m_Settings.exitRadius * m_Settings.exitRadius;
+    for (uint32_t index : candidates) {
+        const EntityState& state = m_World.entities[index];
+        float distanceSq = glm::dot(glm::vec2(state.position) - client.viewer, glm::vec2(state.position) - client.viewer);
+
+        auto trackedIt = client.tracked.find(state.networkID);
+        bool isTracked = trackedIt != client.tracked.end();
+        bool isSelf = state.networkID == peerID;
+        if (!isSelf && distanceSq > (isTracked ? exitRadiusSq : radiusSq)) {
+            continue;
+        }
+
+        Tracked& tracked = stillTracked[state.networkID];
+        if (isTracked) {
+            tracked = trackedIt->second;
+            if (tracked.sent && SnapshotCodec::SameOnWire(tracked.lastSent, state)) {
+                tracked.priority = 0.0f;
+                snapshot.entities.push_back(state);     // Unchanged: free in the delta
+                continue;
+            }
+        }
+
+        // Roughly 1 at the viewer, falling to 0.1 at the edge of the radius
+        float distance = std::sqrt(distanceSq);
+        tracked.priority += isSelf ? 1e6f : 1.0f / (1.0f + 9.0f * distance / m_Settings.radius);
+        pending.push_back({ &state, &tracked });
+    }
+    m_Stats.relevant += (uint32_t)stillTracked.size();
+
+    std::sort(pending.begin(), pending.end(),
+              [](const Pending& a, const Pending& b) { return a.tracked->priority > b.tracked->priority; });
+
+    size_t budget = m_Settings.bytesPerSnapshot;
+    for (const Pending& entry : pending) {
+        if (budget >= EntityUpdateBytes || entry.state->networkID == peerID) {
+            budget -= std::min(budget, EntityUpdateBytes);
+            entry.tracked->lastSent = *entry.state;
+            entry.tracked->priority = 0.0f;
+            entry.tracked->sent = true;
+            snapshot.entities.push_back(*entry.state);
+            m_Stats.updated++;
+        } else {
+            // Deferred: the client keeps what it has, or doesn't see a new entity yet
+            if (entry.tracked->sent) {
+                snapshot.entities.push_back(entry.tracked->lastSent);
+            }
+            m_Stats.deferred++;
+        }
+    }
+
+    // Entities that left the area drop out, which the delta sends as a removal
+    client.tracked = std::move(stillTracked);
+
+    std::sort(snapshot.entities.begin(), snapshot.entities.end(),
+              [](const EntityState& a, const EntityState& b) { return a.networkID < b.networkID; });
+    return snapshot;
+}
+
+uint64_t InterestManager::CellKey(int x, int y) const {
+    return (uint64_t(uint32_t(x)) << 32) | uint32_t(y);
+}
+
+void InterestManager::GatherCandidates(const glm::vec2& center, float radius, std::vector<uint32_t>& indices) const {
+    int minX = (int)std::floor((center.x - radius) / m_Settings.cellSize);
+    int maxX = (int)std::floor((center.x + radius) / m_Settings.cellSize);
+    int minY = (int)std::floor((center.y - radius) / m_Settings.cellSize);
+    int maxY = (int)std::floor((center.y + radius) / m_Settings.cellSize);
+
+    for (int y = minY; y <= maxY; y++) {
+        for (int x = minX; x <= maxX; x++) {
+            auto it = m_Grid.find(CellKey(x, y));
+            if (it != m_Grid.end()) {
+                indices.insert(indices.end(), it->second.begin(), it->second.end());
+            }
+        }
+    }
+}
@@ -0,0 +1,72 @@
+#pragma once
+
+#include "Snapshot.h"
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+#include <glm/glm.hpp>
+
+// Decides per client which replicated entities it sees and how often they update.
+// Entities are bucketed into a uniform grid each tick; a client is interested in those
+// within its radius of its own entity (with a larger exit radius so edges don't flicker).
+// Changed entities compete for the client's per-snapshot byte budget through priority
+// accumulators that grow faster the closer an entity is, so near entities update every
+// tick and distant ones at a lower rate. Deferred entities keep their last sent state,
+// which the snapshot delta encodes for free.
+class InterestManager {
+public:
+    struct Settings {
+        float cellSize = 512.0f;
+        float radius = 1600.0f;
+        float exitRadius = 2000.0f;
+        size_t bytesPerSnapshot = 1200;    // Per client, roughly one MTU
+    };
+
+    struct Stats {
+        uint32_t relevant = 0;      // Summed over the clients of the last tick
+        uint32_t updated = 0;
+        uint32_t deferred = 0;
+    };
+
+    void SetSettings(const Settings& settings) { m_Settings = settings; }
+    const Settings& GetSettings() const { return m_Settings; }
+
+    void AddClient(uint32_t peerID);
+    void RemoveClient(uint32_t peerID);
+    void Clear() { m_Clients.clear(); }
+
+    // Once per tick with the full world state, which is kept until the next tick;
+    // move it in to avoid the copy
+    void BeginTick(Snapshot world);
+    // The part of the world this client should receive this tick. Its own entity
+    // (networkID == peerID) is always included and centres the interest area.
+    Snapshot BuildClientSnapshot(uint32_t peerID);
+
+    const Stats& GetStats() const { return m_Stats; }
+
+private:
+    // Worst case for a changed entity on the wire (id gap, mask and every field)
+    static constexpr size_t EntityUpdateBytes = 20;
+
+    struct Tracked {
+        EntityState lastSent;
+        float priority = 0.0f;
+        bool sent = false;          // False while a newly relevant entity waits for budget
+    };
+
+    struct ClientState {
+        std::unordered_map<uint32_t, Tracked> tracked;
+        glm::vec2 viewer{0.0f};
+    };
+
+    Settings m_Settings;
+    Snapshot m_World;
+    bool m_HasWorld = false;
+    std::unordered_map<uint64_t, std::vector<uint32_t>> m_Grid;     // Cell -> indices into m_World
+    std::unordered_map<uint32_t, ClientState> m_Clients;
+    Stats m_Stats;
+
+    // Helper functions
+    uint64_t CellKey(int x, int y) const;
+    void GatherCandidates(const glm::vec2& center, float radius, std::vector<uint32_t>& indices) const;
+};
@@ -0,0 +1,118 @@
+#include "Interpolation.h"
+#include <algorithm>
+#include <cmath>
+#include <glm/gtc/constants.hpp>
+
+namespace {
+    // Along the shorter way around
+    float LerpAngle(float from, float to, float t) {
+        float delta = std::remainder(to - from, glm::two_pi<float>());
+        return from + delta * t;
+    }
+
+    glm::vec3 LerpAngles(const glm::vec3& from, const glm::vec3& to, float t) {
+        return glm::vec3(LerpAngle(from.x, to.x, t), LerpAngle(from.y, to.y, t), LerpAngle(from.z, to.z, t));
+    }
+}
+
+void SnapshotInterpolator::EntityHistory::Push(const TimedState& sample) {
+    // A server restart numbers ticks from zero again; older states no longer fit
+    if (count > 0 && sample.time <= At(count - 1).time) {
+        count = 0;
+    }
+
+    if (count == HistorySize) {
+        start = (start + 1) % HistorySize;
+        count--;
+    }
+    ring[(start + count) % HistorySize] = sample;
+    count++;
+}
+
+void SnapshotInterpolator::AddSnapshot(const Snapshot& snapshot, double localTime) {
+    if (snapshot.rate == 0) {
+        return;
+    }
+
+    double serverTime = static_cast<double>(snapshot.tick) / snapshot.rate;
+
+    // Network jitter averages out of the offset; a large jump means a new server or a long stall
+    double offset = serverTime - localTime;
+    if (!m_HasClock || std::abs(offset - m_ClockOffset) > ClockResync) {
+        m_ClockOffset = offset;
+        m_RenderTime = serverTime - m_Settings.delay;
+        m_LatestTime = serverTime;
+        m_HasClock = true;
+    } else {
+        m_ClockOffset += (offset - m_ClockOffset) * ClockSmoothing;
+        m_LatestTime = std::max(m_LatestTime, serverTime);
+    }
+
+    for (const EntityState& state : snapshot.entities) {
+        m_Entities[state.networkID].Push({ serverTime, state });
+    }
+}
+
+void SnapshotInterpolator::Update(double localTime) {
+    if (!m_HasClock) {
+        return;
+    }
+
+    // Clock smoothing may pull the target back a little; hold still rather than rewind
+    double target = localTime + m_ClockOffset - m_Settings.delay;
+    if (target > m_RenderTime || m_RenderTime - target > ClockResync) {
+        m_RenderTime = target;
+    }
+}
+
+bool SnapshotInterpolator::Sample(uint32_t networkID, EntityState& state) const {
+    auto it = m_Entities.find(networkID);
+    if (it == m_Entities.end() || it->second.count == 0) {
+        return false;
+    }
+
+    const EntityHistory& history = it->second;
+    const TimedState& oldest = history.At(0);
+    const TimedState& newest = history.At(history.count - 1);
+
+    if (m_RenderTime <= oldest.time) {
+        state = oldest.state;
+        return true;
+    }
+
+    // Out of states: carry on at the last velocity for a moment, then wait for the next one
+    if (m_RenderTime >= newest.time) {
+        state = newest.state;
+        if (history.count >= 2 && m_Settings.maxExtrapolation > 0.0f) {
+            const TimedState& previous = history.At(history.count - 2);
+            double ahead = std::min(m_RenderTime - newest.time, static_cast<double>(m_Settings.maxExtrapolation));
+            glm::vec3 velocity = (newest.state.position - previous.state.position) /
+                                 static_cast<float>(newest.time - previous.time);
+            state.position += velocity * static_cast<float>(ahead);
+        }
+        return true;
+    }
+
+    // The pair around the render time; the newest pairs are the likely ones
+    size_t index = history.count - 1;
+    while (index > 0 && history.At(index - 1).time > m_RenderTime) {
+        index--;
+    }
+    const TimedState& from = history.At(index - 1);
+    const TimedState& to = history.At(index);
+    float t = static_cast<float>((m_RenderTime - from.time) / (to.time - from.time));
+
+    state = from.state;
+    state.position = glm::mix(from.state.position, to.state.position, t);
+    state.rotation = LerpAngles(from.state.rotation, to.state.rotation, t);
+    state.scale = glm::mix(from.state.scale, to.state.scale, t);
+    return true;
+}
+
+void SnapshotInterpolator::Clear() {
+    m_Entities.clear();
+    m_ClockOffset = 0.0;
+    m_RenderTime = 0.0;
+    m_LatestTime = 0.0;
+    m_HasClock = false;
+}
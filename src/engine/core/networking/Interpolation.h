@@ -0,0 +1,63 @@
+#pragma once
+
+#include "Snapshot.h"
+#include <array>
+#include <cstdint>
+#include <unordered_map>
+
+// Jitter buffer for remote entities. Every snapshot's states are stored against the server
+// time they describe (tick / rate), and entities are shown a fixed delay behind the newest
+// server time, interpolating between the two states around it. Snapshots arriving early, late
+// or not at all then don't show, so the server can send far less often than the frame rate.
+// Past the newest state an entity keeps its last velocity for a short while, then holds.
+class SnapshotInterpolator {
+public:
+    struct Settings {
+        float delay = 0.1f;                 // Seconds behind the server; at least two snapshot intervals
+        float maxExtrapolation = 0.05f;     // Seconds to extrapolate once states run out; 0 disables
+    };
+
+    void SetSettings(const Settings& settings) { m_Settings = settings; }
+    const Settings& GetSettings() const { return m_Settings; }
+
+    // Buffers every entity in the snapshot; localTime is the caller's clock in seconds
+    void AddSnapshot(const Snapshot& snapshot, double localTime);
+    // Moves the render clock to localTime; call once per frame before Sample
+    void Update(double localTime);
+    // The entity's state at the render time; false if nothing is buffered for it
+    bool Sample(uint32_t networkID, EntityState& state) const;
+
+    void Remove(uint32_t networkID) { m_Entities.erase(networkID); }
+    void Clear();
+
+    // Server time being shown, and how far it trails the newest snapshot received
+    double GetRenderTime() const { return m_RenderTime; }
+    double GetBufferedTime() const { return m_LatestTime - m_RenderTime; }
+
+private:
+    static constexpr size_t HistorySize = 16;
+    static constexpr double ClockSmoothing = 0.05;     // Weight of each new clock offset sample
+    static constexpr double ClockResync = 0.5;         // Seconds off before the clock jumps instead
+
+    struct TimedState {
+        double time = 0.0;
+        EntityState state;
+    };
+
+    // Ring of the entity's latest states, oldest first
+    struct EntityHistory {
+        std::array<TimedState, HistorySize> ring;
+        size_t start = 0;
+        size_t count = 0;
+
+        const TimedState& At(size_t index) const { return ring[(start + index) % HistorySize]; }
+        void Push(const TimedState& sample);
+    };
+
+    Settings m_Settings;
+    std::unordered_map<uint32_t, EntityHistory> m_Entities;
+    double m_ClockOffset = 0.0;     // Server time minus local time, smoothed over snapshots
+    double m_RenderTime = 0.0;
+    double m_LatestTime = 0.0;
+    bool m_HasClock = false;
+};
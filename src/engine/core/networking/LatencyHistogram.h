@@ -0,0 +1,53 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+
+// Log2-bucketed latency counts in microseconds. One thread records; any thread may read
+// while it does, seeing counts that are at most a few samples behind.
+class LatencyHistogram {
+public:
+    static constexpr int BucketCount = 20;     // Bucket i counts [2^i, 2^(i+1)) us; the last is open-ended
+
+    void Record(uint64_t microseconds) {
+        int bucket = 0;
+        while (bucket < BucketCount - 1 && (microseconds >> (bucket + 1)) != 0) {
+            bucket++;
+        }
+        // Single writer, so plain load/store instead of a read-modify-write
+        m_Counts[bucket].store(m_Counts[bucket].load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+        if (microseconds > m_Max.load(std::memory_order_relaxed)) {
+            m_Max.store(microseconds, std::memory_order_relaxed);
+        }
+    }
+
+    uint32_t GetCount(int bucket) const { return m_Counts[bucket].load(std::memory_order_relaxed); }
+    uint64_t GetMax() const { return m_Max.load(std::memory_order_relaxed); }
+
+    uint64_t GetTotal() const {
+        uint64_t total = 0;
+        for (const auto& count : m_Counts) total += count.load(std::memory_order_relaxed);
+        return total;
+    }
+
+    // Upper bound of the bucket holding the given fraction (0-1) of samples
+    uint64_t GetPercentile(double fraction) const {
+        uint64_t total = GetTotal();
+        if (total == 0) return 0;
+
+        uint64_t target = static_cast<uint64_t>(fraction * total);
+        uint64_t seen = 0;
+        for (int i = 0; i < BucketCount; i++) {
+            seen += GetCount(i);
+            if (seen > target) return BucketUpperBound(i);
+        }
+        return BucketUpperBound(BucketCount - 1);
+    }
+
+    static uint64_t BucketUpperBound(int bucket) { return uint64_t(1) << (bucket + 1); }
+
+private:
+    std::array<std::atomic<uint32_t>, BucketCount> m_Counts{};
+    std::atomic<uint64_t> m_Max{0};
+};
@@ -1,23 +1,56 @@
 #include "NetworkManager.h"
 #include <engine/utils/Logger.h>
+#include <engine/utils/Profiler.h>
 #include <iostream>
 #include <algorithm>
+#include <stdexcept>
 
 // Static error storage
 std::string NetworkManager::s_LastError = "";
 
+namespace {
+    // Bundle lengths are LEB128 varuints; messages under 128 bytes cost one extra byte
+    size_t EncodeVarUint(uint8_t* out, size_t value) {
+        size_t size = 0;
+        do {
+            uint8_t byte = value & 0x7F;
+            value >>= 7;
+            out[size++] = byte | (value ? 0x80 : 0);
+        } while (value);
+        return size;
+    }
+
+    bool DecodeVarUint(const uint8_t* data, size_t size, size_t& offset, size_t& value) {
+        value = 0;
+        for (int shift = 0; offset < size && shift < 32; shift += 7) {
+            uint8_t byte = data[offset++];
+            value |= static_cast<size_t>(byte & 0x7F) << shift;
+            if (!(byte & 0x80)) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    uint64_t BundleKey(uint32_t peerID, uint8_t channel, PacketReliability reliability) {
+        return (static_cast<uint64_t>(peerID) << 16) | (static_cast<uint64_t>(channel) << 8) |
+               static_cast<uint64_t>(reliability);
+    }
+}
+
 NetworkManager::NetworkManager()
     : m_Initialized(false)
     , m_IsServer(false)
     , m_IsClient(false)
     , m_Host(nullptr)
     , m_ServerPeer(nullptr)
-    , m_NextPeerID(1)
     , m_EventCallback(nullptr)
     , m_BytesSent(0)
     , m_BytesReceived(0)
     , m_PacketsSent(0)
     , m_PacketsReceived(0)
+    , m_MessagesSent(0)
+    , m_MessagesReceived(0)
     , m_MaxClients(32)
     , m_ChannelLimit(4)
     , m_IncomingBandwidth(0)
@@ -25,6 +58,9 @@ NetworkManager::NetworkManager()
     , m_CompressionEnabled(false)
     , m_ThreadRunning(false)
     , m_PendingConnection(false)
+    , m_HostRequests(0)
+    , m_Outgoing(QueueCapacity)
+    , m_Incoming(QueueCapacity)
 {
     RegisterBuiltinHandlers();
 }
@@ -86,8 +122,17 @@ void NetworkManager::Shutdown() {
         m_Host = nullptr;
     }
     
-    m_ConnectedPeers.clear();
-    m_PacketHandlers.clear();
+    // Nothing is left to send to or dispatch from
+    OutgoingMessage outgoing;
+    while (m_Outgoing.TryPop(outgoing)) {
+        enet_packet_destroy(outgoing.packet);
+    }
+    DiscardIncoming();
+    m_Bundles.clear();
+    m_OpenBundles.clear();
+    
+    ClearPeers();
+    m_PacketHandlers.fill(nullptr);
     
     enet_deinitialize();
     m_Initialized = false;
@@ -101,7 +146,7 @@ bool NetworkManager::StartServer(uint16_t port, size_t maxClients) {
         return false;
     }
     
-    if (m_IsServer || m_IsClient) {
+    if (m_IsServer || m_IsClient || m_PendingConnection) {
         SetError("Already running as server or client");
         return false;
     }
@@ -111,21 +156,25 @@ bool NetworkManager::StartServer(uint16_t port, size_t maxClients) {
     address.port = port;
     
     m_MaxClients = maxClients;
-    m_Host = enet_host_create(&address, maxClients, m_ChannelLimit, 
-                             m_IncomingBandwidth, m_OutgoingBandwidth);
-    
-    if (!m_Host) {
-        SetError("Failed to create server host on port " + std::to_string(port));
-        return false;
-    }
-    
-    if (m_CompressionEnabled) {
-        enet_host_compress_with_range_coder(m_Host);
+    {
+        auto lock = LockHost();
+        m_Host = enet_host_create(&address, maxClients, m_ChannelLimit, 
+                                 m_IncomingBandwidth, m_OutgoingBandwidth);
+        
+        if (!m_Host) {
+            SetError("Failed to create server host on port " + std::to_string(port));
+            return false;
+        }
+        
+        if (m_CompressionEnabled) {
+            enet_host_compress_with_range_coder(m_Host);
+        }
+        m_IsServer = true;
     }
     
-    m_IsServer = true;
     m_LocalPeerID = 0; // Server always has peer ID 0
-    m_ConnectedPeers.clear();
+    ClearPeers();
+    m_ThreadCondition.notify_one();
     
     Logger::Info("Server started on port " + std::to_string(port) + 
                 " with max " + std::to_string(maxClients) + " clients");
@@ -139,29 +188,37 @@ bool NetworkManager::StartServer(uint16_t port, size_t maxClients) {
 }
 
 void NetworkManager::StopServer() {
-    if (!m_IsServer || !m_Host) {
+    if (!m_IsServer) {
         return;
     }
     
-    // Disconnect all clients
-    for (auto& peer : m_ConnectedPeers) {
-        if (peer.enetPeer && peer.isConnected) {
-            enet_peer_disconnect(peer.enetPeer, 0);
+    Flush();
+    {
+        auto lock = LockHost();
+        
+        // Whatever the game queued goes out ahead of the disconnects
+        SendOutgoing();
+        for (size_t i = 0; i < m_Host->peerCount; i++) {
+            if (m_Host->peers[i].state == ENET_PEER_STATE_CONNECTED) {
+                enet_peer_disconnect(&m_Host->peers[i], 0);
+            }
         }
-    }
-    
-    // Process final events
-    ENetEvent event;
-    while (enet_host_service(m_Host, &event, 100) > 0) {
-        if (event.type == ENET_EVENT_TYPE_DISCONNECT) {
-            RemovePeer(event.peer);
+        
+        // Let the disconnects go out; anything still arriving is dropped
+        ENetEvent event;
+        while (enet_host_service(m_Host, &event, 100) > 0) {
+            if (event.type == ENET_EVENT_TYPE_RECEIVE) {
+                enet_packet_destroy(event.packet);
+            }
         }
+        DiscardIncoming();
+        
+        enet_host_destroy(m_Host);
+        m_Host = nullptr;
+        m_IsServer = false;
     }
-    
-    enet_host_destroy(m_Host);
-    m_Host = nullptr;
-    m_IsServer = false;
-    m_ConnectedPeers.clear();
+    ClearPeers();
+    m_Bundles.clear();
     
     Logger::Info("Server stopped");
     QueueEvent(NetworkEvent(NetworkEventType::SERVER_STOPPED));
@@ -201,6 +258,7 @@ bool NetworkManager::ConnectToServer(const std::string& address, uint16_t port,
 
 bool NetworkManager::ConnectToServerBlocking(const std::string& address, uint16_t port, uint32_t timeoutMs) {
     // This is the original blocking implementation for use in the network thread
+    std::lock_guard<std::mutex> lock(m_HostMutex);
     
     m_Host = enet_host_create(nullptr, 1, m_ChannelLimit, 
                              m_IncomingBandwidth, m_OutgoingBandwidth);
@@ -236,20 +294,16 @@ bool NetworkManager::ConnectToServerBlocking(const std::string& address, uint16_
     if (enet_host_service(m_Host, &event, timeoutMs) > 0 && 
         event.type == ENET_EVENT_TYPE_CONNECT) {
         
+        // The game thread adds the server (always ID 0) as a peer
+        IncomingMessage message;
+        message.kind = IncomingMessage::Kind::CONNECT;
+        message.peerID = 0;
+        message.enetPeer = m_ServerPeer;
+        message.address = serverAddress;
+        message.connectID = m_ServerPeer->connectID;
+        PushIncoming(std::move(message));
         m_IsClient = true;
         
-        // Add server as a peer
-        PeerInfo serverInfo;
-        serverInfo.id = 0; // Server always gets ID 0
-        serverInfo.enetPeer = m_ServerPeer;
-        serverInfo.address = address;
-        serverInfo.port = port;
-        serverInfo.isConnected = true;
-        m_ConnectedPeers.push_back(serverInfo);
-        
-        // Don't assign our own client ID yet - wait for server to send it via PEER_ID_ASSIGNMENT packet
-        m_LocalPeerID = 0; // Will be set when we receive the assignment packet
-        
         Logger::Info("Connected to server " + address + ":" + std::to_string(port) + ", waiting for peer ID assignment");
         // Note: We'll queue the SERVER_CONNECTED event after receiving peer ID assignment
         return true;
@@ -265,7 +319,7 @@ bool NetworkManager::ConnectToServerBlocking(const std::string& address, uint16_
 }
 
 void NetworkManager::DisconnectFromServer(const std::string& reason) {
-    if (!m_IsClient || !m_ServerPeer) {
+    if (!m_IsClient) {
         return;
     }
     
@@ -275,21 +329,30 @@ void NetworkManager::DisconnectFromServer(const std::string& reason) {
         SendPacket(disconnectPacket, 0, PacketReliability::RELIABLE);
     }
     
-    enet_peer_disconnect(m_ServerPeer, 0);
-    
-    // Wait for disconnect acknowledgment
-    ENetEvent event;
-    while (enet_host_service(m_Host, &event, 3000) > 0) {
-        if (event.type == ENET_EVENT_TYPE_DISCONNECT) {
-            break;
+    Flush();
+    {
+        auto lock = LockHost();
+        SendOutgoing();
+        enet_peer_disconnect(m_ServerPeer, 0);
+        
+        // Wait for disconnect acknowledgment
+        ENetEvent event;
+        while (enet_host_service(m_Host, &event, 3000) > 0) {
+            if (event.type == ENET_EVENT_TYPE_RECEIVE) {
+                enet_packet_destroy(event.packet);
+            } else if (event.type == ENET_EVENT_TYPE_DISCONNECT) {
+                break;
+            }
         }
+        DiscardIncoming();
+        
+        enet_host_destroy(m_Host);
+        m_Host = nullptr;
+        m_ServerPeer = nullptr;
+        m_IsClient = false;
     }
-    
-    enet_host_destroy(m_Host);
-    m_Host = nullptr;
-    m_ServerPeer = nullptr;
-    m_IsClient = false;
-    m_ConnectedPeers.clear();
+    ClearPeers();
+    m_Bundles.clear();
     
     Logger::Info("Disconnected from server: " + reason);
     
@@ -306,82 +369,306 @@ void NetworkManager::DisconnectFromServer(const std::string& reason) {
 }
 
 bool NetworkManager::IsConnectedToServer() const {
-    return m_IsClient && m_ServerPeer && 
-           m_ServerPeer->state == ENET_PEER_STATE_CONNECTED;
+    // The server's entry is added on connect and dropped on disconnect, both on this thread
+    return m_IsClient && GetPeerInfo(0) != nullptr;
 }
 
 bool NetworkManager::SendPacket(const Packet& packet, uint32_t peerID, 
                                 PacketReliability reliability, uint8_t channel) {
-    if (!m_Host) {
-        SetError("No active host");
+    if (!CanSendTo(peerID)) {
+        SetError("Failed to send packet");
         return false;
     }
     
+    uint32_t target = m_IsClient ? 0 : peerID;
+    uint8_t header[PacketHeader::WireSize];
+    packet.GetHeader().WriteTo(header);
+    if (QueueMessage(target, channel, reliability, header, packet.GetData(), packet.GetDataSize())) {
+        return true;
+    }
+    
+    // Too big to share a datagram; it follows whatever is already bundled for this peer
+    FlushBundle(target, channel, reliability);
     ENetPacket* enetPacket = packet.CreateENetPacket(reliability);
     if (!enetPacket) {
         SetError("Failed to create ENet packet");
         return false;
     }
     
-    bool success = false;
+    if (!QueueOutgoing(enetPacket, target, GetConnectID(target), channel, false)) {
+        enet_packet_destroy(enetPacket);
+        return false;
+    }
     
-    if (m_IsClient) {
-        // Client sends to server (peerID is ignored)
-        if (m_ServerPeer && m_ServerPeer->state == ENET_PEER_STATE_CONNECTED) {
-            success = enet_peer_send(m_ServerPeer, channel, enetPacket) == 0;
-        }
-    } else if (m_IsServer) {
-        // Server sends to specific client
-        PeerInfo* peer = GetPeerInfo(peerID);
-        if (peer && peer->enetPeer && peer->isConnected) {
-            success = enet_peer_send(peer->enetPeer, channel, enetPacket) == 0;
+    m_BytesSent += packet.GetTotalSize();
+    m_PacketsSent++;
+    m_MessagesSent++;
+    return true;
+}
+
+bool NetworkManager::BroadcastPacket(const Packet& packet, 
+                                    PacketReliability reliability, uint8_t channel) {
+    if (!m_IsServer) {
+        SetError("Not running as server");
+        return false;
+    }
+    
+    // Each peer gets the message in its own bundle
+    uint8_t header[PacketHeader::WireSize];
+    packet.GetHeader().WriteTo(header);
+    if (FitsBundle(packet.GetDataSize())) {
+        for (const PeerInfo& peer : m_ConnectedPeers) {
+            QueueMessage(peer.id, channel, reliability, header, packet.GetData(), packet.GetDataSize());
         }
+        return true;
     }
     
-    if (success) {
-        m_BytesSent += packet.GetTotalSize();
-        m_PacketsSent++;
-    } else {
+    for (const PeerInfo& peer : m_ConnectedPeers) {
+        FlushBundle(peer.id, channel, reliability);
+    }
+    ENetPacket* enetPacket = packet.CreateENetPacket(reliability);
+    if (!enetPacket) {
+        SetError("Failed to create ENet packet");
+        return false;
+    }
+    
+    if (!QueueOutgoing(enetPacket, 0, 0, channel, true)) {
         enet_packet_destroy(enetPacket);
+        return false;
+    }
+    
+    m_BytesSent += packet.GetTotalSize() * m_ConnectedPeers.size();
+    m_PacketsSent++;
+    m_MessagesSent += static_cast<uint32_t>(m_ConnectedPeers.size());
+    
+    return true;
+}
+
+bool NetworkManager::SendPacket(PacketWriter& writer, uint32_t peerID, uint8_t channel) {
+    if (writer.IsSent()) {
+        SetError("Packet writer was already sent");
+        return false;
+    }
+    if (!CanSendTo(peerID)) {
         SetError("Failed to send packet");
+        return false;
     }
     
-    return success;
+    ENetPacket* enetPacket = writer.Finish();
+    if (!enetPacket) {
+        SetError("Failed to create ENet packet");
+        return false;
+    }
+    
+    // Small writers are copied into the bundle and keep their packet, which they free
+    uint32_t target = m_IsClient ? 0 : peerID;
+    const uint8_t* data = enetPacket->data;
+    size_t payloadSize = writer.GetTotalSize() - PacketHeader::WireSize;
+    if (QueueMessage(target, channel, writer.GetReliability(), data, data + PacketHeader::WireSize, payloadSize)) {
+        return true;
+    }
+    
+    // Once queued the packet belongs to the network thread
+    FlushBundle(target, channel, writer.GetReliability());
+    if (!QueueOutgoing(enetPacket, target, GetConnectID(target), channel, false)) {
+        return false;
+    }
+    
+    writer.MarkSent();
+    m_BytesSent += writer.GetTotalSize();
+    m_PacketsSent++;
+    m_MessagesSent++;
+    return true;
 }
 
-bool NetworkManager::BroadcastPacket(const Packet& packet, 
-                                    PacketReliability reliability, uint8_t channel) {
-    if (!m_IsServer || !m_Host) {
+bool NetworkManager::BroadcastPacket(PacketWriter& writer, uint8_t channel) {
+    if (!m_IsServer) {
         SetError("Not running as server");
         return false;
     }
+    if (writer.IsSent()) {
+        SetError("Packet writer was already sent");
+        return false;
+    }
     
-    ENetPacket* enetPacket = packet.CreateENetPacket(reliability);
+    ENetPacket* enetPacket = writer.Finish();
     if (!enetPacket) {
         SetError("Failed to create ENet packet");
         return false;
     }
     
-    enet_host_broadcast(m_Host, channel, enetPacket);
+    const uint8_t* data = enetPacket->data;
+    size_t payloadSize = writer.GetTotalSize() - PacketHeader::WireSize;
+    if (FitsBundle(payloadSize)) {
+        for (const PeerInfo& peer : m_ConnectedPeers) {
+            QueueMessage(peer.id, channel, writer.GetReliability(), data, data + PacketHeader::WireSize, payloadSize);
+        }
+        return true;
+    }
     
-    m_BytesSent += packet.GetTotalSize() * m_ConnectedPeers.size();
+    for (const PeerInfo& peer : m_ConnectedPeers) {
+        FlushBundle(peer.id, channel, writer.GetReliability());
+    }
+    if (!QueueOutgoing(enetPacket, 0, 0, channel, true)) {
+        return false;
+    }
+    
+    writer.MarkSent();
+    m_BytesSent += writer.GetTotalSize() * m_ConnectedPeers.size();
     m_PacketsSent++;
+    m_MessagesSent += static_cast<uint32_t>(m_ConnectedPeers.size());
+    return true;
+}
+
+bool NetworkManager::FitsBundle(size_t payloadSize) {
+    size_t messageSize = PacketHeader::WireSize + payloadSize;
+    uint8_t prefix[10];
+    return PacketHeader::WireSize + EncodeVarUint(prefix, messageSize) + messageSize <= MaxBundleSize;
+}
+
+bool NetworkManager::QueueMessage(uint32_t peerID, uint8_t channel, PacketReliability reliability,
+                                  const uint8_t* header, const uint8_t* payload, size_t payloadSize) {
+    if (!FitsBundle(payloadSize)) {
+        return false;
+    }
+    
+    size_t messageSize = PacketHeader::WireSize + payloadSize;
+    uint8_t prefix[10];
+    size_t prefixSize = EncodeVarUint(prefix, messageSize);
+    
+    Bundle& bundle = m_Bundles[BundleKey(peerID, channel, reliability)];
+    uint32_t connectID = GetConnectID(peerID);
+    if (bundle.writer && bundle.connectID != connectID) {
+        // Written for the slot's previous client
+        bundle.writer.reset();
+        bundle.messages = 0;
+    }
+    if (bundle.writer && bundle.writer->GetTotalSize() + prefixSize + messageSize > MaxBundleSize) {
+        SendBundle(bundle);
+    }
+    if (!bundle.writer) {
+        bundle.writer = std::make_unique<PacketWriter>(PacketType::BUNDLE, reliability, MaxBundleSize);
+        bundle.peerID = peerID;
+        bundle.connectID = connectID;
+        bundle.channel = channel;
+    }
+    if (!bundle.listed) {
+        m_OpenBundles.push_back(BundleKey(peerID, channel, reliability));
+        bundle.listed = true;
+    }
     
+    bundle.writer->WriteBytes(prefix, prefixSize);
+    bundle.writer->WriteBytes(header, PacketHeader::WireSize);
+    bundle.writer->WriteBytes(payload, payloadSize);
+    bundle.messages++;
+    m_MessagesSent++;
     return true;
 }
 
-void NetworkManager::Update() {
-    if (!m_Host) {
-        return;
+void NetworkManager::FlushBundle(uint32_t peerID, uint8_t channel, PacketReliability reliability) {
+    auto it = m_Bundles.find(BundleKey(peerID, channel, reliability));
+    if (it != m_Bundles.end() && it->second.writer) {
+        SendBundle(it->second);
+    }
+}
+
+void NetworkManager::SendBundle(Bundle& bundle) {
+    ENetPacket* enetPacket = bundle.writer->Finish();
+    if (!enetPacket) {
+        SetError("Failed to create ENet packet");
+    } else if (QueueOutgoing(enetPacket, bundle.peerID, bundle.connectID, bundle.channel, false)) {
+        bundle.writer->MarkSent();
+        m_BytesSent += bundle.writer->GetTotalSize();
+        m_PacketsSent++;
     }
     
-    ProcessEvents();
+    bundle.writer.reset();
+    bundle.messages = 0;
+}
+
+void NetworkManager::Flush() {
+    for (uint64_t key : m_OpenBundles) {
+        auto it = m_Bundles.find(key);
+        if (it == m_Bundles.end()) {
+            continue;
+        }
+        if (it->second.writer) {
+            SendBundle(it->second);
+        }
+        it->second.listed = false;
+    }
+    m_OpenBundles.clear();
+}
+
+bool NetworkManager::QueueOutgoing(ENetPacket* packet, uint32_t peerID, uint32_t connectID, uint8_t channel, bool broadcast) {
+    OutgoingMessage message;
+    message.packet = packet;
+    message.peerID = peerID;
+    message.connectID = connectID;
+    message.channel = channel;
+    message.broadcast = broadcast;
+    
+    if (!m_Outgoing.TryPush(std::move(message))) {
+        SetError("Send queue full");
+        return false;
+    }
+    return true;
+}
+
+bool NetworkManager::CanSendTo(uint32_t peerID) const {
+    if (m_IsClient) {
+        // Client sends to server (peerID is ignored)
+        return GetPeerInfo(0) != nullptr;
+    }
+    if (m_IsServer) {
+        const PeerInfo* peer = GetPeerInfo(peerID);
+        return peer && peer->isConnected;
+    }
+    return false;
+}
+
+uint32_t NetworkManager::GetConnectID(uint32_t peerID) const {
+    const PeerInfo* peer = GetPeerInfo(peerID);
+    return peer ? peer->connectID : 0;
+}
+
+ENetPeer* NetworkManager::GetSendTarget(uint32_t peerID) {
+    if (m_IsClient) {
+        // Client sends to server (peerID is ignored)
+        if (m_ServerPeer && m_ServerPeer->state == ENET_PEER_STATE_CONNECTED) {
+            return m_ServerPeer;
+        }
+    } else if (m_IsServer) {
+        // Server sends to specific client, found straight from its ID
+        if (peerID >= 1 && peerID <= m_Host->peerCount) {
+            ENetPeer* enetPeer = &m_Host->peers[peerID - 1];
+            if (enetPeer->state == ENET_PEER_STATE_CONNECTED) {
+                return enetPeer;
+            }
+        }
+    }
+    return nullptr;
+}
+
+std::unique_lock<std::mutex> NetworkManager::LockHost() {
+    // The network thread holds the lock for almost every iteration; the request count
+    // makes it stand aside instead of racing us for the mutex
+    m_HostRequests++;
+    std::unique_lock<std::mutex> lock(m_HostMutex);
+    m_HostRequests--;
+    return lock;
+}
+
+void NetworkManager::Update() {
+    // Sends made since the game's last Flush() go ahead of any replies to what arrives now
+    Flush();
+    ProcessIncoming();
     
     // Send periodic pings
     static uint32_t lastPingTime = 0;
     uint32_t currentTime = enet_time_get();
     
-    if (currentTime - lastPingTime > 5000) { // Ping every 5 seconds
+    if ((m_IsServer || m_IsClient) && currentTime - lastPingTime > 5000) { // Ping every 5 seconds
         for (auto& peer : m_ConnectedPeers) {
             if (peer.isConnected) {
                 SendPing(peer.id);
@@ -404,171 +691,313 @@ void NetworkManager::Update() {
         }
         eventsToProcess.pop();
     }
+    
+    // Replies from handlers and callbacks leave this frame
+    Flush();
 }
 
-void NetworkManager::ProcessEvents() {
-    ENetEvent event;
+void NetworkManager::ProcessIncoming() {
+    uint64_t now = Profiler::NowNs();
+    IncomingMessage message;
+    
+    while (m_Incoming.TryPop(message)) {
+        switch (message.kind) {
+            case IncomingMessage::Kind::CONNECT:
+                OnPeerConnected(message);
+                break;
+                
+            case IncomingMessage::Kind::DISCONNECT:
+                OnPeerDisconnected(message);
+                break;
+                
+            case IncomingMessage::Kind::RECEIVE:
+                m_DispatchDelay.Record(now > message.receivedNs ? (now - message.receivedNs) / 1000 : 0);
+                DispatchPacket(message);
+                enet_packet_destroy(message.packet);
+                break;
+        }
+    }
+}
+
+void NetworkManager::DispatchPacket(const IncomingMessage& message) {
+    try {
+        // Handlers read straight from the ENet buffer, which lives until the message is done
+        Packet packet = Packet::Wrap(message.packet);
+        
+        m_BytesReceived += message.packet->dataLength;
+        m_PacketsReceived++;
+        
+        PeerInfo* peer = GetPeerInfo(message.peerID);
+        if (peer) {
+            peer->roundTripTime = message.roundTripTime;
+        }
+        
+        if (packet.GetType() != PacketType::BUNDLE) {
+            DispatchMessage(message.packet->data, message.packet->dataLength, message.peerID);
+            return;
+        }
+        
+        // Split the bundle back into its messages, each handled as if it came alone
+        const uint8_t* data = packet.GetData();
+        size_t size = packet.GetDataSize();
+        size_t offset = 0;
+        while (offset < size) {
+            size_t length = 0;
+            if (!DecodeVarUint(data, size, offset, length) || length > size - offset) {
+                throw std::runtime_error("Malformed bundle from peer " + std::to_string(message.peerID));
+            }
+            DispatchMessage(data + offset, length, message.peerID);
+            offset += length;
+        }
+        
+    } catch (const std::exception& e) {
+        Logger::Error<NetworkManager>("Failed to process received packet: " + 
+                                    std::string(e.what()), this);
+    }
+}
+
+void NetworkManager::DispatchMessage(const uint8_t* data, size_t size, uint32_t peerID) {
+    Packet packet = Packet::Wrap(data, size);
+    m_MessagesReceived++;
+    
+    // Handle packet through registered handlers
+    const PacketHandler& handler = m_PacketHandlers[static_cast<uint8_t>(packet.GetType())];
+    if (handler) {
+        handler(packet, peerID);
+    } else {
+        // Queue as generic packet received event; the queued copy must own its bytes
+        NetworkEvent netEvent(NetworkEventType::PACKET_RECEIVED, peerID);
+        netEvent.packet = Packet::FromBytes(data, size);
+        QueueEvent(netEvent);
+    }
+}
+
+void NetworkManager::OnPeerConnected(const IncomingMessage& message) {
+    PeerInfo peer;
+    peer.id = message.peerID;
+    peer.enetPeer = message.enetPeer;
+    peer.connectID = message.connectID;
+    peer.isConnected = true;
+    
+    // Get address info
+    char hostBuffer[256];
+    if (enet_address_get_host_ip(&message.address, hostBuffer, sizeof(hostBuffer)) == 0) {
+        peer.address = hostBuffer;
+    }
+    peer.port = message.address.port;
+    AddPeer(peer);
+    
+    if (m_IsClient) {
+        // Don't assign our own client ID yet - wait for server to send it via PEER_ID_ASSIGNMENT packet
+        m_LocalPeerID = 0; // Will be set when we receive the assignment packet
+        return;
+    }
+    
+    Logger::Info("Client connected from " + peer.address + ":" + std::to_string(peer.port));
+    QueueEvent(NetworkEvent(NetworkEventType::CLIENT_CONNECTED, peer.id, 
+                           "Client " + std::to_string(peer.id) + " connected"));
+}
+
+void NetworkManager::OnPeerDisconnected(const IncomingMessage& message) {
+    RemovePeer(message.peerID);
+    
+    if (m_IsServer) {
+        QueueEvent(NetworkEvent(NetworkEventType::CLIENT_DISCONNECTED, 
+                              message.peerID, "Client disconnected"));
+        Logger::Info("Client " + std::to_string(message.peerID) + " disconnected");
+    } else if (m_IsClient) {
+        QueueEvent(NetworkEvent(NetworkEventType::SERVER_DISCONNECTED, 0, 
+                              "Server disconnected"));
+        Logger::Info("Server disconnected");
+    }
+}
+
+void NetworkManager::ServiceHost(uint32_t timeoutMs) {
+    // Room may have opened up since the last pass
+    while (!m_IncomingOverflow.empty() && m_Incoming.TryPush(std::move(m_IncomingOverflow.front()))) {
+        m_IncomingOverflow.pop_front();
+    }
     
-    while (enet_host_service(m_Host, &event, 0) > 0) {
+    SendOutgoing();
+    
+    // Wait for traffic at most timeoutMs, then take everything else that has already arrived
+    ENetEvent event;
+    int result = enet_host_service(m_Host, &event, timeoutMs);
+    while (result > 0) {
         HandleENetEvent(event);
+        result = enet_host_check_events(m_Host, &event);
     }
+    
+    // Sends queued while we waited go out now rather than after the next wait
+    SendOutgoing();
+    enet_host_flush(m_Host);
 }
 
 void NetworkManager::HandleENetEvent(const ENetEvent& event) {
+    IncomingMessage message;
+    
     switch (event.type) {
         case ENET_EVENT_TYPE_CONNECT: {
-            if (m_IsServer) {
-                AddPeer(event.peer);
-                Logger::Info("Client connected from " + 
-                           std::to_string((event.peer->address.host & 0xFF)) + "." +
-                           std::to_string(((event.peer->address.host >> 8) & 0xFF)) + "." +
-                           std::to_string(((event.peer->address.host >> 16) & 0xFF)) + "." +
-                           std::to_string(((event.peer->address.host >> 24) & 0xFF)) + ":" +
-                           std::to_string(event.peer->address.port));
+            if (!m_IsServer) {
+                return;
             }
+            message.kind = IncomingMessage::Kind::CONNECT;
+            message.peerID = AssignPeerID(event.peer);
+            message.enetPeer = event.peer;
+            message.address = event.peer->address;
+            message.connectID = event.peer->connectID;
             break;
         }
         
         case ENET_EVENT_TYPE_DISCONNECT: {
+            message.kind = IncomingMessage::Kind::DISCONNECT;
             if (m_IsServer) {
-                PeerInfo* peer = FindPeerByENetPeer(event.peer);
-                if (peer) {
-                    QueueEvent(NetworkEvent(NetworkEventType::CLIENT_DISCONNECTED, 
-                                          peer->id, "Client disconnected"));
-                    Logger::Info("Client " + std::to_string(peer->id) + " disconnected");
-                    RemovePeer(event.peer);
-                }
-            } else if (m_IsClient) {
-                QueueEvent(NetworkEvent(NetworkEventType::SERVER_DISCONNECTED, 0, 
-                                      "Server disconnected"));
-                Logger::Info("Server disconnected");
+                message.peerID = static_cast<uint32_t>(reinterpret_cast<uintptr_t>(event.peer->data));
             }
             break;
         }
         
         case ENET_EVENT_TYPE_RECEIVE: {
-            try {
-                Packet packet = Packet::FromENetPacket(event.packet);
-                
-                m_BytesReceived += event.packet->dataLength;
-                m_PacketsReceived++;
-                
-                // Find sender peer ID
-                uint32_t senderID = 0;
-                if (m_IsServer) {
-                    PeerInfo* peer = FindPeerByENetPeer(event.peer);
-                    if (peer) {
-                        senderID = peer->id;
-                    }
-                }
-                
-                // Handle packet through registered handlers
-                auto handler = m_PacketHandlers.find(packet.GetType());
-                if (handler != m_PacketHandlers.end()) {
-                    handler->second(packet, senderID);
-                } else {
-                    // Queue as generic packet received event
-                    NetworkEvent netEvent(NetworkEventType::PACKET_RECEIVED, senderID);
-                    netEvent.packet = packet;
-                    QueueEvent(netEvent);
-                }
-                
-            } catch (const std::exception& e) {
-                Logger::Error<NetworkManager>("Failed to process received packet: " + 
-                                            std::string(e.what()), this);
-            }
-            
-            enet_packet_destroy(event.packet);
+            message.kind = IncomingMessage::Kind::RECEIVE;
+            message.peerID = m_IsServer ? static_cast<uint32_t>(reinterpret_cast<uintptr_t>(event.peer->data)) : 0;
+            message.packet = event.packet;
+            message.roundTripTime = event.peer->roundTripTime;
+            message.receivedNs = Profiler::NowNs();
             break;
         }
         
         default:
-            break;
+            return;
     }
+    
+    PushIncoming(std::move(message));
+}
+
+void NetworkManager::PushIncoming(IncomingMessage&& message) {
+    // Never block the network thread on a stalled game thread; keep order through the overflow
+    if (!m_IncomingOverflow.empty() || !m_Incoming.TryPush(std::move(message))) {
+        m_IncomingOverflow.push_back(std::move(message));
+    }
+}
+
+void NetworkManager::SendOutgoing() {
+    OutgoingMessage message;
+    while (m_Outgoing.TryPop(message)) {
+        if (message.broadcast) {
+            // enet_host_broadcast destroys the packet itself when no peer takes it
+            enet_host_broadcast(m_Host, message.channel, message.packet);
+            continue;
+        }
+        
+        // The client's only target is the server, whose connection cannot change under it
+        ENetPeer* target = GetSendTarget(message.peerID);
+        bool sameConnection = target && (m_IsClient || target->connectID == message.connectID);
+        if (!sameConnection || enet_peer_send(target, message.channel, message.packet) != 0) {
+            enet_packet_destroy(message.packet);
+        }
+    }
+}
+
+void NetworkManager::DiscardIncoming() {
+    // Called with the network thread locked out, so the overflow is ours too
+    IncomingMessage message;
+    while (m_Incoming.TryPop(message)) {
+        if (message.packet) {
+            enet_packet_destroy(message.packet);
+        }
+    }
+    for (IncomingMessage& overflow : m_IncomingOverflow) {
+        if (overflow.packet) {
+            enet_packet_destroy(overflow.packet);
+        }
+    }
+    m_IncomingOverflow.clear();
 }
 
 void NetworkManager::RegisterPacketHandler(PacketType type, PacketHandler handler) {
-    m_PacketHandlers[type] = handler;
+    m_PacketHandlers[static_cast<uint8_t>(type)] = handler;
 }
 
 void NetworkManager::UnregisterPacketHandler(PacketType type) {
-    m_PacketHandlers.erase(type);
+    m_PacketHandlers[static_cast<uint8_t>(type)] = nullptr;
 }
 
-void NetworkManager::AddPeer(ENetPeer* enetPeer) {
-    PeerInfo peer;
-    peer.id = m_NextPeerID++;
-    peer.enetPeer = enetPeer;
-    peer.isConnected = true;
+uint32_t NetworkManager::AssignPeerID(ENetPeer* enetPeer) {
+    // The slot index makes the ID, so sends map back to the ENet peer without a lookup
+    uint32_t peerID = static_cast<uint32_t>(enetPeer - m_Host->peers) + 1;
     
     // Set peer data to our peer ID for easy lookup
-    enetPeer->data = reinterpret_cast<void*>(static_cast<uintptr_t>(peer.id));
+    enetPeer->data = reinterpret_cast<void*>(static_cast<uintptr_t>(peerID));
     
-    // Get address info
-    char hostBuffer[256];
-    if (enet_address_get_host_ip(&enetPeer->address, hostBuffer, sizeof(hostBuffer)) == 0) {
-        peer.address = hostBuffer;
-    }
-    peer.port = enetPeer->address.port;
-    
-    m_ConnectedPeers.push_back(peer);
-    
-    // Send peer ID assignment to the newly connected client
-    Logger::Info("=== SERVER ASSIGNING PEER ID ===");
-    Logger::Info("Assigning peer ID: " + std::to_string(peer.id) + " to new client");
-    Logger::Info("Server local peer ID: " + std::to_string(m_LocalPeerID));
-    
-    Packet peerIDPacket = PacketFactory::CreatePeerIDAssignmentPacket(peer.id);
+    // The assignment goes out before anything the game sends this peer
+    Logger::Info("Assigning peer ID: " + std::to_string(peerID) + " to new client");
+    Packet peerIDPacket = PacketFactory::CreatePeerIDAssignmentPacket(peerID);
     ENetPacket* enetPacket = peerIDPacket.CreateENetPacket(PacketReliability::RELIABLE);
     if (enetPacket && enet_peer_send(enetPeer, 0, enetPacket) == 0) {
-        Logger::Info("Successfully sent PEER_ID_ASSIGNMENT packet to client (assigned ID: " + std::to_string(peer.id) + ")");
         enet_host_flush(m_Host); // Force immediate send
     } else {
         Logger::Error<NetworkManager>("Failed to send peer ID assignment packet", this);
         if (enetPacket) enet_packet_destroy(enetPacket);
     }
-    
-    QueueEvent(NetworkEvent(NetworkEventType::CLIENT_CONNECTED, peer.id, 
-                           "Client " + std::to_string(peer.id) + " connected"));
+    return peerID;
 }
 
-void NetworkManager::RemovePeer(ENetPeer* enetPeer) {
-    auto it = std::find_if(m_ConnectedPeers.begin(), m_ConnectedPeers.end(),
-                          [enetPeer](const PeerInfo& peer) {
-                              return peer.enetPeer == enetPeer;
-                          });
+void NetworkManager::AddPeer(const PeerInfo& peer) {
+    if (peer.id >= m_PeerSlots.size()) {
+        m_PeerSlots.resize(peer.id + 1, -1);
+    }
     
-    if (it != m_ConnectedPeers.end()) {
-        m_ConnectedPeers.erase(it);
+    int32_t& slot = m_PeerSlots[peer.id];
+    if (slot >= 0) {
+        m_ConnectedPeers[slot] = peer;
+        return;
     }
+    slot = static_cast<int32_t>(m_ConnectedPeers.size());
+    m_ConnectedPeers.push_back(peer);
 }
 
-PeerInfo* NetworkManager::FindPeerByENetPeer(ENetPeer* enetPeer) {
-    auto it = std::find_if(m_ConnectedPeers.begin(), m_ConnectedPeers.end(),
-                          [enetPeer](PeerInfo& peer) {
-                              return peer.enetPeer == enetPeer;
-                          });
+void NetworkManager::RemovePeer(uint32_t peerID) {
+    if (peerID < m_PeerSlots.size() && m_PeerSlots[peerID] >= 0) {
+        // Fill the gap with the last peer so the list stays dense
+        int32_t slot = m_PeerSlots[peerID];
+        if (static_cast<size_t>(slot) != m_ConnectedPeers.size() - 1) {
+            m_ConnectedPeers[slot] = std::move(m_ConnectedPeers.back());
+            m_PeerSlots[m_ConnectedPeers[slot].id] = slot;
+        }
+        m_ConnectedPeers.pop_back();
+        m_PeerSlots[peerID] = -1;
+    }
     
-    return (it != m_ConnectedPeers.end()) ? &(*it) : nullptr;
+    // Anything still bundled for the peer has nowhere to go; listed bundles go out with
+    // the next Flush() and are dropped by the network thread, their connection being gone
+    for (auto bundle = m_Bundles.begin(); bundle != m_Bundles.end();) {
+        if (bundle->second.peerID == peerID && !bundle->second.listed) {
+            bundle = m_Bundles.erase(bundle);
+        } else {
+            ++bundle;
+        }
+    }
+}
+
+void NetworkManager::ClearPeers() {
+    m_ConnectedPeers.clear();
+    m_PeerSlots.clear();
 }
 
 PeerInfo* NetworkManager::GetPeerInfo(uint32_t peerID) {
-    auto it = std::find_if(m_ConnectedPeers.begin(), m_ConnectedPeers.end(),
-                          [peerID](PeerInfo& peer) {
-                              return peer.id == peerID;
-                          });
-    
-    return (it != m_ConnectedPeers.end()) ? &(*it) : nullptr;
+    if (peerID >= m_PeerSlots.size() || m_PeerSlots[peerID] < 0) {
+        return nullptr;
+    }
+    return &m_ConnectedPeers[m_PeerSlots[peerID]];
 }
 
 const PeerInfo* NetworkManager::GetPeerInfo(uint32_t peerID) const {
-    auto it = std::find_if(m_ConnectedPeers.begin(), m_ConnectedPeers.end(),
-                          [peerID](const PeerInfo& peer) {
-                              return peer.id == peerID;
-                          });
-    
-    return (it != m_ConnectedPeers.end()) ? &(*it) : nullptr;
+    if (peerID >= m_PeerSlots.size() || m_PeerSlots[peerID] < 0) {
+        return nullptr;
+    }
+    return &m_ConnectedPeers[m_PeerSlots[peerID]];
 }
+
 void NetworkManager::QueueEvent(const NetworkEvent& event) {
     std::lock_guard<std::mutex> lock(m_EventQueueMutex);
     m_EventQueue.push(event);
@@ -580,19 +1009,14 @@ void NetworkManager::SetError(const std::string& error) {
 }
 
 uint32_t NetworkManager::GetLatency(uint32_t peerID) const {
-    if (m_IsClient && peerID == 0 && m_ServerPeer) {
-        return m_ServerPeer->roundTripTime;
-    } else if (m_IsServer) {
-        const PeerInfo* peer = GetPeerInfo(peerID);
-        if (peer && peer->enetPeer) {
-            return peer->enetPeer->roundTripTime;
-        }
-    }
-    return 0;
+    // A client's only peer is the server
+    const PeerInfo* peer = GetPeerInfo(m_IsClient ? 0 : peerID);
+    return peer ? peer->roundTripTime : 0;
 }
 
 void NetworkManager::SetChannelLimit(size_t limit) {
     m_ChannelLimit = limit;
+    auto lock = LockHost();
     if (m_Host) {
         enet_host_channel_limit(m_Host, limit);
     }
@@ -601,6 +1025,7 @@ void NetworkManager::SetChannelLimit(size_t limit) {
 void NetworkManager::SetBandwidthLimit(uint32_t incomingBandwidth, uint32_t outgoingBandwidth) {
     m_IncomingBandwidth = incomingBandwidth;
     m_OutgoingBandwidth = outgoingBandwidth;
+    auto lock = LockHost();
     if (m_Host) {
         enet_host_bandwidth_limit(m_Host, incomingBandwidth, outgoingBandwidth);
     }
@@ -608,6 +1033,7 @@ void NetworkManager::SetBandwidthLimit(uint32_t incomingBandwidth, uint32_t outg
 
 void NetworkManager::SetCompressionEnabled(bool enabled) {
     m_CompressionEnabled = enabled;
+    auto lock = LockHost();
     if (m_Host && enabled) {
         enet_host_compress_with_range_coder(m_Host);
     }
@@ -626,14 +1052,12 @@ void NetworkManager::SendPong(uint32_t peerID) {
     SendPacket(pongPacket, peerID, PacketReliability::UNRELIABLE);
 }
 
-void NetworkManager::UpdatePeerLatency(uint32_t peerID, uint32_t timestamp) {
-    uint32_t currentTime = enet_time_get();
-    uint32_t roundTripTime = currentTime - timestamp;
-    
+void NetworkManager::UpdatePeerLatency(uint32_t peerID) {
+    // Round trip time is ENet's own estimate, delivered with every packet; pongs just
+    // record that the peer is still answering
     PeerInfo* peer = GetPeerInfo(peerID);
     if (peer) {
-        peer->roundTripTime = roundTripTime;
-        peer->lastPingTime = currentTime;
+        peer->lastPingTime = enet_time_get();
     }
 }
 
@@ -643,14 +1067,6 @@ void NetworkManager::HandlePing(const Packet& packet, uint32_t peerID) {
     SendPacket(pongPacket, peerID, PacketReliability::UNRELIABLE);
 }
 
-void NetworkManager::HandlePong(const Packet& packet, uint32_t peerID) {
-    // Update peer ping time
-    PeerInfo* peer = GetPeerInfo(peerID);
-    if (peer) {
-        peer->roundTripTime = enet_time_get() - peer->lastPingTime;
-    }
-}
-
 void NetworkManager::SetupDefaultHandlers() {
     RegisterBuiltinHandlers();
 }
@@ -664,7 +1080,7 @@ void NetworkManager::RegisterBuiltinHandlers() {
     
     RegisterPacketHandler(PacketType::PONG,
         [this](const Packet& packet, uint32_t senderID) {
-            UpdatePeerLatency(senderID, packet.GetTimestamp());
+            UpdatePeerLatency(senderID);
         });
     
         RegisterPacketHandler(PacketType::PEER_ID_ASSIGNMENT,
@@ -692,10 +1108,13 @@ void NetworkManager::RegisterBuiltinHandlers() {
 
 void NetworkManager::NetworkThreadFunction() {
     Logger::Info("Network thread started");
+    Profiler::SetThreadName("Network");
+    uint64_t lastServiceNs = 0;
     
     while (m_ThreadRunning) {
         // Check for pending connection requests
         if (m_PendingConnection) {
+            PROFILE_SCOPE("Network::Connect");
             AsyncConnectionData connectionData;
             {
                 std::lock_guard<std::mutex> lock(m_ConnectionDataMutex);
@@ -716,7 +1135,27 @@ void NetworkManager::NetworkThreadFunction() {
             m_PendingConnection = false;
         }
         
-        // Wait for next operation or timeout
+        // Stand aside while the game thread takes the host over
+        while (m_HostRequests > 0) {
+            std::this_thread::yield();
+        }
+        
+        {
+            std::lock_guard<std::mutex> lock(m_HostMutex);
+            if (m_Host) {
+                uint64_t now = Profiler::NowNs();
+                if (lastServiceNs) {
+                    m_ServiceInterval.Record((now - lastServiceNs) / 1000);
+                }
+                lastServiceNs = now;
+                
+                ServiceHost(ServiceTimeoutMs);
+                continue;
+            }
+        }
+        lastServiceNs = 0;
+        
+        // No host to service; wait for a server to start or a connection request
         std::unique_lock<std::mutex> lock(m_EventQueueMutex);
         m_ThreadCondition.wait_for(lock, std::chrono::milliseconds(100));
     }
@@ -1,8 +1,12 @@
 #pragma once
 
 #include "Packet.h"
+#include "SPSCQueue.h"
+#include "LatencyHistogram.h"
 #include <enet/enet.h>
+#include <array>
 #include <functional>
+#include <deque>
 #include <queue>
 #include <memory>
 #include <vector>
@@ -39,21 +43,26 @@ struct NetworkEvent {
 // Peer information
 struct PeerInfo {
     uint32_t id;
-    ENetPeer* enetPeer;
+    ENetPeer* enetPeer;       // Identity only; the network thread owns it
     std::string address;
     uint16_t port;
     uint32_t lastPingTime;
-    uint32_t roundTripTime;
+    uint32_t roundTripTime;   // ENet's smoothed estimate as of the last packet from this peer
+    uint32_t connectID;       // ENet's ID for this connection; a client reusing the slot gets a new one
     bool isConnected;
     
-    PeerInfo() : id(0), enetPeer(nullptr), port(0), lastPingTime(0), roundTripTime(0), isConnected(false) {}
+    PeerInfo() : id(0), enetPeer(nullptr), port(0), lastPingTime(0), roundTripTime(0), connectID(0), isConnected(false) {}
 };
 
 // Network callback types
 using NetworkEventCallback = std::function<void(const NetworkEvent&)>;
 using PacketHandler = std::function<void(const Packet&, uint32_t peerID)>;
 
-// Main NetworkManager class
+// Main NetworkManager class. A network thread owns the ENetHost and services it every
+// millisecond or so, independent of frame time, so ACKs and resends never wait on a slow
+// frame. Packets cross between it and the game thread through lock-free single-producer
+// single-consumer rings; Update() dispatches whatever has arrived since the last call.
+// Starting, stopping and disconnecting take the host over briefly from the game thread.
 class NetworkManager {
 public:
     NetworkManager();
@@ -67,12 +76,12 @@ public:
     // Server functions
     bool StartServer(uint16_t port, size_t maxClients = 32);
     void StopServer();
-    bool IsServer() const { return m_IsServer && m_Host != nullptr; }
+    bool IsServer() const { return m_IsServer; }
     
     // Client functions
     bool ConnectToServer(const std::string& address, uint16_t port, uint32_t timeoutMs = 5000);
     void DisconnectFromServer(const std::string& reason = "");
-    bool IsClient() const { return m_IsClient && m_Host != nullptr; }
+    bool IsClient() const { return m_IsClient; }
     bool IsConnectedToServer() const;
     
     // Packet sending
@@ -82,16 +91,23 @@ public:
     bool BroadcastPacket(const Packet& packet, 
                          PacketReliability reliability = PacketReliability::RELIABLE, 
                          uint8_t channel = 0);
+    // Zero-copy sends; a writer goes out once, to one peer or as a broadcast (reliability is set on the writer)
+    bool SendPacket(PacketWriter& writer, uint32_t peerID = 0, uint8_t channel = 0);
+    bool BroadcastPacket(PacketWriter& writer, uint8_t channel = 0);
     
-    // Network update (call this every frame)
+    // Dispatches received packets and events on the calling (game) thread; call every frame
     void Update();
+    // Sends the messages bundled since the last flush. Call once per tick after the game's
+    // sends; Update() also flushes, so nothing waits longer than a frame.
+    void Flush();
     
     // Event handling
     void SetEventCallback(NetworkEventCallback callback) { m_EventCallback = callback; }
     void RegisterPacketHandler(PacketType type, PacketHandler handler);
     void UnregisterPacketHandler(PacketType type);
     
-    // Peer management
+    // Peer management. A client's peer ID is its ENet slot index + 1 (0 is the server), so IDs
+    // stay small and are reused once a client has gone; lookups by ID are a table index.
     const std::vector<PeerInfo>& GetConnectedPeers() const { return m_ConnectedPeers; }
     PeerInfo* GetPeerInfo(uint32_t peerID);
     const PeerInfo* GetPeerInfo(uint32_t peerID) const;
@@ -104,6 +120,13 @@ public:
     uint64_t GetBytesReceived() const { return m_BytesReceived; }
     uint32_t GetPacketsSent() const { return m_PacketsSent; }
     uint32_t GetPacketsReceived() const { return m_PacketsReceived; }
+    // Game messages, several of which usually share one packet
+    uint32_t GetMessagesSent() const { return m_MessagesSent; }
+    uint32_t GetMessagesReceived() const { return m_MessagesReceived; }
+    // Time between services of the host on the network thread, and from receipt there to
+    // dispatch in Update(). The first stays flat whatever the frame time; the second tracks it.
+    const LatencyHistogram& GetServiceIntervalHistogram() const { return m_ServiceInterval; }
+    const LatencyHistogram& GetDispatchDelayHistogram() const { return m_DispatchDelay; }
     
     // Configuration
     void SetChannelLimit(size_t limit);
@@ -114,21 +137,62 @@ public:
     static std::string GetLastError() { return s_LastError; }
     
 private:
+    // Longest the network thread blocks in enet_host_service, so queued sends wait at most this long
+    static constexpr uint32_t ServiceTimeoutMs = 1;
+    static constexpr size_t QueueCapacity = 4096;
+    // Largest bundle, leaving room under ENet's 1400-byte MTU for its own and UDP/IP headers
+    static constexpr size_t MaxBundleSize = 1200;
+
+    // Messages to one peer on one channel with one reliability, sent together as a BUNDLE:
+    // the header, then per message its varuint length and its bytes (header included)
+    struct Bundle {
+        std::unique_ptr<PacketWriter> writer;
+        uint32_t peerID = 0;
+        uint32_t connectID = 0;     // Connection the messages were written for
+        uint8_t channel = 0;
+        uint32_t messages = 0;
+        bool listed = false;        // In m_OpenBundles
+    };
+
+    // Game thread -> network thread. Each message owns its packet until ENet takes it.
+    // Peer IDs are reused slots, so a packet is dropped if its connection is gone by the
+    // time it is sent rather than reaching the next client in the slot.
+    struct OutgoingMessage {
+        ENetPacket* packet = nullptr;
+        uint32_t peerID = 0;
+        uint32_t connectID = 0;
+        uint8_t channel = 0;
+        bool broadcast = false;
+    };
+
+    // Network thread -> game thread
+    struct IncomingMessage {
+        enum class Kind : uint8_t { CONNECT, DISCONNECT, RECEIVE };
+        Kind kind = Kind::RECEIVE;
+        uint32_t peerID = 0;
+        ENetPeer* enetPeer = nullptr;
+        ENetAddress address{};
+        uint32_t connectID = 0;         // CONNECT
+        ENetPacket* packet = nullptr;   // RECEIVE; destroyed by the game thread after dispatch
+        uint32_t roundTripTime = 0;
+        uint64_t receivedNs = 0;
+    };
+
     // Internal state
     bool m_Initialized;
-    bool m_IsServer;
-    bool m_IsClient;
-    ENetHost* m_Host;
+    std::atomic<bool> m_IsServer;
+    std::atomic<bool> m_IsClient;
+    ENetHost* m_Host;       // Network thread, or whoever holds m_HostMutex
     ENetPeer* m_ServerPeer; // For client: connection to server
     
     // Peer management
-    std::vector<PeerInfo> m_ConnectedPeers;
-    uint32_t m_NextPeerID;
+    std::vector<PeerInfo> m_ConnectedPeers;     // Unordered; removal swaps in the last peer
+    std::vector<int32_t> m_PeerSlots;           // Peer ID -> index in m_ConnectedPeers, -1 if none
     uint32_t m_LocalPeerID;
     
     // Event handling
     NetworkEventCallback m_EventCallback;
-    std::unordered_map<PacketType, PacketHandler> m_PacketHandlers;
+    std::array<PacketHandler, 256> m_PacketHandlers;    // Indexed by the PacketType byte
     std::queue<NetworkEvent> m_EventQueue;
     
     // Statistics
@@ -136,6 +200,8 @@ private:
     uint64_t m_BytesReceived;
     uint32_t m_PacketsSent;
     uint32_t m_PacketsReceived;
+    uint32_t m_MessagesSent;
+    uint32_t m_MessagesReceived;
     
     // Configuration
     size_t m_MaxClients;
@@ -154,6 +220,19 @@ private:
     std::condition_variable m_ThreadCondition;
     std::atomic<bool> m_PendingConnection;
     
+    // Host ownership and packet exchange with the network thread
+    std::mutex m_HostMutex;
+    std::atomic<int> m_HostRequests;    // Game thread waiting for m_HostMutex; the network thread yields to it
+    SPSCQueue<OutgoingMessage> m_Outgoing;
+    SPSCQueue<IncomingMessage> m_Incoming;
+    std::deque<IncomingMessage> m_IncomingOverflow;             // While m_Incoming is full, under m_HostMutex
+    LatencyHistogram m_ServiceInterval;
+    LatencyHistogram m_DispatchDelay;
+    
+    // Outgoing bundles by peer, channel and reliability (game thread)
+    std::unordered_map<uint64_t, Bundle> m_Bundles;
+    std::vector<uint64_t> m_OpenBundles;
+    
     // Async connection data
     struct AsyncConnectionData {
         std::string address;
@@ -164,23 +243,43 @@ private:
     AsyncConnectionData m_ConnectionData;
     
     // Internal methods
-    void ProcessEvents();
+    std::unique_lock<std::mutex> LockHost();
+    bool QueueOutgoing(ENetPacket* packet, uint32_t peerID, uint32_t connectID, uint8_t channel, bool broadcast);
+    bool CanSendTo(uint32_t peerID) const;
+    uint32_t GetConnectID(uint32_t peerID) const;   // 0 if the peer is not connected
+    static bool FitsBundle(size_t payloadSize);
+    bool QueueMessage(uint32_t peerID, uint8_t channel, PacketReliability reliability,
+                      const uint8_t* header, const uint8_t* payload, size_t payloadSize);
+    void FlushBundle(uint32_t peerID, uint8_t channel, PacketReliability reliability);
+    void SendBundle(Bundle& bundle);
+    void DispatchMessage(const uint8_t* data, size_t size, uint32_t peerID);
+    void ProcessIncoming();
+    void DispatchPacket(const IncomingMessage& message);
+    void OnPeerConnected(const IncomingMessage& message);
+    void OnPeerDisconnected(const IncomingMessage& message);
+    
+    // Network thread, or the game thread holding m_HostMutex
+    void ServiceHost(uint32_t timeoutMs);
     void HandleENetEvent(const ENetEvent& event);
+    void PushIncoming(IncomingMessage&& message);
+    void SendOutgoing();
+    void DiscardIncoming();
+    ENetPeer* GetSendTarget(uint32_t peerID);
     void NetworkThreadFunction(); // New thread function
     bool ConnectToServerBlocking(const std::string& address, uint16_t port, uint32_t timeoutMs); // Blocking version
     void RegisterBuiltinHandlers(); // Register built-in packet handlers
     void SendPong(uint32_t peerID); // Send pong packet
-    void UpdatePeerLatency(uint32_t peerID, uint32_t timestamp); // Update peer latency
-    void AddPeer(ENetPeer* enetPeer);
-    void RemovePeer(ENetPeer* enetPeer);
-    PeerInfo* FindPeerByENetPeer(ENetPeer* enetPeer);
+    void UpdatePeerLatency(uint32_t peerID); // Update peer latency
+    uint32_t AssignPeerID(ENetPeer* enetPeer);
+    void AddPeer(const PeerInfo& peer);
+    void RemovePeer(uint32_t peerID);
+    void ClearPeers();
     void QueueEvent(const NetworkEvent& event);
     void SetError(const std::string& error);
     
     // Ping system
     void SendPing(uint32_t peerID);
     void HandlePing(const Packet& packet, uint32_t peerID);
-    void HandlePong(const Packet& packet, uint32_t peerID);
     
     // Built-in packet handlers
     void SetupDefaultHandlers();
@@ -1,178 +1,372 @@
 #include "Packet.h"
+#include <algorithm>
 #include <stdexcept>
 
+namespace {
+    uint32_t ToENetFlags(PacketReliability reliability) {
+        switch (reliability) {
+            case PacketReliability::RELIABLE:
+                return ENET_PACKET_FLAG_RELIABLE;
+            case PacketReliability::UNSEQUENCED:
+                return ENET_PACKET_FLAG_UNSEQUENCED;
+            case PacketReliability::UNRELIABLE:
+            default:
+                return 0;
+        }
+    }
+}
+
+// PacketHeader implementation
+
+void PacketHeader::WriteTo(uint8_t* out) const {
+    out[0] = static_cast<uint8_t>(type);
+    out[1] = static_cast<uint8_t>(timestamp & 0xFF);
+    out[2] = static_cast<uint8_t>((timestamp >> 8) & 0xFF);
+}
+
+PacketHeader PacketHeader::ReadFrom(const uint8_t* in, uint32_t dataSize) {
+    PacketHeader header;
+    header.type = static_cast<PacketType>(in[0]);
+    header.dataSize = dataSize;
+    
+    // Latest time whose low 16 bits match the sent ones
+    uint16_t sent = static_cast<uint16_t>(in[1] | (in[2] << 8));
+    uint32_t now = enet_time_get();
+    header.timestamp = now - static_cast<uint16_t>(static_cast<uint16_t>(now) - sent);
+    return header;
+}
+
 // Packet class implementation
 
-void Packet::WriteUint8(uint8_t value) {
-    m_Data.push_back(value);
+void Packet::WriteBytes(const void* bytes, size_t size) {
+    if (m_View) {
+        // Writing to a received packet: take a private copy first
+        m_Data.assign(m_View, m_View + m_Header.dataSize);
+        m_View = nullptr;
+    }
+    size_t offset = m_Data.size();
+    m_Data.resize(offset + size);
+    std::memcpy(m_Data.data() + offset, bytes, size);
     UpdateHeader();
 }
 
+void Packet::ReadBytes(void* bytes, size_t size) {
+    if (m_ReadPos + size > m_Header.dataSize) {
+        throw std::runtime_error("Packet read overflow: tried to read past end of data");
+    }
+    std::memcpy(bytes, GetData() + m_ReadPos, size);
+    m_ReadPos += size;
+}
+
+void Packet::WriteUint8(uint8_t value) {
+    WriteBytes(&value, sizeof(value));
+}
+
 void Packet::WriteUint16(uint16_t value) {
-    m_Data.push_back(static_cast<uint8_t>(value & 0xFF));
-    m_Data.push_back(static_cast<uint8_t>((value >> 8) & 0xFF));
-    UpdateHeader();
+    uint8_t bytes[2];
+    WireFormat::StoreUint16(bytes, value);
+    WriteBytes(bytes, sizeof(bytes));
 }
 
 void Packet::WriteUint32(uint32_t value) {
-    m_Data.push_back(static_cast<uint8_t>(value & 0xFF));
-    m_Data.push_back(static_cast<uint8_t>((value >> 8) & 0xFF));
-    m_Data.push_back(static_cast<uint8_t>((value >> 16) & 0xFF));
-    m_Data.push_back(static_cast<uint8_t>((value >> 24) & 0xFF));
-    UpdateHeader();
+    uint8_t bytes[4];
+    WireFormat::StoreUint32(bytes, value);
+    WriteBytes(bytes, sizeof(bytes));
 }
 
 void Packet::WriteFloat(float value) {
-    union { float f; uint32_t i; } converter;
-    converter.f = value;
-    WriteUint32(converter.i);
+    uint8_t bytes[4];
+    WireFormat::StoreFloat(bytes, value);
+    WriteBytes(bytes, sizeof(bytes));
 }
 
 void Packet::WriteString(const std::string& value) {
     WriteUint16(static_cast<uint16_t>(value.length()));
-    for (char c : value) {
-        WriteUint8(static_cast<uint8_t>(c));
-    }
+    WriteBytes(value.data(), value.length());
 }
 
 void Packet::WriteVec2(const glm::vec2& value) {
-    WriteFloat(value.x);
-    WriteFloat(value.y);
+    uint8_t bytes[8];
+    WireFormat::StoreFloat(bytes, value.x);
+    WireFormat::StoreFloat(bytes + 4, value.y);
+    WriteBytes(bytes, sizeof(bytes));
 }
 
 void Packet::WriteVec3(const glm::vec3& value) {
-    WriteFloat(value.x);
-    WriteFloat(value.y);
-    WriteFloat(value.z);
+    uint8_t bytes[12];
+    WireFormat::StoreFloat(bytes, value.x);
+    WireFormat::StoreFloat(bytes + 4, value.y);
+    WireFormat::StoreFloat(bytes + 8, value.z);
+    WriteBytes(bytes, sizeof(bytes));
 }
 
 uint8_t Packet::ReadUint8() {
-    if (m_ReadPos >= m_Data.size()) {
-        throw std::runtime_error("Packet read overflow: tried to read past end of data");
-    }
-    return m_Data[m_ReadPos++];
+    uint8_t value;
+    ReadBytes(&value, sizeof(value));
+    return value;
 }
 
 uint16_t Packet::ReadUint16() {
-    uint16_t value = 0;
-    value |= static_cast<uint16_t>(ReadUint8());
-    value |= static_cast<uint16_t>(ReadUint8()) << 8;
-    return value;
+    uint8_t bytes[2];
+    ReadBytes(bytes, sizeof(bytes));
+    return WireFormat::LoadUint16(bytes);
 }
 
 uint32_t Packet::ReadUint32() {
-    uint32_t value = 0;
-    value |= static_cast<uint32_t>(ReadUint8());
-    value |= static_cast<uint32_t>(ReadUint8()) << 8;
-    value |= static_cast<uint32_t>(ReadUint8()) << 16;
-    value |= static_cast<uint32_t>(ReadUint8()) << 24;
-    return value;
+    uint8_t bytes[4];
+    ReadBytes(bytes, sizeof(bytes));
+    return WireFormat::LoadUint32(bytes);
 }
 
 float Packet::ReadFloat() {
-    union { float f; uint32_t i; } converter;
-    converter.i = ReadUint32();
-    return converter.f;
+    uint8_t bytes[4];
+    ReadBytes(bytes, sizeof(bytes));
+    return WireFormat::LoadFloat(bytes);
 }
 
 std::string Packet::ReadString() {
     uint16_t length = ReadUint16();
-    std::string result;
-    result.reserve(length);
-    for (uint16_t i = 0; i < length; ++i) {
-        result.push_back(static_cast<char>(ReadUint8()));
+    if (m_ReadPos + length > m_Header.dataSize) {
+        throw std::runtime_error("Packet read overflow: tried to read past end of data");
     }
+    std::string result(reinterpret_cast<const char*>(GetData() + m_ReadPos), length);
+    m_ReadPos += length;
     return result;
 }
 
-glm::vec2 Packet::ReadVec2() {
-    float x = ReadFloat();
-    float y = ReadFloat();
-    return glm::vec2(x, y);
+void Packet::WriteBits(BitWriter& bits) {
+    bits.Flush();
+    WriteBytes(bits.GetData(), bits.GetSize());
 }
 
-glm::vec3 Packet::ReadVec3() {
-    float x = ReadFloat();
-    float y = ReadFloat();
-    float z = ReadFloat();
-    return glm::vec3(x, y, z);
+BitReader Packet::ReadBits() const {
+    return BitReader(GetData() + m_ReadPos, m_Header.dataSize - m_ReadPos);
 }
 
-const uint8_t* Packet::GetRawData() const {
-    static std::vector<uint8_t> combined;
-    combined.clear();
-    
-    // Add header
-    const uint8_t* headerBytes = reinterpret_cast<const uint8_t*>(&m_Header);
-    combined.insert(combined.end(), headerBytes, headerBytes + sizeof(PacketHeader));
-    
-    // Add data
-    combined.insert(combined.end(), m_Data.begin(), m_Data.end());
-    
-    return combined.data();
+glm::vec2 Packet::ReadVec2() {
+    uint8_t bytes[8];
+    ReadBytes(bytes, sizeof(bytes));
+    return glm::vec2(WireFormat::LoadFloat(bytes), WireFormat::LoadFloat(bytes + 4));
+}
+
+glm::vec3 Packet::ReadVec3() {
+    uint8_t bytes[12];
+    ReadBytes(bytes, sizeof(bytes));
+    return glm::vec3(WireFormat::LoadFloat(bytes), WireFormat::LoadFloat(bytes + 4), WireFormat::LoadFloat(bytes + 8));
 }
 
 ENetPacket* Packet::CreateENetPacket(PacketReliability reliability) const {
-    uint32_t flags = 0;
-    
-    switch (reliability) {
-        case PacketReliability::RELIABLE:
-            flags = ENET_PACKET_FLAG_RELIABLE;
-            break;
-        case PacketReliability::UNRELIABLE:
-            flags = 0;
-            break;
-        case PacketReliability::UNSEQUENCED:
-            flags = ENET_PACKET_FLAG_UNSEQUENCED;
-            break;
+    ENetPacket* enetPacket = enet_packet_create(nullptr, GetTotalSize(), ToENetFlags(reliability));
+    if (!enetPacket) {
+        return nullptr;
     }
     
-    return enet_packet_create(GetRawData(), GetTotalSize(), flags);
+    m_Header.WriteTo(enetPacket->data);
+    if (m_Header.dataSize > 0) {
+        std::memcpy(enetPacket->data + PacketHeader::WireSize, GetData(), m_Header.dataSize);
+    }
+    return enetPacket;
 }
 
 Packet Packet::FromENetPacket(ENetPacket* enetPacket) {
-    if (!enetPacket || enetPacket->dataLength < sizeof(PacketHeader)) {
+    if (!enetPacket) {
         throw std::runtime_error("Invalid ENet packet: too small or null");
     }
-    
-    Packet packet;
-    
-    // Read header
-    std::memcpy(&packet.m_Header, enetPacket->data, sizeof(PacketHeader));
-    
-    // Read data
-    size_t dataSize = enetPacket->dataLength - sizeof(PacketHeader);
-    if (dataSize > 0) {
-        packet.m_Data.resize(dataSize);
-        std::memcpy(packet.m_Data.data(), 
-                   static_cast<uint8_t*>(enetPacket->data) + sizeof(PacketHeader), 
-                   dataSize);
+    return FromBytes(enetPacket->data, enetPacket->dataLength);
+}
+
+Packet Packet::FromBytes(const uint8_t* data, size_t size) {
+    Packet packet = Wrap(data, size);
+    packet.m_Data.assign(packet.m_View, packet.m_View + packet.m_Header.dataSize);
+    packet.m_View = nullptr;
+    return packet;
+}
+
+Packet Packet::Wrap(const ENetPacket* enetPacket) {
+    if (!enetPacket) {
+        throw std::runtime_error("Invalid ENet packet: too small or null");
+    }
+    return Wrap(enetPacket->data, enetPacket->dataLength);
+}
+
+Packet Packet::Wrap(const uint8_t* data, size_t size) {
+    if (!data || size < PacketHeader::WireSize) {
+        throw std::runtime_error("Invalid ENet packet: too small or null");
     }
     
+    Packet packet;
+    uint32_t dataSize = static_cast<uint32_t>(size - PacketHeader::WireSize);
+    packet.m_Header = PacketHeader::ReadFrom(data, dataSize);
+    packet.m_View = data + PacketHeader::WireSize;
     packet.m_ReadPos = 0;
     return packet;
 }
 
 void Packet::Clear() {
     m_Data.clear();
+    m_View = nullptr;
     m_ReadPos = 0;
     m_Header = PacketHeader();
 }
 
+// PacketWriter implementation
+
+PacketWriter::PacketWriter(PacketType type, PacketReliability reliability, size_t capacity)
+    : m_Packet(nullptr), m_Reliability(reliability), m_Size(PacketHeader::WireSize), m_Capacity(0), m_Finished(false), m_Sent(false)
+{
+    m_Capacity = std::max(capacity, PacketHeader::WireSize);
+    m_Packet = enet_packet_create(nullptr, m_Capacity, ToENetFlags(reliability));
+    if (m_Packet) {
+        PacketHeader(type, 0).WriteTo(m_Packet->data);
+    }
+}
+
+PacketWriter::~PacketWriter() {
+    // Once queued the network thread owns the packet, and ENet releases it after sending
+    if (m_Packet && !m_Sent) {
+        enet_packet_destroy(m_Packet);
+    }
+}
+
+void PacketWriter::WriteUint16(uint16_t value) {
+    uint8_t bytes[2];
+    WireFormat::StoreUint16(bytes, value);
+    WriteBytes(bytes, sizeof(bytes));
+}
+
+void PacketWriter::WriteUint32(uint32_t value) {
+    uint8_t bytes[4];
+    WireFormat::StoreUint32(bytes, value);
+    WriteBytes(bytes, sizeof(bytes));
+}
+
+void PacketWriter::WriteFloat(float value) {
+    uint8_t bytes[4];
+    WireFormat::StoreFloat(bytes, value);
+    WriteBytes(bytes, sizeof(bytes));
+}
+
+void PacketWriter::WriteVec2(const glm::vec2& value) {
+    uint8_t bytes[8];
+    WireFormat::StoreFloat(bytes, value.x);
+    WireFormat::StoreFloat(bytes + 4, value.y);
+    WriteBytes(bytes, sizeof(bytes));
+}
+
+void PacketWriter::WriteVec3(const glm::vec3& value) {
+    uint8_t bytes[12];
+    WireFormat::StoreFloat(bytes, value.x);
+    WireFormat::StoreFloat(bytes + 4, value.y);
+    WireFormat::StoreFloat(bytes + 8, value.z);
+    WriteBytes(bytes, sizeof(bytes));
+}
+
+void PacketWriter::WriteString(const std::string& value) {
+    WriteUint16(static_cast<uint16_t>(value.length()));
+    WriteBytes(value.data(), value.length());
+}
+
+void PacketWriter::WriteBytes(const void* bytes, size_t size) {
+    if (!m_Packet || m_Finished) {
+        return;
+    }
+    
+    if (m_Size + size > m_Capacity) {
+        size_t capacity = std::max(m_Capacity * 2, m_Size + size);
+        if (enet_packet_resize(m_Packet, capacity) != 0) {
+            enet_packet_destroy(m_Packet);
+            m_Packet = nullptr;
+            return;
+        }
+        m_Capacity = capacity;
+    }
+    std::memcpy(m_Packet->data + m_Size, bytes, size);
+    m_Size += size;
+}
+
+ENetPacket* PacketWriter::Finish() {
+    if (!m_Packet || m_Finished) {
+        return m_Packet;
+    }
+    
+    enet_packet_resize(m_Packet, m_Size);   // Shrinking never reallocates
+    m_Finished = true;
+    return m_Packet;
+}
+
 // PacketData implementations
 
+void PacketData::PlayerMove::Serialize(BitWriter& bits) const {
+    bits.WriteVarUint(playerID);
+    bits.WriteQuantized(position, PositionRange);
+    bits.WriteQuantized(velocity, VelocityRange);
+    bits.WriteAngle(rotation, RotationBits);
+}
+
+void PacketData::PlayerMove::Deserialize(BitReader& bits) {
+    playerID = bits.ReadVarUint();
+    position = bits.ReadQuantizedVec2(PositionRange);
+    velocity = bits.ReadQuantizedVec2(VelocityRange);
+    rotation = bits.ReadAngle(RotationBits);
+}
+
 void PacketData::PlayerMove::WriteTo(Packet& packet) const {
-    packet.WriteUint32(playerID);
-    packet.WriteVec2(position);
-    packet.WriteVec2(velocity);
-    packet.WriteFloat(rotation);
+    BitWriter bits(16);
+    Serialize(bits);
+    packet.WriteBits(bits);
+}
+
+void PacketData::PlayerMove::WriteTo(PacketWriter& writer) const {
+    BitWriter bits(16);
+    Serialize(bits);
+    writer.WriteBits(bits);
 }
 
 void PacketData::PlayerMove::ReadFrom(Packet& packet) {
-    playerID = packet.ReadUint32();
-    position = packet.ReadVec2();
-    velocity = packet.ReadVec2();
-    rotation = packet.ReadFloat();
+    BitReader bits = packet.ReadBits();
+    Deserialize(bits);
+    packet.SkipBits(bits);
+}
+
+void PacketData::PlayerInput::Serialize(BitWriter& bits) const {
+    bits.WriteVarUint(static_cast<uint32_t>(commands.size()));
+    if (commands.empty()) {
+        return;
+    }
+    
+    // Sequences are consecutive, so only the first is sent
+    bits.WriteVarUint(commands.front().sequence);
+    for (const InputCommand& command : commands) {
+        bits.WriteBits(command.buttons, InputButtonBits);
+        bits.WriteAngle(command.aim, RotationBits);
+    }
+}
+
+void PacketData::PlayerInput::Deserialize(BitReader& bits) {
+    size_t count = std::min<size_t>(bits.ReadVarUint(), MaxCommands);
+    commands.resize(count);
+    if (count == 0) {
+        return;
+    }
+    
+    uint32_t sequence = bits.ReadVarUint();
+    for (InputCommand& command : commands) {
+        command.sequence = sequence++;
+        command.buttons = static_cast<uint8_t>(bits.ReadBits(InputButtonBits));
+        command.aim = bits.ReadAngle(RotationBits);
+    }
+}
+
+void PacketData::PlayerInput::WriteTo(PacketWriter& writer) const {
+    BitWriter bits(8 + commands.size() * 2);
+    Serialize(bits);
+    writer.WriteBits(bits);
+}
+
+void PacketData::PlayerInput::ReadFrom(Packet& packet) {
+    BitReader bits = packet.ReadBits();
+    Deserialize(bits);
+    packet.SkipBits(bits);
 }
 
 void PacketData::ChatMessage::WriteTo(Packet& packet) const {
@@ -187,20 +381,36 @@ void PacketData::ChatMessage::ReadFrom(Packet& packet) {
     message = packet.ReadString();
 }
 
+void PacketData::EntityUpdate::Serialize(BitWriter& bits) const {
+    bits.WriteVarUint(entityID);
+    bits.WriteQuantized(position, PositionRange);
+    bits.WriteAngle(rotation.x, RotationBits);
+    bits.WriteAngle(rotation.y, RotationBits);
+    bits.WriteAngle(rotation.z, RotationBits);
+    bits.WriteQuantized(scale, ScaleRange);
+    bits.WriteBool(isVisible);
+}
+
+void PacketData::EntityUpdate::Deserialize(BitReader& bits) {
+    entityID = bits.ReadVarUint();
+    position = bits.ReadQuantizedVec3(PositionRange);
+    rotation.x = bits.ReadAngle(RotationBits);
+    rotation.y = bits.ReadAngle(RotationBits);
+    rotation.z = bits.ReadAngle(RotationBits);
+    scale = bits.ReadQuantizedVec3(ScaleRange);
+    isVisible = bits.ReadBool();
+}
+
 void PacketData::EntityUpdate::WriteTo(Packet& packet) const {
-    packet.WriteUint32(entityID);
-    packet.WriteVec3(position);
-    packet.WriteVec3(rotation);
-    packet.WriteVec3(scale);
-    packet.WriteUint8(isVisible ? 1 : 0);
+    BitWriter bits(24);
+    Serialize(bits);
+    packet.WriteBits(bits);
 }
 
 void PacketData::EntityUpdate::ReadFrom(Packet& packet) {
-    entityID = packet.ReadUint32();
-    position = packet.ReadVec3();
-    rotation = packet.ReadVec3();
-    scale = packet.ReadVec3();
-    isVisible = packet.ReadUint8() != 0;
+    BitReader bits = packet.ReadBits();
+    Deserialize(bits);
+    packet.SkipBits(bits);
 }
 
 void PacketData::PlayerJoin::WriteTo(Packet& packet) const {
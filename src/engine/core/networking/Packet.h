@@ -5,6 +5,7 @@
 #include <string>
 #include <cstring>
 #include <glm/glm.hpp>
+#include "BitStream.h"
 
 // Forward declarations
 class NetworkManager;
@@ -17,10 +18,12 @@ enum class PacketType : uint8_t {
     PING, // Server to client message
     PONG, // Client to server response
     PEER_ID_ASSIGNMENT, // Server assigns peer ID to client
+    BUNDLE, // Several length-prefixed messages sent as one datagram
     
     
     // Player actions
     PLAYER_MOVE,
+    PLAYER_INPUT, // Client input commands, simulated by the server
     PLAYER_POSITION_UPDATE,
     PLAYER_JOIN,
     PLAYER_LEAVE,
@@ -30,6 +33,7 @@ enum class PacketType : uint8_t {
     ENTITY_SPAWN,
     ENTITY_DESTROY,
     ENTITY_UPDATE,
+    SNAPSHOT_ACK, // Client confirms a GAME_STATE_UPDATE snapshot tick
     
     // Chat/Communication
     CHAT_MESSAGE,
@@ -49,8 +53,50 @@ enum class PacketReliability {
     UNSEQUENCED = 2         // Fast, guaranteed but unordered
 };
 
-// Base packet structure
+// Fixed-size values are stored little-endian byte by byte, so the wire format does not
+// depend on the host. Floats travel as their IEEE-754 bits.
+namespace WireFormat {
+    inline void StoreUint16(uint8_t* out, uint16_t value) {
+        out[0] = static_cast<uint8_t>(value & 0xFF);
+        out[1] = static_cast<uint8_t>((value >> 8) & 0xFF);
+    }
+
+    inline void StoreUint32(uint8_t* out, uint32_t value) {
+        out[0] = static_cast<uint8_t>(value & 0xFF);
+        out[1] = static_cast<uint8_t>((value >> 8) & 0xFF);
+        out[2] = static_cast<uint8_t>((value >> 16) & 0xFF);
+        out[3] = static_cast<uint8_t>((value >> 24) & 0xFF);
+    }
+
+    inline void StoreFloat(uint8_t* out, float value) {
+        uint32_t bits;
+        std::memcpy(&bits, &value, sizeof(bits));
+        StoreUint32(out, bits);
+    }
+
+    inline uint16_t LoadUint16(const uint8_t* in) {
+        return static_cast<uint16_t>(in[0] | (in[1] << 8));
+    }
+
+    inline uint32_t LoadUint32(const uint8_t* in) {
+        return static_cast<uint32_t>(in[0]) | (static_cast<uint32_t>(in[1]) << 8) |
+               (static_cast<uint32_t>(in[2]) << 16) | (static_cast<uint32_t>(in[3]) << 24);
+    }
+
+    inline float LoadFloat(const uint8_t* in) {
+        uint32_t bits = LoadUint32(in);
+        float value;
+        std::memcpy(&value, &bits, sizeof(value));
+        return value;
+    }
+}
+
+// Base packet structure. On the wire it is 3 bytes: the type and the low 16 bits of the
+// timestamp. The payload size comes from the ENet packet length, and the timestamp is
+// widened again on receipt (valid for packets less than ~65 seconds old).
 struct PacketHeader {
+    static constexpr size_t WireSize = 3;
+
     PacketType type;
     uint32_t timestamp;
     uint32_t dataSize;
@@ -58,9 +104,14 @@ struct PacketHeader {
     PacketHeader() : type(PacketType::PING), timestamp(0), dataSize(0) {}
     PacketHeader(PacketType t, uint32_t size) 
         : type(t), timestamp(enet_time_get()), dataSize(size) {}
+
+    void WriteTo(uint8_t* out) const;
+    static PacketHeader ReadFrom(const uint8_t* in, uint32_t dataSize);
 };
 
-// Packet data container with serialization support
+// Packet data container with serialization support. A packet either owns its bytes (built
+// with Write*) or is a read-only view over a received ENet packet (Packet::Wrap), which is
+// only valid until that ENet packet is destroyed. Values are little-endian on the wire.
 class Packet {
 public:
     Packet() : m_Header(), m_Data() {}
@@ -80,6 +131,7 @@ public:
     void WriteString(const std::string& value);
     void WriteVec2(const glm::vec2& value);
     void WriteVec3(const glm::vec3& value);
+    void WriteBits(BitWriter& bits);        // Flushes and appends the bit-packed bytes
     
     // Data reading
     uint8_t ReadUint8();
@@ -89,19 +141,27 @@ public:
     std::string ReadString();
     glm::vec2 ReadVec2();
     glm::vec3 ReadVec3();
+    // Reader over the rest of the payload; call SkipBits with it once done
+    BitReader ReadBits() const;
+    void SkipBits(const BitReader& reader) { m_ReadPos += reader.GetBytesRead(); }
     
-    // Raw data access
-    const uint8_t* GetRawData() const;
-    size_t GetTotalSize() const { return sizeof(PacketHeader) + m_Data.size(); }
+    // Payload bytes (header excluded)
+    const uint8_t* GetData() const { return m_View ? m_View : m_Data.data(); }
+    size_t GetTotalSize() const { return PacketHeader::WireSize + m_Header.dataSize; }
+    bool IsView() const { return m_View != nullptr; }
     
     // Reset read position
     void ResetReadPosition() { m_ReadPos = 0; }
     
-    // Create ENet packet from this packet
+    // Create ENet packet from this packet, serialized straight into its buffer
     ENetPacket* CreateENetPacket(PacketReliability reliability = PacketReliability::RELIABLE) const;
     
-    // Create packet from ENet packet
+    // Create packet from ENet packet (copies the payload, safe to keep)
     static Packet FromENetPacket(ENetPacket* enetPacket);
+    static Packet FromBytes(const uint8_t* data, size_t size);
+    // Read-only view over an ENet packet's data (or one message of a bundle), no copy
+    static Packet Wrap(const ENetPacket* enetPacket);
+    static Packet Wrap(const uint8_t* data, size_t size);
     
     // Clear packet data
     void Clear();
@@ -109,15 +169,69 @@ public:
 private:
     PacketHeader m_Header;
     std::vector<uint8_t> m_Data;
+    const uint8_t* m_View = nullptr;
     mutable size_t m_ReadPos = 0;
     
+    void WriteBytes(const void* bytes, size_t size);
+    void ReadBytes(void* bytes, size_t size);
     void UpdateHeader() { m_Header.dataSize = static_cast<uint32_t>(m_Data.size()); }
 };
 
+// Serializes directly into an ENet packet reserved up front, so sending costs no copies
+// beyond the writes themselves. The finished packet is handed to the network thread once,
+// to one peer or as a broadcast; it is released by ENet once sent, or by the writer if it
+// never was.
+class PacketWriter {
+public:
+    static constexpr size_t DefaultCapacity = 64;
+
+    explicit PacketWriter(PacketType type, PacketReliability reliability = PacketReliability::RELIABLE,
+                          size_t capacity = DefaultCapacity);
+    ~PacketWriter();
+
+    PacketWriter(const PacketWriter&) = delete;
+    PacketWriter& operator=(const PacketWriter&) = delete;
+
+    // Same encoding as the Packet writes
+    void WriteUint8(uint8_t value) { WriteBytes(&value, sizeof(value)); }
+    void WriteUint16(uint16_t value);
+    void WriteUint32(uint32_t value);
+    void WriteFloat(float value);
+    void WriteString(const std::string& value);
+    void WriteVec2(const glm::vec2& value);
+    void WriteVec3(const glm::vec3& value);
+    void WriteBits(BitWriter& bits) { bits.Flush(); WriteBytes(bits.GetData(), bits.GetSize()); }
+    void WriteBytes(const void* bytes, size_t size);
+
+    size_t GetTotalSize() const { return m_Size; }
+    PacketReliability GetReliability() const { return m_Reliability; }
+
+    // Trims the packet to its written size; nullptr if allocation failed.
+    // Further writes are not allowed once finished.
+    ENetPacket* Finish();
+    // Called by the sender once the packet is queued; it then belongs to the network thread
+    void MarkSent() { m_Sent = true; }
+    bool IsSent() const { return m_Sent; }
+
+private:
+    ENetPacket* m_Packet;
+    PacketReliability m_Reliability;
+    size_t m_Size;
+    size_t m_Capacity;
+    bool m_Finished;
+    bool m_Sent;
+};
+
 // Common packet structures for game events
 namespace PacketData {
+
+    // Quantization for bit-packed game state
+    inline constexpr QuantizedRange PositionRange{ -32768.0f, 32768.0f, 20 };   // 1/16 px
+    inline constexpr QuantizedRange VelocityRange{ -4096.0f, 4096.0f, 16 };     // 1/8 px/s
+    inline constexpr QuantizedRange ScaleRange{ 0.0f, 64.0f, 14 };             // ~1/256
+    inline constexpr int RotationBits = 12;                                     // ~0.09 degrees
     
-    // Player movement packet
+    // Player movement packet (bit-packed, 12 bytes for IDs below 128)
     struct PlayerMove {
         uint32_t playerID;
         glm::vec2 position;
@@ -125,7 +239,39 @@ namespace PacketData {
         float rotation;
         
         void WriteTo(Packet& packet) const;
+        void WriteTo(PacketWriter& writer) const;
+        void ReadFrom(Packet& packet);
+        void Serialize(BitWriter& bits) const;
+        void Deserialize(BitReader& bits);
+    };
+    
+    // Movement buttons held during one input step
+    enum InputButton : uint8_t {
+        INPUT_UP = 1 << 0,
+        INPUT_DOWN = 1 << 1,
+        INPUT_LEFT = 1 << 2,
+        INPUT_RIGHT = 1 << 3
+    };
+    inline constexpr int InputButtonBits = 4;
+    
+    // One fixed step of a player's input, numbered so the server can report which it applied
+    struct InputCommand {
+        uint32_t sequence = 0;
+        uint8_t buttons = 0;
+        float aim = 0.0f;       // Facing angle in radians, as TransformComponent::rotation.z
+    };
+    
+    // Client input packet: consecutive commands, oldest first, resent until the server has
+    // applied them so a lost packet costs nothing (2 bytes per command)
+    struct PlayerInput {
+        static constexpr size_t MaxCommands = 32;
+        
+        std::vector<InputCommand> commands;
+        
+        void WriteTo(PacketWriter& writer) const;
         void ReadFrom(Packet& packet);
+        void Serialize(BitWriter& bits) const;
+        void Deserialize(BitReader& bits);
     };
     
     // Chat message packet
@@ -138,7 +284,7 @@ namespace PacketData {
         void ReadFrom(Packet& packet);
     };
     
-    // Entity update packet
+    // Entity update packet (bit-packed; rotation is three quantized angles in radians)
     struct EntityUpdate {
         uint32_t entityID;
         glm::vec3 position;
@@ -148,6 +294,8 @@ namespace PacketData {
         
         void WriteTo(Packet& packet) const;
         void ReadFrom(Packet& packet);
+        void Serialize(BitWriter& bits) const;
+        void Deserialize(BitReader& bits);
     };
     
     // Player join packet
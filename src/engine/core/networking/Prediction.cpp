@@ -0,0 +1,172 @@
+#include "Prediction.h"
+#include <algorithm>
+
+namespace {
+    bool Overlaps(const glm::vec2& pos1, const glm::vec2& size1,
+                  const glm::vec2& pos2, const glm::vec2& size2) {
+        glm::vec2 min1 = pos1 - size1 * 0.5f;
+        glm::vec2 max1 = pos1 + size1 * 0.5f;
+        glm::vec2 min2 = pos2 - size2 * 0.5f;
+        glm::vec2 max2 = pos2 + size2 * 0.5f;
+
+        return (min1.x < max2.x && max1.x > min2.x &&
+                min1.y < max2.y && max1.y > min2.y);
+    }
+
+    // Pushes the box out of each overlapping obstacle along its axis of least overlap
+    glm::vec2 ResolveCollision(const glm::vec2& position, const glm::vec2& size, const ObstacleWorld& obstacles,
+                               std::vector<ObstacleHandle>& scratch) {
+        glm::vec2 resolved = position;
+
+        // Only obstacles near the player can collide; the margin covers pushes out of earlier obstacles
+        scratch.clear();
+        obstacles.QueryAABB(position - size, position + size, scratch);
+
+        for (ObstacleHandle handle : scratch) {
+            const Obstacle* obstacle = obstacles.Get(handle);
+            if (!obstacle || !Overlaps(resolved, size, obstacle->position, obstacle->size)) {
+                continue;
+            }
+
+            glm::vec2 playerMin = resolved - size * 0.5f;
+            glm::vec2 playerMax = resolved + size * 0.5f;
+            glm::vec2 obstacleMin = obstacle->position - obstacle->size * 0.5f;
+            glm::vec2 obstacleMax = obstacle->position + obstacle->size * 0.5f;
+
+            float overlapX = std::min(playerMax.x - obstacleMin.x, obstacleMax.x - playerMin.x);
+            float overlapY = std::min(playerMax.y - obstacleMin.y, obstacleMax.y - playerMin.y);
+
+            if (overlapX < overlapY) {
+                resolved.x = (resolved.x < obstacle->position.x) ? obstacleMin.x - size.x * 0.5f
+                                                                 : obstacleMax.x + size.x * 0.5f;
+            } else {
+                resolved.y = (resolved.y < obstacle->position.y) ? obstacleMin.y - size.y * 0.5f
+                                                                 : obstacleMax.y + size.y * 0.5f;
+            }
+        }
+
+        return resolved;
+    }
+}
+
+glm::vec2 PlayerMovement::Step(const glm::vec2& position, uint8_t buttons, const glm::vec2& size,
+                               const World& world, std::vector<ObstacleHandle>& scratch) {
+    glm::vec2 direction(0.0f);
+    if (buttons & PacketData::INPUT_UP) direction.y -= 1.0f;
+    if (buttons & PacketData::INPUT_DOWN) direction.y += 1.0f;
+    if (buttons & PacketData::INPUT_LEFT) direction.x -= 1.0f;
+    if (buttons & PacketData::INPUT_RIGHT) direction.x += 1.0f;
+
+    glm::vec2 next = position;
+    if (glm::length(direction) > 0.001f) {
+        next += glm::normalize(direction) * StepDistance;
+    }
+
+    if (world.obstacles) {
+        next = ResolveCollision(next, size, *world.obstacles, scratch);
+    }
+
+    glm::vec2 halfSize = size * 0.5f;
+    return glm::clamp(next, halfSize, world.bounds - halfSize);
+}
+
+// InputPredictor
+
+uint32_t InputPredictor::Record(PacketData::InputCommand command, const glm::vec2& predicted) {
+    command.sequence = m_NextSequence++;
+    if (m_Pending.size() >= MaxPending) {
+        // Far behind the server; the oldest commands will be resolved by a correction
+        m_Pending.pop_front();
+    }
+    m_Pending.push_back({ command, predicted });
+    return command.sequence;
+}
+
+bool InputPredictor::Reconcile(uint32_t ackedSequence, const glm::vec2& serverPosition, glm::vec2& position,
+                               const glm::vec2& size, const PlayerMovement::World& world) {
+    // Nothing applied yet, or an ack older than one already handled
+    if (ackedSequence == 0 || ackedSequence < m_AckedSequence) {
+        return false;
+    }
+
+    // Without the prediction for the acked command to compare against, trust the server
+    bool mismatch = false;
+    if (ackedSequence > m_AckedSequence) {
+        bool found = false;
+        while (!m_Pending.empty() && m_Pending.front().command.sequence <= ackedSequence) {
+            if (m_Pending.front().command.sequence == ackedSequence) {
+                m_AckedPrediction = m_Pending.front().predicted;
+                found = true;
+            }
+            m_Pending.pop_front();
+        }
+        m_AckedSequence = ackedSequence;
+        mismatch = !found;
+    }
+
+    if (!mismatch && glm::length(serverPosition - m_AckedPrediction) <= CorrectionThreshold) {
+        return false;
+    }
+
+    // Start over from the server's position and redo what it has not seen yet
+    position = serverPosition;
+    m_AckedPrediction = serverPosition;
+    for (PendingCommand& pending : m_Pending) {
+        position = PlayerMovement::Step(position, pending.command.buttons, size, world, m_Scratch);
+        pending.predicted = position;
+    }
+    m_Corrections++;
+    return true;
+}
+
+void InputPredictor::FillInput(PacketData::PlayerInput& input) const {
+    size_t count = std::min(m_Pending.size(), PacketData::PlayerInput::MaxCommands);
+    input.commands.clear();
+    for (auto it = m_Pending.end() - count; it != m_Pending.end(); ++it) {
+        input.commands.push_back(it->command);
+    }
+}
+
+void InputPredictor::Reset() {
+    m_Pending.clear();
+    m_NextSequence = 1;
+    m_AckedSequence = 0;
+    m_AckedPrediction = glm::vec2(0.0f);
+}
+
+// InputBudget
+
+void InputBudget::Refill(double now) {
+    if (m_LastRefill >= 0.0 && now > m_LastRefill) {
+        float earned = static_cast<float>((now - m_LastRefill) * PlayerMovement::StepRate);
+        m_Credits = std::min(m_Credits + earned, BurstCommands);
+    }
+    m_LastRefill = now;
+}
+
+bool InputBudget::Accept(uint32_t sequence) {
+    // Already applied, resent until the ack arrives
+    if (sequence <= m_LastApplied) {
+        return false;
+    }
+
+    if (m_Credits < 1.0f) {
+        m_Dropped++;
+        return false;
+    }
+
+    // After an outage the client is ahead by about the steps it lasted; that resynchronises
+    if (m_LastApplied != 0) {
+        double elapsed = std::max(m_LastRefill - m_LastAppliedTime, 0.0);
+        double allowed = InputPredictor::MaxPending + elapsed * PlayerMovement::StepRate;
+        if (sequence - m_LastApplied > allowed) {
+            m_Dropped++;
+            return false;
+        }
+    }
+
+    m_Credits -= 1.0f;
+    m_LastApplied = sequence;
+    m_LastAppliedTime = m_LastRefill;
+    return true;
+}
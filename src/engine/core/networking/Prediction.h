@@ -0,0 +1,92 @@
+#pragma once
+
+#include "Packet.h"
+#include <cstdint>
+#include <deque>
+#include <vector>
+#include <glm/glm.hpp>
+#include <engine/core/spatial/ObstacleWorld.h>
+
+// Player movement as one function of input, run by the client to predict its own player and
+// by the server as the authority. It advances in fixed steps, one per input command, so both
+// sides reach the same position from the same commands whatever their frame rates.
+namespace PlayerMovement {
+    inline constexpr float StepRate = 128.0f;
+    inline constexpr float StepTime = 1.0f / StepRate;
+    inline constexpr float StepDistance = 1.0f;    // Units per step while any direction is held
+    inline constexpr float DefaultSize = 32.0f;    // Player box edge when no PlayerComponent says otherwise
+
+    struct World {
+        const ObstacleWorld* obstacles = nullptr;   // None if null
+        glm::vec2 bounds{1280.0f, 720.0f};          // Players are kept inside [0, bounds]
+    };
+
+    // Position after one step with the given InputButton mask; scratch is reused between calls
+    glm::vec2 Step(const glm::vec2& position, uint8_t buttons, const glm::vec2& size,
+                   const World& world, std::vector<ObstacleHandle>& scratch);
+}
+
+// Client half of prediction: the local commands the server has not applied yet, each with the
+// position it predicted. Snapshots carry the server's position after the last command it
+// applied; if that disagrees with the prediction for the same command, the player is put
+// where the server says and the later commands are replayed on top.
+class InputPredictor {
+public:
+    static constexpr size_t MaxPending = 256;               // Two seconds of steps
+    static constexpr float CorrectionThreshold = 0.25f;     // Snapshot quantization stays well below this
+
+    // Numbers a command that was just applied locally and remembers where it left the player
+    uint32_t Record(PacketData::InputCommand command, const glm::vec2& predicted);
+
+    // Checks the server's position after command ackedSequence; true if position was corrected
+    bool Reconcile(uint32_t ackedSequence, const glm::vec2& serverPosition, glm::vec2& position,
+                   const glm::vec2& size, const PlayerMovement::World& world);
+
+    // The newest unapplied commands (at most PlayerInput::MaxCommands), oldest first. Older
+    // ones are not resent; if the server missed them, reconciliation corrects the player.
+    void FillInput(PacketData::PlayerInput& input) const;
+    void Reset();
+
+    size_t GetPendingCount() const { return m_Pending.size(); }
+    uint32_t GetCorrections() const { return m_Corrections; }
+
+private:
+    struct PendingCommand {
+        PacketData::InputCommand command;
+        glm::vec2 predicted;
+    };
+
+    std::deque<PendingCommand> m_Pending;
+    uint32_t m_NextSequence = 1;        // 0 means "none applied" in snapshots
+    uint32_t m_AckedSequence = 0;
+    glm::vec2 m_AckedPrediction{0.0f};  // Predicted position for m_AckedSequence
+    uint32_t m_Corrections = 0;
+    std::vector<ObstacleHandle> m_Scratch;
+};
+
+// Server half, one per client: which received commands get simulated. Commands are earned
+// at StepRate per second of server time with a small burst for packet jitter, so sending
+// more of them cannot move a player faster. Commands over budget are dropped; the client
+// sends them again while they are among its newest unacked ones, and anything it no longer
+// sends is skipped and made good by reconciliation. The client numbers a command every step
+// even while its packets are lost, so a sequence may run ahead of the last applied one by
+// MaxPending plus the steps in the server time since; anything further is rejected.
+class InputBudget {
+public:
+    static constexpr float BurstCommands = 16.0f;   // An eighth of a second of steps
+
+    // Earns commands for the server time since the last call; now is in seconds
+    void Refill(double now);
+    // True if the command should be simulated now; it then counts as applied
+    bool Accept(uint32_t sequence);
+
+    uint32_t GetLastApplied() const { return m_LastApplied; }   // 0 if none
+    uint32_t GetDropped() const { return m_Dropped; }
+
+private:
+    uint32_t m_LastApplied = 0;
+    double m_LastAppliedTime = 0.0;     // Refill time when m_LastApplied was accepted
+    float m_Credits = BurstCommands;
+    double m_LastRefill = -1.0;
+    uint32_t m_Dropped = 0;
+};
@@ -0,0 +1,65 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <utility>
+
+// Bounded lock-free ring for exactly one producer thread and one consumer thread.
+// Capacity is rounded up to a power of two. The two indices live on separate cache lines
+// and each side keeps a cached copy of the other's, so pushes and pops only touch the
+// shared line when the ring looks full or empty.
+template<typename T>
+class SPSCQueue {
+public:
+    explicit SPSCQueue(size_t capacity) {
+        size_t size = 1;
+        while (size < capacity) size <<= 1;
+        m_Slots = std::make_unique<T[]>(size);
+        m_Mask = size - 1;
+    }
+
+    SPSCQueue(const SPSCQueue&) = delete;
+    SPSCQueue& operator=(const SPSCQueue&) = delete;
+
+    // Producer only; false if the ring is full
+    bool TryPush(T&& value) {
+        size_t tail = m_Tail.load(std::memory_order_relaxed);
+        if (tail - m_CachedHead > m_Mask) {
+            m_CachedHead = m_Head.load(std::memory_order_acquire);
+            if (tail - m_CachedHead > m_Mask) return false;
+        }
+        m_Slots[tail & m_Mask] = std::move(value);
+        m_Tail.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Consumer only; false if the ring is empty
+    bool TryPop(T& value) {
+        size_t head = m_Head.load(std::memory_order_relaxed);
+        if (head == m_CachedTail) {
+            m_CachedTail = m_Tail.load(std::memory_order_acquire);
+            if (head == m_CachedTail) return false;
+        }
+        value = std::move(m_Slots[head & m_Mask]);
+        m_Head.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Exact only when called from one of the two sides with the other idle
+    size_t ApproxSize() const {
+        return m_Tail.load(std::memory_order_acquire) - m_Head.load(std::memory_order_acquire);
+    }
+    size_t GetCapacity() const { return m_Mask + 1; }
+
+private:
+    static constexpr size_t CacheLine = 64;
+
+    std::unique_ptr<T[]> m_Slots;
+    size_t m_Mask = 0;
+
+    alignas(CacheLine) std::atomic<size_t> m_Head{0};   // Next slot to pop, written by the consumer
+    size_t m_CachedTail = 0;
+    alignas(CacheLine) std::atomic<size_t> m_Tail{0};   // Next slot to push, written by the producer
+    size_t m_CachedHead = 0;
+};
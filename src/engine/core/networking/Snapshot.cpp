@@ -0,0 +1,306 @@
+#include "Snapshot.h"
+#include "NetworkManager.h"
+#include <algorithm>
+#include <engine/scene/Scene.h>
+#include <engine/scene/component/CommonComponents.h>
+
+namespace {
+    enum FieldMask : uint32_t {
+        FIELD_POSITION = 1 << 0,
+        FIELD_ROTATION = 1 << 1,
+        FIELD_SCALE    = 1 << 2,
+        FIELD_VISIBLE  = 1 << 3,
+        FIELD_ALL      = 0xF
+    };
+    constexpr int FieldMaskBits = 4;
+
+    // The integers actually sent, so changes below the wire resolution are not changes
+    struct QuantizedState {
+        uint32_t position[3];
+        uint32_t rotation[3];
+        uint32_t scale[3];
+        bool visible;
+
+        explicit QuantizedState(const EntityState& state) {
+            for (int i = 0; i < 3; i++) {
+                position[i] = PacketData::PositionRange.Quantize(state.position[i]);
+                rotation[i] = QuantizeAngle(state.rotation[i], PacketData::RotationBits);
+                scale[i] = PacketData::ScaleRange.Quantize(state.scale[i]);
+            }
+            visible = state.visible;
+        }
+    };
+
+    bool Same(const uint32_t* a, const uint32_t* b) {
+        return a[0] == b[0] && a[1] == b[1] && a[2] == b[2];
+    }
+
+    uint32_t ChangedFields(const QuantizedState& current, const QuantizedState& baseline) {
+        uint32_t mask = 0;
+        if (!Same(current.position, baseline.position)) mask |= FIELD_POSITION;
+        if (!Same(current.rotation, baseline.rotation)) mask |= FIELD_ROTATION;
+        if (!Same(current.scale, baseline.scale)) mask |= FIELD_SCALE;
+        if (current.visible != baseline.visible) mask |= FIELD_VISIBLE;
+        return mask;
+    }
+
+    void WriteFields(BitWriter& bits, const QuantizedState& state, uint32_t mask) {
+        bits.WriteBits(mask, FieldMaskBits);
+        for (int i = 0; i < 3 && (mask & FIELD_POSITION); i++) {
+            bits.WriteBits(state.position[i], PacketData::PositionRange.bits);
+        }
+        for (int i = 0; i < 3 && (mask & FIELD_ROTATION); i++) {
+            bits.WriteBits(state.rotation[i], PacketData::RotationBits);
+        }
+        for (int i = 0; i < 3 && (mask & FIELD_SCALE); i++) {
+            bits.WriteBits(state.scale[i], PacketData::ScaleRange.bits);
+        }
+        if (mask & FIELD_VISIBLE) {
+            bits.WriteBool(state.visible);
+        }
+    }
+
+    void ReadFields(BitReader& bits, EntityState& state) {
+        uint32_t mask = bits.ReadBits(FieldMaskBits);
+        for (int i = 0; i < 3 && (mask & FIELD_POSITION); i++) {
+            state.position[i] = bits.ReadQuantized(PacketData::PositionRange);
+        }
+        for (int i = 0; i < 3 && (mask & FIELD_ROTATION); i++) {
+            state.rotation[i] = bits.ReadAngle(PacketData::RotationBits);
+        }
+        for (int i = 0; i < 3 && (mask & FIELD_SCALE); i++) {
+            state.scale[i] = bits.ReadQuantized(PacketData::ScaleRange);
+        }
+        if (mask & FIELD_VISIBLE) {
+            state.visible = bits.ReadBool();
+        }
+    }
+
+    bool ByNetworkID(const EntityState& state, uint32_t networkID) {
+        return state.networkID < networkID;
+    }
+}
+
+// Snapshot
+
+const EntityState* Snapshot::Find(uint32_t networkID) const {
+    auto it = std::lower_bound(entities.begin(), entities.end(), networkID, ByNetworkID);
+    return (it != entities.end() && it->networkID == networkID) ? &(*it) : nullptr;
+}
+
+Snapshot Snapshot::Capture(Scene& scene, uint32_t tick) {
+    Snapshot snapshot;
+    snapshot.tick = tick;
+
+    ComponentManager* components = scene.GetComponentManager();
+    for (const Entity& entity : scene.GetEntitiesWith<ReplicatedComponent, TransformComponent>()) {
+        const auto* replicated = components->GetComponent<ReplicatedComponent>(entity.GetID());
+        const auto* transform = components->GetComponent<TransformComponent>(entity.GetID());
+        const auto* renderable = components->GetComponent<RenderableComponent>(entity.GetID());
+
+        EntityState state;
+        state.networkID = replicated->networkID;
+        state.position = transform->position;
+        state.rotation = transform->rotation;
+        state.scale = transform->scale;
+        state.visible = !renderable || renderable->visible;
+        snapshot.entities.push_back(state);
+    }
+
+    std::sort(snapshot.entities.begin(), snapshot.entities.end(),
+              [](const EntityState& a, const EntityState& b) { return a.networkID < b.networkID; });
+    return snapshot;
+}
+
+// SnapshotHistory
+
+void SnapshotHistory::Store(const Snapshot& snapshot) {
+    m_Ring[snapshot.tick % Size] = snapshot;
+    m_Valid[snapshot.tick % Size] = true;
+}
+
+const Snapshot* SnapshotHistory::Find(uint32_t tick) const {
+    size_t slot = tick % Size;
+    return (m_Valid[slot] && m_Ring[slot].tick == tick) ? &m_Ring[slot] : nullptr;
+}
+
+void SnapshotHistory::Clear() {
+    m_Valid.fill(false);
+}
+
+// SnapshotCodec
+
+void SnapshotCodec::Write(BitWriter& bits, const Snapshot& snapshot, const Snapshot* baseline) {
+    bits.WriteVarUint(snapshot.tick);
+    bits.WriteVarUint(baseline ? snapshot.tick - baseline->tick : 0);
+    bits.WriteVarUint(snapshot.inputAck);
+    bits.WriteVarUint(snapshot.rate);
+
+    // Both lists are sorted, so ids go out as gaps from the previous one
+    std::vector<uint32_t> removed;
+    if (baseline) {
+        for (const EntityState& old : baseline->entities) {
+            if (!snapshot.Find(old.networkID)) {
+                removed.push_back(old.networkID);
+            }
+        }
+    }
+
+    bits.WriteVarUint(static_cast<uint32_t>(removed.size()));
+    uint32_t previous = 0;
+    for (uint32_t networkID : removed) {
+        bits.WriteVarUint(networkID - previous);
+        previous = networkID;
+    }
+
+    struct Change {
+        uint32_t networkID;
+        uint32_t mask;
+        QuantizedState state;
+    };
+    std::vector<Change> changes;
+    changes.reserve(snapshot.entities.size());
+    for (const EntityState& entity : snapshot.entities) {
+        QuantizedState state(entity);
+        const EntityState* old = baseline ? baseline->Find(entity.networkID) : nullptr;
+        uint32_t mask = old ? ChangedFields(state, QuantizedState(*old)) : FIELD_ALL;
+        if (mask) {
+            changes.push_back({ entity.networkID, mask, state });
+        }
+    }
+
+    bits.WriteVarUint(static_cast<uint32_t>(changes.size()));
+    previous = 0;
+    for (const Change& change : changes) {
+        bits.WriteVarUint(change.networkID - previous);
+        previous = change.networkID;
+        WriteFields(bits, change.state, change.mask);
+    }
+}
+
+bool SnapshotCodec::Read(BitReader& bits, const SnapshotHistory& history, Snapshot& snapshot) {
+    snapshot.tick = bits.ReadVarUint();
+    uint32_t baselineDistance = bits.ReadVarUint();
+    snapshot.inputAck = bits.ReadVarUint();
+    snapshot.rate = bits.ReadVarUint();
+
+    snapshot.entities.clear();
+    if (baselineDistance > 0) {
+        const Snapshot* baseline = history.Find(snapshot.tick - baselineDistance);
+        if (!baseline) {
+            return false;
+        }
+        snapshot.entities = baseline->entities;
+    }
+
+    uint32_t removedCount = bits.ReadVarUint();
+    uint32_t networkID = 0;
+    for (uint32_t i = 0; i < removedCount; i++) {
+        networkID += bits.ReadVarUint();
+        auto it = std::lower_bound(snapshot.entities.begin(), snapshot.entities.end(), networkID, ByNetworkID);
+        if (it != snapshot.entities.end() && it->networkID == networkID) {
+            snapshot.entities.erase(it);
+        }
+    }
+
+    uint32_t changedCount = bits.ReadVarUint();
+    networkID = 0;
+    for (uint32_t i = 0; i < changedCount; i++) {
+        networkID += bits.ReadVarUint();
+        auto it = std::lower_bound(snapshot.entities.begin(), snapshot.entities.end(), networkID, ByNetworkID);
+        if (it == snapshot.entities.end() || it->networkID != networkID) {
+            EntityState added;
+            added.networkID = networkID;
+            it = snapshot.entities.insert(it, added);
+        }
+        ReadFields(bits, *it);
+    }
+    return true;
+}
+
+bool SnapshotCodec::SameOnWire(const EntityState& a, const EntityState& b) {
+    return ChangedFields(QuantizedState(a), QuantizedState(b)) == 0;
+}
+
+// ReplicationServer
+
+void ReplicationServer::AddClient(uint32_t peerID) {
+    m_Clients[peerID] = ClientState();
+}
+
+void ReplicationServer::RemoveClient(uint32_t peerID) {
+    m_Clients.erase(peerID);
+}
+
+void ReplicationServer::Acknowledge(uint32_t peerID, uint32_t tick) {
+    auto it = m_Clients.find(peerID);
+    if (it == m_Clients.end()) {
+        return;
+    }
+
+    ClientState& client = it->second;
+    if (!client.hasAck || tick > client.ackedTick) {
+        client.ackedTick = tick;
+        client.hasAck = true;
+    }
+}
+
+bool ReplicationServer::SendSnapshot(NetworkManager& manager, uint32_t peerID, const Snapshot& snapshot) {
+    auto it = m_Clients.find(peerID);
+    if (it == m_Clients.end()) {
+        return false;
+    }
+
+    // Fall back to a full snapshot until the client acks one still in history
+    ClientState& client = it->second;
+    const Snapshot* baseline = client.hasAck ? client.history.Find(client.ackedTick) : nullptr;
+
+    BitWriter bits(64);
+    SnapshotCodec::Write(bits, snapshot, baseline);
+    client.history.Store(snapshot);
+
+    PacketWriter writer(PacketType::GAME_STATE_UPDATE, PacketReliability::UNRELIABLE,
+                        PacketHeader::WireSize + bits.GetBitCount() / 8 + 1);
+    writer.WriteBits(bits);
+    if (!manager.SendPacket(writer, peerID)) {
+        return false;
+    }
+
+    m_Stats.bytesSent += writer.GetTotalSize();
+    if (baseline) {
+        m_Stats.deltaSnapshots++;
+    } else {
+        m_Stats.fullSnapshots++;
+    }
+    return true;
+}
+
+// ReplicationClient
+
+bool ReplicationClient::Receive(NetworkManager& manager, const Packet& packet, Snapshot& snapshot) {
+    BitReader bits = packet.ReadBits();
+    if (!SnapshotCodec::Read(bits, m_History, snapshot)) {
+        return false;
+    }
+
+    // Unreliable delivery can reorder; never step back to an older world state
+    if (m_HasSnapshot && snapshot.tick <= m_LatestTick) {
+        return false;
+    }
+    m_History.Store(snapshot);
+    m_LatestTick = snapshot.tick;
+    m_HasSnapshot = true;
+
+    Packet ack(PacketType::SNAPSHOT_ACK);
+    BitWriter ackBits(4);
+    ackBits.WriteVarUint(snapshot.tick);
+    ack.WriteBits(ackBits);
+    manager.SendPacket(ack, 0, PacketReliability::UNRELIABLE);
+    return true;
+}
+
+void ReplicationClient::Reset() {
+    m_History.Clear();
+    m_LatestTick = 0;
+    m_HasSnapshot = false;
+}
@@ -0,0 +1,105 @@
+#pragma once
+
+#include "Packet.h"
+#include <array>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+#include <glm/glm.hpp>
+
+class NetworkManager;
+class Scene;
+
+// Replicated state of one entity, quantized on the wire with PacketData's ranges
+struct EntityState {
+    uint32_t networkID = 0;
+    glm::vec3 position{0.0f};
+    glm::vec3 rotation{0.0f};
+    glm::vec3 scale{1.0f};
+    bool visible = true;
+};
+
+// World state at one server tick; entities are kept sorted by networkID
+struct Snapshot {
+    uint32_t tick = 0;
+    uint32_t inputAck = 0;      // Last input command of the receiving client the server applied, 0 if none
+    uint32_t rate = 0;          // Snapshots per second; a snapshot describes server time tick / rate
+    std::vector<EntityState> entities;
+
+    const EntityState* Find(uint32_t networkID) const;
+
+    // Every entity with a ReplicatedComponent and a TransformComponent
+    static Snapshot Capture(Scene& scene, uint32_t tick);
+};
+
+// Most recent snapshots by tick, used as delta baselines
+class SnapshotHistory {
+public:
+    static constexpr size_t Size = 32;
+
+    void Store(const Snapshot& snapshot);
+    const Snapshot* Find(uint32_t tick) const;
+    void Clear();
+
+private:
+    std::array<Snapshot, Size> m_Ring;
+    std::array<bool, Size> m_Valid{};
+};
+
+// Delta encoding against a baseline both sides hold. Entities whose quantized state matches
+// the baseline are skipped, so a snapshot costs in proportion to what changed.
+namespace SnapshotCodec {
+    // baseline may be null for a full snapshot
+    void Write(BitWriter& bits, const Snapshot& snapshot, const Snapshot* baseline);
+    // False if the baseline it was encoded against is no longer in history
+    bool Read(BitReader& bits, const SnapshotHistory& history, Snapshot& snapshot);
+    // True if both states quantize to the same values, i.e. a delta between them is empty
+    bool SameOnWire(const EntityState& a, const EntityState& b);
+}
+
+// Server half: one baseline history per client, advanced by the client's acks.
+// Snapshots go out unreliably as GAME_STATE_UPDATE; a lost one only costs the next delta
+// a larger diff, since it is encoded against the last snapshot the client confirmed.
+class ReplicationServer {
+public:
+    struct Stats {
+        size_t bytesSent = 0;       // Since the last ResetStats
+        uint32_t deltaSnapshots = 0;
+        uint32_t fullSnapshots = 0;
+    };
+
+    void AddClient(uint32_t peerID);
+    void RemoveClient(uint32_t peerID);
+    void Clear() { m_Clients.clear(); }
+
+    void Acknowledge(uint32_t peerID, uint32_t tick);
+    bool SendSnapshot(NetworkManager& manager, uint32_t peerID, const Snapshot& snapshot);
+
+    const Stats& GetStats() const { return m_Stats; }
+    void ResetStats() { m_Stats = Stats(); }
+
+private:
+    struct ClientState {
+        SnapshotHistory history;
+        uint32_t ackedTick = 0;
+        bool hasAck = false;
+    };
+
+    std::unordered_map<uint32_t, ClientState> m_Clients;
+    Stats m_Stats;
+};
+
+// Client half: decodes snapshots against its own history and acks each one it accepts
+class ReplicationClient {
+public:
+    // False for stale snapshots and ones whose baseline is gone; those are not acked
+    bool Receive(NetworkManager& manager, const Packet& packet, Snapshot& snapshot);
+    void Reset();
+
+    uint32_t GetLatestTick() const { return m_LatestTick; }
+
+private:
+    SnapshotHistory m_History;
+    uint32_t m_LatestTick = 0;
+    bool m_HasSnapshot = false;
+};
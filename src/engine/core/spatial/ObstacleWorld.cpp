@@ -0,0 +1,358 @@
+#include "ObstacleWorld.h"
+#include <algorithm>
+#include <cmath>
+#include <cfloat>
+
+namespace {
+    constexpr uint32_t InvalidIndex = 0xFFFFFFFF;
+
+    // Slab test, matching the renderers' ray/box convention: a ray starting
+    // inside a box does not hit it
+    bool RayIntersectsBox(const glm::vec2& origin, const glm::vec2& invDir,
+                          const glm::vec2& boxMin, const glm::vec2& boxMax, float& hitDistance) {
+        glm::vec2 t1 = (boxMin - origin) * invDir;
+        glm::vec2 t2 = (boxMax - origin) * invDir;
+        glm::vec2 tMin = glm::min(t1, t2);
+        glm::vec2 tMax = glm::max(t1, t2);
+
+        float tNear = std::max(tMin.x, tMin.y);
+        float tFar = std::min(tMax.x, tMax.y);
+
+        hitDistance = tNear;
+        return tNear >= 0.0f && tNear <= tFar;
+    }
+
+    float DistanceToBox(const glm::vec2& point, const glm::vec2& boxMin, const glm::vec2& boxMax) {
+        glm::vec2 outside = glm::max(glm::max(boxMin - point, point - boxMax), glm::vec2(0.0f));
+        return glm::length(outside);
+    }
+}
+
+ObstacleWorld::ObstacleWorld(float cellSize)
+    : m_CellSize(std::max(cellSize, 1.0f)), m_Revision(0),
+      m_BoundsMin(FLT_MAX), m_BoundsMax(-FLT_MAX), m_VisitStamp(0)
+{
+}
+
+ObstacleHandle ObstacleWorld::Add(const Obstacle& obstacle) {
+    ObstacleHandle handle;
+    if (!m_FreeHandles.empty()) {
+        handle = m_FreeHandles.back();
+        m_FreeHandles.pop_back();
+    } else {
+        handle = (ObstacleHandle)m_HandleToDense.size();
+        m_HandleToDense.push_back(InvalidIndex);
+    }
+
+    m_HandleToDense[handle] = (uint32_t)m_Obstacles.size();
+    m_Obstacles.push_back(obstacle);
+    m_DenseToHandle.push_back(handle);
+
+    InsertIntoCells(handle, obstacle);
+    m_Revision++;
+    return handle;
+}
+
+ObstacleHandle ObstacleWorld::Add(const glm::vec2& position, const glm::vec2& size) {
+    return Add(Obstacle(position, size));
+}
+
+bool ObstacleWorld::Update(ObstacleHandle handle, const Obstacle& obstacle) {
+    if (handle >= m_HandleToDense.size() || m_HandleToDense[handle] == InvalidIndex) return false;
+
+    Obstacle& current = m_Obstacles[m_HandleToDense[handle]];
+    if (current.position == obstacle.position && current.size == obstacle.size) return true;
+
+    RemoveFromCells(handle, current);
+    current = obstacle;
+    InsertIntoCells(handle, current);
+    m_Revision++;
+    return true;
+}
+
+bool ObstacleWorld::Remove(ObstacleHandle handle) {
+    if (handle >= m_HandleToDense.size() || m_HandleToDense[handle] == InvalidIndex) return false;
+
+    uint32_t index = m_HandleToDense[handle];
+    RemoveFromCells(handle, m_Obstacles[index]);
+
+    // Swap-remove keeps the dense array packed for the renderers
+    uint32_t last = (uint32_t)m_Obstacles.size() - 1;
+    if (index != last) {
+        m_Obstacles[index] = m_Obstacles[last];
+        m_DenseToHandle[index] = m_DenseToHandle[last];
+        m_HandleToDense[m_DenseToHandle[index]] = index;
+    }
+    m_Obstacles.pop_back();
+    m_DenseToHandle.pop_back();
+
+    m_HandleToDense[handle] = InvalidIndex;
+    m_FreeHandles.push_back(handle);
+    m_Revision++;
+    return true;
+}
+
+void ObstacleWorld::SetObstacles(const std::vector<Obstacle>& obstacles) {
+    Clear();
+    m_Obstacles.reserve(obstacles.size());
+    for (const auto& obstacle : obstacles) {
+        Add(obstacle);
+    }
+}
+
+void ObstacleWorld::Clear() {
+    m_Obstacles.clear();
+    m_DenseToHandle.clear();
+    m_HandleToDense.clear();
+    m_FreeHandles.clear();
+    m_Cells.clear();
+    m_BoundsMin = glm::vec2(FLT_MAX);
+    m_BoundsMax = glm::vec2(-FLT_MAX);
+    m_Revision++;
+}
+
+bool ObstacleWorld::Raycast(const glm::vec2& origin, const glm::vec2& direction, float maxDistance,
+                            ObstacleRaycastHit* outHit) const {
+    if (m_Obstacles.empty() || maxDistance <= 0.0f) return false;
+
+    glm::vec2 invDir;
+    invDir.x = (direction.x != 0.0f) ? 1.0f / direction.x : 1e30f;
+    invDir.y = (direction.y != 0.0f) ? 1.0f / direction.y : 1e30f;
+
+    // 1. Clip the ray to the occupied part of the grid
+    glm::vec2 t1 = (m_BoundsMin - origin) * invDir;
+    glm::vec2 t2 = (m_BoundsMax - origin) * invDir;
+    float tStart = std::max(std::max(std::min(t1.x, t2.x), std::min(t1.y, t2.y)), 0.0f);
+    float tEnd = std::min(std::min(std::max(t1.x, t2.x), std::max(t1.y, t2.y)), maxDistance);
+    if (tStart > tEnd) return false;
+
+    // 2. Walk the cells along the ray (Amanatides & Woo)
+    glm::ivec2 cell = CellOf(origin + direction * tStart);
+    glm::ivec2 step(direction.x > 0.0f ? 1 : -1, direction.y > 0.0f ? 1 : -1);
+    glm::vec2 tMax, tDelta;
+    for (int axis = 0; axis < 2; axis++) {
+        if (direction[axis] == 0.0f) {
+            tMax[axis] = FLT_MAX;
+            tDelta[axis] = FLT_MAX;
+            continue;
+        }
+        float boundary = (float)(cell[axis] + (step[axis] > 0 ? 1 : 0)) * m_CellSize;
+        tMax[axis] = (boundary - origin[axis]) * invDir[axis];
+        tDelta[axis] = m_CellSize * std::abs(invDir[axis]);
+    }
+
+    uint32_t stamp = NextVisitStamp();
+    float bestDistance = FLT_MAX;
+    ObstacleHandle bestHandle = InvalidObstacleHandle;
+
+    while (true) {
+        if (const auto* handles = FindCell(cell.x, cell.y)) {
+            for (ObstacleHandle handle : *handles) {
+                if (m_VisitMarks[handle] == stamp) continue;
+                m_VisitMarks[handle] = stamp;
+
+                const Obstacle& obstacle = m_Obstacles[m_HandleToDense[handle]];
+                glm::vec2 halfSize = obstacle.size * 0.5f;
+                float hitDistance;
+                if (RayIntersectsBox(origin, invDir, obstacle.position - halfSize, obstacle.position + halfSize, hitDistance) &&
+                    hitDistance < maxDistance && hitDistance < bestDistance) {
+                    bestDistance = hitDistance;
+                    bestHandle = handle;
+                }
+            }
+        }
+
+        // A hit inside the current cell cannot be beaten by cells further along
+        float cellExit = std::min(tMax.x, tMax.y);
+        if (bestDistance <= cellExit || cellExit > tEnd) break;
+
+        if (tMax.x < tMax.y) {
+            cell.x += step.x;
+            tMax.x += tDelta.x;
+        } else {
+            cell.y += step.y;
+            tMax.y += tDelta.y;
+        }
+    }
+
+    if (bestHandle == InvalidObstacleHandle) return false;
+
+    if (outHit) {
+        outHit->handle = bestHandle;
+        outHit->distance = bestDistance;
+        outHit->point = origin + direction * bestDistance;
+    }
+    return true;
+}
+
+void ObstacleWorld::QueryAABB(const glm::vec2& boxMin, const glm::vec2& boxMax, std::vector<ObstacleHandle>& outHandles) const {
+    if (m_Obstacles.empty()) return;
+
+    // Only the part of the box covering obstacles can produce results
+    glm::vec2 queryMin = glm::max(boxMin, m_BoundsMin);
+    glm::vec2 queryMax = glm::min(boxMax, m_BoundsMax);
+    if (queryMin.x > queryMax.x || queryMin.y > queryMax.y) return;
+
+    glm::ivec2 cellMin = CellOf(queryMin);
+    glm::ivec2 cellMax = CellOf(queryMax);
+
+    auto overlaps = [&](const Obstacle& obstacle) {
+        glm::vec2 halfSize = obstacle.size * 0.5f;
+        glm::vec2 obstacleMin = obstacle.position - halfSize;
+        glm::vec2 obstacleMax = obstacle.position + halfSize;
+        return obstacleMin.x <= boxMax.x && obstacleMax.x >= boxMin.x &&
+               obstacleMin.y <= boxMax.y && obstacleMax.y >= boxMin.y;
+    };
+
+    // Huge boxes are cheaper to answer with a straight scan
+    int64_t cellCount = (int64_t)(cellMax.x - cellMin.x + 1) * (int64_t)(cellMax.y - cellMin.y + 1);
+    if (cellCount > (int64_t)m_Obstacles.size() * 4) {
+        for (size_t i = 0; i < m_Obstacles.size(); i++) {
+            if (overlaps(m_Obstacles[i])) outHandles.push_back(m_DenseToHandle[i]);
+        }
+        return;
+    }
+
+    uint32_t stamp = NextVisitStamp();
+    for (int y = cellMin.y; y <= cellMax.y; y++) {
+        for (int x = cellMin.x; x <= cellMax.x; x++) {
+            const auto* handles = FindCell(x, y);
+            if (!handles) continue;
+
+            for (ObstacleHandle handle : *handles) {
+                if (m_VisitMarks[handle] == stamp) continue;
+                m_VisitMarks[handle] = stamp;
+
+                if (overlaps(m_Obstacles[m_HandleToDense[handle]])) {
+                    outHandles.push_back(handle);
+                }
+            }
+        }
+    }
+}
+
+ObstacleHandle ObstacleWorld::FindNearest(const glm::vec2& point, float maxDistance, float* outDistance) const {
+    if (m_Obstacles.empty()) return InvalidObstacleHandle;
+
+    glm::ivec2 center = CellOf(point);
+
+    // Rings past the occupied cells or maxDistance cannot hold anything closer
+    glm::ivec2 boundsMin = CellOf(m_BoundsMin);
+    glm::ivec2 boundsMax = CellOf(m_BoundsMax);
+    int ringsToBounds = std::max(std::max(center.x - boundsMin.x, boundsMax.x - center.x),
+                                 std::max(center.y - boundsMin.y, boundsMax.y - center.y));
+    int ringsToRange = (int)std::ceil(std::min(maxDistance, 1e9f) / m_CellSize) + 1;
+    int maxRing = std::max(0, std::min(ringsToBounds, ringsToRange));
+
+    uint32_t stamp = NextVisitStamp();
+    float bestDistance = maxDistance;
+    ObstacleHandle bestHandle = InvalidObstacleHandle;
+
+    auto visitCell = [&](int x, int y) {
+        const auto* handles = FindCell(x, y);
+        if (!handles) return;
+
+        for (ObstacleHandle handle : *handles) {
+            if (m_VisitMarks[handle] == stamp) continue;
+            m_VisitMarks[handle] = stamp;
+
+            const Obstacle& obstacle = m_Obstacles[m_HandleToDense[handle]];
+            glm::vec2 halfSize = obstacle.size * 0.5f;
+            float distance = DistanceToBox(point, obstacle.position - halfSize, obstacle.position + halfSize);
+            if (distance <= bestDistance) {
+                bestDistance = distance;
+                bestHandle = handle;
+            }
+        }
+    };
+
+    for (int ring = 0; ring <= maxRing; ring++) {
+        if (ring == 0) {
+            visitCell(center.x, center.y);
+        } else {
+            for (int i = -ring; i <= ring; i++) {
+                visitCell(center.x + i, center.y - ring);
+                visitCell(center.x + i, center.y + ring);
+            }
+            for (int i = -ring + 1; i <= ring - 1; i++) {
+                visitCell(center.x - ring, center.y + i);
+                visitCell(center.x + ring, center.y + i);
+            }
+        }
+
+        // Every cell in the next ring is at least this far away
+        if (bestHandle != InvalidObstacleHandle && bestDistance <= (float)ring * m_CellSize) break;
+    }
+
+    if (bestHandle != InvalidObstacleHandle && outDistance) {
+        *outDistance = bestDistance;
+    }
+    return bestHandle;
+}
+
+const Obstacle* ObstacleWorld::Get(ObstacleHandle handle) const {
+    if (handle >= m_HandleToDense.size() || m_HandleToDense[handle] == InvalidIndex) return nullptr;
+    return &m_Obstacles[m_HandleToDense[handle]];
+}
+
+glm::ivec2 ObstacleWorld::CellOf(const glm::vec2& point) const {
+    return glm::ivec2((int)std::floor(point.x / m_CellSize), (int)std::floor(point.y / m_CellSize));
+}
+
+uint64_t ObstacleWorld::CellKey(int x, int y) {
+    return ((uint64_t)(uint32_t)x << 32) | (uint64_t)(uint32_t)y;
+}
+
+void ObstacleWorld::InsertIntoCells(ObstacleHandle handle, const Obstacle& obstacle) {
+    glm::vec2 halfSize = obstacle.size * 0.5f;
+    glm::vec2 obstacleMin = obstacle.position - halfSize;
+    glm::vec2 obstacleMax = obstacle.position + halfSize;
+
+    glm::ivec2 cellMin = CellOf(obstacleMin);
+    glm::ivec2 cellMax = CellOf(obstacleMax);
+    for (int y = cellMin.y; y <= cellMax.y; y++) {
+        for (int x = cellMin.x; x <= cellMax.x; x++) {
+            m_Cells[CellKey(x, y)].push_back(handle);
+        }
+    }
+
+    m_BoundsMin = glm::min(m_BoundsMin, obstacleMin);
+    m_BoundsMax = glm::max(m_BoundsMax, obstacleMax);
+}
+
+void ObstacleWorld::RemoveFromCells(ObstacleHandle handle, const Obstacle& obstacle) {
+    glm::vec2 halfSize = obstacle.size * 0.5f;
+    glm::ivec2 cellMin = CellOf(obstacle.position - halfSize);
+    glm::ivec2 cellMax = CellOf(obstacle.position + halfSize);
+    for (int y = cellMin.y; y <= cellMax.y; y++) {
+        for (int x = cellMin.x; x <= cellMax.x; x++) {
+            auto it = m_Cells.find(CellKey(x, y));
+            if (it == m_Cells.end()) continue;
+
+            auto& handles = it->second;
+            auto found = std::find(handles.begin(), handles.end(), handle);
+            if (found != handles.end()) {
+                *found = handles.back();
+                handles.pop_back();
+            }
+            if (handles.empty()) m_Cells.erase(it);
+        }
+    }
+}
+
+const std::vector<ObstacleHandle>* ObstacleWorld::FindCell(int x, int y) const {
+    auto it = m_Cells.find(CellKey(x, y));
+    return it != m_Cells.end() ? &it->second : nullptr;
+}
+
+uint32_t ObstacleWorld::NextVisitStamp() const {
+    if (m_VisitMarks.size() < m_HandleToDense.size()) {
+        m_VisitMarks.resize(m_HandleToDense.size(), 0);
+    }
+    if (++m_VisitStamp == 0) {
+        // Wrapped around: old marks could collide with new stamps
+        std::fill(m_VisitMarks.begin(), m_VisitMarks.end(), 0);
+        m_VisitStamp = 1;
+    }
+    return m_VisitStamp;
+}
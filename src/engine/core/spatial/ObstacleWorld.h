@@ -0,0 +1,87 @@
+#pragma once
+#include <glm/glm.hpp>
+#include <vector>
+#include <unordered_map>
+#include <cstdint>
+
+// Structure to represent obstacles that block movement, vision and light
+struct Obstacle {
+    glm::vec2 position;
+    glm::vec2 size;
+
+    Obstacle(const glm::vec2& pos, const glm::vec2& sz)
+        : position(pos), size(sz) {}
+};
+
+using ObstacleHandle = uint32_t;
+static constexpr ObstacleHandle InvalidObstacleHandle = 0xFFFFFFFF;
+
+struct ObstacleRaycastHit {
+    ObstacleHandle handle = InvalidObstacleHandle;
+    float distance = 0.0f;       // Along the ray direction
+    glm::vec2 point{0.0f};
+};
+
+// Engine-wide obstacle set shared by the renderers, shadow map and collision code.
+// Obstacles are binned into a uniform grid (every cell they overlap), so raycasts walk
+// only the cells along the ray and box/nearest queries only touch nearby cells.
+// Obstacles can be added, moved and removed individually; every change bumps the
+// revision so dependent caches (shadow rows, visibility polygons, baked lighting) can refresh.
+class ObstacleWorld {
+public:
+    ObstacleWorld(float cellSize = 128.0f);
+
+    // Editing
+    ObstacleHandle Add(const Obstacle& obstacle);
+    ObstacleHandle Add(const glm::vec2& position, const glm::vec2& size);
+    bool Update(ObstacleHandle handle, const Obstacle& obstacle);
+    bool Remove(ObstacleHandle handle);
+    void SetObstacles(const std::vector<Obstacle>& obstacles); // Replaces everything
+    void Clear();
+
+    // Nearest obstacle hit by a ray starting outside it, within [0, maxDistance).
+    // direction must be normalized.
+    bool Raycast(const glm::vec2& origin, const glm::vec2& direction, float maxDistance,
+                 ObstacleRaycastHit* outHit = nullptr) const;
+
+    // Obstacles touching or overlapping the box (appended to outHandles)
+    void QueryAABB(const glm::vec2& boxMin, const glm::vec2& boxMax, std::vector<ObstacleHandle>& outHandles) const;
+
+    // Obstacle closest to a point (distance 0 when inside), or InvalidObstacleHandle
+    ObstacleHandle FindNearest(const glm::vec2& point, float maxDistance, float* outDistance = nullptr) const;
+
+    // Access
+    const Obstacle* Get(ObstacleHandle handle) const;
+    const std::vector<Obstacle>& GetObstacles() const { return m_Obstacles; } // Dense, unordered
+    size_t GetCount() const { return m_Obstacles.size(); }
+    uint32_t GetRevision() const { return m_Revision; }
+    float GetCellSize() const { return m_CellSize; }
+
+private:
+    float m_CellSize;
+    uint32_t m_Revision;
+
+    // Dense obstacle storage; handles map to dense indices and back
+    std::vector<Obstacle> m_Obstacles;
+    std::vector<ObstacleHandle> m_DenseToHandle;
+    std::vector<uint32_t> m_HandleToDense;
+    std::vector<ObstacleHandle> m_FreeHandles;
+
+    // Grid cells (packed cell coordinates -> handles of obstacles overlapping the cell)
+    std::unordered_map<uint64_t, std::vector<ObstacleHandle>> m_Cells;
+
+    // Conservative bounds of every obstacle, grown on insert and reset on Clear()
+    glm::vec2 m_BoundsMin, m_BoundsMax;
+
+    // Per-query visit marks so obstacles spanning several cells are tested once
+    mutable std::vector<uint32_t> m_VisitMarks;
+    mutable uint32_t m_VisitStamp;
+
+    // Helper functions
+    glm::ivec2 CellOf(const glm::vec2& point) const;
+    static uint64_t CellKey(int x, int y);
+    void InsertIntoCells(ObstacleHandle handle, const Obstacle& obstacle);
+    void RemoveFromCells(ObstacleHandle handle, const Obstacle& obstacle);
+    const std::vector<ObstacleHandle>* FindCell(int x, int y) const;
+    uint32_t NextVisitStamp() const;
+};
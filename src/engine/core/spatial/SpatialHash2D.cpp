@@ -0,0 +1,164 @@
+#include "SpatialHash2D.h"
+#include <algorithm>
+#include <cmath>
+
+SpatialHash2D::SpatialHash2D(float cellSize)
+    : m_CellSize(std::max(cellSize, 1.0f)), m_SweepStamp(0), m_SweptCount(0), m_VisitStamp(0)
+{
+}
+
+void SpatialHash2D::Insert(uint32_t id, const glm::vec2& boxMin, const glm::vec2& boxMax) {
+    glm::ivec2 cellMin = CellOf(boxMin);
+    glm::ivec2 cellMax = CellOf(boxMax);
+
+    auto it = m_Entries.find(id);
+    if (it == m_Entries.end()) {
+        Entry entry;
+        entry.boxMin = boxMin;
+        entry.boxMax = boxMax;
+        entry.cellMin = cellMin;
+        entry.cellMax = cellMax;
+        entry.sweepStamp = m_SweepStamp;
+        entry.visitStamp = 0;
+        m_Entries.emplace(id, entry);
+        AddToCells(id, cellMin, cellMax);
+        m_SweptCount++;
+        return;
+    }
+
+    Entry& entry = it->second;
+    entry.boxMin = boxMin;
+    entry.boxMax = boxMax;
+    if (entry.sweepStamp != m_SweepStamp) {
+        entry.sweepStamp = m_SweepStamp;
+        m_SweptCount++;
+    }
+
+    // Only re-bin when the box covers different cells
+    if (entry.cellMin != cellMin || entry.cellMax != cellMax) {
+        RemoveFromCells(id, entry.cellMin, entry.cellMax);
+        AddToCells(id, cellMin, cellMax);
+        entry.cellMin = cellMin;
+        entry.cellMax = cellMax;
+    }
+}
+
+bool SpatialHash2D::Remove(uint32_t id) {
+    auto it = m_Entries.find(id);
+    if (it == m_Entries.end()) return false;
+
+    RemoveFromCells(id, it->second.cellMin, it->second.cellMax);
+    if (it->second.sweepStamp == m_SweepStamp && m_SweptCount > 0) m_SweptCount--;
+    m_Entries.erase(it);
+    return true;
+}
+
+bool SpatialHash2D::Contains(uint32_t id) const {
+    return m_Entries.find(id) != m_Entries.end();
+}
+
+void SpatialHash2D::Clear() {
+    m_Entries.clear();
+    m_Cells.clear();
+    m_SweptCount = 0;
+}
+
+void SpatialHash2D::BeginSweep() {
+    m_SweepStamp++;
+    m_SweptCount = 0;
+}
+
+void SpatialHash2D::EndSweep() {
+    // Nothing went missing: skip the walk over every entry
+    if (m_SweptCount == m_Entries.size()) return;
+
+    for (auto it = m_Entries.begin(); it != m_Entries.end();) {
+        if (it->second.sweepStamp != m_SweepStamp) {
+            RemoveFromCells(it->first, it->second.cellMin, it->second.cellMax);
+            it = m_Entries.erase(it);
+        } else {
+            ++it;
+        }
+    }
+}
+
+void SpatialHash2D::Query(const glm::vec2& boxMin, const glm::vec2& boxMax, std::vector<uint32_t>& outIds) const {
+    if (m_Entries.empty()) return;
+
+    auto overlaps = [&](const Entry& entry) {
+        return entry.boxMin.x <= boxMax.x && entry.boxMax.x >= boxMin.x &&
+               entry.boxMin.y <= boxMax.y && entry.boxMax.y >= boxMin.y;
+    };
+
+    glm::ivec2 cellMin = CellOf(boxMin);
+    glm::ivec2 cellMax = CellOf(boxMax);
+
+    // Boxes covering more cells than there are entries are cheaper to answer with a scan
+    int64_t cellCount = (int64_t)(cellMax.x - cellMin.x + 1) * (int64_t)(cellMax.y - cellMin.y + 1);
+    if (cellCount > (int64_t)m_Entries.size()) {
+        for (const auto& [id, entry] : m_Entries) {
+            if (overlaps(entry)) outIds.push_back(id);
+        }
+        return;
+    }
+
+    uint32_t stamp = NextVisitStamp();
+    for (int y = cellMin.y; y <= cellMax.y; y++) {
+        for (int x = cellMin.x; x <= cellMax.x; x++) {
+            auto cell = m_Cells.find(CellKey(x, y));
+            if (cell == m_Cells.end()) continue;
+
+            for (uint32_t id : cell->second) {
+                const Entry& entry = m_Entries.find(id)->second;
+                if (entry.visitStamp == stamp) continue;
+                entry.visitStamp = stamp;
+
+                if (overlaps(entry)) outIds.push_back(id);
+            }
+        }
+    }
+}
+
+glm::ivec2 SpatialHash2D::CellOf(const glm::vec2& point) const {
+    return glm::ivec2((int)std::floor(point.x / m_CellSize), (int)std::floor(point.y / m_CellSize));
+}
+
+uint64_t SpatialHash2D::CellKey(int x, int y) {
+    return ((uint64_t)(uint32_t)x << 32) | (uint64_t)(uint32_t)y;
+}
+
+void SpatialHash2D::AddToCells(uint32_t id, const glm::ivec2& cellMin, const glm::ivec2& cellMax) {
+    for (int y = cellMin.y; y <= cellMax.y; y++) {
+        for (int x = cellMin.x; x <= cellMax.x; x++) {
+            m_Cells[CellKey(x, y)].push_back(id);
+        }
+    }
+}
+
+void SpatialHash2D::RemoveFromCells(uint32_t id, const glm::ivec2& cellMin, const glm::ivec2& cellMax) {
+    for (int y = cellMin.y; y <= cellMax.y; y++) {
+        for (int x = cellMin.x; x <= cellMax.x; x++) {
+            auto it = m_Cells.find(CellKey(x, y));
+            if (it == m_Cells.end()) continue;
+
+            auto& ids = it->second;
+            auto found = std::find(ids.begin(), ids.end(), id);
+            if (found != ids.end()) {
+                *found = ids.back();
+                ids.pop_back();
+            }
+            if (ids.empty()) m_Cells.erase(it);
+        }
+    }
+}
+
+uint32_t SpatialHash2D::NextVisitStamp() const {
+    if (++m_VisitStamp == 0) {
+        // Wrapped around: old marks could collide with new stamps
+        for (const auto& [id, entry] : m_Entries) {
+            entry.visitStamp = 0;
+        }
+        m_VisitStamp = 1;
+    }
+    return m_VisitStamp;
+}
@@ -0,0 +1,54 @@
+#pragma once
+#include <glm/glm.hpp>
+#include <vector>
+#include <unordered_map>
+#include <cstdint>
+
+// Spatial hash of axis-aligned boxes keyed by id (entity IDs, sprite indices, ...).
+// Boxes are binned into every grid cell they overlap; moving a box only touches the
+// grid when it crosses into different cells, so re-inserting mostly static content
+// every frame is cheap. Queries only visit the cells covering the query box.
+class SpatialHash2D {
+public:
+    SpatialHash2D(float cellSize = 256.0f);
+
+    // Inserts the box, or moves it if the id is already present
+    void Insert(uint32_t id, const glm::vec2& boxMin, const glm::vec2& boxMax);
+    bool Remove(uint32_t id);
+    bool Contains(uint32_t id) const;
+    void Clear();
+
+    // Sweep: ids not inserted between BeginSweep() and EndSweep() are removed; when every
+    // id was inserted again EndSweep() has nothing to look for and returns straight away
+    void BeginSweep();
+    void EndSweep();
+
+    // Ids whose box touches or overlaps the query box (appended to outIds, unordered)
+    void Query(const glm::vec2& boxMin, const glm::vec2& boxMax, std::vector<uint32_t>& outIds) const;
+
+    size_t GetCount() const { return m_Entries.size(); }
+    float GetCellSize() const { return m_CellSize; }
+
+private:
+    struct Entry {
+        glm::vec2 boxMin, boxMax;
+        glm::ivec2 cellMin, cellMax;
+        uint32_t sweepStamp;
+        mutable uint32_t visitStamp;
+    };
+
+    float m_CellSize;
+    std::unordered_map<uint32_t, Entry> m_Entries;
+    std::unordered_map<uint64_t, std::vector<uint32_t>> m_Cells; // Packed cell coordinates -> ids
+
+    uint32_t m_SweepStamp;
+    size_t m_SweptCount;    // Entries stamped since BeginSweep()
+    mutable uint32_t m_VisitStamp;
+
+    // Helper functions
+    glm::ivec2 CellOf(const glm::vec2& point) const;
+    static uint64_t CellKey(int x, int y);
+    void AddToCells(uint32_t id, const glm::ivec2& cellMin, const glm::ivec2& cellMax);
+    void RemoveFromCells(uint32_t id, const glm::ivec2& cellMin, const glm::ivec2& cellMax);
+    uint32_t NextVisitStamp() const;
+};
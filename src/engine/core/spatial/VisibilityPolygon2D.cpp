@@ -0,0 +1,261 @@
+#include "VisibilityPolygon2D.h"
+#include <glm/gtc/constants.hpp>
+#include <algorithm>
+#include <cmath>
+#include <cfloat>
+#include "ObstacleWorld.h"
+
+namespace {
+    constexpr float AngleEpsilon = 1e-6f;   // Events closer than this are processed together
+    constexpr float SweepEpsilon = 1e-4f;   // Look-ahead used to order segments sharing an endpoint
+
+    float Cross(const glm::vec2& a, const glm::vec2& b) {
+        return a.x * b.y - a.y * b.x;
+    }
+
+    // Monotonic in atan2(y, x) over [-PI, PI] but needs no trigonometry; used to order
+    // vertices around the viewer so Contains() avoids an atan2 per query
+    float PseudoAngle(float x, float y) {
+        float p = x / (std::abs(x) + std::abs(y));
+        return y < 0.0f ? p - 1.0f : 1.0f - p;
+    }
+}
+
+bool VisibilityPolygon2D::SegmentCompare::operator()(int a, int b) const {
+    float distanceA = owner->DistanceAlong(a, owner->m_SweepDir);
+    float distanceB = owner->DistanceAlong(b, owner->m_SweepDir);
+    if (distanceA != distanceB) return distanceA < distanceB;
+    return a < b;
+}
+
+VisibilityPolygon2D::VisibilityPolygon2D()
+    : m_Viewer(0.0f), m_Range(0.0f), m_Built(false), m_SweepDir(1.0f, 0.0f)
+{
+}
+
+void VisibilityPolygon2D::Clear() {
+    m_Segments.clear();
+    m_Events.clear();
+    m_Vertices.clear();
+    m_Angles.clear();
+    m_Built = false;
+}
+
+void VisibilityPolygon2D::Build(const glm::vec2& viewer, float range, const std::vector<Obstacle>& obstacles) {
+    BeginBuild(viewer, range);
+    if (range <= 0.0f) return;
+
+    // 1. Collect obstacle edges that can matter within range
+    float reach = range;
+    for (const auto& obstacle : obstacles) {
+        AddObstacleEdges(obstacle, reach);
+    }
+    FinishBuild(reach);
+}
+
+void VisibilityPolygon2D::Build(const glm::vec2& viewer, float range, const ObstacleWorld& world) {
+    BeginBuild(viewer, range);
+    if (range <= 0.0f) return;
+
+    // 1. Only obstacles overlapping the range square can matter
+    m_Candidates.clear();
+    world.QueryAABB(viewer - glm::vec2(range), viewer + glm::vec2(range), m_Candidates);
+
+    float reach = range;
+    for (ObstacleHandle handle : m_Candidates) {
+        AddObstacleEdges(*world.Get(handle), reach);
+    }
+    FinishBuild(reach);
+}
+
+void VisibilityPolygon2D::BeginBuild(const glm::vec2& viewer, float range) {
+    Clear();
+    m_Viewer = viewer;
+    m_Range = range;
+    m_Built = true;
+}
+
+void VisibilityPolygon2D::AddObstacleEdges(const Obstacle& obstacle, float& reach) {
+    glm::vec2 rangeMin = m_Viewer - glm::vec2(m_Range);
+    glm::vec2 rangeMax = m_Viewer + glm::vec2(m_Range);
+    glm::vec2 boxMin = obstacle.position - obstacle.size * 0.5f;
+    glm::vec2 boxMax = obstacle.position + obstacle.size * 0.5f;
+
+    if (boxMax.x < rangeMin.x || boxMin.x > rangeMax.x ||
+        boxMax.y < rangeMin.y || boxMin.y > rangeMax.y) return;
+
+    // A viewer standing inside an obstacle is not blocked by it
+    if (m_Viewer.x > boxMin.x && m_Viewer.x < boxMax.x &&
+        m_Viewer.y > boxMin.y && m_Viewer.y < boxMax.y) return;
+
+    glm::vec2 corners[4] = {
+        boxMin, glm::vec2(boxMax.x, boxMin.y), boxMax, glm::vec2(boxMin.x, boxMax.y)
+    };
+    for (int i = 0; i < 4; i++) {
+        AddSegment(corners[i], corners[(i + 1) % 4]);
+        reach = std::max(reach, glm::length(corners[i] - m_Viewer));
+    }
+}
+
+void VisibilityPolygon2D::FinishBuild(float reach) {
+    // 2. Close the sweep with a polygon enclosing every edge, so no edge crosses it
+    //    (the active set ordering assumes edges never cross); Contains() clips to range
+    float boundaryRadius = reach * 1.01f / std::cos(glm::pi<float>() / BoundarySegments);
+    glm::vec2 previous = m_Viewer + glm::vec2(-boundaryRadius, 0.0f);
+    for (int i = 1; i <= BoundarySegments; i++) {
+        float angle = -glm::pi<float>() + glm::two_pi<float>() * (float)i / (float)BoundarySegments;
+        glm::vec2 current = m_Viewer + glm::vec2(std::cos(angle), std::sin(angle)) * boundaryRadius;
+        AddSegment(previous, current);
+        previous = current;
+    }
+
+    // 3. Sort the events by angle, ends before starts at the same angle
+    std::sort(m_Events.begin(), m_Events.end(), [](const SweepEvent& a, const SweepEvent& b) {
+        if (a.angle != b.angle) return a.angle < b.angle;
+        return !a.isStart && b.isStart;
+    });
+
+    // 4. Sweep, keeping the active segments ordered by distance from the viewer
+    using ActiveSet = std::set<int, SegmentCompare>;
+    ActiveSet active(SegmentCompare{this});
+    std::vector<ActiveSet::iterator> handles(m_Segments.size(), active.end());
+
+    size_t eventIndex = 0;
+    while (eventIndex < m_Events.size()) {
+        float angle = m_Events[eventIndex].angle;
+        glm::vec2 rayDir(std::cos(angle), std::sin(angle));
+
+        size_t groupEnd = eventIndex;
+        while (groupEnd < m_Events.size() && m_Events[groupEnd].angle - angle <= AngleEpsilon) {
+            groupEnd++;
+        }
+
+        int nearestBefore = active.empty() ? -1 : *active.begin();
+
+        // Compare just past this angle so segments meeting at a shared corner order correctly
+        m_SweepDir = glm::vec2(std::cos(angle + SweepEpsilon), std::sin(angle + SweepEpsilon));
+
+        for (size_t i = eventIndex; i < groupEnd; i++) {
+            const SweepEvent& event = m_Events[i];
+            if (!event.isStart && handles[event.segment] != active.end()) {
+                active.erase(handles[event.segment]);
+                handles[event.segment] = active.end();
+            }
+        }
+        for (size_t i = eventIndex; i < groupEnd; i++) {
+            const SweepEvent& event = m_Events[i];
+            if (event.isStart) {
+                handles[event.segment] = active.insert(event.segment).first;
+            }
+        }
+
+        int nearestAfter = active.empty() ? -1 : *active.begin();
+
+        // The outline only bends where the nearest segment changes
+        if (nearestBefore != nearestAfter) {
+            if (nearestBefore >= 0) EmitVertex(PointAlong(nearestBefore, rayDir), angle);
+            if (nearestAfter >= 0) EmitVertex(PointAlong(nearestAfter, rayDir), angle);
+        }
+
+        eventIndex = groupEnd;
+    }
+}
+
+bool VisibilityPolygon2D::IsBuiltFor(const glm::vec2& viewer, float range) const {
+    return m_Built && m_Viewer == viewer && m_Range == range;
+}
+
+bool VisibilityPolygon2D::Contains(const glm::vec2& point) const {
+    if (m_Vertices.size() < 2) return false;
+
+    glm::vec2 toPoint = point - m_Viewer;
+    float distanceSq = glm::dot(toPoint, toPoint);
+    if (distanceSq > m_Range * m_Range) return false;
+    if (distanceSq < 1e-8f) return true; // At viewer position
+
+    // Find the polygon edge spanning this angle
+    float angle = PseudoAngle(toPoint.x, toPoint.y);
+    size_t next = std::upper_bound(m_Angles.begin(), m_Angles.end(), angle) - m_Angles.begin();
+    next = std::min(std::max(next, (size_t)1), m_Vertices.size() - 1);
+    const glm::vec2& a = m_Vertices[next - 1];
+    const glm::vec2& b = m_Vertices[next];
+
+    // Vertices wind around the viewer, so the inside is to the left of every edge
+    glm::vec2 edge = b - a;
+    return Cross(edge, point - a) >= -1e-3f * glm::length(edge);
+}
+
+void VisibilityPolygon2D::BuildTriangleFan(std::vector<glm::vec2>& outVertices) const {
+    outVertices.clear();
+    if (m_Vertices.empty()) return;
+
+    outVertices.reserve(m_Vertices.size() + 2);
+    outVertices.push_back(m_Viewer);
+    outVertices.insert(outVertices.end(), m_Vertices.begin(), m_Vertices.end());
+    outVertices.push_back(m_Vertices.front());
+}
+
+void VisibilityPolygon2D::AddSegment(const glm::vec2& a, const glm::vec2& b) {
+    glm::vec2 start = a, end = b;
+    glm::vec2 toStart = start - m_Viewer;
+    glm::vec2 toEnd = end - m_Viewer;
+
+    float winding = Cross(toStart, toEnd);
+    if (std::abs(winding) < 1e-6f) return; // Edge-on to the viewer, covers no angle
+
+    // Orient every segment so the sweep meets start first
+    if (winding < 0.0f) {
+        std::swap(start, end);
+        std::swap(toStart, toEnd);
+    }
+
+    float startAngle = std::atan2(toStart.y, toStart.x);
+    float endAngle = std::atan2(toEnd.y, toEnd.x);
+
+    auto push = [this](const glm::vec2& s, const glm::vec2& e, float angleStart, float angleEnd) {
+        // Slivers narrower than an event group would start after they end
+        if (angleEnd - angleStart <= AngleEpsilon) return;
+        int index = (int)m_Segments.size();
+        m_Segments.push_back({s, e});
+        m_Events.push_back({angleStart, true, index});
+        m_Events.push_back({angleEnd, false, index});
+    };
+
+    if (endAngle >= startAngle) {
+        push(start, end, startAngle, endAngle);
+        return;
+    }
+
+    // Crosses the +-PI seam: split where the segment meets the viewer's negative x axis
+    float t = toStart.y / (toStart.y - toEnd.y);
+    glm::vec2 seam = start + (end - start) * t;
+    push(start, seam, startAngle, glm::pi<float>());
+    push(seam, end, -glm::pi<float>(), endAngle);
+}
+
+float VisibilityPolygon2D::DistanceAlong(int segment, const glm::vec2& dir) const {
+    const Segment& s = m_Segments[segment];
+    glm::vec2 edge = s.end - s.start;
+    float denominator = Cross(dir, edge);
+    if (std::abs(denominator) < 1e-12f) return FLT_MAX;
+    return Cross(s.start - m_Viewer, edge) / denominator;
+}
+
+glm::vec2 VisibilityPolygon2D::PointAlong(int segment, const glm::vec2& dir) const {
+    float distance = DistanceAlong(segment, dir);
+    if (distance == FLT_MAX) {
+        // Parallel to the ray: the segment's nearer endpoint is the visible one
+        const Segment& s = m_Segments[segment];
+        return glm::length(s.start - m_Viewer) < glm::length(s.end - m_Viewer) ? s.start : s.end;
+    }
+    return m_Viewer + dir * distance;
+}
+
+void VisibilityPolygon2D::EmitVertex(const glm::vec2& point, float angle) {
+    if (!m_Vertices.empty()) {
+        glm::vec2 delta = point - m_Vertices.back();
+        if (glm::dot(delta, delta) < 1e-6f) return;
+    }
+    m_Vertices.push_back(point);
+    m_Angles.push_back(PseudoAngle(std::cos(angle), std::sin(angle)));
+}
@@ -0,0 +1,81 @@
+#pragma once
+#include <glm/glm.hpp>
+#include <vector>
+#include <set>
+
+// Forward declarations
+struct Obstacle;
+class ObstacleWorld;
+
+// Visibility polygon around a single viewer, built with an angular sweep over obstacle edges.
+// Building is O(n log n) in the number of edges; once built, point visibility queries are
+// a binary search over the polygon's vertex angles, so checking many targets against one
+// viewer (fog of war, server-side line of sight) is cheap.
+class VisibilityPolygon2D {
+public:
+    static constexpr int BoundarySegments = 32; // Sides of the polygon closing the sweep beyond the range
+
+    VisibilityPolygon2D();
+
+    // Rebuilds the polygon for a viewer. Obstacles containing the viewer do not block it.
+    // Edges of overlapping obstacles cross, which can misplace the outline near the crossing.
+    void Build(const glm::vec2& viewer, float range, const std::vector<Obstacle>& obstacles);
+    void Build(const glm::vec2& viewer, float range, const ObstacleWorld& world); // Only visits obstacles near the range
+    void Clear();
+
+    // Queries
+    bool Contains(const glm::vec2& point) const;
+    bool IsBuiltFor(const glm::vec2& viewer, float range) const;
+    bool IsEmpty() const { return m_Vertices.empty(); }
+
+    // Polygon vertices in increasing angle around the viewer
+    const std::vector<glm::vec2>& GetVertices() const { return m_Vertices; }
+    const glm::vec2& GetViewer() const { return m_Viewer; }
+    float GetRange() const { return m_Range; }
+
+    // Viewer followed by the closed outline, ready to draw as GL_TRIANGLE_FAN
+    void BuildTriangleFan(std::vector<glm::vec2>& outVertices) const;
+
+private:
+    struct Segment {
+        glm::vec2 start; // First endpoint in sweep order
+        glm::vec2 end;   // Last endpoint in sweep order
+    };
+
+    struct SweepEvent {
+        float angle;
+        bool isStart;
+        int segment;
+    };
+
+    // Orders the active segments by distance along the current sweep ray
+    struct SegmentCompare {
+        const VisibilityPolygon2D* owner;
+        bool operator()(int a, int b) const;
+    };
+
+    glm::vec2 m_Viewer;
+    float m_Range;
+    bool m_Built;
+
+    // Sweep state (kept as members so rebuilding does not reallocate)
+    std::vector<Segment> m_Segments;
+    std::vector<SweepEvent> m_Events;
+    glm::vec2 m_SweepDir;
+
+    // Result
+    std::vector<glm::vec2> m_Vertices;
+    std::vector<float> m_Angles;    // Pseudo-angle of each vertex, for Contains()
+
+    // Candidate obstacles gathered from an ObstacleWorld
+    std::vector<uint32_t> m_Candidates;
+
+    // Helper functions
+    void BeginBuild(const glm::vec2& viewer, float range);
+    void AddObstacleEdges(const Obstacle& obstacle, float& reach);
+    void FinishBuild(float reach);
+    void AddSegment(const glm::vec2& a, const glm::vec2& b);
+    float DistanceAlong(int segment, const glm::vec2& dir) const;
+    glm::vec2 PointAlong(int segment, const glm::vec2& dir) const;
+    void EmitVertex(const glm::vec2& point, float angle);
+};
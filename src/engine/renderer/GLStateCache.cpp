@@ -0,0 +1,247 @@
+#include "GLStateCache.h"
+#include <glad/glad.h>
+
+namespace {
+    constexpr unsigned int Unknown = 0xFFFFFFFFu;
+
+    // Buffer targets that are not part of vertex array state. GL_ELEMENT_ARRAY_BUFFER is
+    // stored in the bound VAO, so it is always passed through.
+    constexpr unsigned int CachedBufferTargets[] = {
+        GL_ARRAY_BUFFER, GL_PIXEL_UNPACK_BUFFER, GL_PIXEL_PACK_BUFFER,
+        GL_UNIFORM_BUFFER, GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER
+    };
+    constexpr int CachedBufferTargetCount = sizeof(CachedBufferTargets) / sizeof(CachedBufferTargets[0]);
+
+    struct State {
+        unsigned int program = Unknown;
+        unsigned int vertexArray = Unknown;
+        unsigned int buffers[CachedBufferTargetCount];
+        unsigned int activeUnit = Unknown;
+        unsigned int textures[GLStateCache::MaxTextureUnits];
+        int blendEnabled = -1;                  // -1 unknown, 0 disabled, 1 enabled
+        unsigned int blendFunc[4] = { Unknown, Unknown, Unknown, Unknown };
+        unsigned int blendEquation[2] = { Unknown, Unknown };
+
+        State() { Reset(); }
+
+        void Reset() {
+            program = Unknown;
+            vertexArray = Unknown;
+            for (auto& buffer : buffers) buffer = Unknown;
+            activeUnit = Unknown;
+            for (auto& texture : textures) texture = Unknown;
+            blendEnabled = -1;
+            for (auto& factor : blendFunc) factor = Unknown;
+            for (auto& mode : blendEquation) mode = Unknown;
+        }
+    };
+
+    State s_State;
+    GLStateStats s_Frame;
+    GLStateStats s_LastFrame;
+
+    int BufferSlot(unsigned int target) {
+        for (int i = 0; i < CachedBufferTargetCount; i++) {
+            if (CachedBufferTargets[i] == target) return i;
+        }
+        return -1;
+    }
+
+    void SetActiveUnit(unsigned int unit) {
+        if (s_State.activeUnit == unit) return;
+        glActiveTexture(GL_TEXTURE0 + unit);
+        s_State.activeUnit = unit;
+    }
+
+    // Unknown active unit: query it once so plain binds can be tracked
+    unsigned int ActiveUnit() {
+        if (s_State.activeUnit == Unknown) {
+            GLint active = GL_TEXTURE0;
+            glGetIntegerv(GL_ACTIVE_TEXTURE, &active);
+            s_State.activeUnit = (unsigned int)(active - GL_TEXTURE0);
+        }
+        return s_State.activeUnit;
+    }
+}
+
+void GLStateCache::UseProgram(unsigned int program) {
+    if (s_State.program == program) {
+        s_Frame.program.elided++;
+        return;
+    }
+    glUseProgram(program);
+    s_State.program = program;
+    s_Frame.program.issued++;
+}
+
+void GLStateCache::BindVertexArray(unsigned int vertexArray) {
+    if (s_State.vertexArray == vertexArray) {
+        s_Frame.vertexArray.elided++;
+        return;
+    }
+    glBindVertexArray(vertexArray);
+    s_State.vertexArray = vertexArray;
+    s_Frame.vertexArray.issued++;
+}
+
+void GLStateCache::BindBuffer(unsigned int target, unsigned int buffer) {
+    int slot = BufferSlot(target);
+    if (slot >= 0 && s_State.buffers[slot] == buffer) {
+        s_Frame.buffer.elided++;
+        return;
+    }
+    glBindBuffer(target, buffer);
+    if (slot >= 0) s_State.buffers[slot] = buffer;
+    s_Frame.buffer.issued++;
+}
+
+void GLStateCache::BindTexture(unsigned int unit, unsigned int texture) {
+    if (unit >= (unsigned int)MaxTextureUnits) {
+        // Beyond what we track: bind directly and forget the active unit
+        glActiveTexture(GL_TEXTURE0 + unit);
+        glBindTexture(GL_TEXTURE_2D, texture);
+        s_State.activeUnit = unit;
+        s_Frame.texture.issued++;
+        return;
+    }
+
+    if (s_State.textures[unit] == texture) {
+        s_Frame.texture.elided++;
+        return;
+    }
+    SetActiveUnit(unit);
+    glBindTexture(GL_TEXTURE_2D, texture);
+    s_State.textures[unit] = texture;
+    s_Frame.texture.issued++;
+}
+
+void GLStateCache::BindTexture(unsigned int texture) {
+    BindTexture(ActiveUnit(), texture);
+}
+
+void GLStateCache::SetBlendEnabled(bool enabled) {
+    if (s_State.blendEnabled == (enabled ? 1 : 0)) {
+        s_Frame.blend.elided++;
+        return;
+    }
+    if (enabled) glEnable(GL_BLEND); else glDisable(GL_BLEND);
+    s_State.blendEnabled = enabled ? 1 : 0;
+    s_Frame.blend.issued++;
+}
+
+void GLStateCache::SetBlendFunc(unsigned int source, unsigned int destination) {
+    SetBlendFuncSeparate(source, destination, source, destination);
+}
+
+void GLStateCache::SetBlendFuncSeparate(unsigned int sourceRGB, unsigned int destinationRGB,
+                                        unsigned int sourceAlpha, unsigned int destinationAlpha) {
+    unsigned int* func = s_State.blendFunc;
+    if (func[0] == sourceRGB && func[1] == destinationRGB && func[2] == sourceAlpha && func[3] == destinationAlpha) {
+        s_Frame.blend.elided++;
+        return;
+    }
+    glBlendFuncSeparate(sourceRGB, destinationRGB, sourceAlpha, destinationAlpha);
+    func[0] = sourceRGB;
+    func[1] = destinationRGB;
+    func[2] = sourceAlpha;
+    func[3] = destinationAlpha;
+    s_Frame.blend.issued++;
+}
+
+void GLStateCache::SetBlendEquation(unsigned int mode) {
+    SetBlendEquationSeparate(mode, mode);
+}
+
+void GLStateCache::SetBlendEquationSeparate(unsigned int modeRGB, unsigned int modeAlpha) {
+    if (s_State.blendEquation[0] == modeRGB && s_State.blendEquation[1] == modeAlpha) {
+        s_Frame.blend.elided++;
+        return;
+    }
+    glBlendEquationSeparate(modeRGB, modeAlpha);
+    s_State.blendEquation[0] = modeRGB;
+    s_State.blendEquation[1] = modeAlpha;
+    s_Frame.blend.issued++;
+}
+
+unsigned int GLStateCache::GetProgram() {
+    if (s_State.program == Unknown) {
+        GLint program = 0;
+        glGetIntegerv(GL_CURRENT_PROGRAM, &program);
+        s_State.program = (unsigned int)program;
+    }
+    return s_State.program;
+}
+
+unsigned int GLStateCache::GetVertexArray() {
+    if (s_State.vertexArray == Unknown) {
+        GLint vertexArray = 0;
+        glGetIntegerv(GL_VERTEX_ARRAY_BINDING, &vertexArray);
+        s_State.vertexArray = (unsigned int)vertexArray;
+    }
+    return s_State.vertexArray;
+}
+
+bool GLStateCache::IsBlendEnabled() {
+    if (s_State.blendEnabled < 0) {
+        s_State.blendEnabled = glIsEnabled(GL_BLEND) == GL_TRUE ? 1 : 0;
+    }
+    return s_State.blendEnabled == 1;
+}
+
+void GLStateCache::GetBlendFuncSeparate(unsigned int factors[4]) {
+    unsigned int* func = s_State.blendFunc;
+    if (func[0] == Unknown) {
+        const GLenum queries[4] = { GL_BLEND_SRC_RGB, GL_BLEND_DST_RGB, GL_BLEND_SRC_ALPHA, GL_BLEND_DST_ALPHA };
+        for (int i = 0; i < 4; i++) {
+            GLint value = 0;
+            glGetIntegerv(queries[i], &value);
+            func[i] = (unsigned int)value;
+        }
+    }
+    for (int i = 0; i < 4; i++) factors[i] = func[i];
+}
+
+void GLStateCache::GetBlendEquationSeparate(unsigned int modes[2]) {
+    if (s_State.blendEquation[0] == Unknown) {
+        GLint rgb = 0, alpha = 0;
+        glGetIntegerv(GL_BLEND_EQUATION_RGB, &rgb);
+        glGetIntegerv(GL_BLEND_EQUATION_ALPHA, &alpha);
+        s_State.blendEquation[0] = (unsigned int)rgb;
+        s_State.blendEquation[1] = (unsigned int)alpha;
+    }
+    modes[0] = s_State.blendEquation[0];
+    modes[1] = s_State.blendEquation[1];
+}
+
+void GLStateCache::OnProgramDeleted(unsigned int program) {
+    if (s_State.program == program) s_State.program = Unknown;
+}
+
+void GLStateCache::OnVertexArrayDeleted(unsigned int vertexArray) {
+    if (s_State.vertexArray == vertexArray) s_State.vertexArray = Unknown;
+}
+
+void GLStateCache::OnBufferDeleted(unsigned int buffer) {
+    for (auto& bound : s_State.buffers) {
+        if (bound == buffer) bound = Unknown;
+    }
+}
+
+void GLStateCache::OnTextureDeleted(unsigned int texture) {
+    for (auto& bound : s_State.textures) {
+        if (bound == texture) bound = Unknown;
+    }
+}
+
+void GLStateCache::Invalidate() {
+    s_State.Reset();
+}
+
+void GLStateCache::BeginFrame() {
+    s_LastFrame = s_Frame;
+    s_Frame = GLStateStats();
+}
+
+const GLStateStats& GLStateCache::GetStats() {
+    return s_LastFrame;
+}
@@ -0,0 +1,68 @@
+#pragma once
+#include <cstdint>
+
+// Calls issued to the driver vs. skipped because the state was already in effect
+struct GLStateStats {
+    struct Counter {
+        uint32_t issued = 0;
+        uint32_t elided = 0;
+    };
+
+    Counter program;
+    Counter vertexArray;
+    Counter buffer;
+    Counter texture;
+    Counter blend;
+
+    uint32_t TotalIssued() const {
+        return program.issued + vertexArray.issued + buffer.issued + texture.issued + blend.issued;
+    }
+    uint32_t TotalElided() const {
+        return program.elided + vertexArray.elided + buffer.elided + texture.elided + blend.elided;
+    }
+};
+
+// Shadow copy of the GL state the renderers touch most often (program, vertex array,
+// array buffer, 2D texture per unit, blend state). Binds that would not change anything
+// are skipped. Every engine renderer goes through this; code that changes the same state
+// behind its back (ImGui, raw GL calls) must call Invalidate() afterwards.
+class GLStateCache {
+public:
+    static constexpr int MaxTextureUnits = 32;
+
+    static void UseProgram(unsigned int program);
+    static void BindVertexArray(unsigned int vertexArray);
+    static void BindBuffer(unsigned int target, unsigned int buffer);
+
+    // Binds a GL_TEXTURE_2D to a texture unit, only switching the active unit when needed
+    static void BindTexture(unsigned int unit, unsigned int texture);
+    // Binds a GL_TEXTURE_2D on whichever unit is active (texture creation and uploads)
+    static void BindTexture(unsigned int texture);
+
+    static void SetBlendEnabled(bool enabled);
+    static void SetBlendFunc(unsigned int source, unsigned int destination);
+    static void SetBlendFuncSeparate(unsigned int sourceRGB, unsigned int destinationRGB,
+                                     unsigned int sourceAlpha, unsigned int destinationAlpha);
+    static void SetBlendEquation(unsigned int mode);
+    static void SetBlendEquationSeparate(unsigned int modeRGB, unsigned int modeAlpha);
+
+    // Current state (queried from GL once if it is unknown)
+    static unsigned int GetProgram();
+    static unsigned int GetVertexArray();
+    static bool IsBlendEnabled();
+    static void GetBlendFuncSeparate(unsigned int factors[4]);     // srcRGB, dstRGB, srcAlpha, dstAlpha
+    static void GetBlendEquationSeparate(unsigned int modes[2]);   // rgb, alpha
+
+    // Must be called before deleting objects so a recycled name is not mistaken for bound
+    static void OnProgramDeleted(unsigned int program);
+    static void OnVertexArrayDeleted(unsigned int vertexArray);
+    static void OnBufferDeleted(unsigned int buffer);
+    static void OnTextureDeleted(unsigned int texture);
+
+    // Forget everything; the next call of each kind is always issued
+    static void Invalidate();
+
+    // Starts a new frame of counters; GetStats() returns the last complete frame
+    static void BeginFrame();
+    static const GLStateStats& GetStats();
+};
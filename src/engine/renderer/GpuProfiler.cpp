@@ -0,0 +1,162 @@
+#include "GpuProfiler.h"
+#include <glad/glad.h>
+
+namespace {
+    struct Zone {
+        const char* name;
+        uint64_t cpuStartNs;
+        unsigned int query;
+    };
+
+    struct FrameSlot {
+        std::vector<Zone> zones;
+        bool pending = false;
+    };
+
+    FrameSlot s_Frames[GpuProfiler::FrameLatency];
+    int s_Current = 0;
+    bool s_Started = false;
+
+    std::vector<unsigned int> s_FreeQueries;
+    std::vector<unsigned int> s_AllQueries;
+
+    int s_Depth = 0;            // Open zones, including folded nested ones
+    bool s_QueryActive = false;
+
+    std::vector<GpuProfiler::ZoneResult> s_LastResults;
+    double s_LastFrameMs = 0.0;
+    uint32_t s_DroppedFrames = 0;
+
+    unsigned int AcquireQuery() {
+        if (s_FreeQueries.empty()) {
+            unsigned int query = 0;
+            glGenQueries(1, &query);
+            s_AllQueries.push_back(query);
+            return query;
+        }
+        unsigned int query = s_FreeQueries.back();
+        s_FreeQueries.pop_back();
+        return query;
+    }
+
+    void ReleaseSlot(FrameSlot& slot) {
+        for (const auto& zone : slot.zones) {
+            s_FreeQueries.push_back(zone.query);
+        }
+        slot.zones.clear();
+        slot.pending = false;
+    }
+
+    // Reads a slot back if the GPU is done with it; never waits
+    bool TryResolve(FrameSlot& slot) {
+        if (slot.zones.empty()) {
+            slot.pending = false;
+            return true;
+        }
+
+        // Queries finish in submission order, so the last one answers for the frame
+        GLint available = 0;
+        glGetQueryObjectiv(slot.zones.back().query, GL_QUERY_RESULT_AVAILABLE, &available);
+        if (!available) return false;
+
+        s_LastResults.clear();
+        s_LastFrameMs = 0.0;
+        for (const auto& zone : slot.zones) {
+            GLuint64 elapsedNs = 0;
+            glGetQueryObjectui64v(zone.query, GL_QUERY_RESULT, &elapsedNs);
+
+            double ms = elapsedNs / 1e6;
+            s_LastResults.push_back({ zone.name, ms });
+            s_LastFrameMs += ms;
+            Profiler::RecordGpuZone(zone.name, zone.cpuStartNs, elapsedNs);
+        }
+
+        ReleaseSlot(slot);
+        return true;
+    }
+}
+
+void GpuProfiler::BeginFrame() {
+    if (s_Started) {
+        // Close the frame that was being recorded
+        if (s_QueryActive) {
+            glEndQuery(GL_TIME_ELAPSED);
+            s_QueryActive = false;
+        }
+        s_Depth = 0;
+        s_Frames[s_Current].pending = !s_Frames[s_Current].zones.empty();
+
+        // Oldest first; stop at the first frame the GPU has not finished
+        for (int i = 1; i <= FrameLatency; i++) {
+            FrameSlot& slot = s_Frames[(s_Current + i) % FrameLatency];
+            if (slot.pending && !TryResolve(slot)) break;
+        }
+    }
+    s_Started = true;
+
+    s_Current = (s_Current + 1) % FrameLatency;
+    FrameSlot& slot = s_Frames[s_Current];
+    if (slot.pending) {
+        // Still in flight after FrameLatency frames: give up on it rather than wait
+        ReleaseSlot(slot);
+        s_DroppedFrames++;
+    }
+}
+
+void GpuProfiler::BeginZone(const char* name) {
+    if (s_Depth++ > 0) return;
+    if (!s_Started || !Profiler::IsEnabled()) return;
+
+    FrameSlot& slot = s_Frames[s_Current];
+    if ((int)slot.zones.size() >= MaxZonesPerFrame) return;
+
+    Zone zone;
+    zone.name = name;
+    zone.cpuStartNs = Profiler::NowNs();
+    zone.query = AcquireQuery();
+    slot.zones.push_back(zone);
+
+    glBeginQuery(GL_TIME_ELAPSED, zone.query);
+    s_QueryActive = true;
+}
+
+void GpuProfiler::EndZone() {
+    if (s_Depth == 0) return;
+    if (--s_Depth > 0) return;
+
+    if (s_QueryActive) {
+        glEndQuery(GL_TIME_ELAPSED);
+        s_QueryActive = false;
+    }
+}
+
+const std::vector<GpuProfiler::ZoneResult>& GpuProfiler::GetLastResults() {
+    return s_LastResults;
+}
+
+double GpuProfiler::GetLastFrameMs() {
+    return s_LastFrameMs;
+}
+
+uint32_t GpuProfiler::GetDroppedFrames() {
+    return s_DroppedFrames;
+}
+
+void GpuProfiler::Shutdown() {
+    if (s_QueryActive) {
+        glEndQuery(GL_TIME_ELAPSED);
+        s_QueryActive = false;
+    }
+    if (!s_AllQueries.empty()) {
+        glDeleteQueries((GLsizei)s_AllQueries.size(), s_AllQueries.data());
+    }
+    s_AllQueries.clear();
+    s_FreeQueries.clear();
+    for (auto& slot : s_Frames) {
+        slot.zones.clear();
+        slot.pending = false;
+    }
+    s_LastResults.clear();
+    s_Depth = 0;
+    s_Started = false;
+}
@@ -0,0 +1,49 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+#include "../utils/Profiler.h"
+
+// GPU timing with GL_TIME_ELAPSED queries. Results are read back FrameLatency frames later
+// and only once the driver reports them available, so profiling never stalls the pipeline.
+// Elapsed-time queries cannot nest: zones opened inside another zone are folded into it.
+// Resolved zones are forwarded to the CPU profiler on its "GPU" track.
+class GpuProfiler {
+public:
+    static constexpr int FrameLatency = 4;
+    static constexpr int MaxZonesPerFrame = 64;
+
+    struct ZoneResult {
+        const char* name;
+        double ms;
+    };
+
+    // Once per frame on the GL thread: collects finished frames, then starts recording
+    static void BeginFrame();
+
+    // Names must outlive the profiler (string literals or Profiler::InternName)
+    static void BeginZone(const char* name);
+    static void EndZone();
+
+    // Most recently resolved frame
+    static const std::vector<ZoneResult>& GetLastResults();
+    static double GetLastFrameMs();
+    static uint32_t GetDroppedFrames();     // Frames whose results were still pending when recycled
+
+    // Releases the query objects; call while the context is still current
+    static void Shutdown();
+};
+
+class GpuProfileScope {
+public:
+    explicit GpuProfileScope(const char* name) { GpuProfiler::BeginZone(name); }
+    ~GpuProfileScope() { GpuProfiler::EndZone(); }
+
+    GpuProfileScope(const GpuProfileScope&) = delete;
+    GpuProfileScope& operator=(const GpuProfileScope&) = delete;
+};
+
+#if PRISM_PROFILER_ENABLED
+#define GPU_PROFILE_SCOPE(name) GpuProfileScope PRISM_PROFILE_CONCAT(gpuProfileScope, __LINE__)(name)
+#else
+#define GPU_PROFILE_SCOPE(name) ((void)0)
+#endif
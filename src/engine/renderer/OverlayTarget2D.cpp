@@ -0,0 +1,78 @@
+#include "OverlayTarget2D.h"
+#include "GLStateCache.h"
+#include <glad/glad.h>
+#include <glm/gtc/matrix_transform.hpp>
+#include <cmath>
+#include <engine/utils/Logger.h>
+
+OverlayTarget2D::OverlayTarget2D(RenderTargetFormat format)
+    : m_EdgeSharpness(32.0f), m_WindowWidth(1), m_WindowHeight(1),
+      m_PreviousFBO(0), m_BlendWasEnabled(false), m_Active(false)
+{
+    m_Target = new RenderTarget2D(1, 1, format);
+    m_UpsampleShader = new Shader("shaders/UpsampleVertex.vert.glsl", "shaders/UpsampleFrag.frag.glsl");
+    m_QuadBatch = new QuadBatch();
+    m_PreviousViewport[0] = m_PreviousViewport[1] = m_PreviousViewport[2] = m_PreviousViewport[3] = 0;
+    Logger::Info("Upsample shader created with ID: " + std::to_string(m_UpsampleShader->GetID()));
+}
+
+OverlayTarget2D::~OverlayTarget2D() {
+    delete m_QuadBatch;
+    delete m_UpsampleShader;
+    delete m_Target;
+}
+
+bool OverlayTarget2D::Begin(int windowWidth, int windowHeight, float scale) {
+    if (scale >= 0.999f || scale <= 0.0f) return false;
+
+    m_WindowWidth = windowWidth;
+    m_WindowHeight = windowHeight;
+    m_Target->Resize((int)std::ceil(windowWidth * scale), (int)std::ceil(windowHeight * scale));
+
+    glGetIntegerv(GL_FRAMEBUFFER_BINDING, &m_PreviousFBO);
+    glGetIntegerv(GL_VIEWPORT, m_PreviousViewport);
+    m_BlendWasEnabled = GLStateCache::IsBlendEnabled();
+
+    // The overlay is written as-is; blending happens when compositing
+    m_Target->Bind();
+    m_Target->Clear();
+    GLStateCache::SetBlendEnabled(false);
+
+    m_Active = true;
+    return true;
+}
+
+void OverlayTarget2D::End() {
+    if (!m_Active) return;
+    m_Active = false;
+
+    glBindFramebuffer(GL_FRAMEBUFFER, m_PreviousFBO);
+    glViewport(m_PreviousViewport[0], m_PreviousViewport[1], m_PreviousViewport[2], m_PreviousViewport[3]);
+    if (m_BlendWasEnabled) GLStateCache::SetBlendEnabled(true);
+
+    Composite(*m_Target, m_WindowWidth, m_WindowHeight,
+              glm::vec2((float)m_PreviousViewport[2], (float)m_PreviousViewport[3]));
+}
+
+void OverlayTarget2D::Composite(const RenderTarget2D& source, int windowWidth, int windowHeight, const glm::vec2& screenSize) {
+    m_QuadBatch->Begin(m_UpsampleShader);
+
+    glm::mat4 projection = glm::ortho(0.0f, (float)windowWidth, (float)windowHeight, 0.0f);
+    m_UpsampleShader->SetMat4("uProjection", projection);
+
+    source.BindTexture(0);
+    m_UpsampleShader->SetInt("uOverlay", 0);
+    m_UpsampleShader->SetVec2("uOverlaySize", glm::vec2(source.GetWidth(), source.GetHeight()));
+    m_UpsampleShader->SetVec2("uScreenSize", screenSize);
+    m_UpsampleShader->SetFloat("uEdgeSharpness", m_EdgeSharpness);
+
+    QuadInstance compositeInstance;
+    compositeInstance.position = glm::vec2(windowWidth * 0.5f, windowHeight * 0.5f);
+    compositeInstance.size = glm::vec2((float)windowWidth, (float)windowHeight);
+    compositeInstance.rotation = 0.0f;
+    compositeInstance.color = glm::vec4(1.0f);
+    compositeInstance.texIndex = 0.0f;
+
+    m_QuadBatch->Add(compositeInstance);
+    m_QuadBatch->End();
+}
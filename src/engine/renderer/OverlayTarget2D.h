@@ -0,0 +1,45 @@
+#pragma once
+#include <glm/glm.hpp>
+#include "QuadBatch.h"
+#include "Shader.h"
+#include "RenderTarget2D.h"
+
+// Reduced-resolution target for full-screen overlays (fog, vision, lighting).
+// The overlay is shaded into a scaled offscreen texture and composited back over
+// the window with an edge-aware upsample, using whatever blend state the caller set.
+class OverlayTarget2D {
+public:
+    OverlayTarget2D(RenderTargetFormat format = RenderTargetFormat::RGBA8);
+    ~OverlayTarget2D();
+
+    // Redirects rendering into the scaled target. Returns false (and does nothing)
+    // when scale is 1.0 or above, in which case the overlay should draw directly.
+    bool Begin(int windowWidth, int windowHeight, float scale);
+
+    // Restores the previous target and composites the overlay over the window
+    void End();
+
+    // Upsamples any overlay texture over the bound target with the current blend state
+    // (used by the render graph, which owns its own overlay targets)
+    void Composite(const RenderTarget2D& source, int windowWidth, int windowHeight, const glm::vec2& screenSize);
+
+    // Higher values keep shadow edges crisper when upsampling
+    void SetEdgeSharpness(float sharpness) { m_EdgeSharpness = sharpness; }
+    float GetEdgeSharpness() const { return m_EdgeSharpness; }
+
+    const RenderTarget2D* GetTarget() const { return m_Target; }
+
+private:
+    RenderTarget2D* m_Target;
+    Shader* m_UpsampleShader;
+    QuadBatch* m_QuadBatch;
+
+    float m_EdgeSharpness;
+    int m_WindowWidth, m_WindowHeight;
+
+    // State saved in Begin() and restored in End()
+    int m_PreviousFBO;
+    int m_PreviousViewport[4];
+    bool m_BlendWasEnabled;
+    bool m_Active;
+};
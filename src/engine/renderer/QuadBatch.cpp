@@ -1,20 +1,51 @@
 #include "QuadBatch.h"
+#include "GLStateCache.h"
 #include <glad/glad.h>
 #include <glm/ext/matrix_clip_space.hpp>
 #include <engine/utils/Logger.h>
+#include <engine/utils/Profiler.h>
+
+namespace {
+    struct UnitQuad {
+        unsigned int vbo = 0;
+        unsigned int ebo = 0;
+        int users = 0;
+    };
+
+    UnitQuad s_UnitQuad;
+}
 
 QuadBatch::QuadBatch() {
     SetupBuffers();
 }
 
 QuadBatch::~QuadBatch() {
+    GLStateCache::OnVertexArrayDeleted(m_VAO);
+    GLStateCache::OnBufferDeleted(m_InstanceVBO);
     glDeleteVertexArrays(1, &m_VAO);
-    glDeleteBuffers(1, &m_VBO);
-    glDeleteBuffers(1, &m_EBO);
     glDeleteBuffers(1, &m_InstanceVBO);
+    ReleaseUnitQuad();
 }
 
 void QuadBatch::SetupBuffers() {
+    AcquireUnitQuad();
+
+    glGenVertexArrays(1, &m_VAO);
+    GLStateCache::BindVertexArray(m_VAO);
+    SetupQuadAttributes();
+
+    // Instance buffer
+    glGenBuffers(1, &m_InstanceVBO);
+    GLStateCache::BindBuffer(GL_ARRAY_BUFFER, m_InstanceVBO);
+    glBufferData(GL_ARRAY_BUFFER, MaxQuads * sizeof(QuadInstance), nullptr, GL_DYNAMIC_DRAW);
+    SetupInstanceAttributes();
+
+    GLStateCache::BindVertexArray(0);
+}
+
+void QuadBatch::AcquireUnitQuad() {
+    if (s_UnitQuad.users++ > 0) return;
+
     float quadVertices[] = {
         // pos      // tex
         -0.5f, -0.5f, 0.0f, 0.0f,
@@ -24,55 +55,70 @@ void QuadBatch::SetupBuffers() {
     };
     unsigned int quadIndices[] = { 0, 1, 2, 2, 3, 0 };
 
-    glGenVertexArrays(1, &m_VAO);
-    glBindVertexArray(m_VAO);
-
-    glGenBuffers(1, &m_VBO);
-    glBindBuffer(GL_ARRAY_BUFFER, m_VBO);
+    glGenBuffers(1, &s_UnitQuad.vbo);
+    GLStateCache::BindBuffer(GL_ARRAY_BUFFER, s_UnitQuad.vbo);
     glBufferData(GL_ARRAY_BUFFER, sizeof(quadVertices), quadVertices, GL_STATIC_DRAW);
 
-    glGenBuffers(1, &m_EBO);
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_EBO);
-    glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(quadIndices), quadIndices, GL_STATIC_DRAW);
+    // Upload the indices through GL_ARRAY_BUFFER: the element binding belongs to whatever VAO is bound
+    glGenBuffers(1, &s_UnitQuad.ebo);
+    GLStateCache::BindBuffer(GL_ARRAY_BUFFER, s_UnitQuad.ebo);
+    glBufferData(GL_ARRAY_BUFFER, sizeof(quadIndices), quadIndices, GL_STATIC_DRAW);
+}
+
+void QuadBatch::ReleaseUnitQuad() {
+    if (s_UnitQuad.users == 0 || --s_UnitQuad.users > 0) return;
 
-    // Vertex attributes for quad
+    GLStateCache::OnBufferDeleted(s_UnitQuad.vbo);
+    GLStateCache::OnBufferDeleted(s_UnitQuad.ebo);
+    glDeleteBuffers(1, &s_UnitQuad.vbo);
+    glDeleteBuffers(1, &s_UnitQuad.ebo);
+    s_UnitQuad.vbo = 0;
+    s_UnitQuad.ebo = 0;
+}
+
+void QuadBatch::SetupQuadAttributes() {
+    GLStateCache::BindBuffer(GL_ARRAY_BUFFER, s_UnitQuad.vbo);
+    GLStateCache::BindBuffer(GL_ELEMENT_ARRAY_BUFFER, s_UnitQuad.ebo);
     glEnableVertexAttribArray(0); // pos
     glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 4 * sizeof(float), (void*)0);
     glEnableVertexAttribArray(1); // texcoord
     glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 4 * sizeof(float), (void*)(2 * sizeof(float)));
+}
 
-    // Instance buffer
-    glGenBuffers(1, &m_InstanceVBO);
-    glBindBuffer(GL_ARRAY_BUFFER, m_InstanceVBO);
-    glBufferData(GL_ARRAY_BUFFER, MaxQuads * sizeof(QuadInstance), nullptr, GL_DYNAMIC_DRAW);
-
-    // Instance attributes
+void QuadBatch::SetupInstanceAttributes(size_t stride, bool withUVRect) {
     size_t offset = 0;
     glEnableVertexAttribArray(2); // iPos
-    glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, sizeof(QuadInstance), (void*)offset);
+    glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, (GLsizei)stride, (void*)offset);
     glVertexAttribDivisor(2, 1);
     offset += sizeof(glm::vec2);
 
     glEnableVertexAttribArray(3); // iSize
-    glVertexAttribPointer(3, 2, GL_FLOAT, GL_FALSE, sizeof(QuadInstance), (void*)offset);
+    glVertexAttribPointer(3, 2, GL_FLOAT, GL_FALSE, (GLsizei)stride, (void*)offset);
     glVertexAttribDivisor(3, 1);
     offset += sizeof(glm::vec2);
 
     glEnableVertexAttribArray(4); // iRotation
-    glVertexAttribPointer(4, 1, GL_FLOAT, GL_FALSE, sizeof(QuadInstance), (void*)offset);
+    glVertexAttribPointer(4, 1, GL_FLOAT, GL_FALSE, (GLsizei)stride, (void*)offset);
     glVertexAttribDivisor(4, 1);
     offset += sizeof(float);
 
     glEnableVertexAttribArray(5); // iColor
-    glVertexAttribPointer(5, 4, GL_FLOAT, GL_FALSE, sizeof(QuadInstance), (void*)offset);
+    glVertexAttribPointer(5, 4, GL_FLOAT, GL_FALSE, (GLsizei)stride, (void*)offset);
     glVertexAttribDivisor(5, 1);
     offset += sizeof(glm::vec4);
 
     glEnableVertexAttribArray(6); // iTexIndex
-    glVertexAttribPointer(6, 1, GL_FLOAT, GL_FALSE, sizeof(QuadInstance), (void*)offset);
+    glVertexAttribPointer(6, 1, GL_FLOAT, GL_FALSE, (GLsizei)stride, (void*)offset);
     glVertexAttribDivisor(6, 1);
+    offset += sizeof(float);
 
-    glBindVertexArray(0);
+    if (withUVRect) {
+        glEnableVertexAttribArray(7); // iUVRect
+        glVertexAttribPointer(7, 4, GL_FLOAT, GL_FALSE, (GLsizei)stride, (void*)offset);
+        glVertexAttribDivisor(7, 1);
+    } else {
+        glDisableVertexAttribArray(7);
+    }
 }
 
 void QuadBatch::Begin(Shader* shader) {
@@ -87,7 +133,7 @@ void QuadBatch::Begin(Shader* shader) {
         Logger::Error("QuadBatch::Begin - No shader provided!", this);
     }
     
-    glBindVertexArray(m_VAO);
+    GLStateCache::BindVertexArray(m_VAO);
     m_Instances.clear();
 }
 
@@ -101,7 +147,8 @@ void QuadBatch::End() {
     if (!m_Instances.empty())
         Flush();
     
-    glBindVertexArray(0);
+    // The VAO stays bound: the next batch binds its own and the state cache skips
+    // the bind entirely when it is the same one
     
     // Don't unbind the shader here - let the caller decide when to unbind
     // This ensures uniforms set outside of QuadBatch remain valid
@@ -109,20 +156,23 @@ void QuadBatch::End() {
 }
 
 void QuadBatch::Flush() {
+    if (m_Instances.empty()) return;
+    PROFILE_SCOPE("QuadBatch::Flush");
     if (!m_CurrentShader) {
         Logger::Error("QuadBatch::Flush - No shader bound!", this);
         return;
     }
     
-    // Make sure the shader is still bound
+    // Uniform setters between Add() calls may have switched programs; these are
+    // no-ops when nothing changed since Begin()
     m_CurrentShader->Bind();
+    GLStateCache::BindVertexArray(m_VAO);
     
     // Update instance data
-    glBindBuffer(GL_ARRAY_BUFFER, m_InstanceVBO);
+    GLStateCache::BindBuffer(GL_ARRAY_BUFFER, m_InstanceVBO);
     glBufferSubData(GL_ARRAY_BUFFER, 0, m_Instances.size() * sizeof(QuadInstance), m_Instances.data());
     
     // Draw the instances
-    glBindVertexArray(m_VAO);
     glDrawElementsInstanced(GL_TRIANGLES, 6, GL_UNSIGNED_INT, 0, m_Instances.size());
     
     // Clear instances after drawing
@@ -13,6 +13,7 @@ struct QuadInstance {
     float rotation;
     glm::vec4 color;
     float texIndex;
+    glm::vec4 uvRect{0.0f, 0.0f, 1.0f, 1.0f};  // Texture sub-rect (min uv, max uv) for atlases
 };
 #pragma pack(pop)
 
@@ -30,9 +31,21 @@ public:
     void End();
     void Flush();
 
+    // Points instance attributes 2-7 of the bound VAO at the bound GL_ARRAY_BUFFER (QuadInstance layout).
+    // A larger stride reads records that start with a QuadInstance and carry extra data after it;
+    // without uvRect only 2-6 are set up and the records may end after texIndex.
+    static void SetupInstanceAttributes(size_t stride = sizeof(QuadInstance), bool withUVRect = true);
+
+    // Unit quad (pos, tex) shared by every batch: acquired once per owner, freed with the last release
+    static void AcquireUnitQuad();
+    static void ReleaseUnitQuad();
+    // Points attributes 0-1 and the element buffer of the bound VAO at the shared unit quad.
+    // Leaves its vertex buffer bound to GL_ARRAY_BUFFER.
+    static void SetupQuadAttributes();
+
 private:
     std::vector<QuadInstance> m_Instances;
     Shader* m_CurrentShader = nullptr;
-    unsigned int m_VAO, m_VBO, m_EBO, m_InstanceVBO;
+    unsigned int m_VAO, m_InstanceVBO;
     void SetupBuffers();
 };
\ No newline at end of file
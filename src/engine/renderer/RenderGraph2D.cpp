@@ -0,0 +1,332 @@
+#include "RenderGraph2D.h"
+#include <glad/glad.h>
+#include <engine/utils/Logger.h>
+#include <algorithm>
+#include <cmath>
+#include "OverlayTarget2D.h"
+#include "GLStateCache.h"
+#include "GpuProfiler.h"
+
+namespace {
+    // Pooled targets unused for this many frames are released
+    constexpr uint64_t PoolRetainFrames = 120;
+}
+
+// --- RenderGraphContext ---
+
+const RenderTarget2D* RenderGraphContext::GetTarget(RenderGraphResource resource) const {
+    if (!m_Graph->IsValid(resource) || resource == m_Graph->GetBackbuffer()) return nullptr;
+    int physical = m_Graph->m_Resources[resource].physical;
+    return physical >= 0 ? m_Graph->m_Pool[physical].target : nullptr;
+}
+
+void RenderGraphContext::BindTexture(RenderGraphResource resource, unsigned int slot) const {
+    if (const RenderTarget2D* target = GetTarget(resource)) {
+        target->BindTexture(slot);
+    }
+}
+
+int RenderGraphContext::GetWindowWidth() const {
+    return m_Graph->m_WindowWidth;
+}
+
+int RenderGraphContext::GetWindowHeight() const {
+    return m_Graph->m_WindowHeight;
+}
+
+// --- RenderGraphPassBuilder ---
+
+RenderGraphPassBuilder& RenderGraphPassBuilder::Read(RenderGraphResource resource) {
+    if (!m_Graph->IsValid(resource)) {
+        Logger::Warn("RenderGraph2D - Pass '" + m_Graph->m_Passes[m_Pass].name + "' reads an invalid resource", m_Graph);
+        return *this;
+    }
+    m_Graph->m_Passes[m_Pass].reads.push_back(resource);
+    return *this;
+}
+
+RenderGraphPassBuilder& RenderGraphPassBuilder::Write(RenderGraphResource resource, RenderGraphBlend blend) {
+    if (!m_Graph->IsValid(resource)) {
+        Logger::Warn("RenderGraph2D - Pass '" + m_Graph->m_Passes[m_Pass].name + "' writes an invalid resource", m_Graph);
+        return *this;
+    }
+    m_Graph->m_Passes[m_Pass].output = resource;
+    m_Graph->m_Passes[m_Pass].blend = blend;
+    return *this;
+}
+
+RenderGraphPassBuilder& RenderGraphPassBuilder::Clear(const glm::vec4& color) {
+    m_Graph->m_Passes[m_Pass].clear = true;
+    m_Graph->m_Passes[m_Pass].clearColor = color;
+    return *this;
+}
+
+RenderGraphPassBuilder& RenderGraphPassBuilder::SideEffects() {
+    m_Graph->m_Passes[m_Pass].sideEffects = true;
+    return *this;
+}
+
+RenderGraphPassBuilder& RenderGraphPassBuilder::Execute(ExecuteFunction execute) {
+    m_Graph->m_Passes[m_Pass].execute = std::move(execute);
+    return *this;
+}
+
+// --- RenderGraph2D ---
+
+RenderGraph2D::RenderGraph2D()
+    : m_WindowWidth(1), m_WindowHeight(1), m_Frame(0), m_BackbufferFBO(0),
+      m_BoundFramebuffer(-1)
+{
+    m_Compositor = new OverlayTarget2D();
+    m_BackbufferViewport[0] = m_BackbufferViewport[1] = 0;
+    m_BackbufferViewport[2] = m_BackbufferViewport[3] = 1;
+}
+
+RenderGraph2D::~RenderGraph2D() {
+    for (auto& pooled : m_Pool) {
+        delete pooled.target;
+    }
+    delete m_Compositor;
+}
+
+void RenderGraph2D::Begin(int windowWidth, int windowHeight) {
+    m_WindowWidth = std::max(windowWidth, 1);
+    m_WindowHeight = std::max(windowHeight, 1);
+    m_Frame++;
+
+    m_Passes.clear();
+    m_Resources.clear();
+
+    Resource backbuffer;
+    backbuffer.name = "Backbuffer";
+    m_Resources.push_back(backbuffer);
+}
+
+RenderGraphResource RenderGraph2D::CreateTarget(const std::string& name, const RenderGraphTargetDesc& desc) {
+    Resource resource;
+    resource.name = name;
+    resource.desc = desc;
+    resource.width = std::max((int)std::ceil(m_WindowWidth * desc.scale), 1);
+    resource.height = std::max((int)std::ceil(m_WindowHeight * desc.scale), 1);
+    m_Resources.push_back(resource);
+    return (RenderGraphResource)m_Resources.size() - 1;
+}
+
+RenderGraphPassBuilder RenderGraph2D::AddPass(const std::string& name) {
+    Pass pass;
+    pass.name = name;
+    pass.profileName = Profiler::InternName(name);
+    m_Passes.push_back(pass);
+    return RenderGraphPassBuilder(this, (int)m_Passes.size() - 1);
+}
+
+void RenderGraph2D::AddCompositePass(const std::string& name, RenderGraphResource source, RenderGraphResource destination,
+                                     RenderGraphBlend blend, float edgeSharpness) {
+    AddPass(name)
+        .Read(source)
+        .Write(destination, blend)
+        .Execute([this, source, destination, edgeSharpness](const RenderGraphContext& context) {
+            const RenderTarget2D* overlay = context.GetTarget(source);
+            if (!overlay) return;
+
+            // The upsample filter works in destination pixels
+            glm::vec2 screenSize((float)m_BackbufferViewport[2], (float)m_BackbufferViewport[3]);
+            if (const RenderTarget2D* target = context.GetTarget(destination)) {
+                screenSize = glm::vec2((float)target->GetWidth(), (float)target->GetHeight());
+            }
+
+            m_Compositor->SetEdgeSharpness(edgeSharpness);
+            m_Compositor->Composite(*overlay, m_WindowWidth, m_WindowHeight, screenSize);
+        });
+}
+
+void RenderGraph2D::Execute() {
+    m_Stats = RenderGraphStats();
+    m_Stats.declaredPasses = (int)m_Passes.size();
+    m_Stats.transientTargets = (int)m_Resources.size() - 1;
+    if (m_Passes.empty()) return;
+
+    // Whatever is bound now is the backbuffer
+    glGetIntegerv(GL_FRAMEBUFFER_BINDING, &m_BackbufferFBO);
+    glGetIntegerv(GL_VIEWPORT, m_BackbufferViewport);
+    m_BoundFramebuffer = m_BackbufferFBO;
+
+    CullPasses();
+    ComputeLifetimes();
+
+    RenderGraphContext context(this);
+    for (int i = 0; i < (int)m_Passes.size(); i++) {
+        Pass& pass = m_Passes[i];
+        if (!pass.live) {
+            m_Stats.culledPasses++;
+            continue;
+        }
+
+        // Covers the target binds and clears as well as the pass itself
+        PROFILE_SCOPE(pass.profileName);
+        GPU_PROFILE_SCOPE(pass.profileName);
+
+        // Transient targets come alive on first use
+        for (RenderGraphResource read : pass.reads) {
+            Resource& resource = m_Resources[read];
+            if (read != GetBackbuffer() && resource.physical < 0) {
+                Logger::Warn("RenderGraph2D - Pass '" + pass.name + "' reads '" + resource.name + "' before anything writes it", this);
+                resource.physical = AcquireTarget(resource);
+                BindOutput(read);
+                const RenderTarget2D* target = m_Pool[resource.physical].target;
+                target->Clear(resource.desc.clearColor.r, resource.desc.clearColor.g,
+                              resource.desc.clearColor.b, resource.desc.clearColor.a);
+                resource.written = true;
+            }
+        }
+
+        if (pass.output != InvalidRenderGraphResource) {
+            Resource& output = m_Resources[pass.output];
+            if (pass.output != GetBackbuffer() && output.physical < 0) {
+                output.physical = AcquireTarget(output);
+            }
+            BindOutput(pass.output);
+
+            // Aliased targets hold another resource's pixels until their first write
+            if (pass.clear) {
+                glClearBufferfv(GL_COLOR, 0, &pass.clearColor[0]);
+            } else if (pass.output != GetBackbuffer() && !output.written) {
+                glClearBufferfv(GL_COLOR, 0, &output.desc.clearColor[0]);
+            }
+            output.written = true;
+        }
+
+        ApplyBlend(pass.blend);
+
+        if (pass.execute) {
+            pass.execute(context);
+        }
+
+        // Hand targets back once their last reader is done so later resources can alias them
+        auto release = [&](RenderGraphResource handle) {
+            Resource& resource = m_Resources[handle];
+            if (handle != GetBackbuffer() && resource.lastUse == i && resource.physical >= 0) {
+                ReleaseTarget(resource.physical);
+                resource.physical = -1;
+            }
+        };
+        for (RenderGraphResource read : pass.reads) {
+            release(read);
+        }
+        if (pass.output != InvalidRenderGraphResource) {
+            release(pass.output);
+        }
+    }
+
+    // Leave the backbuffer bound for whatever draws next (UI)
+    BindOutput(GetBackbuffer());
+
+    for (const auto& pooled : m_Pool) {
+        if (pooled.lastUsedFrame == m_Frame) m_Stats.physicalTargets++;
+    }
+    TrimPool();
+    m_Stats.pooledTargets = (int)m_Pool.size();
+}
+
+void RenderGraph2D::CullPasses() {
+    // Walk backwards from the backbuffer: a pass is live if something later reads its output.
+    // Writes are treated as read-modify-write, so earlier writers of a live target stay live.
+    std::vector<bool> needed(m_Resources.size(), false);
+    needed[GetBackbuffer()] = true;
+
+    for (int i = (int)m_Passes.size() - 1; i >= 0; i--) {
+        Pass& pass = m_Passes[i];
+        bool writesNeeded = pass.output != InvalidRenderGraphResource && needed[pass.output];
+        pass.live = pass.sideEffects || writesNeeded;
+        if (!pass.live) continue;
+
+        for (RenderGraphResource read : pass.reads) {
+            needed[read] = true;
+        }
+    }
+}
+
+void RenderGraph2D::ComputeLifetimes() {
+    for (int i = 0; i < (int)m_Passes.size(); i++) {
+        const Pass& pass = m_Passes[i];
+        if (!pass.live) continue;
+
+        for (RenderGraphResource read : pass.reads) {
+            m_Resources[read].lastUse = i;
+        }
+        if (pass.output != InvalidRenderGraphResource) {
+            m_Resources[pass.output].lastUse = i;
+        }
+    }
+}
+
+int RenderGraph2D::AcquireTarget(const Resource& resource) {
+    for (int i = 0; i < (int)m_Pool.size(); i++) {
+        PooledTarget& pooled = m_Pool[i];
+        if (pooled.inUse) continue;
+        if (pooled.target->GetWidth() != resource.width || pooled.target->GetHeight() != resource.height ||
+            pooled.target->GetFormat() != resource.desc.format) continue;
+
+        pooled.inUse = true;
+        pooled.lastUsedFrame = m_Frame;
+        return i;
+    }
+
+    PooledTarget pooled;
+    pooled.target = new RenderTarget2D(resource.width, resource.height, resource.desc.format);
+    pooled.inUse = true;
+    pooled.lastUsedFrame = m_Frame;
+    m_Pool.push_back(pooled);
+    return (int)m_Pool.size() - 1;
+}
+
+void RenderGraph2D::ReleaseTarget(int physical) {
+    m_Pool[physical].inUse = false;
+}
+
+void RenderGraph2D::TrimPool() {
+    m_Pool.erase(std::remove_if(m_Pool.begin(), m_Pool.end(), [this](PooledTarget& pooled) {
+        if (pooled.inUse || pooled.lastUsedFrame + PoolRetainFrames >= m_Frame) return false;
+        delete pooled.target;
+        return true;
+    }), m_Pool.end());
+}
+
+void RenderGraph2D::BindOutput(RenderGraphResource resource) {
+    if (resource == GetBackbuffer()) {
+        if (m_BoundFramebuffer == m_BackbufferFBO) return;
+        glBindFramebuffer(GL_FRAMEBUFFER, m_BackbufferFBO);
+        glViewport(m_BackbufferViewport[0], m_BackbufferViewport[1], m_BackbufferViewport[2], m_BackbufferViewport[3]);
+        m_BoundFramebuffer = m_BackbufferFBO;
+    } else {
+        const RenderTarget2D* target = m_Pool[m_Resources[resource].physical].target;
+        if (m_BoundFramebuffer == (int)target->GetFramebufferID()) return;
+        target->Bind();
+        m_BoundFramebuffer = (int)target->GetFramebufferID();
+    }
+    m_Stats.framebufferBinds++;
+}
+
+void RenderGraph2D::ApplyBlend(RenderGraphBlend blend) {
+    switch (blend) {
+        case RenderGraphBlend::None:
+            GLStateCache::SetBlendEnabled(false);
+            break;
+        case RenderGraphBlend::Alpha:
+            GLStateCache::SetBlendEnabled(true);
+            GLStateCache::SetBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+            break;
+        case RenderGraphBlend::Multiply:
+            GLStateCache::SetBlendEnabled(true);
+            GLStateCache::SetBlendFunc(GL_DST_COLOR, GL_ZERO);
+            break;
+        case RenderGraphBlend::Additive:
+            GLStateCache::SetBlendEnabled(true);
+            GLStateCache::SetBlendFunc(GL_ONE, GL_ONE);
+            break;
+    }
+}
+
+bool RenderGraph2D::IsValid(RenderGraphResource resource) const {
+    return resource >= 0 && resource < (RenderGraphResource)m_Resources.size();
+}
@@ -0,0 +1,157 @@
+#pragma once
+#include <glm/glm.hpp>
+#include <functional>
+#include <string>
+#include <vector>
+#include <cstdint>
+#include "RenderTarget2D.h"
+
+class OverlayTarget2D;
+
+using RenderGraphResource = int;
+static constexpr RenderGraphResource InvalidRenderGraphResource = -1;
+
+enum class RenderGraphBlend {
+    None,       // Overwrite
+    Alpha,      // src * a + dst * (1 - a)
+    Multiply,   // src * dst (lighting)
+    Additive    // src + dst
+};
+
+// Transient target: sized relative to the window and cleared by the first pass writing it
+struct RenderGraphTargetDesc {
+    float scale = 1.0f;                                 // Resolution relative to the window
+    RenderTargetFormat format = RenderTargetFormat::RGBA8;
+    glm::vec4 clearColor{0.0f};
+};
+
+class RenderGraph2D;
+
+// Handed to pass callbacks while the graph executes
+class RenderGraphContext {
+public:
+    // Physical target behind a transient resource (nullptr for the backbuffer)
+    const RenderTarget2D* GetTarget(RenderGraphResource resource) const;
+    void BindTexture(RenderGraphResource resource, unsigned int slot) const;
+
+    int GetWindowWidth() const;
+    int GetWindowHeight() const;
+
+private:
+    friend class RenderGraph2D;
+    explicit RenderGraphContext(const RenderGraph2D* graph) : m_Graph(graph) {}
+    const RenderGraph2D* m_Graph;
+};
+
+// Declares one pass: what it reads, the single target it writes and how it blends
+class RenderGraphPassBuilder {
+public:
+    using ExecuteFunction = std::function<void(const RenderGraphContext&)>;
+
+    RenderGraphPassBuilder& Read(RenderGraphResource resource);
+    RenderGraphPassBuilder& Write(RenderGraphResource resource, RenderGraphBlend blend = RenderGraphBlend::None);
+    RenderGraphPassBuilder& Clear(const glm::vec4& color);  // Clear the output before executing
+    RenderGraphPassBuilder& SideEffects();                  // Never culled (e.g. readbacks)
+    RenderGraphPassBuilder& Execute(ExecuteFunction execute);
+
+private:
+    friend class RenderGraph2D;
+    RenderGraphPassBuilder(RenderGraph2D* graph, int pass) : m_Graph(graph), m_Pass(pass) {}
+    RenderGraph2D* m_Graph;
+    int m_Pass;
+};
+
+struct RenderGraphStats {
+    int declaredPasses = 0;
+    int culledPasses = 0;
+    int transientTargets = 0;     // Declared this frame
+    int physicalTargets = 0;      // Distinct textures backing them (after aliasing)
+    int pooledTargets = 0;        // Kept alive across frames
+    int framebufferBinds = 0;     // After redundant binds were skipped
+};
+
+// Frame graph for the 2D renderer. Passes are declared every frame in execution order;
+// on Execute() the graph drops passes whose output nobody reads, backs transient targets
+// with pooled RenderTarget2Ds (resources whose lifetimes do not overlap share a texture),
+// and skips framebuffer/viewport/blend changes that are already in effect.
+// Pass callbacks must leave the framebuffer, viewport and blend state as they found them.
+class RenderGraph2D {
+public:
+    RenderGraph2D();
+    ~RenderGraph2D();
+
+    // Starts a new frame description; pooled targets survive across frames
+    void Begin(int windowWidth, int windowHeight);
+
+    // Whatever framebuffer is bound when Execute() is called
+    RenderGraphResource GetBackbuffer() const { return 0; }
+    RenderGraphResource CreateTarget(const std::string& name, const RenderGraphTargetDesc& desc);
+
+    RenderGraphPassBuilder AddPass(const std::string& name);
+
+    // Upsamples a (usually reduced-resolution) target over another one with an edge-aware filter
+    void AddCompositePass(const std::string& name, RenderGraphResource source, RenderGraphResource destination,
+                          RenderGraphBlend blend, float edgeSharpness = 32.0f);
+
+    void Execute();
+
+    const RenderGraphStats& GetStats() const { return m_Stats; }
+    int GetWindowWidth() const { return m_WindowWidth; }
+    int GetWindowHeight() const { return m_WindowHeight; }
+
+private:
+    friend class RenderGraphContext;
+    friend class RenderGraphPassBuilder;
+
+    struct Resource {
+        std::string name;
+        RenderGraphTargetDesc desc;
+        int width = 0, height = 0;
+        int physical = -1;          // Index into m_Pool while alive
+        int lastUse = -1;           // Last live pass touching it
+        bool written = false;
+    };
+
+    struct Pass {
+        std::string name;
+        const char* profileName = nullptr;    // Interned copy of name for profiler zones
+        std::vector<RenderGraphResource> reads;
+        RenderGraphResource output = InvalidRenderGraphResource;
+        RenderGraphBlend blend = RenderGraphBlend::None;
+        bool clear = false;
+        glm::vec4 clearColor{0.0f};
+        bool sideEffects = false;
+        bool live = false;
+        RenderGraphPassBuilder::ExecuteFunction execute;
+    };
+
+    struct PooledTarget {
+        RenderTarget2D* target = nullptr;
+        bool inUse = false;
+        uint64_t lastUsedFrame = 0;
+    };
+
+    std::vector<Resource> m_Resources;   // Index 0 is the backbuffer
+    std::vector<Pass> m_Passes;
+    std::vector<PooledTarget> m_Pool;
+    OverlayTarget2D* m_Compositor;
+
+    int m_WindowWidth, m_WindowHeight;
+    uint64_t m_Frame;
+    RenderGraphStats m_Stats;
+
+    // State tracked while executing
+    int m_BackbufferFBO;
+    int m_BackbufferViewport[4];
+    int m_BoundFramebuffer;         // -1 when unknown
+
+    // Helper functions
+    void CullPasses();
+    void ComputeLifetimes();
+    int AcquireTarget(const Resource& resource);
+    void ReleaseTarget(int physical);
+    void TrimPool();
+    void BindOutput(RenderGraphResource resource);
+    void ApplyBlend(RenderGraphBlend blend);    // Redundant changes are skipped by GLStateCache
+    bool IsValid(RenderGraphResource resource) const;
+};
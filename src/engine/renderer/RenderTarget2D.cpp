@@ -0,0 +1,75 @@
+#include "RenderTarget2D.h"
+#include "GLStateCache.h"
+#include <glad/glad.h>
+#include <algorithm>
+#include <engine/utils/Logger.h>
+
+RenderTarget2D::RenderTarget2D(int width, int height, RenderTargetFormat format)
+    : m_FBO(0), m_Texture(0), m_Width(std::max(width, 1)), m_Height(std::max(height, 1)), m_Format(format)
+{
+    glGenTextures(1, &m_Texture);
+    GLStateCache::BindTexture(m_Texture);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    AllocateStorage();
+
+    GLint previousFBO = 0;
+    glGetIntegerv(GL_FRAMEBUFFER_BINDING, &previousFBO);
+
+    glGenFramebuffers(1, &m_FBO);
+    glBindFramebuffer(GL_FRAMEBUFFER, m_FBO);
+    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, m_Texture, 0);
+
+    if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE) {
+        Logger::Error("RenderTarget2D - Framebuffer is incomplete", this);
+    }
+
+    glBindFramebuffer(GL_FRAMEBUFFER, previousFBO);
+}
+
+RenderTarget2D::~RenderTarget2D() {
+    GLStateCache::OnTextureDeleted(m_Texture);
+    glDeleteFramebuffers(1, &m_FBO);
+    glDeleteTextures(1, &m_Texture);
+}
+
+void RenderTarget2D::Resize(int width, int height) {
+    width = std::max(width, 1);
+    height = std::max(height, 1);
+    if (width == m_Width && height == m_Height) return;
+
+    m_Width = width;
+    m_Height = height;
+    AllocateStorage();
+}
+
+void RenderTarget2D::Bind() const {
+    glBindFramebuffer(GL_FRAMEBUFFER, m_FBO);
+    glViewport(0, 0, m_Width, m_Height);
+}
+
+void RenderTarget2D::Unbind() const {
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+}
+
+void RenderTarget2D::BindTexture(unsigned int slot) const {
+    GLStateCache::BindTexture(slot, m_Texture);
+}
+
+void RenderTarget2D::Clear(float r, float g, float b, float a) const {
+    // glClearBuffer leaves the global clear color untouched
+    const float clearValue[4] = { r, g, b, a };
+    glClearBufferfv(GL_COLOR, 0, clearValue);
+}
+
+void RenderTarget2D::AllocateStorage() {
+    GLStateCache::BindTexture(m_Texture);
+    if (m_Format == RenderTargetFormat::RGBA16F) {
+        glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA16F, m_Width, m_Height, 0, GL_RGBA, GL_FLOAT, nullptr);
+    } else {
+        glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, m_Width, m_Height, 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+    }
+    GLStateCache::BindTexture(0);
+}
@@ -0,0 +1,37 @@
+#pragma once
+
+enum class RenderTargetFormat {
+    RGBA8,      // Standard 8-bit color
+    RGBA16F     // Half-float color, keeps values above 1.0 (lighting)
+};
+
+// Offscreen color target: a framebuffer with a single texture attachment
+class RenderTarget2D {
+public:
+    RenderTarget2D(int width, int height, RenderTargetFormat format = RenderTargetFormat::RGBA8);
+    ~RenderTarget2D();
+
+    // Reallocates the color texture when the size changes
+    void Resize(int width, int height);
+
+    // Binds the framebuffer and sets the viewport to cover it
+    void Bind() const;
+    void Unbind() const;
+
+    // Binds the color texture for sampling
+    void BindTexture(unsigned int slot = 0) const;
+    void Clear(float r = 0.0f, float g = 0.0f, float b = 0.0f, float a = 0.0f) const;
+
+    int GetWidth() const { return m_Width; }
+    int GetHeight() const { return m_Height; }
+    RenderTargetFormat GetFormat() const { return m_Format; }
+    unsigned int GetFramebufferID() const { return m_FBO; }
+    unsigned int GetTextureID() const { return m_Texture; }
+
+private:
+    unsigned int m_FBO, m_Texture;
+    int m_Width, m_Height;
+    RenderTargetFormat m_Format;
+
+    void AllocateStorage();
+};
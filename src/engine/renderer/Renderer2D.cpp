@@ -2,12 +2,17 @@
 #include "Renderer2D.h"
 #include "Shader.h"
 #include <glm/gtc/matrix_transform.hpp>
+#include <cfloat>
+#include <cmath>
 
 Renderer2D::Renderer2D(int width, int height)
-    : m_WindowWidth(width), m_WindowHeight(height)
+    : m_ActiveStream(Stream::Quads), m_WindowWidth(width), m_WindowHeight(height), m_ViewMin(0.0f), m_ViewMax(0.0f),
+      m_CullingEnabled(true), m_CulledQuads(0)
 {
     m_BaseShader = new Shader("shaders/BaseVertex.vert.glsl", "shaders/BaseFrag.frag.glsl");
+    m_ShapeShader = new Shader("shaders/ShapeVertex.vert.glsl", "shaders/ShapeFrag.frag.glsl");
     m_QuadBatch = new QuadBatch();
+    m_ShapeBatch = new ShapeBatch();
     m_Projection = glm::ortho(0.0f, (float)width, (float)height, 0.0f);
     
     // Initialize texture uniforms for the base shader
@@ -26,24 +31,67 @@ Renderer2D::Renderer2D(int width, int height)
 
 Renderer2D::~Renderer2D() {
     delete m_QuadBatch;
+    delete m_ShapeBatch;
     delete m_BaseShader;
+    delete m_ShapeShader;
 }
 
 void Renderer2D::BeginBatch(Shader* shader) {
     if (!shader) shader = m_BaseShader;
+    
+    m_ShapeBatch->Begin(m_ShapeShader);
+    m_ShapeShader->SetMat4("uProjection", m_Projection);
+    
     m_QuadBatch->Begin(shader);
     shader->SetMat4("uProjection", m_Projection);
+    m_ActiveStream = Stream::Quads;
+    m_CulledQuads = 0;
 }
 
 void Renderer2D::EndBatch() {
+    // Only the active stream can hold pending instances
     m_QuadBatch->End();
+    m_ShapeBatch->End();
 }
 
 void Renderer2D::Flush() {
     m_QuadBatch->Flush();
+    m_ShapeBatch->Flush();
+}
+
+bool Renderer2D::IsOutsideView(const glm::vec2& pos, const glm::vec2& halfExtents, float rotation) const {
+    if (!m_CullingEnabled) return false;
+    
+    glm::vec2 extents = glm::abs(halfExtents);
+    if (rotation != 0.0f) {
+        // Box around the rotated quad
+        float c = std::abs(std::cos(rotation));
+        float s = std::abs(std::sin(rotation));
+        extents = glm::vec2(c * extents.x + s * extents.y, s * extents.x + c * extents.y);
+    }
+    return pos.x + extents.x < m_ViewMin.x || pos.x - extents.x > m_ViewMax.x ||
+           pos.y + extents.y < m_ViewMin.y || pos.y - extents.y > m_ViewMax.y;
+}
+
+void Renderer2D::SwitchStream(Stream stream) {
+    if (m_ActiveStream == stream) return;
+    
+    // Whatever the other batch holds was drawn first
+    if (m_ActiveStream == Stream::Quads) {
+        m_QuadBatch->Flush();
+    } else {
+        m_ShapeBatch->Flush();
+    }
+    m_ActiveStream = stream;
 }
 
 void Renderer2D::DrawQuad(const glm::vec2& pos, const glm::vec2& size, float rotation, const glm::vec4& color, Texture2D* texture) {
+    if (IsOutsideView(pos, size * 0.5f, rotation)) {
+        m_CulledQuads++;
+        return;
+    }
+    SwitchStream(Stream::Quads);
+    
     QuadInstance instance;
     instance.position = pos;
     instance.size = size;
@@ -66,11 +114,7 @@ void Renderer2D::DrawRectRot(const glm::vec2& pos, const glm::vec2& size, float
 }
 
 void Renderer2D::DrawLine(const glm::vec2& p0, const glm::vec2& p1, float thickness, const glm::vec4& color) {
-    glm::vec2 delta = p1 - p0;
-    float length = glm::length(delta);
-    float angle = atan2(delta.y, delta.x);
-    glm::vec2 center = (p0 + p1) * 0.5f;
-    DrawQuad(center, {length, thickness}, angle, color, nullptr);
+    DrawLineRot(p0, p1, thickness, 0.0f, color);
 }
 
 void Renderer2D::DrawLineRot(const glm::vec2& p0, const glm::vec2& p1, float thickness, float rotation, const glm::vec4& color) {
@@ -78,18 +122,99 @@ void Renderer2D::DrawLineRot(const glm::vec2& p0, const glm::vec2& p1, float thi
     float length = glm::length(delta);
     float angle = atan2(delta.y, delta.x) + rotation;
     glm::vec2 center = (p0 + p1) * 0.5f;
-    DrawQuad(center, {length, thickness}, angle, color, nullptr);
+    
+    // A line is a square-capped box along the segment
+    DrawRoundedRect(center, {length, thickness}, angle, 0.0f, color);
 }
 
 void Renderer2D::DrawCircle(const glm::vec2& center, float radius, const glm::vec4& color) {
-    DrawQuad(center, {radius * 2.0f, radius * 2.0f}, 0.0f, color, nullptr);
+    DrawRing(center, radius, 0.0f, color);
+}
+
+void Renderer2D::DrawRing(const glm::vec2& center, float radius, float thickness, const glm::vec4& color) {
+    ShapeInstance shape{};
+    shape.position = center;
+    shape.halfSize = glm::vec2(radius);
+    shape.color = color;
+    shape.radius = radius;
+    shape.thickness = thickness;
+    shape.shapeType = (float)ShapeType::Circle;
+    DrawShape(shape);
+}
+
+void Renderer2D::DrawCapsule(const glm::vec2& p0, const glm::vec2& p1, float radius, const glm::vec4& color) {
+    glm::vec2 delta = p1 - p0;
+    
+    ShapeInstance shape{};
+    shape.position = (p0 + p1) * 0.5f;
+    shape.halfSize = glm::vec2(glm::length(delta) * 0.5f + radius, radius);
+    shape.rotation = atan2(delta.y, delta.x);
+    shape.color = color;
+    shape.radius = radius;
+    shape.shapeType = (float)ShapeType::Capsule;
+    DrawShape(shape);
+}
+
+void Renderer2D::DrawRoundedRect(const glm::vec2& pos, const glm::vec2& size, float rotation, float cornerRadius,
+                                 const glm::vec4& color, float thickness) {
+    ShapeInstance shape{};
+    shape.position = pos;
+    shape.halfSize = glm::abs(size) * 0.5f;
+    shape.rotation = rotation;
+    shape.color = color;
+    shape.thickness = thickness;
+    shape.cornerRadius = cornerRadius;
+    shape.shapeType = (float)ShapeType::RoundedRect;
+    DrawShape(shape);
+}
+
+void Renderer2D::DrawShape(const ShapeInstance& shape) {
+    if (IsOutsideView(shape.position, shape.halfSize + glm::vec2(shape.feather + 2.0f), shape.rotation)) {
+        m_CulledQuads++;
+        return;
+    }
+    SwitchStream(Stream::Shapes);
+    m_ShapeBatch->Add(shape);
+}
+
+void Renderer2D::DrawStaticBatch(StaticBatch& batch) {
+    // Anything submitted so far sits underneath the static geometry
+    Flush();
+    
+    // Projection was uploaded in BeginBatch/SetProjection; the chunks cull themselves
+    m_BaseShader->Bind();
+    batch.Draw(m_ViewMin, m_ViewMax);
+}
+
+void Renderer2D::DrawParticles(ParticleRenderer2D& particles) {
+    Flush();
+    
+    // Same sprite shader and projection; the particle buffer replaces the instance buffer
+    m_BaseShader->Bind();
+    particles.Draw();
 }
 
 void Renderer2D::SetProjection(const glm::mat4& proj) {
     m_Projection = proj;
+    
+    // The view rect is the clip-space square mapped back into world space
+    glm::mat4 inverse = glm::inverse(proj);
+    m_ViewMin = glm::vec2(FLT_MAX);
+    m_ViewMax = glm::vec2(-FLT_MAX);
+    const glm::vec2 corners[4] = { {-1.0f, -1.0f}, {1.0f, -1.0f}, {-1.0f, 1.0f}, {1.0f, 1.0f} };
+    for (const auto& corner : corners) {
+        glm::vec4 world = inverse * glm::vec4(corner, 0.0f, 1.0f);
+        glm::vec2 point = glm::vec2(world) / world.w;
+        m_ViewMin = glm::min(m_ViewMin, point);
+        m_ViewMax = glm::max(m_ViewMax, point);
+    }
+
+    m_ShapeShader->Bind();
+    m_ShapeShader->SetMat4("uProjection", m_Projection);
+    
+    // Left bound: the sprite batch uses this program next and the bind is skipped
     m_BaseShader->Bind();
     m_BaseShader->SetMat4("uProjection", m_Projection);
-    m_BaseShader->Unbind();
 }
 
 void Renderer2D::SetWindowSize(int width, int height) {
@@ -1,6 +1,9 @@
 #pragma once
 #include <glm/glm.hpp>
 #include "QuadBatch.h"
+#include "ShapeBatch.h"
+#include "StaticBatch.h"
+#include "particles/ParticleRenderer2D.h"
 #include "Shader.h"
 #include "Texture2D.h"
 
@@ -16,20 +19,53 @@ public:
     void DrawQuad(const glm::vec2& pos, const glm::vec2& size, float rotation, const glm::vec4& color, Texture2D* texture = nullptr);
     void DrawRect(const glm::vec2& pos, const glm::vec2& size, const glm::vec4& color);
     void DrawRectRot(const glm::vec2& pos, const glm::vec2& size, float rotation, const glm::vec4& color);
+
+    // Anti-aliased SDF shapes, one instance each. They share the sprite stream: switching
+    // between sprites and shapes flushes the other batch so draw order is preserved.
     void DrawLine(const glm::vec2& p0, const glm::vec2& p1, float thickness, const glm::vec4& color);
     void DrawLineRot(const glm::vec2& p0, const glm::vec2& p1, float thickness, float rotation, const glm::vec4& color);
     void DrawCircle(const glm::vec2& center, float radius, const glm::vec4& color);
+    void DrawRing(const glm::vec2& center, float radius, float thickness, const glm::vec4& color);
+    void DrawCapsule(const glm::vec2& p0, const glm::vec2& p1, float radius, const glm::vec4& color);
+    void DrawRoundedRect(const glm::vec2& pos, const glm::vec2& size, float rotation, float cornerRadius,
+                         const glm::vec4& color, float thickness = 0.0f);
+    void DrawShape(const ShapeInstance& shape);
+
+    // Draws the visible chunks of a static batch with the base shader, in submission order
+    void DrawStaticBatch(StaticBatch& batch);
+    // Draws the GPU-simulated particles straight from their simulation buffer
+    void DrawParticles(ParticleRenderer2D& particles);
 
     void SetProjection(const glm::mat4& proj);
     void SetWindowSize(int width, int height);
 
+    // Quads entirely outside the view rect are dropped before they reach the batch
+    void SetCullingEnabled(bool enabled) { m_CullingEnabled = enabled; }
+    bool IsCullingEnabled() const { return m_CullingEnabled; }
+    const glm::vec2& GetViewMin() const { return m_ViewMin; }   // World-space view rect from the projection
+    const glm::vec2& GetViewMax() const { return m_ViewMax; }
+    const glm::mat4& GetProjection() const { return m_Projection; }
+    int GetCulledQuadCount() const { return m_CulledQuads; }    // Since the last BeginBatch
+
     int GetWindowWidth() const { return m_WindowWidth; }
     int GetWindowHeight() const { return m_WindowHeight; }
     Shader* GetBaseShader() const { return m_BaseShader; }
 
 private:
+    enum class Stream { Quads, Shapes };
+
     QuadBatch* m_QuadBatch;
+    ShapeBatch* m_ShapeBatch;
     Shader*    m_BaseShader;
+    Shader*    m_ShapeShader;
+    Stream     m_ActiveStream;
     int        m_WindowWidth, m_WindowHeight;
     glm::mat4  m_Projection;
+    glm::vec2  m_ViewMin, m_ViewMax;
+    bool       m_CullingEnabled;
+    int        m_CulledQuads;
+
+    // Helper functions
+    bool IsOutsideView(const glm::vec2& pos, const glm::vec2& halfExtents, float rotation) const;
+    void SwitchStream(Stream stream);
 };
\ No newline at end of file
@@ -1,4 +1,5 @@
 #include "Shader.h"
+#include "GLStateCache.h"
 #include <glad/glad.h>
 #include <fstream>
 #include <filesystem>
@@ -13,17 +14,23 @@ Shader::Shader(const std::string& vertexPath, const std::string& fragmentPath) {
     ID = CreateProgram(vertexSrc, fragmentSrc);
 }
 
+Shader::Shader(const std::string& vertexPath, const std::vector<std::string>& feedbackVaryings) {
+    std::string vertexSrc = ReadFile(ResourcePath::GetFullPath(vertexPath));
+    ID = CreateFeedbackProgram(vertexSrc, feedbackVaryings);
+}
+
 Shader::~Shader() {
+    GLStateCache::OnProgramDeleted(ID);
     glDeleteProgram(ID);
 }
 
 void Shader::Bind() const {
-    glUseProgram(ID);
+    GLStateCache::UseProgram(ID);
     //Logger::Info("Binding shader program: " + std::to_string(ID));
 }
 
 void Shader::Unbind() const {
-    glUseProgram(0);
+    GLStateCache::UseProgram(0);
     //Logger::Info("Unbinding shader program");
 }
 
@@ -119,6 +126,34 @@ unsigned int Shader::CreateProgram(const std::string& vertexSrc, const std::stri
 
     glAttachShader(program, vs);
     glAttachShader(program, fs);
+    LinkProgram(program);
+
+    glDeleteShader(vs);
+    glDeleteShader(fs);
+
+    return program;
+}
+
+unsigned int Shader::CreateFeedbackProgram(const std::string& vertexSrc, const std::vector<std::string>& feedbackVaryings) {
+    unsigned int vs = CompileShader(GL_VERTEX_SHADER, vertexSrc);
+    unsigned int program = glCreateProgram();
+    glAttachShader(program, vs);
+
+    // Varyings have to be declared before linking
+    std::vector<const char*> names;
+    names.reserve(feedbackVaryings.size());
+    for (const auto& varying : feedbackVaryings) {
+        names.push_back(varying.c_str());
+    }
+    glTransformFeedbackVaryings(program, (GLsizei)names.size(), names.data(), GL_INTERLEAVED_ATTRIBS);
+    LinkProgram(program);
+
+    glDeleteShader(vs);
+
+    return program;
+}
+
+unsigned int Shader::LinkProgram(unsigned int program) {
     glLinkProgram(program);
 
     int success;
@@ -129,9 +164,5 @@ unsigned int Shader::CreateProgram(const std::string& vertexSrc, const std::stri
         Logger::Error<std::string>("Shader Link Error: " + std::string(info));
         throw std::runtime_error("Shader linking failed: " + std::string(info));
     }
-
-    glDeleteShader(vs);
-    glDeleteShader(fs);
-
     return program;
 }
\ No newline at end of file
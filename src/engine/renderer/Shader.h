@@ -1,10 +1,13 @@
 #pragma once
 #include <string>
+#include <vector>
 #include <glm/glm.hpp>
 
 class Shader {
 public:
     Shader(const std::string& vertexPath, const std::string& fragmentPath);
+    // Vertex-only program whose outputs are captured by transform feedback, interleaved in the given order
+    Shader(const std::string& vertexPath, const std::vector<std::string>& feedbackVaryings);
     ~Shader();
 
     void Bind() const;
@@ -30,4 +33,6 @@ private:
     std::string ReadFile(const std::string& path);
     unsigned int CompileShader(unsigned int type, const std::string& source);
     unsigned int CreateProgram(const std::string& vertexSrc, const std::string& fragmentSrc);
+    unsigned int CreateFeedbackProgram(const std::string& vertexSrc, const std::vector<std::string>& feedbackVaryings);
+    unsigned int LinkProgram(unsigned int program);
 };
\ No newline at end of file
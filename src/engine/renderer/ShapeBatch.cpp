@@ -0,0 +1,106 @@
+#include "ShapeBatch.h"
+#include "GLStateCache.h"
+#include "QuadBatch.h"
+#include <glad/glad.h>
+#include <cstddef>
+#include <engine/utils/Logger.h>
+#include <engine/utils/Profiler.h>
+
+ShapeBatch::ShapeBatch() {
+    m_Instances.reserve(MaxShapes);
+    SetupBuffers();
+}
+
+ShapeBatch::~ShapeBatch() {
+    GLStateCache::OnVertexArrayDeleted(m_VAO);
+    GLStateCache::OnBufferDeleted(m_InstanceVBO);
+    glDeleteVertexArrays(1, &m_VAO);
+    glDeleteBuffers(1, &m_InstanceVBO);
+    QuadBatch::ReleaseUnitQuad();
+}
+
+void ShapeBatch::SetupBuffers() {
+    QuadBatch::AcquireUnitQuad();
+
+    glGenVertexArrays(1, &m_VAO);
+    GLStateCache::BindVertexArray(m_VAO);
+    QuadBatch::SetupQuadAttributes();
+
+    // Instance buffer
+    glGenBuffers(1, &m_InstanceVBO);
+    GLStateCache::BindBuffer(GL_ARRAY_BUFFER, m_InstanceVBO);
+    glBufferData(GL_ARRAY_BUFFER, MaxShapes * sizeof(ShapeInstance), nullptr, GL_STREAM_DRAW);
+
+    // Instance attributes
+    glEnableVertexAttribArray(2); // iPos
+    glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, sizeof(ShapeInstance), (void*)offsetof(ShapeInstance, position));
+    glVertexAttribDivisor(2, 1);
+
+    glEnableVertexAttribArray(3); // iHalfSize
+    glVertexAttribPointer(3, 2, GL_FLOAT, GL_FALSE, sizeof(ShapeInstance), (void*)offsetof(ShapeInstance, halfSize));
+    glVertexAttribDivisor(3, 1);
+
+    glEnableVertexAttribArray(4); // iRotation
+    glVertexAttribPointer(4, 1, GL_FLOAT, GL_FALSE, sizeof(ShapeInstance), (void*)offsetof(ShapeInstance, rotation));
+    glVertexAttribDivisor(4, 1);
+
+    glEnableVertexAttribArray(5); // iColor
+    glVertexAttribPointer(5, 4, GL_FLOAT, GL_FALSE, sizeof(ShapeInstance), (void*)offsetof(ShapeInstance, color));
+    glVertexAttribDivisor(5, 1);
+
+    glEnableVertexAttribArray(6); // iParams: radius, thickness, cornerRadius, feather
+    glVertexAttribPointer(6, 4, GL_FLOAT, GL_FALSE, sizeof(ShapeInstance), (void*)offsetof(ShapeInstance, radius));
+    glVertexAttribDivisor(6, 1);
+
+    glEnableVertexAttribArray(7); // iShapeType
+    glVertexAttribPointer(7, 1, GL_FLOAT, GL_FALSE, sizeof(ShapeInstance), (void*)offsetof(ShapeInstance, shapeType));
+    glVertexAttribDivisor(7, 1);
+
+    GLStateCache::BindVertexArray(0);
+}
+
+void ShapeBatch::Begin(Shader* shader) {
+    m_CurrentShader = shader;
+    if (m_CurrentShader) {
+        m_CurrentShader->Bind();
+    } else {
+        Logger::Error("ShapeBatch::Begin - No shader provided!", this);
+    }
+
+    GLStateCache::BindVertexArray(m_VAO);
+    m_Instances.clear();
+}
+
+void ShapeBatch::Add(const ShapeInstance& instance) {
+    m_Instances.push_back(instance);
+    if (m_Instances.size() >= MaxShapes)
+        Flush();
+}
+
+void ShapeBatch::End() {
+    if (!m_Instances.empty())
+        Flush();
+
+    m_CurrentShader = nullptr;
+}
+
+void ShapeBatch::Flush() {
+    if (m_Instances.empty()) return;
+    if (!m_CurrentShader) {
+        Logger::Error("ShapeBatch::Flush - No shader bound!", this);
+        return;
+    }
+    PROFILE_SCOPE("ShapeBatch::Flush");
+
+    // Sprites may have been drawn in between; both are no-ops otherwise
+    m_CurrentShader->Bind();
+    GLStateCache::BindVertexArray(m_VAO);
+
+    // Orphan the buffer so a second flush in the same frame does not wait on the first draw
+    GLStateCache::BindBuffer(GL_ARRAY_BUFFER, m_InstanceVBO);
+    glBufferData(GL_ARRAY_BUFFER, MaxShapes * sizeof(ShapeInstance), nullptr, GL_STREAM_DRAW);
+    glBufferSubData(GL_ARRAY_BUFFER, 0, m_Instances.size() * sizeof(ShapeInstance), m_Instances.data());
+
+    glDrawElementsInstanced(GL_TRIANGLES, 6, GL_UNSIGNED_INT, 0, (GLsizei)m_Instances.size());
+    m_Instances.clear();
+}
@@ -0,0 +1,49 @@
+#pragma once
+
+#include <vector>
+#include <glm/glm.hpp>
+
+#include "Shader.h"
+
+enum class ShapeType {
+    Circle = 0,         // Disc, or a ring when thickness > 0
+    Capsule = 1,        // Segment with round caps (halfSize.x includes the cap radius)
+    RoundedRect = 2     // Box with rounded corners, outline when thickness > 0 (also AA lines)
+};
+
+#pragma pack(push, 1)
+struct ShapeInstance {
+    glm::vec2 position;     // Center
+    glm::vec2 halfSize;     // Shape extents before feathering
+    float rotation;
+    glm::vec4 color;
+    float radius;           // Circle / capsule radius
+    float thickness;        // 0 = filled, otherwise stroke width measured inwards
+    float cornerRadius;     // Rounded rects
+    float feather;          // Extra edge softness on top of the 1px anti-aliasing
+    float shapeType;        // ShapeType
+};
+#pragma pack(pop)
+
+// Instanced signed-distance shapes: every circle, ring, capsule, line or rounded rect is
+// one quad whose coverage the fragment shader computes from the shape's distance field.
+class ShapeBatch {
+public:
+    static constexpr size_t MaxShapes = 8192;
+
+    ShapeBatch();
+    ~ShapeBatch();
+
+    void Begin(Shader* shader);
+    void Add(const ShapeInstance& instance);
+    void End();
+    void Flush();
+
+    bool IsEmpty() const { return m_Instances.empty(); }
+
+private:
+    std::vector<ShapeInstance> m_Instances;
+    Shader* m_CurrentShader = nullptr;
+    unsigned int m_VAO, m_InstanceVBO;
+    void SetupBuffers();
+};
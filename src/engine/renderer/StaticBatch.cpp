@@ -0,0 +1,187 @@
+#include "StaticBatch.h"
+#include "GLStateCache.h"
+#include <glad/glad.h>
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <engine/utils/Profiler.h>
+
+StaticBatch::StaticBatch(float chunkSize)
+    : m_ChunkSize(std::max(chunkSize, 1.0f)), m_Count(0)
+{
+    QuadBatch::AcquireUnitQuad();
+}
+
+StaticBatch::~StaticBatch() {
+    for (auto& [key, chunk] : m_Chunks) {
+        DestroyChunk(chunk);
+    }
+    QuadBatch::ReleaseUnitQuad();
+}
+
+StaticQuadHandle StaticBatch::Add(const QuadInstance& instance) {
+    StaticQuadHandle handle;
+    if (!m_FreeHandles.empty()) {
+        handle = m_FreeHandles.back();
+        m_FreeHandles.pop_back();
+    } else {
+        handle = (StaticQuadHandle)m_Locations.size();
+        m_Locations.emplace_back();
+    }
+
+    Insert(handle, instance);
+    m_Count++;
+    return handle;
+}
+
+bool StaticBatch::Update(StaticQuadHandle handle, const QuadInstance& instance) {
+    if (handle >= m_Locations.size() || !m_Locations[handle].valid) return false;
+
+    Location& location = m_Locations[handle];
+    Chunk& chunk = m_Chunks[location.chunk];
+    QuadInstance& current = chunk.instances[location.index];
+    if (std::memcmp(&current, &instance, sizeof(QuadInstance)) == 0) return true;
+
+    if (ChunkOf(instance.position) == location.chunk) {
+        current = instance;
+        chunk.dirty = true;
+    } else {
+        Erase(handle);
+        Insert(handle, instance);
+    }
+    return true;
+}
+
+bool StaticBatch::Remove(StaticQuadHandle handle) {
+    if (handle >= m_Locations.size() || !m_Locations[handle].valid) return false;
+
+    Erase(handle);
+    m_FreeHandles.push_back(handle);
+    m_Count--;
+    return true;
+}
+
+void StaticBatch::Clear() {
+    for (auto& [key, chunk] : m_Chunks) {
+        DestroyChunk(chunk);
+    }
+    m_Chunks.clear();
+    m_Locations.clear();
+    m_FreeHandles.clear();
+    m_Count = 0;
+}
+
+void StaticBatch::Draw(const glm::vec2& viewMin, const glm::vec2& viewMax) {
+    PROFILE_SCOPE("StaticBatch::Draw");
+    m_Stats = StaticBatchStats();
+
+    for (auto it = m_Chunks.begin(); it != m_Chunks.end();) {
+        Chunk& chunk = it->second;
+        if (chunk.dirty) {
+            if (chunk.instances.empty()) {
+                DestroyChunk(chunk);
+                it = m_Chunks.erase(it);
+                continue;
+            }
+            Rebuild(chunk);
+            m_Stats.rebuiltChunks++;
+            m_Stats.uploadedBytes += chunk.instances.size() * sizeof(QuadInstance);
+        }
+        m_Stats.chunks++;
+
+        if (chunk.boundsMax.x >= viewMin.x && chunk.boundsMin.x <= viewMax.x &&
+            chunk.boundsMax.y >= viewMin.y && chunk.boundsMin.y <= viewMax.y) {
+            GLStateCache::BindVertexArray(chunk.vao);
+            glDrawElementsInstanced(GL_TRIANGLES, 6, GL_UNSIGNED_INT, 0, (GLsizei)chunk.uploadedCount);
+            m_Stats.visibleChunks++;
+            m_Stats.drawnQuads += (int)chunk.uploadedCount;
+        }
+        ++it;
+    }
+}
+
+uint64_t StaticBatch::ChunkOf(const glm::vec2& position) const {
+    int x = (int)std::floor(position.x / m_ChunkSize);
+    int y = (int)std::floor(position.y / m_ChunkSize);
+    return ((uint64_t)(uint32_t)x << 32) | (uint64_t)(uint32_t)y;
+}
+
+void StaticBatch::Insert(StaticQuadHandle handle, const QuadInstance& instance) {
+    uint64_t key = ChunkOf(instance.position);
+    Chunk& chunk = m_Chunks[key];
+
+    Location& location = m_Locations[handle];
+    location.chunk = key;
+    location.index = (uint32_t)chunk.instances.size();
+    location.valid = true;
+
+    chunk.instances.push_back(instance);
+    chunk.handles.push_back(handle);
+    chunk.dirty = true;
+}
+
+void StaticBatch::Erase(StaticQuadHandle handle) {
+    Location& location = m_Locations[handle];
+    Chunk& chunk = m_Chunks[location.chunk];
+
+    // Swap-remove and patch the moved quad's location
+    uint32_t last = (uint32_t)chunk.instances.size() - 1;
+    if (location.index != last) {
+        chunk.instances[location.index] = chunk.instances[last];
+        chunk.handles[location.index] = chunk.handles[last];
+        m_Locations[chunk.handles[location.index]].index = location.index;
+    }
+    chunk.instances.pop_back();
+    chunk.handles.pop_back();
+    chunk.dirty = true;
+
+    location.valid = false;
+}
+
+void StaticBatch::Rebuild(Chunk& chunk) {
+    // Bounds cover rotated quads too, since they may reach into neighbouring chunks
+    chunk.boundsMin = glm::vec2(INFINITY);
+    chunk.boundsMax = glm::vec2(-INFINITY);
+    for (const auto& instance : chunk.instances) {
+        glm::vec2 halfExtents = glm::abs(instance.size) * 0.5f;
+        if (instance.rotation != 0.0f) {
+            float c = std::abs(std::cos(instance.rotation));
+            float s = std::abs(std::sin(instance.rotation));
+            halfExtents = glm::vec2(c * halfExtents.x + s * halfExtents.y, s * halfExtents.x + c * halfExtents.y);
+        }
+        chunk.boundsMin = glm::min(chunk.boundsMin, instance.position - halfExtents);
+        chunk.boundsMax = glm::max(chunk.boundsMax, instance.position + halfExtents);
+    }
+
+    if (chunk.vao == 0) {
+        glGenVertexArrays(1, &chunk.vao);
+        GLStateCache::BindVertexArray(chunk.vao);
+
+        QuadBatch::SetupQuadAttributes();
+
+        glGenBuffers(1, &chunk.instanceVBO);
+        GLStateCache::BindBuffer(GL_ARRAY_BUFFER, chunk.instanceVBO);
+        QuadBatch::SetupInstanceAttributes();
+    } else {
+        GLStateCache::BindBuffer(GL_ARRAY_BUFFER, chunk.instanceVBO);
+    }
+
+    // Fresh storage every rebuild: the driver never has to synchronize with earlier draws
+    glBufferData(GL_ARRAY_BUFFER, chunk.instances.size() * sizeof(QuadInstance), chunk.instances.data(), GL_STATIC_DRAW);
+    chunk.uploadedCount = chunk.instances.size();
+    chunk.dirty = false;
+}
+
+void StaticBatch::DestroyChunk(Chunk& chunk) {
+    if (chunk.vao) {
+        GLStateCache::OnVertexArrayDeleted(chunk.vao);
+        glDeleteVertexArrays(1, &chunk.vao);
+    }
+    if (chunk.instanceVBO) {
+        GLStateCache::OnBufferDeleted(chunk.instanceVBO);
+        glDeleteBuffers(1, &chunk.instanceVBO);
+    }
+    chunk.vao = 0;
+    chunk.instanceVBO = 0;
+    chunk.uploadedCount = 0;
+}
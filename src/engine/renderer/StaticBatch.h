@@ -0,0 +1,70 @@
+#pragma once
+#include <glm/glm.hpp>
+#include <vector>
+#include <unordered_map>
+#include <cstdint>
+#include "QuadBatch.h"
+
+using StaticQuadHandle = uint32_t;
+static constexpr StaticQuadHandle InvalidStaticQuadHandle = 0xFFFFFFFF;
+
+struct StaticBatchStats {
+    int chunks = 0;
+    int visibleChunks = 0;
+    int rebuiltChunks = 0;      // Last Draw()
+    int drawnQuads = 0;
+    size_t uploadedBytes = 0;   // Last Draw(); zero while nothing changes
+};
+
+// Quads that do not move (level geometry, obstacles) baked into per-chunk GPU buffers.
+// Quads are assigned to a chunk by their center; editing a quad only marks its chunk
+// dirty, and Draw() re-uploads dirty chunks before drawing each visible chunk with a
+// single instanced call. Uses the QuadInstance layout, so any QuadBatch shader works.
+class StaticBatch {
+public:
+    StaticBatch(float chunkSize = 512.0f);
+    ~StaticBatch();
+
+    // Editing
+    StaticQuadHandle Add(const QuadInstance& instance);
+    bool Update(StaticQuadHandle handle, const QuadInstance& instance);   // Unchanged quads keep their chunk clean
+    bool Remove(StaticQuadHandle handle);
+    void Clear();
+
+    // Draws every chunk overlapping the view rect; the shader must be bound with its uniforms set
+    void Draw(const glm::vec2& viewMin, const glm::vec2& viewMax);
+
+    const StaticBatchStats& GetStats() const { return m_Stats; }
+    size_t GetCount() const { return m_Count; }
+    float GetChunkSize() const { return m_ChunkSize; }
+
+private:
+    struct Chunk {
+        std::vector<QuadInstance> instances;
+        std::vector<StaticQuadHandle> handles;    // Parallel to instances
+        glm::vec2 boundsMin{0.0f}, boundsMax{0.0f};
+        unsigned int vao = 0, instanceVBO = 0;
+        size_t uploadedCount = 0;
+        bool dirty = true;
+    };
+
+    struct Location {
+        uint64_t chunk = 0;
+        uint32_t index = 0;
+        bool valid = false;
+    };
+
+    float m_ChunkSize;
+    size_t m_Count;
+    std::unordered_map<uint64_t, Chunk> m_Chunks;   // Packed chunk coordinates -> chunk
+    std::vector<Location> m_Locations;              // Indexed by handle
+    std::vector<StaticQuadHandle> m_FreeHandles;
+    StaticBatchStats m_Stats;
+
+    // Helper functions
+    uint64_t ChunkOf(const glm::vec2& position) const;
+    void Insert(StaticQuadHandle handle, const QuadInstance& instance);
+    void Erase(StaticQuadHandle handle);
+    void Rebuild(Chunk& chunk);
+    void DestroyChunk(Chunk& chunk);
+};
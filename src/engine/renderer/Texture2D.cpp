@@ -1,26 +1,69 @@
 #include "Texture2D.h"
+#include "GLStateCache.h"
 #include <glad/glad.h>
 #define STB_IMAGE_IMPLEMENTATION
 #include <stb_image/stb_image.h>
+#include <engine/utils/Logger.h>
 
-Texture2D::Texture2D(const std::string& path) : Index(0) {
+Texture2D::Texture2D(const std::string& path, bool generateMipmaps)
+    : ID(0), Width(0), Height(0), Channels(0), Index(0), m_Path(path), m_OwnsTexture(true), m_Ready(true), m_Failed(false)
+{
     glGenTextures(1, &ID);
-    glBindTexture(GL_TEXTURE_2D, ID);
+    GLStateCache::BindTexture(ID);
 
-    stbi_set_flip_vertically_on_load(1);
+    stbi_set_flip_vertically_on_load_thread(1);
     unsigned char* data = stbi_load(path.c_str(), &Width, &Height, &Channels, 4);
-    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, Width, Height, 0, GL_RGBA, GL_UNSIGNED_BYTE, data);
+    if (!data) {
+        Logger::Error("Texture2D - failed to load " + path + ": " + std::string(stbi_failure_reason()), this);
+        static const unsigned char magenta[4] = { 255, 0, 255, 255 };
+        Width = Height = 1;
+        Channels = 4;
+        m_Failed = true;
+        generateMipmaps = false;
+        glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, 1, 1, 0, GL_RGBA, GL_UNSIGNED_BYTE, magenta);
+    } else {
+        glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, Width, Height, 0, GL_RGBA, GL_UNSIGNED_BYTE, data);
+        stbi_image_free(data);
+    }
 
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    if (generateMipmaps) {
+        glGenerateMipmap(GL_TEXTURE_2D);
+    }
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, generateMipmaps ? GL_LINEAR_MIPMAP_LINEAR : GL_LINEAR);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+}
+
+Texture2D::Texture2D(const std::string& path, unsigned int placeholder)
+    : ID(placeholder), Width(1), Height(1), Channels(4), Index(0), m_Path(path), m_OwnsTexture(false), m_Ready(false), m_Failed(false)
+{
+}
+
+Texture2D::~Texture2D() {
+    ReleaseTexture();
+}
+
+void Texture2D::AdoptTexture(unsigned int id, int width, int height) {
+    ReleaseTexture();
+    ID = id;
+    Width = width;
+    Height = height;
+    Channels = 4;
+    m_OwnsTexture = true;
+    m_Ready = true;
+}
 
-    stbi_image_free(data);
+void Texture2D::ReleaseTexture() {
+    if (m_OwnsTexture && ID) {
+        GLStateCache::OnTextureDeleted(ID);
+        glDeleteTextures(1, &ID);
+    }
+    ID = 0;
+    m_OwnsTexture = false;
 }
-Texture2D::~Texture2D() { glDeleteTextures(1, &ID); }
+
 void Texture2D::Bind(unsigned int slot) const {
-    glActiveTexture(GL_TEXTURE0 + slot);
-    glBindTexture(GL_TEXTURE_2D, ID);
+    GLStateCache::BindTexture(slot, ID);
 }
-void Texture2D::Unbind() const { glBindTexture(GL_TEXTURE_2D, 0); }
\ No newline at end of file
+void Texture2D::Unbind() const { GLStateCache::BindTexture(0); }
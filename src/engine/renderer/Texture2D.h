@@ -7,7 +7,9 @@ public:
     int Width, Height, Channels;
     int Index; // Texture slot index
 
-    Texture2D(const std::string& path);
+    // Synchronous load; falls back to a 1x1 magenta texture if the file can't be decoded.
+    // Prefer TextureLoader::Load for anything loaded while the game is running.
+    Texture2D(const std::string& path, bool generateMipmaps = false);
     ~Texture2D();
 
     void Bind(unsigned int slot = 0) const;
@@ -16,4 +18,21 @@ public:
     // Get the texture index for shader use
     int GetIndex() const { return Index; }
     void SetIndex(int index) { Index = index; }
-};
\ No newline at end of file
+
+    // False while an asynchronous load still shows the placeholder
+    bool IsReady() const { return m_Ready; }
+    bool HasFailed() const { return m_Failed; }
+    const std::string& GetPath() const { return m_Path; }
+
+private:
+    friend class TextureLoader;
+
+    std::string m_Path;
+    bool m_OwnsTexture;     // False while ID is the loader's shared placeholder
+    bool m_Ready, m_Failed;
+
+    // Pending texture that shows the given placeholder until TextureLoader swaps the real one in
+    Texture2D(const std::string& path, unsigned int placeholder);
+    void AdoptTexture(unsigned int id, int width, int height);
+    void ReleaseTexture();
+};
@@ -0,0 +1,288 @@
+#include "TextureLoader.h"
+#include "GLStateCache.h"
+#include <glad/glad.h>
+#include <stb_image/stb_image.h>
+#include <algorithm>
+#include <condition_variable>
+#include <cstring>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+#include <engine/utils/Logger.h>
+#include <engine/utils/Profiler.h>
+#include <engine/utils/ResourcePath.h>
+
+namespace {
+    constexpr int MaxWorkers = 4;
+
+    struct DecodeJob {
+        Texture2D* texture;
+        std::string fullPath;
+        bool generateMipmaps;
+    };
+
+    struct DecodedImage {
+        Texture2D* texture;
+        unsigned char* pixels;      // RGBA8, nullptr if decoding failed
+        int width, height;
+        bool generateMipmaps;
+        std::string error;
+        unsigned int staging = 0;   // Texture being filled; swapped into the Texture2D once complete
+        int nextRow = 0;
+    };
+
+    // Shared with the workers
+    std::vector<std::thread> s_Workers;
+    std::mutex s_Mutex;
+    std::condition_variable s_JobReady;
+    std::deque<DecodeJob> s_Jobs;
+    std::deque<DecodedImage> s_Decoded;
+    bool s_Stopping = false;
+
+    // Render thread only
+    std::unordered_map<std::string, std::unique_ptr<Texture2D>> s_Textures;
+    std::deque<DecodedImage> s_Uploads;
+    unsigned int s_Placeholder = 0;
+    unsigned int s_StagingBuffers[TextureLoader::StagingBufferCount] = {};
+    GLsync s_StagingFences[TextureLoader::StagingBufferCount] = {};
+    int s_NextStaging = 0;
+    size_t s_UploadBudget = TextureLoader::DefaultUploadBudget;
+    TextureLoader::Stats s_Stats;
+
+    void WorkerLoop() {
+        stbi_set_flip_vertically_on_load_thread(1);
+
+        for (;;) {
+            DecodeJob job;
+            {
+                std::unique_lock<std::mutex> lock(s_Mutex);
+                s_JobReady.wait(lock, [] { return s_Stopping || !s_Jobs.empty(); });
+                if (s_Stopping) return;
+                job = std::move(s_Jobs.front());
+                s_Jobs.pop_front();
+            }
+
+            DecodedImage image{ job.texture, nullptr, 0, 0, job.generateMipmaps, std::string() };
+            int channels = 0;
+            image.pixels = stbi_load(job.fullPath.c_str(), &image.width, &image.height, &channels, 4);
+            if (!image.pixels) {
+                image.error = stbi_failure_reason() ? stbi_failure_reason() : "unknown error";
+            }
+
+            std::lock_guard<std::mutex> lock(s_Mutex);
+            s_Decoded.push_back(std::move(image));
+        }
+    }
+
+    void StartWorkers() {
+        unsigned int hardware = std::thread::hardware_concurrency();
+        int count = std::clamp((int)hardware - 1, 1, MaxWorkers);
+        s_Stopping = false;
+        for (int i = 0; i < count; i++) {
+            s_Workers.emplace_back(WorkerLoop);
+        }
+    }
+
+    void CreatePlaceholder() {
+        // Grey checkerboard, sampled with nearest filtering so it stays crisp at any size
+        static const unsigned char pixels[16] = {
+            160, 160, 160, 255,   96,  96,  96, 255,
+             96,  96,  96, 255,  160, 160, 160, 255
+        };
+        glGenTextures(1, &s_Placeholder);
+        GLStateCache::BindTexture(s_Placeholder);
+        glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, 2, 2, 0, GL_RGBA, GL_UNSIGNED_BYTE, pixels);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
+    }
+
+    void CreateStagingBuffers() {
+        glGenBuffers(TextureLoader::StagingBufferCount, s_StagingBuffers);
+        for (unsigned int buffer : s_StagingBuffers) {
+            GLStateCache::BindBuffer(GL_PIXEL_UNPACK_BUFFER, buffer);
+            glBufferData(GL_PIXEL_UNPACK_BUFFER, TextureLoader::StagingBufferSize, nullptr, GL_STREAM_DRAW);
+        }
+        GLStateCache::BindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+    }
+
+    // Next staging buffer whose previous upload the GPU has consumed, or 0 if it is still in flight
+    unsigned int AcquireStagingBuffer() {
+        GLsync& fence = s_StagingFences[s_NextStaging];
+        if (fence) {
+            GLenum status = glClientWaitSync(fence, 0, 0);
+            if (status == GL_TIMEOUT_EXPIRED) return 0;
+            glDeleteSync(fence);
+            fence = nullptr;
+        }
+        return s_StagingBuffers[s_NextStaging];
+    }
+
+    void ReleaseStagingBuffer() {
+        s_StagingFences[s_NextStaging] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+        s_NextStaging = (s_NextStaging + 1) % TextureLoader::StagingBufferCount;
+    }
+
+    void BeginUpload(DecodedImage& image) {
+        glGenTextures(1, &image.staging);
+        GLStateCache::BindTexture(image.staging);
+        glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, image.width, image.height, 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, image.generateMipmaps ? GL_LINEAR_MIPMAP_LINEAR : GL_LINEAR);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    }
+
+    // Copies the next rows of the image through a staging buffer; false if none was free
+    bool UploadRows(DecodedImage& image, size_t budget, size_t& uploaded) {
+        size_t rowBytes = (size_t)image.width * 4;
+        size_t maxRows = std::min(TextureLoader::StagingBufferSize, std::max(budget, rowBytes)) / rowBytes;
+        int rows = (int)std::min<size_t>(std::max<size_t>(maxRows, 1), (size_t)(image.height - image.nextRow));
+        size_t bytes = rowBytes * rows;
+
+        unsigned int buffer = AcquireStagingBuffer();
+        if (!buffer) return false;
+
+        GLStateCache::BindBuffer(GL_PIXEL_UNPACK_BUFFER, buffer);
+        void* mapped = glMapBufferRange(GL_PIXEL_UNPACK_BUFFER, 0, bytes,
+                                        GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_BUFFER_BIT | GL_MAP_UNSYNCHRONIZED_BIT);
+        if (!mapped) return false;
+        std::memcpy(mapped, image.pixels + rowBytes * image.nextRow, bytes);
+        glUnmapBuffer(GL_PIXEL_UNPACK_BUFFER);
+
+        GLStateCache::BindTexture(image.staging);
+        glTexSubImage2D(GL_TEXTURE_2D, 0, 0, image.nextRow, image.width, rows, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+        ReleaseStagingBuffer();
+
+        image.nextRow += rows;
+        uploaded += bytes;
+        return true;
+    }
+}
+
+Texture2D* TextureLoader::Load(const std::string& path, bool generateMipmaps) {
+    auto it = s_Textures.find(path);
+    if (it != s_Textures.end()) return it->second.get();
+
+    if (!s_Placeholder) {
+        CreatePlaceholder();
+        CreateStagingBuffers();
+    }
+    if (s_Workers.empty()) {
+        StartWorkers();
+    }
+
+    Texture2D* texture = new Texture2D(path, s_Placeholder);
+    s_Textures.emplace(path, std::unique_ptr<Texture2D>(texture));
+    s_Stats.pendingDecodes++;
+
+    {
+        std::lock_guard<std::mutex> lock(s_Mutex);
+        s_Jobs.push_back({ texture, ResourcePath::GetFullPath(path), generateMipmaps });
+    }
+    s_JobReady.notify_one();
+    return texture;
+}
+
+void TextureLoader::Update() {
+    s_Stats.bytesUploadedLastFrame = 0;
+    if (s_Textures.empty()) return;
+
+    PROFILE_SCOPE("TextureLoader::Update");
+    {
+        std::lock_guard<std::mutex> lock(s_Mutex);
+        while (!s_Decoded.empty()) {
+            s_Uploads.push_back(std::move(s_Decoded.front()));
+            s_Decoded.pop_front();
+            s_Stats.pendingDecodes--;
+        }
+    }
+
+    size_t uploaded = 0;
+    while (!s_Uploads.empty() && uploaded < s_UploadBudget) {
+        DecodedImage& image = s_Uploads.front();
+        if (!image.pixels) {
+            Logger::Error<std::string>("TextureLoader - failed to load " + image.texture->GetPath() + ": " + image.error);
+            image.texture->m_Failed = true;
+            s_Stats.failed++;
+            s_Uploads.pop_front();
+            continue;
+        }
+
+        if (!image.staging) {
+            BeginUpload(image);
+        }
+        if (!UploadRows(image, s_UploadBudget - uploaded, uploaded)) break;
+
+        if (image.nextRow == image.height) {
+            if (image.generateMipmaps) {
+                glGenerateMipmap(GL_TEXTURE_2D);
+            }
+            image.texture->AdoptTexture(image.staging, image.width, image.height);
+            stbi_image_free(image.pixels);
+            s_Uploads.pop_front();
+            s_Stats.loaded++;
+        }
+    }
+
+    // Everything else uploads from client memory
+    GLStateCache::BindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+
+    s_Stats.bytesUploadedLastFrame = uploaded;
+    s_Stats.pendingUploads = s_Uploads.size();
+}
+
+void TextureLoader::SetUploadBudget(size_t bytesPerFrame) {
+    s_UploadBudget = std::max<size_t>(bytesPerFrame, 1);
+}
+
+TextureLoader::Stats TextureLoader::GetStats() {
+    return s_Stats;
+}
+
+void TextureLoader::Shutdown() {
+    {
+        std::lock_guard<std::mutex> lock(s_Mutex);
+        s_Stopping = true;
+        s_Jobs.clear();
+    }
+    s_JobReady.notify_all();
+    for (std::thread& worker : s_Workers) {
+        worker.join();
+    }
+    s_Workers.clear();
+
+    for (std::deque<DecodedImage>* images : { &s_Decoded, &s_Uploads }) {
+        for (DecodedImage& image : *images) {
+            if (image.staging) {
+                GLStateCache::OnTextureDeleted(image.staging);
+                glDeleteTextures(1, &image.staging);
+            }
+            stbi_image_free(image.pixels);
+        }
+        images->clear();
+    }
+    s_Textures.clear();
+
+    for (int i = 0; i < StagingBufferCount; i++) {
+        if (s_StagingFences[i]) {
+            glDeleteSync(s_StagingFences[i]);
+            s_StagingFences[i] = nullptr;
+        }
+        if (s_StagingBuffers[i]) {
+            GLStateCache::OnBufferDeleted(s_StagingBuffers[i]);
+            glDeleteBuffers(1, &s_StagingBuffers[i]);
+            s_StagingBuffers[i] = 0;
+        }
+    }
+    if (s_Placeholder) {
+        GLStateCache::OnTextureDeleted(s_Placeholder);
+        glDeleteTextures(1, &s_Placeholder);
+        s_Placeholder = 0;
+    }
+    s_Stats = Stats();
+}
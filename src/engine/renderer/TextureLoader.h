@@ -0,0 +1,36 @@
+#pragma once
+#include <cstddef>
+#include <string>
+#include "Texture2D.h"
+
+// Asynchronous texture loading. Files are decoded by a small worker pool, then streamed to
+// the GPU from the render thread through a ring of pixel unpack buffers, at most
+// UploadBudget bytes per frame so a burst of loads never causes a hitch.
+// Until its upload finishes a texture shows a shared checkerboard placeholder.
+class TextureLoader {
+public:
+    static constexpr int StagingBufferCount = 3;
+    static constexpr size_t StagingBufferSize = 4 * 1024 * 1024;
+    static constexpr size_t DefaultUploadBudget = 8 * 1024 * 1024;
+
+    struct Stats {
+        size_t pendingDecodes = 0;
+        size_t pendingUploads = 0;
+        size_t bytesUploadedLastFrame = 0;
+        size_t loaded = 0;
+        size_t failed = 0;
+    };
+
+    // Path is relative to the resource directory. The texture is owned by the loader and
+    // cached, so loading the same path twice returns the same texture.
+    static Texture2D* Load(const std::string& path, bool generateMipmaps = true);
+
+    // Once per frame on the GL thread: uploads decoded images within the budget
+    static void Update();
+
+    static void SetUploadBudget(size_t bytesPerFrame);
+    static Stats GetStats();
+
+    // Joins the workers and releases every texture; call while the context is still current
+    static void Shutdown();
+};
@@ -1,19 +1,24 @@
 #include "FogRenderer2D.h"
 #include <glm/gtc/matrix_transform.hpp>
 #include <engine/utils/Logger.h>
+#include <engine/utils/Profiler.h>
 #include <algorithm>
 #include <cmath>
-#include "../vision/VisionRenderer2D.h" // For Obstacle struct
+#include "../../core/spatial/ObstacleWorld.h"
+#include "../shadow/ShadowMap2D.h"
 
 FogRenderer2D::FogRenderer2D(int windowWidth, int windowHeight)
-    : m_WindowWidth(windowWidth), m_WindowHeight(windowHeight), m_DebugMode(false)
+    : m_WindowWidth(windowWidth), m_WindowHeight(windowHeight), m_ObstacleWorld(nullptr), m_ShadowMap(nullptr),
+      m_VisibilityDirty(true), m_VisibilityRevision(0), m_DebugMode(false)
 {
     m_FogShader = new Shader("shaders/FogVertex.vert.glsl", "shaders/FogFrag.frag.glsl");
     m_QuadBatch = new QuadBatch();
+    m_OverlayTarget = new OverlayTarget2D(RenderTargetFormat::RGBA8);
     Logger::Info("Fog shader created with ID: " + std::to_string(m_FogShader->GetID()));
 }
 
 FogRenderer2D::~FogRenderer2D() {
+    delete m_OverlayTarget;
     delete m_QuadBatch;
     delete m_FogShader;
 }
@@ -25,6 +30,18 @@ void FogRenderer2D::DrawFogQuad(const glm::vec2& playerPos, const glm::vec2& pla
 }
 
 void FogRenderer2D::DrawFogQuad(const glm::vec2& playerPos, const FogConfig& config) {
+    // Shade at the configured scale; composited back in OverlayTarget2D::End()
+    bool scaled = m_OverlayTarget->Begin(m_WindowWidth, m_WindowHeight, config.renderScale);
+    
+    ShadeFog(playerPos, config);
+    
+    if (scaled) {
+        m_OverlayTarget->End();
+    }
+}
+
+void FogRenderer2D::ShadeFog(const glm::vec2& playerPos, const FogConfig& config) {
+    PROFILE_SCOPE("FogRenderer2D::ShadeFog");
     // Start the quad batch with our fog shader
     m_QuadBatch->Begin(m_FogShader);
     
@@ -40,7 +57,7 @@ void FogRenderer2D::DrawFogQuad(const glm::vec2& playerPos, const FogConfig& con
     // Create a quad that covers the entire screen - NO ROTATION
     QuadInstance fogInstance;
     fogInstance.position = glm::vec2(m_WindowWidth * 0.5f, m_WindowHeight * 0.5f);
-    fogInstance.size = glm::vec2(m_WindowWidth + 100.0f, m_WindowHeight + 100.0f); // Slightly larger to ensure full coverage
+    fogInstance.size = glm::vec2((float)m_WindowWidth, (float)m_WindowHeight); // Exactly covers the window
     fogInstance.rotation = 0.0f; // No rotation
     fogInstance.color = glm::vec4(1.0f); // White color (fog color handled in shader)
     fogInstance.texIndex = 0.0f;
@@ -61,22 +78,21 @@ void FogRenderer2D::DrawFogQuad(const glm::vec2& playerPos, float radius, float
     DrawFogQuad(playerPos, legacyConfig);
 }
 
-void FogRenderer2D::AddObstacle(const glm::vec2& position, const glm::vec2& size) {
-    m_Obstacles.emplace_back(position, size);
+void FogRenderer2D::SetObstacleWorld(const ObstacleWorld* world) {
+    m_ObstacleWorld = world;
+    m_VisibilityDirty = true;
 }
 
-void FogRenderer2D::AddObstacles(const std::vector<Obstacle>& obstacles) {
-    m_Obstacles.insert(m_Obstacles.end(), obstacles.begin(), obstacles.end());
+const ObstacleWorld* FogRenderer2D::GetObstacleWorld() const {
+    return m_ObstacleWorld;
 }
 
-void FogRenderer2D::ClearObstacles() {
-    m_Obstacles.clear();
+void FogRenderer2D::SetShadowMap(ShadowMap2D* shadowMap) {
+    m_ShadowMap = shadowMap;
 }
 
-void FogRenderer2D::RemoveObstacle(size_t index) {
-    if (index < m_Obstacles.size()) {
-        m_Obstacles.erase(m_Obstacles.begin() + index);
-    }
+ShadowMap2D* FogRenderer2D::GetShadowMap() const {
+    return m_ShadowMap;
 }
 
 void FogRenderer2D::SetFogConfig(const FogConfig& config) {
@@ -105,17 +121,9 @@ float FogRenderer2D::GetVisibilityAtPosition(const glm::vec2& position, const gl
     float distance = glm::length(position - playerPos);
     if (distance > config.range) return 0.0f;
     
-    // 2. Check line of sight (omnidirectional)
-    glm::vec2 rayDir = glm::normalize(position - playerPos);
-    float rayLength = distance;
-    
-    for (const auto& obstacle : m_Obstacles) {
-        float hitDistance;
-        if (RayIntersectsBox(playerPos, rayDir, obstacle.position, obstacle.size, hitDistance)) {
-            if (hitDistance < rayLength) {
-                return 0.0f; // Blocked by obstacle
-            }
-        }
+    // 2. Check line of sight (omnidirectional) against the cached visibility polygon
+    if (!GetVisibilityPolygon(playerPos, config.range).Contains(position)) {
+        return 0.0f; // Blocked by obstacle
     }
     
     // 3. Apply distance falloff
@@ -123,6 +131,20 @@ float FogRenderer2D::GetVisibilityAtPosition(const glm::vec2& position, const gl
     return falloff;
 }
 
+const VisibilityPolygon2D& FogRenderer2D::GetVisibilityPolygon(const glm::vec2& playerPos, float range) const {
+    uint32_t revision = m_ObstacleWorld ? m_ObstacleWorld->GetRevision() : 0;
+    if (m_VisibilityDirty || revision != m_VisibilityRevision || !m_VisibilityPolygon.IsBuiltFor(playerPos, range)) {
+        if (m_ObstacleWorld) {
+            m_VisibilityPolygon.Build(playerPos, range, *m_ObstacleWorld);
+        } else {
+            m_VisibilityPolygon.Build(playerPos, range, std::vector<Obstacle>());
+        }
+        m_VisibilityRevision = revision;
+        m_VisibilityDirty = false;
+    }
+    return m_VisibilityPolygon;
+}
+
 void FogRenderer2D::SetDebugMode(bool enabled) {
     m_DebugMode = enabled;
 }
@@ -132,7 +154,8 @@ void FogRenderer2D::DrawObstaclesDebug() {
     
     // This method can be used with a separate debug renderer if needed
     // For now, we'll rely on the shader's debug visualization
-    Logger::Info("Drawing " + std::to_string(m_Obstacles.size()) + " obstacles");
+    size_t obstacleCount = m_ObstacleWorld ? m_ObstacleWorld->GetCount() : 0;
+    Logger::Info("Drawing " + std::to_string(obstacleCount) + " obstacles");
 }
 
 void FogRenderer2D::UpdateShaderUniforms(const glm::vec2& playerPos, const FogConfig& config) {
@@ -144,42 +167,13 @@ void FogRenderer2D::UpdateShaderUniforms(const glm::vec2& playerPos, const FogCo
     // Shadow parameters
     m_FogShader->SetFloat("uShadowSoftness", config.shadowSoftness);
     
-    // Obstacle parameters
-    int obstacleCount = std::min((int)m_Obstacles.size(), 32); // Limit to 32 obstacles
-    m_FogShader->SetInt("uObstacleCount", obstacleCount);
-    
-    // Set obstacle positions and sizes
-    for (int i = 0; i < obstacleCount; i++) {
-        std::string posUniform = "uObstacles[" + std::to_string(i) + "]";
-        std::string sizeUniform = "uObstacleSizes[" + std::to_string(i) + "]";
-        
-        m_FogShader->SetVec2(posUniform, m_Obstacles[i].position);
-        m_FogShader->SetVec2(sizeUniform, m_Obstacles[i].size);
+    // Occlusion parameters - the player is one caster in the shared occlusion map
+    int playerRow = -1;
+    if (m_ShadowMap) {
+        playerRow = m_ShadowMap->RequestCaster(playerPos);
+        m_ShadowMap->ApplyUniforms(m_FogShader);
     }
-}
-
-bool FogRenderer2D::RayIntersectsBox(const glm::vec2& rayStart, const glm::vec2& rayDir, 
-                                    const glm::vec2& boxCenter, const glm::vec2& boxSize, 
-                                    float& hitDistance) const {
-    glm::vec2 boxMin = boxCenter - boxSize * 0.5f;
-    glm::vec2 boxMax = boxCenter + boxSize * 0.5f;
-    
-    // Handle division by zero
-    glm::vec2 invDir;
-    invDir.x = (rayDir.x != 0.0f) ? 1.0f / rayDir.x : 1e30f;
-    invDir.y = (rayDir.y != 0.0f) ? 1.0f / rayDir.y : 1e30f;
-    
-    glm::vec2 t1 = (boxMin - rayStart) * invDir;
-    glm::vec2 t2 = (boxMax - rayStart) * invDir;
-    
-    glm::vec2 tMin = glm::min(t1, t2);
-    glm::vec2 tMax = glm::max(t1, t2);
-    
-    float tNear = std::max(tMin.x, tMin.y);
-    float tFar = std::min(tMax.x, tMax.y);
-    
-    hitDistance = tNear;
-    return tNear >= 0.0f && tNear <= tFar;
+    m_FogShader->SetInt("uPlayerShadowRow", playerRow);
 }
 
 bool FogRenderer2D::IsInVisionCone(const glm::vec2& worldPos, const glm::vec2& playerPos, 
@@ -3,15 +3,19 @@
 #include <vector>
 #include "../QuadBatch.h"
 #include "../Shader.h"
+#include "../OverlayTarget2D.h"
+#include "../../core/spatial/VisibilityPolygon2D.h"
 
-// Forward declaration for obstacles
-struct Obstacle;
+// Forward declarations
+class ObstacleWorld;
+class ShadowMap2D;
 
 // Structure to hold fog parameters (Guards and Thieves style)
 struct FogConfig {
     float range = 400.0f;           // Maximum visibility distance
     float shadowSoftness = 0.3f;    // Edge softness for shadows behind obstacles
     glm::vec4 fogColor = glm::vec4(0.0f, 0.0f, 0.0f, 0.85f); // Color for dark/blocked areas
+    float renderScale = 1.0f;       // Overlay resolution scale (1.0 full, 0.5 half, 0.25 quarter)
 };
 
 class FogRenderer2D {
@@ -28,12 +32,17 @@ public:
     
     // Legacy function for backward compatibility (omnidirectional fog)
     void DrawFogQuad(const glm::vec2& playerPos, float radius, float softness, const glm::vec4& fogColor);
+    
+    // Shades the fog into the bound target as-is (no scaling or compositing - the render graph does that)
+    void ShadeFog(const glm::vec2& playerPos, const FogConfig& config);
 
-    // Obstacle management (for shadow casting)
-    void AddObstacle(const glm::vec2& position, const glm::vec2& size);
-    void AddObstacles(const std::vector<Obstacle>& obstacles);
-    void ClearObstacles();
-    void RemoveObstacle(size_t index);
+    // Shared obstacle set (for shadow casting - nothing blocks sight when none is set)
+    void SetObstacleWorld(const ObstacleWorld* world);
+    const ObstacleWorld* GetObstacleWorld() const;
+    
+    // Shared occlusion map (line of sight is skipped when none is set)
+    void SetShadowMap(ShadowMap2D* shadowMap);
+    ShadowMap2D* GetShadowMap() const;
     
     // Fog configuration
     void SetFogConfig(const FogConfig& config);
@@ -48,6 +57,9 @@ public:
     float GetVisibilityAtPosition(const glm::vec2& position, const glm::vec2& playerPos, 
                                  const glm::vec2& playerDirection, const FogConfig& config) const;
     
+    // Visibility polygon around the player, rebuilt only when the player, range or obstacles change
+    const VisibilityPolygon2D& GetVisibilityPolygon(const glm::vec2& playerPos, float range) const;
+    
     // Debug functions
     void SetDebugMode(bool enabled);
     void DrawObstaclesDebug();
@@ -56,6 +68,7 @@ private:
     // Core rendering components
     QuadBatch* m_QuadBatch;
     Shader* m_FogShader;
+    OverlayTarget2D* m_OverlayTarget;
     
     // Window properties
     int m_WindowWidth, m_WindowHeight;
@@ -64,16 +77,19 @@ private:
     FogConfig m_Config;
     
     // Obstacles
-    std::vector<Obstacle> m_Obstacles;
+    const ObstacleWorld* m_ObstacleWorld;
+    ShadowMap2D* m_ShadowMap;
+    
+    // Cached line of sight for CPU queries
+    mutable VisibilityPolygon2D m_VisibilityPolygon;
+    mutable bool m_VisibilityDirty;
+    mutable uint32_t m_VisibilityRevision; // Obstacle world revision the polygon was built from
     
     // Debug mode
     bool m_DebugMode;
     
     // Helper functions
     void UpdateShaderUniforms(const glm::vec2& playerPos, const FogConfig& config);
-    bool RayIntersectsBox(const glm::vec2& rayStart, const glm::vec2& rayDir, 
-                         const glm::vec2& boxCenter, const glm::vec2& boxSize, 
-                         float& hitDistance) const;
     bool IsInVisionCone(const glm::vec2& worldPos, const glm::vec2& playerPos, 
                        const glm::vec2& playerDir, float visionAngle) const;
 };
\ No newline at end of file
@@ -19,6 +19,7 @@ struct Light {
     float innerAngle;              // Inner cone angle in radians (for spot lights)
     float outerAngle;              // Outer cone angle in radians (for spot lights)
     float bloom;                   // Bloom effect intensity
+    bool isStatic = false;         // Never moves - baked into the cached lightmap instead of shaded every frame
     
     // Deprecated field - kept for compatibility but use type instead
     bool isDirectional;
@@ -87,4 +88,5 @@ struct LightConfig {
     bool enableShadows = true;                        // Enable/disable shadow casting
     float bloom = 0.0f;                               // Global bloom effect intensity (0.0 to 1.0)
     LightType lightType = LightType::POINT_LIGHT;     // Default light type for new lights
+    float renderScale = 1.0f;                         // Overlay resolution scale (1.0 full, 0.5 half, 0.25 quarter)
 }; 
\ No newline at end of file
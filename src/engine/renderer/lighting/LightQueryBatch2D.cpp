@@ -0,0 +1,278 @@
+#include "LightQueryBatch2D.h"
+#include <glm/gtc/constants.hpp>
+#include <algorithm>
+#include <cmath>
+#include "../../core/spatial/ObstacleWorld.h"
+
+static_assert(sizeof(glm::vec2) == 2 * sizeof(float), "Query positions are loaded as packed float pairs");
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define PRISM_LIGHT_QUERY_SSE 1
+#include <emmintrin.h>
+#else
+#define PRISM_LIGHT_QUERY_SSE 0
+#endif
+
+namespace {
+    constexpr float BlockedAttenuation = 0.1f; // Matches the single point query
+
+    float Smoothstep(float edge0, float edge1, float x) {
+        float t = std::min(std::max((x - edge0) / std::max(edge1 - edge0, 1e-6f), 0.0f), 1.0f);
+        return t * t * (3.0f - 2.0f * t);
+    }
+
+#if PRISM_LIGHT_QUERY_SSE
+    // Fast log2/exp2 (relative error around 1e-4), used for the attenuation power curve
+    inline __m128 Log2(__m128 x) {
+        __m128i bits = _mm_castps_si128(x);
+        __m128 y = _mm_mul_ps(_mm_cvtepi32_ps(bits), _mm_set1_ps(1.1920928955078125e-7f));
+        __m128 mantissa = _mm_castsi128_ps(_mm_or_si128(
+            _mm_and_si128(bits, _mm_set1_epi32(0x007FFFFF)), _mm_set1_epi32(0x3F000000)));
+        y = _mm_sub_ps(y, _mm_set1_ps(124.22551499f));
+        y = _mm_sub_ps(y, _mm_mul_ps(_mm_set1_ps(1.498030302f), mantissa));
+        return _mm_sub_ps(y, _mm_div_ps(_mm_set1_ps(1.72587999f), _mm_add_ps(_mm_set1_ps(0.3520887068f), mantissa)));
+    }
+
+    inline __m128 Exp2(__m128 p) {
+        __m128 offset = _mm_and_ps(_mm_cmplt_ps(p, _mm_setzero_ps()), _mm_set1_ps(1.0f));
+        __m128 clipped = _mm_max_ps(p, _mm_set1_ps(-126.0f));
+        __m128 fraction = _mm_add_ps(_mm_sub_ps(clipped, _mm_cvtepi32_ps(_mm_cvttps_epi32(clipped))), offset);
+        __m128 v = _mm_add_ps(clipped, _mm_set1_ps(121.2740575f));
+        v = _mm_add_ps(v, _mm_div_ps(_mm_set1_ps(27.7280233f), _mm_sub_ps(_mm_set1_ps(4.84252568f), fraction)));
+        v = _mm_sub_ps(v, _mm_mul_ps(_mm_set1_ps(1.49012907f), fraction));
+        return _mm_castsi128_ps(_mm_cvttps_epi32(_mm_mul_ps(_mm_set1_ps(8388608.0f), v)));
+    }
+
+    // acos with a cubic polynomial (absolute error below 1e-4 radians)
+    inline __m128 Acos(__m128 x) {
+        __m128 signMask = _mm_set1_ps(-0.0f);
+        __m128 a = _mm_min_ps(_mm_andnot_ps(signMask, x), _mm_set1_ps(1.0f));
+        __m128 poly = _mm_set1_ps(-0.0187293f);
+        poly = _mm_add_ps(_mm_mul_ps(poly, a), _mm_set1_ps(0.0742610f));
+        poly = _mm_add_ps(_mm_mul_ps(poly, a), _mm_set1_ps(-0.2121144f));
+        poly = _mm_add_ps(_mm_mul_ps(poly, a), _mm_set1_ps(1.5707288f));
+        __m128 r = _mm_mul_ps(_mm_sqrt_ps(_mm_sub_ps(_mm_set1_ps(1.0f), a)), poly);
+        __m128 negative = _mm_cmplt_ps(x, _mm_setzero_ps());
+        __m128 reflected = _mm_sub_ps(_mm_set1_ps(glm::pi<float>()), r);
+        return _mm_or_ps(_mm_and_ps(negative, reflected), _mm_andnot_ps(negative, r));
+    }
+
+    inline __m128 Smoothstep(__m128 edge0, __m128 edge1, __m128 x) {
+        __m128 span = _mm_max_ps(_mm_sub_ps(edge1, edge0), _mm_set1_ps(1e-6f));
+        __m128 t = _mm_div_ps(_mm_sub_ps(x, edge0), span);
+        t = _mm_min_ps(_mm_max_ps(t, _mm_setzero_ps()), _mm_set1_ps(1.0f));
+        return _mm_mul_ps(_mm_mul_ps(t, t), _mm_sub_ps(_mm_set1_ps(3.0f), _mm_add_ps(t, t)));
+    }
+
+    inline __m128 Select(__m128 mask, __m128 a, __m128 b) {
+        return _mm_or_ps(_mm_and_ps(mask, a), _mm_andnot_ps(mask, b));
+    }
+#endif
+}
+
+LightQueryBatch2D::LightQueryBatch2D()
+    : m_World(nullptr), m_WorldRevision(0),
+      m_AmbientLight(0.0f), m_ShadowLength(0.0f), m_EnableShadows(false)
+{
+}
+
+void LightQueryBatch2D::Update(const std::vector<Light>& lights, const ObstacleWorld* world, const LightConfig& config) {
+    m_AmbientLight = config.ambientLight;
+    m_ShadowLength = config.shadowLength;
+    m_EnableShadows = config.enableShadows && world;
+
+    bool obstaclesChanged = world != m_World || (world && world->GetRevision() != m_WorldRevision);
+    m_World = world;
+    m_WorldRevision = world ? world->GetRevision() : 0;
+
+    // 1. Lights as structure of arrays
+    size_t lightCount = lights.size();
+    m_PosX.resize(lightCount); m_PosY.resize(lightCount);
+    m_DirX.resize(lightCount); m_DirY.resize(lightCount);
+    m_Range.resize(lightCount); m_Intensity.resize(lightCount);
+    m_CosInnerHalf.resize(lightCount); m_CosOuterHalf.resize(lightCount);
+    m_InnerHalf.resize(lightCount); m_OuterHalf.resize(lightCount);
+    m_Type.resize(lightCount);
+    m_PolygonIndex.resize(lightCount);
+
+    int polygonCount = 0;
+    for (size_t i = 0; i < lightCount; i++) {
+        const Light& light = lights[i];
+        m_PosX[i] = light.position.x;
+        m_PosY[i] = light.position.y;
+        m_DirX[i] = light.direction.x;
+        m_DirY[i] = light.direction.y;
+        m_Range[i] = light.range;
+        m_Intensity[i] = light.intensity;
+        m_Type[i] = light.type;
+
+        // Cone tests compare cosines; half angles past PI never reject anything
+        m_InnerHalf[i] = light.innerAngle * 0.5f;
+        m_OuterHalf[i] = light.outerAngle * 0.5f;
+        m_CosInnerHalf[i] = m_InnerHalf[i] >= glm::pi<float>() ? -2.0f : std::cos(m_InnerHalf[i]);
+        m_CosOuterHalf[i] = m_OuterHalf[i] >= glm::pi<float>() ? -2.0f : std::cos(m_OuterHalf[i]);
+
+        m_PolygonIndex[i] = -1;
+        if (m_EnableShadows && light.type != LightType::DIRECTIONAL_LIGHT) {
+            m_PolygonIndex[i] = polygonCount++;
+        }
+    }
+
+    // 2. Occlusion for point and spot lights - rebuilt only when a light or the obstacles move
+    if ((int)m_Polygons.size() < polygonCount) {
+        m_Polygons.resize(polygonCount);
+    }
+    for (size_t i = 0; i < lightCount; i++) {
+        int index = m_PolygonIndex[i];
+        if (index < 0) continue;
+
+        glm::vec2 position(m_PosX[i], m_PosY[i]);
+        VisibilityPolygon2D& polygon = m_Polygons[index];
+        if (obstaclesChanged || !polygon.IsBuiltFor(position, m_Range[i])) {
+            polygon.Build(position, m_Range[i], *world);
+        }
+    }
+}
+
+void LightQueryBatch2D::Evaluate(const glm::vec2* positions, size_t count, float* outIntensities) const {
+    std::fill(outIntensities, outIntensities + count, m_AmbientLight);
+
+    for (size_t light = 0; light < m_Type.size(); light++) {
+        if (m_Type[light] == LightType::DIRECTIONAL_LIGHT) {
+            EvaluateDirectionalLight(light, positions, count, outIntensities);
+        } else {
+            EvaluateLocalLight(light, positions, count, outIntensities);
+        }
+    }
+
+    for (size_t i = 0; i < count; i++) {
+        outIntensities[i] = std::min(outIntensities[i], 2.0f); // Clamp to reasonable values
+    }
+}
+
+void LightQueryBatch2D::EvaluateLocalLight(size_t light, const glm::vec2* positions, size_t count, float* outIntensities) const {
+    const VisibilityPolygon2D* polygon = m_PolygonIndex[light] >= 0 ? &m_Polygons[m_PolygonIndex[light]] : nullptr;
+
+#if PRISM_LIGHT_QUERY_SSE
+    const bool isSpot = m_Type[light] == LightType::SPOT_LIGHT;
+    const __m128 zero = _mm_setzero_ps();
+    const __m128 one = _mm_set1_ps(1.0f);
+    const __m128 lightX = _mm_set1_ps(m_PosX[light]);
+    const __m128 lightY = _mm_set1_ps(m_PosY[light]);
+    const __m128 range = _mm_set1_ps(m_Range[light]);
+    const __m128 edgeStart = _mm_set1_ps(m_Range[light] * 0.7f);
+    const __m128 intensity = _mm_set1_ps(m_Intensity[light]);
+
+    for (size_t base = 0; base < count; base += 4) {
+        size_t lanes = std::min<size_t>(4, count - base);
+
+        // Load four interleaved points and split them into x and y; a partial
+        // last block repeats its final point to fill the register
+        const glm::vec2* block = positions + base;
+        glm::vec2 tail[4];
+        if (lanes < 4) {
+            for (size_t lane = 0; lane < 4; lane++) {
+                tail[lane] = positions[base + std::min(lane, lanes - 1)];
+            }
+            block = tail;
+        }
+        __m128 xy01 = _mm_loadu_ps(&block[0].x);
+        __m128 xy23 = _mm_loadu_ps(&block[2].x);
+        __m128 dx = _mm_sub_ps(_mm_shuffle_ps(xy01, xy23, _MM_SHUFFLE(2, 0, 2, 0)), lightX);
+        __m128 dy = _mm_sub_ps(_mm_shuffle_ps(xy01, xy23, _MM_SHUFFLE(3, 1, 3, 1)), lightY);
+        __m128 distanceSq = _mm_add_ps(_mm_mul_ps(dx, dx), _mm_mul_ps(dy, dy));
+        __m128 distance = _mm_sqrt_ps(distanceSq);
+        __m128 inRange = _mm_cmple_ps(distance, range);
+
+        // attenuation = pow(edgeFalloff / (1 + 0.05d + 0.01d^2), 0.8)
+        __m128 falloff = _mm_add_ps(one, _mm_add_ps(_mm_mul_ps(_mm_set1_ps(0.05f), distance),
+                                                    _mm_mul_ps(_mm_set1_ps(0.01f), distanceSq)));
+        __m128 edge = _mm_sub_ps(one, Smoothstep(edgeStart, range, distance));
+        __m128 attenuation = _mm_div_ps(edge, falloff);
+        __m128 lit = _mm_and_ps(inRange, _mm_cmpgt_ps(attenuation, zero));
+        attenuation = Exp2(_mm_mul_ps(_mm_set1_ps(0.8f), Log2(_mm_max_ps(attenuation, _mm_set1_ps(1e-30f)))));
+
+        __m128 contribution = _mm_mul_ps(intensity, attenuation);
+
+        if (isSpot) {
+            // Cone test on cosines; only the falloff band needs the angle itself
+            __m128 nonZero = _mm_cmpgt_ps(distance, zero);
+            __m128 invDistance = _mm_and_ps(nonZero, _mm_div_ps(one, _mm_max_ps(distance, _mm_set1_ps(1e-12f))));
+            __m128 cosAngle = _mm_mul_ps(_mm_add_ps(_mm_mul_ps(dx, _mm_set1_ps(m_DirX[light])),
+                                                    _mm_mul_ps(dy, _mm_set1_ps(m_DirY[light]))), invDistance);
+            cosAngle = Select(nonZero, cosAngle, one); // At the light itself
+
+            __m128 insideInner = _mm_cmpge_ps(cosAngle, _mm_set1_ps(m_CosInnerHalf[light]));
+            __m128 insideOuter = _mm_cmpge_ps(cosAngle, _mm_set1_ps(m_CosOuterHalf[light]));
+            __m128 band = _mm_sub_ps(one, Smoothstep(_mm_set1_ps(m_InnerHalf[light]), _mm_set1_ps(m_OuterHalf[light]), Acos(cosAngle)));
+            __m128 spot = Select(insideInner, one, band);
+            lit = _mm_and_ps(lit, insideOuter);
+            contribution = _mm_mul_ps(contribution, spot);
+        }
+
+        contribution = _mm_and_ps(lit, contribution);
+
+        if (!polygon && lanes == 4) {
+            _mm_storeu_ps(outIntensities + base, _mm_add_ps(_mm_loadu_ps(outIntensities + base), contribution));
+            continue;
+        }
+
+        // Occlusion is a per-point polygon lookup
+        alignas(16) float results[4];
+        _mm_store_ps(results, contribution);
+        for (size_t lane = 0; lane < lanes; lane++) {
+            float value = results[lane];
+            if (value <= 0.0f) continue;
+            if (polygon && !polygon->Contains(positions[base + lane])) {
+                value *= BlockedAttenuation; // Heavily attenuate if blocked
+            }
+            outIntensities[base + lane] += value;
+        }
+    }
+#else
+    for (size_t i = 0; i < count; i++) {
+        float value = LocalLightScalar(light, positions[i]);
+        if (value <= 0.0f) continue;
+        if (polygon && !polygon->Contains(positions[i])) {
+            value *= BlockedAttenuation;
+        }
+        outIntensities[i] += value;
+    }
+#endif
+}
+
+void LightQueryBatch2D::EvaluateDirectionalLight(size_t light, const glm::vec2* positions, size_t count, float* outIntensities) const {
+    // Directional light: no distance attenuation (like sunlight), any hit blocks it completely
+    for (size_t i = 0; i < count; i++) {
+        if (m_EnableShadows && DirectionalBlocked(light, positions[i])) continue;
+        outIntensities[i] += m_Intensity[light];
+    }
+}
+
+float LightQueryBatch2D::LocalLightScalar(size_t light, const glm::vec2& position) const {
+    glm::vec2 toPoint(position.x - m_PosX[light], position.y - m_PosY[light]);
+    float distance = glm::length(toPoint);
+    if (distance > m_Range[light]) return 0.0f;
+
+    float attenuation = 1.0f / (1.0f + 0.05f * distance + 0.01f * distance * distance);
+    attenuation *= (1.0f - Smoothstep(m_Range[light] * 0.7f, m_Range[light], distance));
+    attenuation = std::pow(attenuation, 0.8f);
+
+    float spotAttenuation = 1.0f;
+    if (m_Type[light] == LightType::SPOT_LIGHT && distance > 0.0f) {
+        float cosAngle = (toPoint.x * m_DirX[light] + toPoint.y * m_DirY[light]) / distance;
+        if (cosAngle < m_CosOuterHalf[light]) return 0.0f;
+        if (cosAngle < m_CosInnerHalf[light]) {
+            float angle = std::acos(glm::clamp(cosAngle, -1.0f, 1.0f));
+            spotAttenuation = 1.0f - Smoothstep(m_InnerHalf[light], m_OuterHalf[light], angle);
+        }
+    }
+
+    return m_Intensity[light] * attenuation * spotAttenuation;
+}
+
+bool LightQueryBatch2D::DirectionalBlocked(size_t light, const glm::vec2& position) const {
+    // The ray goes from the point towards the light
+    glm::vec2 rayDir(-m_DirX[light], -m_DirY[light]);
+    return m_World->Raycast(position, rayDir, m_ShadowLength);
+}
@@ -0,0 +1,52 @@
+#pragma once
+#include <glm/glm.hpp>
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+#include "Light.h"
+#include "../../core/spatial/VisibilityPolygon2D.h"
+
+// Forward declaration for obstacles
+class ObstacleWorld;
+
+// CPU light queries for many points at once (AI perception, stealth checks).
+// Lights are kept as structure-of-arrays and evaluated four query points at a time
+// with SSE. Point and spot light occlusion uses a cached visibility polygon per light,
+// so each query is a binary search instead of a loop over every obstacle; directional
+// lights raycast through the ObstacleWorld grid.
+// Matches LightRenderer2D::CalculateLightContribution to within a small approximation error.
+class LightQueryBatch2D {
+public:
+    LightQueryBatch2D();
+
+    // Refreshes the light data; visibility polygons are only rebuilt for lights that
+    // moved or when the obstacle world changes. world may be null (no occlusion).
+    void Update(const std::vector<Light>& lights, const ObstacleWorld* world, const LightConfig& config);
+
+    // Total light intensity (ambient included, clamped to 2.0) at each position
+    void Evaluate(const glm::vec2* positions, size_t count, float* outIntensities) const;
+
+private:
+    // Light data (structure of arrays, one entry per light)
+    std::vector<float> m_PosX, m_PosY;
+    std::vector<float> m_DirX, m_DirY;
+    std::vector<float> m_Range, m_Intensity;
+    std::vector<float> m_CosInnerHalf, m_CosOuterHalf;   // Cone limits as cosines
+    std::vector<float> m_InnerHalf, m_OuterHalf;         // Cone limits in radians (falloff)
+    std::vector<LightType> m_Type;
+    std::vector<int> m_PolygonIndex;                     // Visibility polygon per light, -1 for directional
+
+    std::vector<VisibilityPolygon2D> m_Polygons;
+    const ObstacleWorld* m_World;
+    uint32_t m_WorldRevision;
+
+    float m_AmbientLight;
+    float m_ShadowLength;
+    bool m_EnableShadows;
+
+    // Helper functions
+    void EvaluateLocalLight(size_t light, const glm::vec2* positions, size_t count, float* outIntensities) const;
+    void EvaluateDirectionalLight(size_t light, const glm::vec2* positions, size_t count, float* outIntensities) const;
+    float LocalLightScalar(size_t light, const glm::vec2& position) const;
+    bool DirectionalBlocked(size_t light, const glm::vec2& position) const;
+};
@@ -1,24 +1,71 @@
 #include "LightRenderer2D.h"
+#include <glad/glad.h>
 #include <glm/gtc/matrix_transform.hpp>
 #include <engine/utils/Logger.h>
+#include <engine/utils/Profiler.h>
 #include <algorithm>
 #include <cmath>
-#include "../vision/VisionRenderer2D.h" // For Obstacle struct
+#include "../../core/spatial/ObstacleWorld.h"
+#include "../shadow/ShadowMap2D.h"
+#include "../GLStateCache.h"
 
 LightRenderer2D::LightRenderer2D(int windowWidth, int windowHeight)
-    : m_WindowWidth(windowWidth), m_WindowHeight(windowHeight), m_DebugMode(false)
+    : m_WindowWidth(windowWidth), m_WindowHeight(windowHeight), m_ObstacleWorld(nullptr), m_ShadowMap(nullptr),
+      m_BakedLightmap(nullptr), m_BakedShadowRevision(0), m_BakedObstacleWorld(nullptr), m_BakedObstacleRevision(0),
+      m_BakeValid(false), m_LightQueryDirty(true), m_LightQueryObstacleRevision(0), m_DebugMode(false)
 {
     m_LightShader = new Shader("shaders/LightVertex.vert.glsl", "shaders/LightFrag.frag.glsl");
     m_QuadBatch = new QuadBatch();
+    m_OverlayTarget = new OverlayTarget2D(RenderTargetFormat::RGBA16F);
     Logger::Info("Light shader created with ID: " + std::to_string(m_LightShader->GetID()));
 }
 
 LightRenderer2D::~LightRenderer2D() {
+    delete m_BakedLightmap;
+    delete m_OverlayTarget;
     delete m_QuadBatch;
     delete m_LightShader;
 }
 
 void LightRenderer2D::DrawLightingOverlay(const std::vector<Light>& lights, const LightConfig& config) {
+    // Shade at the configured scale; composited back in OverlayTarget2D::End()
+    // (the bake runs first so it does not land inside the overlay target)
+    PrepareLights(lights, config);
+    bool scaled = m_OverlayTarget->Begin(m_WindowWidth, m_WindowHeight, config.renderScale);
+    
+    ShadeLights(lights, config);
+    
+    if (scaled) {
+        m_OverlayTarget->End();
+    }
+}
+
+void LightRenderer2D::ShadeLightingOverlay(const std::vector<Light>& lights, const LightConfig& config) {
+    PROFILE_SCOPE("LightRenderer2D::ShadeLightingOverlay");
+    PrepareLights(lights, config);
+    ShadeLights(lights, config);
+}
+
+void LightRenderer2D::PrepareLights(const std::vector<Light>& lights, const LightConfig& config) {
+    // Split the lights: static ones come from the baked lightmap
+    m_StaticLights.clear();
+    m_DynamicLights.clear();
+    for (const auto& light : lights) {
+        if (light.isStatic) {
+            m_StaticLights.push_back(light);
+        } else {
+            m_DynamicLights.push_back(light);
+        }
+    }
+    
+    if (!m_StaticLights.empty()) {
+        BakeStaticLights(config);
+    }
+}
+
+void LightRenderer2D::ShadeLights(const std::vector<Light>& lights, const LightConfig& config) {
+    bool useBakedLightmap = !m_StaticLights.empty();
+    
     // Start the quad batch with our light shader
     m_QuadBatch->Begin(m_LightShader);
     
@@ -28,64 +75,72 @@ void LightRenderer2D::DrawLightingOverlay(const std::vector<Light>& lights, cons
     // Set basic uniforms
     m_LightShader->SetMat4("uProjection", projection);
     
-    // Update all shader uniforms
-    UpdateShaderUniforms(lights, config);
+    // Update all shader uniforms - with a baked lightmap only the dynamic lights are shaded
+    UpdateShaderUniforms(useBakedLightmap ? m_DynamicLights : lights, config);
     
-    // Create a quad that covers the entire screen
-    QuadInstance lightInstance;
-    lightInstance.position = glm::vec2(m_WindowWidth * 0.5f, m_WindowHeight * 0.5f);
-    lightInstance.size = glm::vec2(m_WindowWidth + 100.0f, m_WindowHeight + 100.0f); // Slightly larger for full coverage
-    lightInstance.rotation = 0.0f;
-    lightInstance.color = glm::vec4(1.0f); // White color (actual lighting handled in shader)
-    lightInstance.texIndex = 0.0f;
+    m_LightShader->SetBool("uUseBakedLightmap", useBakedLightmap);
+    m_LightShader->SetBool("uShowLightPositions", m_DebugMode);
+    if (useBakedLightmap) {
+        m_BakedLightmap->BindTexture(1); // Slot 0 holds the shadow map
+        m_LightShader->SetInt("uBakedLightmap", 1);
+        m_LightShader->SetVec2("uScreenSize", glm::vec2((float)m_WindowWidth, (float)m_WindowHeight));
+    }
     
-    m_QuadBatch->Add(lightInstance);
-    m_QuadBatch->End();
+    DrawFullscreenQuad();
 }
 
 void LightRenderer2D::AddLight(const Light& light) {
+    m_LightQueryDirty = true;
     m_Lights.push_back(light);
 }
 
 void LightRenderer2D::AddLights(const std::vector<Light>& lights) {
+    m_LightQueryDirty = true;
     m_Lights.insert(m_Lights.end(), lights.begin(), lights.end());
 }
 
 void LightRenderer2D::ClearLights() {
+    m_LightQueryDirty = true;
     m_Lights.clear();
 }
 
 void LightRenderer2D::RemoveLight(size_t index) {
     if (index < m_Lights.size()) {
+        m_LightQueryDirty = true;
         m_Lights.erase(m_Lights.begin() + index);
     }
 }
 
 void LightRenderer2D::UpdateLight(size_t index, const Light& light) {
     if (index < m_Lights.size()) {
+        m_LightQueryDirty = true;
         m_Lights[index] = light;
     }
 }
 
-void LightRenderer2D::AddObstacle(const glm::vec2& position, const glm::vec2& size) {
-    m_Obstacles.emplace_back(position, size);
+void LightRenderer2D::SetObstacleWorld(const ObstacleWorld* world) {
+    m_LightQueryDirty = true;
+    m_ObstacleWorld = world;
 }
 
-void LightRenderer2D::AddObstacles(const std::vector<Obstacle>& obstacles) {
-    m_Obstacles.insert(m_Obstacles.end(), obstacles.begin(), obstacles.end());
+const ObstacleWorld* LightRenderer2D::GetObstacleWorld() const {
+    return m_ObstacleWorld;
 }
 
-void LightRenderer2D::ClearObstacles() {
-    m_Obstacles.clear();
+void LightRenderer2D::SetShadowMap(ShadowMap2D* shadowMap) {
+    m_ShadowMap = shadowMap;
 }
 
-void LightRenderer2D::RemoveObstacle(size_t index) {
-    if (index < m_Obstacles.size()) {
-        m_Obstacles.erase(m_Obstacles.begin() + index);
-    }
+ShadowMap2D* LightRenderer2D::GetShadowMap() const {
+    return m_ShadowMap;
+}
+
+void LightRenderer2D::InvalidateBakedLighting() {
+    m_BakeValid = false;
 }
 
 void LightRenderer2D::SetLightConfig(const LightConfig& config) {
+    m_LightQueryDirty = true;
     m_Config = config;
 }
 
@@ -103,13 +158,22 @@ bool LightRenderer2D::IsPositionLit(const glm::vec2& position, float threshold)
 }
 
 float LightRenderer2D::GetLightIntensityAtPosition(const glm::vec2& position) const {
-    float totalIntensity = m_Config.ambientLight;
-    
-    for (const auto& light : m_Lights) {
-        totalIntensity += CalculateLightContribution(light, position);
+    float intensity = 0.0f;
+    GetLightIntensityAtPositions(&position, 1, &intensity);
+    return intensity;
+}
+
+void LightRenderer2D::GetLightIntensityAtPositions(const glm::vec2* positions, size_t count, float* outIntensities) const {
+    RefreshLightQuery();
+    m_LightQuery.Evaluate(positions, count, outIntensities);
+}
+
+void LightRenderer2D::ArePositionsLit(const glm::vec2* positions, size_t count, bool* outLit, float threshold) const {
+    m_QueryScratch.resize(count);
+    GetLightIntensityAtPositions(positions, count, m_QueryScratch.data());
+    for (size_t i = 0; i < count; i++) {
+        outLit[i] = m_QueryScratch[i] > threshold;
     }
-    
-    return std::min(totalIntensity, 2.0f); // Clamp to reasonable values
 }
 
 glm::vec3 LightRenderer2D::GetLightColorAtPosition(const glm::vec2& position) const {
@@ -131,7 +195,7 @@ void LightRenderer2D::DrawLightsDebug() {
     if (!m_DebugMode) return;
     
     Logger::Info("Drawing " + std::to_string(m_Lights.size()) + " lights and " + 
-                std::to_string(m_Obstacles.size()) + " obstacles");
+                std::to_string(m_ObstacleWorld ? m_ObstacleWorld->GetCount() : 0) + " obstacles");
 }
 
 void LightRenderer2D::UpdateShaderUniforms(const std::vector<Light>& lights, const LightConfig& config) {
@@ -146,6 +210,13 @@ void LightRenderer2D::UpdateShaderUniforms(const std::vector<Light>& lights, con
     int lightCount = std::min((int)lights.size(), 16); // Limit to 16 lights
     m_LightShader->SetInt("uLightCount", lightCount);
     
+    // Point and spot lights are casters in the shared occlusion map
+    bool useShadowMap = config.enableShadows && m_ShadowMap;
+    bool hasDirectionalLight = false;
+    if (useShadowMap) {
+        m_ShadowMap->ApplyUniforms(m_LightShader);
+    }
+    
     // Set light properties
     for (int i = 0; i < lightCount; i++) {
         const Light& light = lights[i];
@@ -167,44 +238,122 @@ void LightRenderer2D::UpdateShaderUniforms(const std::vector<Light>& lights, con
         m_LightShader->SetFloat(intensityUniform, light.intensity);
         m_LightShader->SetVec3(colorUniform, light.color);
         m_LightShader->SetInt(typeUniform, static_cast<int>(light.type));
+        
+        int shadowRow = -1;
+        if (light.type == LightType::DIRECTIONAL_LIGHT) {
+            hasDirectionalLight = true;
+        } else if (useShadowMap) {
+            shadowRow = m_ShadowMap->RequestCaster(light.position);
+        }
+        m_LightShader->SetInt("uLightShadowRows[" + std::to_string(i) + "]", shadowRow);
     }
     
-    // Obstacle parameters
-    int obstacleCount = std::min((int)m_Obstacles.size(), 32); // Limit to 32 obstacles
+    // Obstacle parameters - only directional lights still trace obstacles analytically
+    int obstacleCount = (hasDirectionalLight && m_ObstacleWorld) ? std::min((int)m_ObstacleWorld->GetCount(), 32) : 0; // Limit to 32 obstacles
     m_LightShader->SetInt("uObstacleCount", obstacleCount);
     
     // Set obstacle positions and sizes
     for (int i = 0; i < obstacleCount; i++) {
+        const Obstacle& obstacle = m_ObstacleWorld->GetObstacles()[i];
         std::string posUniform = "uObstacles[" + std::to_string(i) + "]";
         std::string sizeUniform = "uObstacleSizes[" + std::to_string(i) + "]";
         
-        m_LightShader->SetVec2(posUniform, m_Obstacles[i].position);
-        m_LightShader->SetVec2(sizeUniform, m_Obstacles[i].size);
+        m_LightShader->SetVec2(posUniform, obstacle.position);
+        m_LightShader->SetVec2(sizeUniform, obstacle.size);
     }
 }
 
-bool LightRenderer2D::RayIntersectsBox(const glm::vec2& rayStart, const glm::vec2& rayDir, 
-                                      const glm::vec2& boxCenter, const glm::vec2& boxSize, 
-                                      float& hitDistance) const {
-    glm::vec2 boxMin = boxCenter - boxSize * 0.5f;
-    glm::vec2 boxMax = boxCenter + boxSize * 0.5f;
+void LightRenderer2D::DrawFullscreenQuad() {
+    // Create a quad that covers the entire screen
+    QuadInstance lightInstance;
+    lightInstance.position = glm::vec2(m_WindowWidth * 0.5f, m_WindowHeight * 0.5f);
+    lightInstance.size = glm::vec2((float)m_WindowWidth, (float)m_WindowHeight); // Exactly covers the window
+    lightInstance.rotation = 0.0f;
+    lightInstance.color = glm::vec4(1.0f); // White color (actual lighting handled in shader)
+    lightInstance.texIndex = 0.0f;
     
-    // Handle division by zero
-    glm::vec2 invDir;
-    invDir.x = (rayDir.x != 0.0f) ? 1.0f / rayDir.x : 1e30f;
-    invDir.y = (rayDir.y != 0.0f) ? 1.0f / rayDir.y : 1e30f;
+    m_QuadBatch->Add(lightInstance);
+    m_QuadBatch->End();
+}
+
+bool LightRenderer2D::NeedsRebake(const LightConfig& config, int width, int height) const {
+    if (!m_BakeValid || !m_BakedLightmap) return true;
+    if (m_BakedLightmap->GetWidth() != width || m_BakedLightmap->GetHeight() != height) return true;
+    if (m_BakedObstacleWorld != m_ObstacleWorld) return true;
+    if (m_ObstacleWorld && m_BakedObstacleRevision != m_ObstacleWorld->GetRevision()) return true;
+    if (m_ShadowMap && m_BakedShadowRevision != m_ShadowMap->GetRevision()) return true;
     
-    glm::vec2 t1 = (boxMin - rayStart) * invDir;
-    glm::vec2 t2 = (boxMax - rayStart) * invDir;
+    // Settings that feed the baked result
+    if (config.ambientLight != m_BakedConfig.ambientLight ||
+        config.ambientColor != m_BakedConfig.ambientColor ||
+        config.shadowSoftness != m_BakedConfig.shadowSoftness ||
+        config.shadowLength != m_BakedConfig.shadowLength ||
+        config.enableShadows != m_BakedConfig.enableShadows) return true;
     
-    glm::vec2 tMin = glm::min(t1, t2);
-    glm::vec2 tMax = glm::max(t1, t2);
+    if (m_StaticLights.size() != m_BakedLights.size()) return true;
+    for (size_t i = 0; i < m_StaticLights.size(); i++) {
+        const Light& a = m_StaticLights[i];
+        const Light& b = m_BakedLights[i];
+        if (a.type != b.type || a.position != b.position || a.direction != b.direction ||
+            a.color != b.color || a.intensity != b.intensity || a.range != b.range ||
+            a.innerAngle != b.innerAngle || a.outerAngle != b.outerAngle) return true;
+    }
+    return false;
+}
+
+void LightRenderer2D::BakeStaticLights(const LightConfig& config) {
+    // Bake at the same resolution the overlay is shaded at
+    float scale = (config.renderScale > 0.0f && config.renderScale < 0.999f) ? config.renderScale : 1.0f;
+    int width = std::max((int)std::ceil(m_WindowWidth * scale), 1);
+    int height = std::max((int)std::ceil(m_WindowHeight * scale), 1);
+    
+    if (!NeedsRebake(config, width, height)) return;
+    
+    if (!m_BakedLightmap) {
+        m_BakedLightmap = new RenderTarget2D(width, height, RenderTargetFormat::RGBA16F);
+    } else {
+        m_BakedLightmap->Resize(width, height);
+    }
+    
+    // Save the target we are drawing into
+    GLint previousFBO = 0;
+    GLint previousViewport[4];
+    glGetIntegerv(GL_FRAMEBUFFER_BINDING, &previousFBO);
+    glGetIntegerv(GL_VIEWPORT, previousViewport);
+    bool blendEnabled = GLStateCache::IsBlendEnabled();
+    
+    // Ambient + static lights are written as-is
+    m_BakedLightmap->Bind();
+    m_BakedLightmap->Clear();
+    GLStateCache::SetBlendEnabled(false);
+    
+    m_QuadBatch->Begin(m_LightShader);
+    glm::mat4 projection = glm::ortho(0.0f, (float)m_WindowWidth, (float)m_WindowHeight, 0.0f);
+    m_LightShader->SetMat4("uProjection", projection);
+    UpdateShaderUniforms(m_StaticLights, config);
+    m_LightShader->SetBool("uUseBakedLightmap", false);
+    m_LightShader->SetBool("uShowLightPositions", false);
+    DrawFullscreenQuad();
     
-    float tNear = std::max(tMin.x, tMin.y);
-    float tFar = std::min(tMax.x, tMax.y);
+    // Restore previous state
+    glBindFramebuffer(GL_FRAMEBUFFER, previousFBO);
+    glViewport(previousViewport[0], previousViewport[1], previousViewport[2], previousViewport[3]);
+    if (blendEnabled) GLStateCache::SetBlendEnabled(true);
     
-    hitDistance = tNear;
-    return tNear >= 0.0f && tNear <= tFar;
+    m_BakedLights = m_StaticLights;
+    m_BakedConfig = config;
+    m_BakedObstacleWorld = m_ObstacleWorld;
+    m_BakedObstacleRevision = m_ObstacleWorld ? m_ObstacleWorld->GetRevision() : 0;
+    m_BakedShadowRevision = m_ShadowMap ? m_ShadowMap->GetRevision() : 0;
+    m_BakeValid = true;
+}
+
+void LightRenderer2D::RefreshLightQuery() const {
+    uint32_t obstacleRevision = m_ObstacleWorld ? m_ObstacleWorld->GetRevision() : 0;
+    if (!m_LightQueryDirty && obstacleRevision == m_LightQueryObstacleRevision) return;
+    m_LightQuery.Update(m_Lights, m_ObstacleWorld, m_Config);
+    m_LightQueryObstacleRevision = obstacleRevision;
+    m_LightQueryDirty = false;
 }
 
 bool LightRenderer2D::IsInLightCone(const glm::vec2& worldPos, const glm::vec2& lightPos, 
@@ -274,38 +423,18 @@ float LightRenderer2D::CalculateLightContribution(const Light& light, const glm:
     }
     
     // Check line of sight (simplified for CPU calculation)
-    if (m_Config.enableShadows) {
-        glm::vec2 rayStart, rayDir;
-        float rayLength;
-        
+    if (m_Config.enableShadows && m_ObstacleWorld) {
         if (light.type == LightType::DIRECTIONAL_LIGHT) {
-            // For directional lights, ray goes from position towards light direction
-            rayStart = position;
-            rayDir = -light.direction;
-            rayLength = m_Config.shadowLength;
+            // For directional lights, any obstacle towards the light blocks it
+            if (m_ObstacleWorld->Raycast(position, -light.direction, m_Config.shadowLength)) {
+                attenuation = 0.0f;
+            }
         } else {
-            // For point and spot lights, ray goes from light to position
-            rayStart = light.position;
-            rayDir = glm::normalize(position - light.position);
-            rayLength = glm::length(position - light.position);
-        }
-        
-        for (const auto& obstacle : m_Obstacles) {
-            float hitDistance;
-            if (RayIntersectsBox(rayStart, rayDir, obstacle.position, obstacle.size, hitDistance)) {
-                if (light.type == LightType::DIRECTIONAL_LIGHT) {
-                    // For directional lights, any intersection blocks the light
-                    if (hitDistance >= 0.0f && hitDistance < rayLength) {
-                        attenuation = 0.0f;
-                        break;
-                    }
-                } else {
-                    // For point and spot lights, check if obstacle is between light and point
-                    if (hitDistance < rayLength) {
-                        attenuation *= 0.1f; // Heavily attenuate if blocked
-                        break;
-                    }
-                }
+            // For point and spot lights, check if an obstacle is between light and point
+            glm::vec2 toPosition = position - light.position;
+            float rayLength = glm::length(toPosition);
+            if (rayLength > 0.0f && m_ObstacleWorld->Raycast(light.position, toPosition / rayLength, rayLength)) {
+                attenuation *= 0.1f; // Heavily attenuate if blocked
             }
         }
     }
@@ -315,19 +444,23 @@ float LightRenderer2D::CalculateLightContribution(const Light& light, const glm:
 
 // Convenience methods for creating specific light types
 void LightRenderer2D::AddPointLight(const glm::vec2& position, float range, const glm::vec3& color, float intensity) {
+    m_LightQueryDirty = true;
     m_Lights.emplace_back(position, range, color, intensity);
 }
 
 void LightRenderer2D::AddSpotLight(const glm::vec2& position, const glm::vec2& direction, float range, float angle, 
                                   const glm::vec3& color, float intensity) {
+    m_LightQueryDirty = true;
     m_Lights.emplace_back(position, direction, range, angle, color, intensity);
 }
 
 void LightRenderer2D::AddDirectionalLight(const glm::vec2& direction, const glm::vec3& color, float intensity) {
+    m_LightQueryDirty = true;
     m_Lights.push_back(Light::CreateDirectionalLight(direction, color, intensity));
 }
 
 void LightRenderer2D::AddAdvancedSpotLight(const glm::vec2& position, const glm::vec2& direction, float range, 
                                           float innerAngle, float outerAngle, const glm::vec3& color, float intensity) {
+    m_LightQueryDirty = true;
     m_Lights.push_back(Light::CreateSpotLight(position, direction, range, innerAngle, outerAngle, color, intensity));
 } 
\ No newline at end of file
@@ -1,21 +1,31 @@
 #pragma once
 #include <glm/glm.hpp>
 #include <vector>
+#include <cstdint>
 #include "../QuadBatch.h"
 #include "../Shader.h"
+#include "../OverlayTarget2D.h"
+#include "../RenderTarget2D.h"
 #include "Light.h"
+#include "LightQueryBatch2D.h"
 
-// Forward declaration for obstacles
-struct Obstacle;
+// Forward declarations
+class ObstacleWorld;
+class ShadowMap2D;
 
 class LightRenderer2D {
 public:
     LightRenderer2D(int windowWidth, int windowHeight);
     ~LightRenderer2D();
 
-    // Main rendering function - draws the lighting overlay
+    // Main rendering function - draws the lighting overlay.
+    // Static lights are read from the baked lightmap; only dynamic lights are shaded per frame.
     void DrawLightingOverlay(const std::vector<Light>& lights, const LightConfig& config = LightConfig{});
     
+    // Shades the overlay into the bound target as-is (no scaling or compositing - the render graph does that).
+    // The baked lightmap still follows config.renderScale, so targets should be allocated at that scale.
+    void ShadeLightingOverlay(const std::vector<Light>& lights, const LightConfig& config);
+    
     // Light management
     void AddLight(const Light& light);
     void AddLights(const std::vector<Light>& lights);
@@ -33,11 +43,16 @@ public:
     void AddAdvancedSpotLight(const glm::vec2& position, const glm::vec2& direction, float range, 
                              float innerAngle, float outerAngle, const glm::vec3& color = glm::vec3(1.0f), float intensity = 1.0f);
     
-    // Obstacle management (for shadow casting)
-    void AddObstacle(const glm::vec2& position, const glm::vec2& size);
-    void AddObstacles(const std::vector<Obstacle>& obstacles);
-    void ClearObstacles();
-    void RemoveObstacle(size_t index);
+    // Shared obstacle set (for shadow casting - nothing casts shadows when none is set)
+    void SetObstacleWorld(const ObstacleWorld* world);
+    const ObstacleWorld* GetObstacleWorld() const;
+    
+    // Shared occlusion map (shadows are skipped when none is set)
+    void SetShadowMap(ShadowMap2D* shadowMap);
+    ShadowMap2D* GetShadowMap() const;
+    
+    // Forces the static lightmap to be rebaked on the next draw
+    void InvalidateBakedLighting();
     
     // Lighting configuration
     void SetLightConfig(const LightConfig& config);
@@ -49,6 +64,11 @@ public:
     // Utility functions
     bool IsPositionLit(const glm::vec2& position, float threshold = 0.1f) const;
     float GetLightIntensityAtPosition(const glm::vec2& position) const;
+    
+    // Batch queries for many points (AI perception) - SIMD over the points, occlusion via
+    // cached visibility polygons. Outputs must hold count entries.
+    void GetLightIntensityAtPositions(const glm::vec2* positions, size_t count, float* outIntensities) const;
+    void ArePositionsLit(const glm::vec2* positions, size_t count, bool* outLit, float threshold = 0.1f) const;
     glm::vec3 GetLightColorAtPosition(const glm::vec2& position) const;
     
     // Debug functions
@@ -59,6 +79,7 @@ private:
     // Core rendering components
     QuadBatch* m_QuadBatch;
     Shader* m_LightShader;
+    OverlayTarget2D* m_OverlayTarget;
     
     // Window properties
     int m_WindowWidth, m_WindowHeight;
@@ -68,16 +89,39 @@ private:
     
     // Lights and obstacles
     std::vector<Light> m_Lights;
-    std::vector<Obstacle> m_Obstacles;
+    const ObstacleWorld* m_ObstacleWorld;
+    ShadowMap2D* m_ShadowMap;
+    
+    // Static lighting cache (ambient + static lights, rebaked only when its inputs change)
+    RenderTarget2D* m_BakedLightmap;
+    std::vector<Light> m_BakedLights;  // Static lights the lightmap was baked with
+    LightConfig m_BakedConfig;
+    uint32_t m_BakedShadowRevision;
+    const ObstacleWorld* m_BakedObstacleWorld;
+    uint32_t m_BakedObstacleRevision;
+    bool m_BakeValid;
+    
+    // Per-frame split of the lights passed to DrawLightingOverlay
+    std::vector<Light> m_StaticLights;
+    std::vector<Light> m_DynamicLights;
+    
+    // CPU query cache, refreshed lazily after lights, obstacles or config change
+    mutable LightQueryBatch2D m_LightQuery;
+    mutable bool m_LightQueryDirty;
+    mutable uint32_t m_LightQueryObstacleRevision;
+    mutable std::vector<float> m_QueryScratch;
     
     // Debug mode
     bool m_DebugMode;
     
     // Helper functions
+    void PrepareLights(const std::vector<Light>& lights, const LightConfig& config);  // Static/dynamic split + rebake
+    void ShadeLights(const std::vector<Light>& lights, const LightConfig& config);
     void UpdateShaderUniforms(const std::vector<Light>& lights, const LightConfig& config);
-    bool RayIntersectsBox(const glm::vec2& rayStart, const glm::vec2& rayDir, 
-                         const glm::vec2& boxCenter, const glm::vec2& boxSize, 
-                         float& hitDistance) const;
+    void DrawFullscreenQuad();
+    bool NeedsRebake(const LightConfig& config, int width, int height) const;
+    void BakeStaticLights(const LightConfig& config);
+    void RefreshLightQuery() const;
     bool IsInLightCone(const glm::vec2& worldPos, const glm::vec2& lightPos, 
                       const glm::vec2& lightDir, float lightAngle, bool isDirectional) const;
     float CalculateLightContribution(const Light& light, const glm::vec2& position) const;
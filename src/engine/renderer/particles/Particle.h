@@ -0,0 +1,17 @@
+#pragma once
+#include <glm/glm.hpp>
+
+// Spawn settings for one burst of particles. Every value with a min/max pair is picked
+// per particle on the GPU; the CPU only ever handles whole bursts.
+struct ParticleEmitParams {
+    glm::vec2 position{0.0f};                           // Spawn center (world space)
+    float positionJitter = 0.0f;                        // Spawn radius around the center
+    float direction = 0.0f;                             // Launch angle in radians (0 = +X)
+    float spread = 6.2831853f;                          // Full cone angle around direction
+    float speedMin = 50.0f, speedMax = 150.0f;          // Pixels per second
+    float lifetimeMin = 0.5f, lifetimeMax = 1.5f;       // Seconds
+    float startSize = 6.0f, endSize = 0.0f;             // Square size over the lifetime
+    glm::vec4 startColor{1.0f};                         // Color over the lifetime
+    glm::vec4 endColor{1.0f, 1.0f, 1.0f, 0.0f};
+    glm::vec2 acceleration{0.0f};                       // Gravity, wind
+};
@@ -0,0 +1,226 @@
+#include "ParticleRenderer2D.h"
+#include "../GLStateCache.h"
+#include "../GpuProfiler.h"
+#include <glad/glad.h>
+#include <algorithm>
+#include <cstddef>
+#include <engine/utils/Logger.h>
+#include <engine/utils/Profiler.h>
+
+namespace {
+    constexpr unsigned int BurstBlockBinding = 0;
+
+    // std140 layout of one entry in the shader's BurstBlock
+    struct GpuBurst {
+        glm::vec4 positionJitterDirection;  // xy position, z jitter radius, w direction
+        glm::vec4 spreadSpeedLifetime;      // spread, speed min, speed max, lifetime min
+        glm::vec4 lifetimeSizes;            // lifetime max, start size, end size, unused
+        glm::vec4 startColor;
+        glm::vec4 endColor;
+        glm::ivec4 range;                   // x: spawn offset one past this burst's last particle
+        glm::vec4 acceleration;             // xy
+    };
+
+    const std::vector<std::string> FeedbackVaryings = {
+        "tfPosition", "tfSize", "tfRotation", "tfColor", "tfTexIndex",
+        "tfVelocity", "tfAcceleration", "tfAgeLifetime", "tfSizeRange", "tfColorRange"
+    };
+}
+
+static_assert(offsetof(GpuParticle, texIndex) == offsetof(QuadInstance, texIndex),
+              "GpuParticle must start with the QuadInstance layout");
+
+ParticleRenderer2D::ParticleRenderer2D(size_t capacity)
+    : m_Capacity(std::max<size_t>(capacity, 1)), m_SimulateShader(nullptr), m_BurstUBO(0),
+      m_Current(0), m_SpawnCursor(0), m_Simulated(0), m_TimeToExpire(0.0f), m_Step(0)
+{
+    m_SimulateShader = new Shader("shaders/ParticleSimulate.vert.glsl", FeedbackVaryings);
+    unsigned int blockIndex = glGetUniformBlockIndex(m_SimulateShader->GetID(), "BurstBlock");
+    if (blockIndex == GL_INVALID_INDEX) {
+        Logger::Error("ParticleRenderer2D - BurstBlock not found in simulation shader", this);
+    } else {
+        glUniformBlockBinding(m_SimulateShader->GetID(), blockIndex, BurstBlockBinding);
+    }
+
+    SetupBuffers();
+    m_Stats.capacity = m_Capacity;
+    Logger::Info("ParticleRenderer2D created with " + std::to_string(m_Capacity) + " particles ("
+                 + std::to_string(2 * m_Capacity * sizeof(GpuParticle) / (1024 * 1024)) + " MB)");
+}
+
+ParticleRenderer2D::~ParticleRenderer2D() {
+    for (int i = 0; i < 2; i++) {
+        GLStateCache::OnVertexArrayDeleted(m_SimulateVAO[i]);
+        GLStateCache::OnVertexArrayDeleted(m_DrawVAO[i]);
+        GLStateCache::OnBufferDeleted(m_ParticleVBO[i]);
+    }
+    glDeleteVertexArrays(2, m_SimulateVAO);
+    glDeleteVertexArrays(2, m_DrawVAO);
+    glDeleteBuffers(2, m_ParticleVBO);
+
+    GLStateCache::OnBufferDeleted(m_BurstUBO);
+    glDeleteBuffers(1, &m_BurstUBO);
+    QuadBatch::ReleaseUnitQuad();
+
+    delete m_SimulateShader;
+}
+
+void ParticleRenderer2D::SetupBuffers() {
+    QuadBatch::AcquireUnitQuad();
+
+    glGenBuffers(1, &m_BurstUBO);
+    GLStateCache::BindBuffer(GL_UNIFORM_BUFFER, m_BurstUBO);
+    glBufferData(GL_UNIFORM_BUFFER, MaxBurstsPerStep * sizeof(GpuBurst), nullptr, GL_STREAM_DRAW);
+
+    // Contents stay undefined until spawned: only slots below m_Simulated are ever read
+    glGenBuffers(2, m_ParticleVBO);
+    for (int i = 0; i < 2; i++) {
+        GLStateCache::BindBuffer(GL_ARRAY_BUFFER, m_ParticleVBO[i]);
+        glBufferData(GL_ARRAY_BUFFER, m_Capacity * sizeof(GpuParticle), nullptr, GL_DYNAMIC_COPY);
+    }
+
+    glGenVertexArrays(2, m_SimulateVAO);
+    glGenVertexArrays(2, m_DrawVAO);
+    for (int i = 0; i < 2; i++) {
+        GLStateCache::BindVertexArray(m_SimulateVAO[i]);
+        GLStateCache::BindBuffer(GL_ARRAY_BUFFER, m_ParticleVBO[i]);
+        SetupSimulateAttributes();
+
+        GLStateCache::BindVertexArray(m_DrawVAO[i]);
+        QuadBatch::SetupQuadAttributes();
+
+        GLStateCache::BindBuffer(GL_ARRAY_BUFFER, m_ParticleVBO[i]);
+        QuadBatch::SetupInstanceAttributes(sizeof(GpuParticle), false);
+    }
+
+    GLStateCache::BindVertexArray(0);
+}
+
+void ParticleRenderer2D::SetupSimulateAttributes() {
+    const GLsizei stride = sizeof(GpuParticle);
+    struct FloatAttribute { int size; size_t offset; };
+    const FloatAttribute attributes[] = {
+        { 2, offsetof(GpuParticle, position) },
+        { 2, offsetof(GpuParticle, size) },
+        { 1, offsetof(GpuParticle, rotation) },
+        { 4, offsetof(GpuParticle, color) },
+        { 1, offsetof(GpuParticle, texIndex) },
+        { 2, offsetof(GpuParticle, velocity) },
+        { 2, offsetof(GpuParticle, acceleration) },
+        { 2, offsetof(GpuParticle, age) },          // age, lifetime
+        { 2, offsetof(GpuParticle, startSize) },    // start, end size
+    };
+
+    GLuint location = 0;
+    for (const auto& attribute : attributes) {
+        glEnableVertexAttribArray(location);
+        glVertexAttribPointer(location, attribute.size, GL_FLOAT, GL_FALSE, stride, (void*)attribute.offset);
+        location++;
+    }
+
+    glEnableVertexAttribArray(location); // start, end color
+    glVertexAttribIPointer(location, 2, GL_UNSIGNED_INT, stride, (void*)offsetof(GpuParticle, startColor));
+}
+
+void ParticleRenderer2D::Emit(const ParticleEmitParams& params, uint32_t count) {
+    if (count == 0) return;
+    m_Bursts.push_back({ params, count });
+}
+
+void ParticleRenderer2D::Simulate(float deltaTime) {
+    PROFILE_SCOPE("ParticleRenderer2D::Simulate");
+
+    // Everything spawned so far is dead by the end of this step: start the ring over
+    // so the pool only simulates and draws slots that may still be alive
+    m_TimeToExpire -= deltaTime;
+    if (m_TimeToExpire <= 0.0f) {
+        m_TimeToExpire = 0.0f;
+        m_SpawnCursor = 0;
+        m_Simulated = 0;
+    }
+
+    // Pack as many bursts as the uniform block holds; the rest spawn next step.
+    // Spawning more than the pool in one step would only overwrite itself.
+    GpuBurst bursts[MaxBurstsPerStep];
+    int burstCount = 0;
+    uint32_t spawnTotal = 0;
+    size_t consumed = 0;
+    for (; consumed < m_Bursts.size() && burstCount < MaxBurstsPerStep; consumed++) {
+        const Burst& burst = m_Bursts[consumed];
+        uint32_t count = (uint32_t)std::min<size_t>(burst.count, m_Capacity - spawnTotal);
+        if (count == 0) continue;
+
+        const ParticleEmitParams& p = burst.params;
+        spawnTotal += count;
+        m_TimeToExpire = std::max(m_TimeToExpire, std::max(p.lifetimeMin, p.lifetimeMax));
+
+        GpuBurst& gpu = bursts[burstCount++];
+        gpu.positionJitterDirection = glm::vec4(p.position, p.positionJitter, p.direction);
+        gpu.spreadSpeedLifetime = glm::vec4(p.spread, p.speedMin, p.speedMax, p.lifetimeMin);
+        gpu.lifetimeSizes = glm::vec4(p.lifetimeMax, p.startSize, p.endSize, 0.0f);
+        gpu.startColor = glm::clamp(p.startColor, 0.0f, 1.0f);
+        gpu.endColor = glm::clamp(p.endColor, 0.0f, 1.0f);
+        gpu.range = glm::ivec4((int)spawnTotal, 0, 0, 0);
+        gpu.acceleration = glm::vec4(p.acceleration, 0.0f, 0.0f);
+    }
+    m_Bursts.erase(m_Bursts.begin(), m_Bursts.begin() + consumed);
+
+    size_t spawnStart = m_SpawnCursor;
+    m_SpawnCursor = (m_SpawnCursor + spawnTotal) % m_Capacity;
+    m_Simulated = std::min(m_Capacity, m_Simulated + spawnTotal);
+
+    m_Stats.simulated = m_Simulated;
+    m_Stats.spawned = spawnTotal;
+    m_Stats.pendingBursts = m_Bursts.size();
+    if (m_Simulated == 0) return;
+
+    GPU_PROFILE_SCOPE("ParticleRenderer2D::Simulate");
+
+    if (burstCount > 0) {
+        GLStateCache::BindBuffer(GL_UNIFORM_BUFFER, m_BurstUBO);
+        glBufferSubData(GL_UNIFORM_BUFFER, 0, burstCount * sizeof(GpuBurst), bursts);
+    }
+    glBindBufferBase(GL_UNIFORM_BUFFER, BurstBlockBinding, m_BurstUBO);
+
+    m_SimulateShader->Bind();
+    m_SimulateShader->SetFloat("uDeltaTime", deltaTime);
+    m_SimulateShader->SetInt("uBurstCount", burstCount);
+    m_SimulateShader->SetInt("uSpawnStart", (int)spawnStart);
+    m_SimulateShader->SetInt("uSpawnTotal", (int)spawnTotal);
+    m_SimulateShader->SetInt("uCapacity", (int)m_Capacity);
+    m_SimulateShader->SetInt("uSeed", (int)(m_Step++ * 0x9E3779B9u));
+
+    // One point per particle, read from the current buffer and captured into the other
+    int next = 1 - m_Current;
+    GLStateCache::BindVertexArray(m_SimulateVAO[m_Current]);
+    glBindBufferBase(GL_TRANSFORM_FEEDBACK_BUFFER, 0, m_ParticleVBO[next]);
+
+    glEnable(GL_RASTERIZER_DISCARD);
+    glBeginTransformFeedback(GL_POINTS);
+    glDrawArrays(GL_POINTS, 0, (GLsizei)m_Simulated);
+    glEndTransformFeedback();
+    glDisable(GL_RASTERIZER_DISCARD);
+
+    glBindBufferBase(GL_TRANSFORM_FEEDBACK_BUFFER, 0, 0);
+    m_Current = next;
+}
+
+void ParticleRenderer2D::Draw() {
+    if (m_Simulated == 0) return;
+    PROFILE_SCOPE("ParticleRenderer2D::Draw");
+
+    // Particles carry no uv rect; the disabled attribute reads this constant instead
+    GLStateCache::BindVertexArray(m_DrawVAO[m_Current]);
+    glVertexAttrib4f(7, 0.0f, 0.0f, 1.0f, 1.0f);
+    glDrawElementsInstanced(GL_TRIANGLES, 6, GL_UNSIGNED_INT, 0, (GLsizei)m_Simulated);
+}
+
+void ParticleRenderer2D::Clear() {
+    m_Bursts.clear();
+    m_SpawnCursor = 0;
+    m_Simulated = 0;
+    m_TimeToExpire = 0.0f;
+    m_Stats.simulated = 0;
+    m_Stats.spawned = 0;
+    m_Stats.pendingBursts = 0;
+}
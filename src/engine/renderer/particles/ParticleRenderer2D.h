@@ -0,0 +1,82 @@
+#pragma once
+#include <glm/glm.hpp>
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+#include "Particle.h"
+#include "../QuadBatch.h"
+#include "../Shader.h"
+
+#pragma pack(push, 1)
+// One particle as stored on the GPU. It starts like a QuadInstance (minus uvRect), so the
+// simulation buffer doubles as the instance buffer of the regular sprite shader.
+struct GpuParticle {
+    glm::vec2 position;
+    glm::vec2 size;             // Zero once dead
+    float rotation;
+    glm::vec4 color;
+    float texIndex;
+    glm::vec2 velocity;
+    glm::vec2 acceleration;
+    float age;
+    float lifetime;             // Dead once age >= lifetime (drawn with zero size)
+    float startSize, endSize;
+    uint32_t startColor;        // RGBA8
+    uint32_t endColor;
+};
+#pragma pack(pop)
+
+struct ParticleStats {
+    size_t capacity = 0;
+    size_t simulated = 0;       // Slots filled since the pool last ran empty; upper bound on live particles
+    uint32_t spawned = 0;       // Last Simulate()
+    size_t pendingBursts = 0;   // Queued past the per-step burst limit
+};
+
+// GPU particle pool simulated with transform feedback (GL 4.0 has no compute shaders).
+// Bursts are packed into a uniform block and spawned into a ring over the pool, so the
+// oldest particles are recycled once it is full. Simulate() ping-pongs between two
+// buffers and Draw() renders the latest one through the instanced sprite path. No
+// particle data is ever touched by the CPU.
+class ParticleRenderer2D {
+public:
+    static constexpr int MaxBurstsPerStep = 64;
+
+    ParticleRenderer2D(size_t capacity = 1 << 20);
+    ~ParticleRenderer2D();
+
+    // Queued until the next Simulate()
+    void Emit(const ParticleEmitParams& params, uint32_t count);
+    void Simulate(float deltaTime);
+
+    // Draws every particle slot in use; the sprite shader must be bound with its projection set
+    void Draw();
+    void Clear();
+
+    const ParticleStats& GetStats() const { return m_Stats; }
+    size_t GetCapacity() const { return m_Capacity; }
+
+private:
+    struct Burst {
+        ParticleEmitParams params;
+        uint32_t count;
+    };
+
+    size_t m_Capacity;
+    Shader* m_SimulateShader;
+    unsigned int m_ParticleVBO[2];
+    unsigned int m_SimulateVAO[2];  // Reads buffer i as vertex input
+    unsigned int m_DrawVAO[2];      // Reads buffer i as quad instances
+    unsigned int m_BurstUBO;
+    int m_Current;                  // Buffer holding the latest state
+    size_t m_SpawnCursor;           // Next ring slot to spawn into
+    size_t m_Simulated;             // Slots filled since every particle last expired
+    float m_TimeToExpire;           // Seconds until the longest-lived particle spawned so far dies
+    uint32_t m_Step;
+    std::vector<Burst> m_Bursts;
+    ParticleStats m_Stats;
+
+    // Helper functions
+    void SetupBuffers();
+    void SetupSimulateAttributes();
+};
@@ -0,0 +1,194 @@
+#include "ShadowMap2D.h"
+#include <glad/glad.h>
+#include <engine/utils/Logger.h>
+#include <engine/utils/Profiler.h>
+#include "../../core/spatial/ObstacleWorld.h"
+#include "../GLStateCache.h"
+
+ShadowMap2D::ShadowMap2D(float maxDistance)
+    : m_FBO(0), m_Texture(0), m_MaxDistance(maxDistance), m_Frame(1), m_Revision(0),
+      m_World(nullptr), m_WorldRevision(0), m_ObstaclesDirty(true)
+{
+    m_ShadowShader = new Shader("shaders/ShadowMapVertex.vert.glsl", "shaders/ShadowMapFrag.frag.glsl");
+    m_QuadBatch = new QuadBatch();
+    SetupTarget();
+    Logger::Info("Shadow map shader created with ID: " + std::to_string(m_ShadowShader->GetID()));
+}
+
+ShadowMap2D::~ShadowMap2D() {
+    GLStateCache::OnTextureDeleted(m_Texture);
+    glDeleteFramebuffers(1, &m_FBO);
+    glDeleteTextures(1, &m_Texture);
+    delete m_QuadBatch;
+    delete m_ShadowShader;
+}
+
+void ShadowMap2D::SetupTarget() {
+    glGenTextures(1, &m_Texture);
+    GLStateCache::BindTexture(m_Texture);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_R32F, Resolution, MaxCasters, 0, GL_RED, GL_FLOAT, nullptr);
+
+    // Nearest filtering: depths must not be blended across occluder edges,
+    // the overlay shaders do their own filtering for soft edges
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);        // Angle wraps around
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    GLStateCache::BindTexture(0);
+
+    GLint previousFBO = 0;
+    glGetIntegerv(GL_FRAMEBUFFER_BINDING, &previousFBO);
+
+    glGenFramebuffers(1, &m_FBO);
+    glBindFramebuffer(GL_FRAMEBUFFER, m_FBO);
+    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, m_Texture, 0);
+
+    if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE) {
+        Logger::Error("ShadowMap2D - Occlusion framebuffer is incomplete", this);
+    }
+
+    // Start with every caster unoccluded
+    const float clearValue[4] = { 1.0f, 1.0f, 1.0f, 1.0f };
+    glClearBufferfv(GL_COLOR, 0, clearValue);
+
+    glBindFramebuffer(GL_FRAMEBUFFER, previousFBO);
+}
+
+void ShadowMap2D::SetObstacleWorld(const ObstacleWorld* world) {
+    m_World = world;
+    m_ObstaclesDirty = true;
+    SyncObstacles();
+}
+
+void ShadowMap2D::SyncObstacles() {
+    uint32_t worldRevision = m_World ? m_World->GetRevision() : 0;
+    if (!m_ObstaclesDirty && worldRevision == m_WorldRevision) return;
+
+    m_WorldRevision = worldRevision;
+    m_ObstaclesDirty = false;
+
+    m_ObstacleInstances.clear();
+    if (m_World) {
+        m_ObstacleInstances.reserve(m_World->GetCount());
+
+        for (const auto& obstacle : m_World->GetObstacles()) {
+            QuadInstance instance;
+            instance.position = obstacle.position;
+            instance.size = obstacle.size;
+            instance.rotation = 0.0f;
+            instance.color = glm::vec4(1.0f);
+            instance.texIndex = 0.0f;
+            m_ObstacleInstances.push_back(instance);
+        }
+    }
+
+    InvalidateRows();
+}
+
+void ShadowMap2D::BeginFrame() {
+    m_Frame++;
+    SyncObstacles();
+}
+
+int ShadowMap2D::RequestCaster(const glm::vec2& position) {
+    SyncObstacles();
+
+    // Reuse a row that already holds this caster
+    for (int i = 0; i < MaxCasters; i++) {
+        if (m_Rows[i].valid && m_Rows[i].position == position) {
+            m_Rows[i].lastUsedFrame = m_Frame;
+            return i;
+        }
+    }
+
+    // Otherwise take the least recently used row that is not needed this frame
+    int row = -1;
+    for (int i = 0; i < MaxCasters; i++) {
+        if (m_Rows[i].lastUsedFrame == m_Frame) continue;
+        if (row < 0 || m_Rows[i].lastUsedFrame < m_Rows[row].lastUsedFrame) {
+            row = i;
+        }
+    }
+
+    if (row < 0) {
+        Logger::Warn("ShadowMap2D - Out of caster rows, caster will be drawn unshadowed", this);
+        return -1;
+    }
+
+    RenderCaster(row, position);
+    m_Rows[row].position = position;
+    m_Rows[row].valid = true;
+    m_Rows[row].lastUsedFrame = m_Frame;
+    return row;
+}
+
+void ShadowMap2D::Bind(unsigned int slot) const {
+    GLStateCache::BindTexture(slot, m_Texture);
+}
+
+void ShadowMap2D::ApplyUniforms(Shader* shader, unsigned int slot) const {
+    Bind(slot);
+    shader->SetInt("uShadowMap", (int)slot);
+    shader->SetFloat("uShadowMapMaxDistance", m_MaxDistance);
+    shader->SetFloat("uShadowMapResolution", (float)Resolution);
+    shader->SetFloat("uShadowMapRows", (float)MaxCasters);
+}
+
+void ShadowMap2D::InvalidateRows() {
+    for (auto& row : m_Rows) {
+        row.valid = false;
+    }
+    m_Revision++;
+}
+
+void ShadowMap2D::RenderCaster(int row, const glm::vec2& position) {
+    PROFILE_SCOPE("ShadowMap2D::RenderCaster");
+    // Save the state we are about to touch so callers can request casters mid-frame.
+    // Program, VAO and blend state come from the state cache instead of glGet round trips.
+    GLint previousFBO = 0;
+    GLint previousViewport[4];
+    unsigned int previousProgram = GLStateCache::GetProgram();
+    unsigned int previousVAO = GLStateCache::GetVertexArray();
+    bool blendEnabled = GLStateCache::IsBlendEnabled();
+    unsigned int blendFunc[4], blendEquation[2];
+    GLStateCache::GetBlendFuncSeparate(blendFunc);
+    GLStateCache::GetBlendEquationSeparate(blendEquation);
+    GLboolean scissorEnabled = glIsEnabled(GL_SCISSOR_TEST);
+    glGetIntegerv(GL_FRAMEBUFFER_BINDING, &previousFBO);
+    glGetIntegerv(GL_VIEWPORT, previousViewport);
+
+    glBindFramebuffer(GL_FRAMEBUFFER, m_FBO);
+    glViewport(0, row, Resolution, 1);
+
+    // Reset only this caster's row to "no occluder"
+    glEnable(GL_SCISSOR_TEST);
+    glScissor(0, row, Resolution, 1);
+    const float clearValue[4] = { 1.0f, 1.0f, 1.0f, 1.0f };
+    glClearBufferfv(GL_COLOR, 0, clearValue);
+
+    if (!m_ObstacleInstances.empty()) {
+        // Every obstacle covers the whole row; MIN blending keeps the nearest hit per angle
+        GLStateCache::SetBlendEnabled(true);
+        GLStateCache::SetBlendEquation(GL_MIN);
+        GLStateCache::SetBlendFunc(GL_ONE, GL_ONE);
+
+        m_QuadBatch->Begin(m_ShadowShader);
+        m_ShadowShader->SetVec2("uCasterPos", position);
+        m_ShadowShader->SetFloat("uMaxDistance", m_MaxDistance);
+        m_ShadowShader->SetFloat("uResolution", (float)Resolution);
+        for (const auto& instance : m_ObstacleInstances) {
+            m_QuadBatch->Add(instance);
+        }
+        m_QuadBatch->End();
+    }
+
+    // Restore previous state
+    glBindFramebuffer(GL_FRAMEBUFFER, previousFBO);
+    GLStateCache::UseProgram(previousProgram);
+    GLStateCache::BindVertexArray(previousVAO);
+    glViewport(previousViewport[0], previousViewport[1], previousViewport[2], previousViewport[3]);
+    if (!scissorEnabled) glDisable(GL_SCISSOR_TEST);
+    GLStateCache::SetBlendEnabled(blendEnabled);
+    GLStateCache::SetBlendEquationSeparate(blendEquation[0], blendEquation[1]);
+    GLStateCache::SetBlendFuncSeparate(blendFunc[0], blendFunc[1], blendFunc[2], blendFunc[3]);
+}
@@ -0,0 +1,71 @@
+#pragma once
+#include <glm/glm.hpp>
+#include <vector>
+#include <cstdint>
+#include "../QuadBatch.h"
+#include "../Shader.h"
+
+// Forward declaration for obstacles
+class ObstacleWorld;
+
+// Shared 1D polar occlusion map used by the fog, vision and lighting overlays.
+// Every row of the texture belongs to one caster (a light or a viewer) and stores,
+// for each angle around it, the distance to the nearest obstacle. Overlay shaders
+// then resolve line of sight with a handful of texture taps instead of looping
+// over every obstacle per fragment.
+class ShadowMap2D {
+public:
+    static constexpr int Resolution = 1024; // Angular samples per caster
+    static constexpr int MaxCasters = 32;   // Rows available in the occlusion texture
+
+    ShadowMap2D(float maxDistance = 4096.0f);
+    ~ShadowMap2D();
+
+    // Obstacle source - any change to the world invalidates every cached row
+    void SetObstacleWorld(const ObstacleWorld* world);
+    const ObstacleWorld* GetObstacleWorld() const { return m_World; }
+
+    // Call once per frame before any overlay requests casters (picks up obstacle changes)
+    void BeginFrame();
+
+    // Returns the row holding the occlusion for a caster at this position, rendering it
+    // if it is not cached yet. Returns -1 when every row is already in use this frame.
+    int RequestCaster(const glm::vec2& position);
+
+    // Binds the occlusion texture and sets the shared sampling uniforms on a shader
+    void Bind(unsigned int slot = 0) const;
+    void ApplyUniforms(Shader* shader, unsigned int slot = 0) const;
+
+    float GetMaxDistance() const { return m_MaxDistance; }
+    unsigned int GetTextureID() const { return m_Texture; }
+    uint32_t GetRevision() const { return m_Revision; }
+
+private:
+    struct CasterRow {
+        glm::vec2 position{0.0f};
+        bool valid = false;        // Row holds up-to-date occlusion for position
+        uint64_t lastUsedFrame = 0;
+    };
+
+    // GPU resources
+    unsigned int m_FBO, m_Texture;
+    QuadBatch* m_QuadBatch;
+    Shader* m_ShadowShader;
+
+    float m_MaxDistance;
+    uint64_t m_Frame;
+    uint32_t m_Revision;           // Bumped whenever the obstacle set changes
+
+    const ObstacleWorld* m_World;
+    uint32_t m_WorldRevision;      // World revision the obstacle instances were built from
+    bool m_ObstaclesDirty;
+
+    std::vector<QuadInstance> m_ObstacleInstances;
+    CasterRow m_Rows[MaxCasters];
+
+    // Helper functions
+    void SetupTarget();
+    void SyncObstacles();
+    void InvalidateRows();
+    void RenderCaster(int row, const glm::vec2& position);
+};
@@ -0,0 +1,122 @@
+#include "Font.h"
+#include "../GLStateCache.h"
+#include <glad/glad.h>
+#include <stb_truetype/stb_truetype.h>
+#include <algorithm>
+#include <fstream>
+#include <iterator>
+#include <engine/utils/ResourcePath.h>
+#include <engine/utils/Logger.h>
+
+Font::Font(const std::string& path, float baseSize)
+    : m_Info(std::make_unique<stbtt_fontinfo>()), m_BaseSize(baseSize), m_Scale(0.0f),
+      m_Ascent(0.0f), m_Descent(0.0f), m_LineHeight(0.0f), m_AtlasTexture(0),
+      m_ShelfX(0), m_ShelfY(0), m_ShelfHeight(0), m_Loaded(false), m_AtlasFull(false)
+{
+    std::ifstream file(ResourcePath::GetFullPath(path), std::ios::binary);
+    if (!file.is_open()) {
+        Logger::Error("Font - failed to open " + path, this);
+        return;
+    }
+    m_FontData.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+
+    if (!stbtt_InitFont(m_Info.get(), m_FontData.data(), stbtt_GetFontOffsetForIndex(m_FontData.data(), 0))) {
+        Logger::Error("Font - not a valid TrueType font: " + path, this);
+        return;
+    }
+
+    m_Scale = stbtt_ScaleForPixelHeight(m_Info.get(), m_BaseSize);
+    int ascent, descent, lineGap;
+    stbtt_GetFontVMetrics(m_Info.get(), &ascent, &descent, &lineGap);
+    m_Ascent = ascent * m_Scale;
+    m_Descent = descent * m_Scale;
+    m_LineHeight = (ascent - descent + lineGap) * m_Scale;
+
+    // Distance 0.5 is the glyph edge, so an empty atlas reads as "far outside"
+    std::vector<unsigned char> empty(AtlasSize * AtlasSize, 0);
+    glGenTextures(1, &m_AtlasTexture);
+    GLStateCache::BindTexture(m_AtlasTexture);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_R8, AtlasSize, AtlasSize, 0, GL_RED, GL_UNSIGNED_BYTE, empty.data());
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+
+    m_Loaded = true;
+    Logger::Info("Font loaded: " + path);
+}
+
+Font::~Font() {
+    if (m_AtlasTexture) {
+        GLStateCache::OnTextureDeleted(m_AtlasTexture);
+        glDeleteTextures(1, &m_AtlasTexture);
+    }
+}
+
+const Glyph* Font::GetGlyph(uint32_t codepoint) {
+    if (!m_Loaded) return nullptr;
+
+    auto it = m_Glyphs.find(codepoint);
+    if (it == m_Glyphs.end()) {
+        it = m_Glyphs.emplace(codepoint, RasterizeGlyph(codepoint)).first;
+    }
+    return &it->second;
+}
+
+float Font::GetKerning(uint32_t left, uint32_t right) const {
+    if (!m_Loaded) return 0.0f;
+    return stbtt_GetCodepointKernAdvance(m_Info.get(), (int)left, (int)right) * m_Scale;
+}
+
+Glyph Font::RasterizeGlyph(uint32_t codepoint) {
+    Glyph glyph;
+    int advance, leftBearing;
+    stbtt_GetCodepointHMetrics(m_Info.get(), (int)codepoint, &advance, &leftBearing);
+    glyph.advance = advance * m_Scale;
+
+    // 128 marks the edge; the field falls to 0 over the padding
+    int width = 0, height = 0, xoff = 0, yoff = 0;
+    unsigned char* sdf = stbtt_GetCodepointSDF(m_Info.get(), m_Scale, (int)codepoint, SDFPadding, 128,
+                                               128.0f / SDFPadding, &width, &height, &xoff, &yoff);
+    if (!sdf) return glyph;   // Blank glyph
+
+    int x, y;
+    if (AllocateRegion(width, height, x, y)) {
+        GLStateCache::BindTexture(m_AtlasTexture);
+        glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+        glTexSubImage2D(GL_TEXTURE_2D, 0, x, y, width, height, GL_RED, GL_UNSIGNED_BYTE, sdf);
+        glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+
+        glyph.offset = glm::vec2((float)xoff, (float)yoff);
+        glyph.size = glm::vec2((float)width, (float)height);
+        glyph.uvRect = glm::vec4((float)x, (float)y, (float)(x + width), (float)(y + height)) / (float)AtlasSize;
+    }
+
+    stbtt_FreeSDF(sdf, nullptr);
+    return glyph;
+}
+
+bool Font::AllocateRegion(int width, int height, int& x, int& y) {
+    // One pixel gap keeps bilinear filtering from reading neighbouring glyphs
+    const int gap = 1;
+    if (m_ShelfX + width + gap > AtlasSize) {
+        m_ShelfX = 0;
+        m_ShelfY += m_ShelfHeight + gap;
+        m_ShelfHeight = 0;
+    }
+    if (width + gap > AtlasSize || m_ShelfY + height + gap > AtlasSize) {
+        if (!m_AtlasFull) {
+            Logger::Warn("Font - glyph atlas is full, new glyphs will be blank", this);
+            m_AtlasFull = true;
+        }
+        return false;
+    }
+
+    x = m_ShelfX;
+    y = m_ShelfY;
+    m_ShelfX += width + gap;
+    m_ShelfHeight = std::max(m_ShelfHeight, height);
+    return true;
+}
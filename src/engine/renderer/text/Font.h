@@ -0,0 +1,54 @@
+#pragma once
+#include <glm/glm.hpp>
+#include <string>
+#include <vector>
+#include <memory>
+#include <unordered_map>
+#include <cstdint>
+
+struct stbtt_fontinfo;
+
+struct Glyph {
+    glm::vec2 offset{0.0f};     // Top-left of the quad relative to the pen on the baseline (base size px)
+    glm::vec2 size{0.0f};       // Quad size at base size; zero for blank glyphs like spaces
+    glm::vec4 uvRect{0.0f};     // Atlas sub-rect (min uv, max uv)
+    float advance = 0.0f;
+};
+
+// TrueType font rasterized on demand into a single-channel signed distance field atlas.
+// Glyphs are generated once at the base size and scale to any text size; the atlas
+// is never evicted, so glyph uv rects stay valid for the font's lifetime.
+class Font {
+public:
+    static constexpr int AtlasSize = 1024;
+    static constexpr int SDFPadding = 6;    // Distance field spread around each glyph (px at base size)
+
+    Font(const std::string& path, float baseSize = 48.0f);
+    ~Font();
+
+    // Rasterized into the atlas on first use; nullptr if the font failed to load
+    const Glyph* GetGlyph(uint32_t codepoint);
+    float GetKerning(uint32_t left, uint32_t right) const;
+
+    bool IsLoaded() const { return m_Loaded; }
+    float GetBaseSize() const { return m_BaseSize; }
+    float GetAscent() const { return m_Ascent; }
+    float GetDescent() const { return m_Descent; }
+    float GetLineHeight() const { return m_LineHeight; }
+    unsigned int GetAtlasTexture() const { return m_AtlasTexture; }
+    size_t GetGlyphCount() const { return m_Glyphs.size(); }
+
+private:
+    std::vector<unsigned char> m_FontData;          // stb_truetype reads from this in place
+    std::unique_ptr<stbtt_fontinfo> m_Info;
+    std::unordered_map<uint32_t, Glyph> m_Glyphs;
+    float m_BaseSize, m_Scale;
+    float m_Ascent, m_Descent, m_LineHeight;
+    unsigned int m_AtlasTexture;
+    int m_ShelfX, m_ShelfY, m_ShelfHeight;          // Shelf packer cursor
+    bool m_Loaded, m_AtlasFull;
+
+    // Helper functions
+    Glyph RasterizeGlyph(uint32_t codepoint);
+    bool AllocateRegion(int width, int height, int& x, int& y);
+};
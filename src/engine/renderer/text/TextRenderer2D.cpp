@@ -0,0 +1,164 @@
+#include "TextRenderer2D.h"
+#include "../GLStateCache.h"
+#include <glad/glad.h>
+#include <algorithm>
+#include <engine/utils/Logger.h>
+#include <engine/utils/Profiler.h>
+
+namespace {
+    // Next code point of a UTF-8 string; malformed bytes decode as U+FFFD
+    uint32_t DecodeUtf8(const std::string& text, size_t& i) {
+        unsigned char lead = (unsigned char)text[i++];
+        if (lead < 0x80) return lead;
+
+        int extra = (lead >= 0xF0) ? 3 : (lead >= 0xE0) ? 2 : (lead >= 0xC0) ? 1 : -1;
+        if (extra < 0) return 0xFFFD;
+
+        uint32_t codepoint = lead & (0x3F >> extra);
+        for (int k = 0; k < extra; k++) {
+            if (i >= text.size() || ((unsigned char)text[i] & 0xC0) != 0x80) return 0xFFFD;
+            codepoint = (codepoint << 6) | ((unsigned char)text[i++] & 0x3F);
+        }
+        return codepoint;
+    }
+}
+
+TextRenderer2D::TextRenderer2D()
+    : m_Batch(nullptr), m_Shader(nullptr), m_CurrentFont(nullptr), m_Frame(0),
+      m_OutlineWidth(0.0f), m_OutlineColor(0.0f, 0.0f, 0.0f, 1.0f)
+{
+    m_Batch = new QuadBatch();
+    m_Shader = new Shader("shaders/BaseVertex.vert.glsl", "shaders/TextFrag.frag.glsl");
+}
+
+TextRenderer2D::~TextRenderer2D() {
+    delete m_Batch;
+    delete m_Shader;
+}
+
+void TextRenderer2D::Begin(const glm::mat4& projection) {
+    m_Frame++;
+    EvictStaleStrings();
+
+    m_Batch->Begin(m_Shader);
+    m_Shader->SetMat4("uProjection", projection);
+    m_Shader->SetInt("uAtlas", 0);
+    m_Shader->SetFloat("uOutlineWidth", m_OutlineWidth);
+    m_Shader->SetVec4("uOutlineColor", m_OutlineColor);
+    m_CurrentFont = nullptr;
+}
+
+void TextRenderer2D::DrawString(Font& font, const std::string& text, const glm::vec2& position, float size,
+                                const glm::vec4& color, TextAlign align) {
+    if (text.empty() || !font.IsLoaded()) return;
+
+    // Glyphs of the previous font go out with their own atlas
+    if (&font != m_CurrentFont) {
+        m_Batch->Flush();
+        m_CurrentFont = &font;
+    }
+
+    // Shaping can rasterize new glyphs and rebind textures, so the atlas is bound afterwards
+    const ShapedText& shaped = Shape(font, text);
+    GLStateCache::BindTexture(0, font.GetAtlasTexture());
+
+    float scale = size / font.GetBaseSize();
+    QuadInstance instance;
+    instance.rotation = 0.0f;
+    instance.color = color;
+    instance.texIndex = 1.0f;
+
+    for (const ShapedGlyph& glyph : shaped.glyphs) {
+        float lineWidth = shaped.lineWidths[glyph.line];
+        float alignOffset = align == TextAlign::Center ? -lineWidth * 0.5f :
+                            align == TextAlign::Right ? -lineWidth : 0.0f;
+
+        glm::vec2 topLeft = glyph.offset + glm::vec2(alignOffset, 0.0f);
+        instance.size = glyph.size * scale;
+        instance.position = position + topLeft * scale + instance.size * 0.5f;
+        instance.uvRect = glyph.uvRect;
+        m_Batch->Add(instance);
+    }
+}
+
+void TextRenderer2D::End() {
+    if (m_CurrentFont) {
+        GLStateCache::BindTexture(0, m_CurrentFont->GetAtlasTexture());
+    }
+    m_Batch->End();
+    m_CurrentFont = nullptr;
+}
+
+glm::vec2 TextRenderer2D::MeasureText(Font& font, const std::string& text, float size) {
+    if (text.empty() || !font.IsLoaded()) return glm::vec2(0.0f);
+    return Shape(font, text).bounds * (size / font.GetBaseSize());
+}
+
+size_t TextRenderer2D::GetCachedStringCount() const {
+    size_t count = 0;
+    for (const auto& [font, strings] : m_Cache) {
+        count += strings.size();
+    }
+    return count;
+}
+
+const TextRenderer2D::ShapedText& TextRenderer2D::Shape(Font& font, const std::string& text) {
+    auto& strings = m_Cache[&font];
+    auto it = strings.find(text);
+    if (it != strings.end()) {
+        it->second.lastUsedFrame = m_Frame;
+        return it->second;
+    }
+
+    PROFILE_SCOPE("TextRenderer2D::Shape");
+    ShapedText shaped;
+    shaped.lastUsedFrame = m_Frame;
+
+    glm::vec2 pen(0.0f);
+    uint32_t line = 0;
+    uint32_t previous = 0;
+    size_t i = 0;
+    while (i < text.size()) {
+        uint32_t codepoint = DecodeUtf8(text, i);
+        if (codepoint == '\n') {
+            shaped.lineWidths.push_back(pen.x);
+            pen = glm::vec2(0.0f, pen.y + font.GetLineHeight());
+            line++;
+            previous = 0;
+            continue;
+        }
+
+        const Glyph* glyph = font.GetGlyph(codepoint);
+        if (!glyph) continue;
+
+        if (previous) {
+            pen.x += font.GetKerning(previous, codepoint);
+        }
+        if (glyph->size.x > 0.0f) {
+            shaped.glyphs.push_back({ pen + glyph->offset, glyph->size, glyph->uvRect, line });
+        }
+        pen.x += glyph->advance;
+        previous = codepoint;
+    }
+    shaped.lineWidths.push_back(pen.x);
+
+    shaped.bounds.x = *std::max_element(shaped.lineWidths.begin(), shaped.lineWidths.end());
+    shaped.bounds.y = pen.y + font.GetAscent() - font.GetDescent();
+
+    return strings.emplace(text, std::move(shaped)).first->second;
+}
+
+void TextRenderer2D::EvictStaleStrings() {
+    if (GetCachedStringCount() <= MaxCachedStrings) return;
+
+    // Dynamic strings (timers, scores) pile up; keep only what was drawn recently
+    for (auto& [font, strings] : m_Cache) {
+        for (auto it = strings.begin(); it != strings.end();) {
+            if (m_Frame - it->second.lastUsedFrame > CacheEvictFrames) {
+                it = strings.erase(it);
+            } else {
+                ++it;
+            }
+        }
+    }
+}
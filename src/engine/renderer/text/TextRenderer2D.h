@@ -0,0 +1,67 @@
+#pragma once
+#include <glm/glm.hpp>
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <cstdint>
+#include "Font.h"
+#include "../QuadBatch.h"
+#include "../Shader.h"
+
+enum class TextAlign {
+    Left,
+    Center,
+    Right
+};
+
+// World-space SDF text. Strings are shaped once (glyph lookup, kerning, line breaks) and
+// cached, so drawing a string every frame only scales its glyph quads into the batch.
+// All text between Begin and End shares one draw call per font.
+class TextRenderer2D {
+public:
+    static constexpr size_t MaxCachedStrings = 4096;
+    static constexpr uint64_t CacheEvictFrames = 300;   // Unused this long once the cache is full
+
+    TextRenderer2D();
+    ~TextRenderer2D();
+
+    void Begin(const glm::mat4& projection);
+    // position is the first baseline; align applies to each line
+    void DrawString(Font& font, const std::string& text, const glm::vec2& position, float size,
+                    const glm::vec4& color, TextAlign align = TextAlign::Left);
+    void End();
+
+    glm::vec2 MeasureText(Font& font, const std::string& text, float size);
+
+    // Edge outline in distance-field units (0 disables)
+    void SetOutline(float width, const glm::vec4& color) { m_OutlineWidth = width; m_OutlineColor = color; }
+
+    size_t GetCachedStringCount() const;
+
+private:
+    struct ShapedGlyph {
+        glm::vec2 offset;   // Quad top-left at base size, relative to the start of its line
+        glm::vec2 size;
+        glm::vec4 uvRect;
+        uint32_t line;
+    };
+
+    struct ShapedText {
+        std::vector<ShapedGlyph> glyphs;
+        std::vector<float> lineWidths;   // Base size
+        glm::vec2 bounds{0.0f};          // Widest line, total height (base size)
+        uint64_t lastUsedFrame = 0;
+    };
+
+    QuadBatch* m_Batch;
+    Shader* m_Shader;
+    Font* m_CurrentFont;
+    std::unordered_map<const Font*, std::unordered_map<std::string, ShapedText>> m_Cache;
+    uint64_t m_Frame;
+    float m_OutlineWidth;
+    glm::vec4 m_OutlineColor;
+
+    // Helper functions
+    const ShapedText& Shape(Font& font, const std::string& text);
+    void EvictStaleStrings();
+};
@@ -72,6 +72,7 @@ void GameInspectorUI::DrawGameComponents(Entity& entity) {
             int currentType = static_cast<int>(light.type);
             ImGui::Combo("Type", &currentType, lightTypes, IM_ARRAYSIZE(lightTypes));
             light.type = static_cast<LightType>(currentType);
+            ImGui::Checkbox("Static (baked)", &light.isStatic);
             ImGui::Separator();
             
             // Color controls with multiple options
@@ -12,6 +12,26 @@
 // Forward declaration for game callback
 // extern void OnNetworkUIDisconnect(); // This line is removed as per the edit hint.
 
+namespace {
+    void DrawLatencyHistogram(const char* label, const LatencyHistogram& histogram) {
+        float counts[LatencyHistogram::BucketCount];
+        float highest = 0.0f;
+        for (int i = 0; i < LatencyHistogram::BucketCount; i++) {
+            counts[i] = (float)histogram.GetCount(i);
+            highest = std::max(highest, counts[i]);
+        }
+
+        ImGui::Text("%s  p50 < %.2f ms  p99 < %.2f ms  max %.2f ms", label,
+                    histogram.GetPercentile(0.5) / 1000.0, histogram.GetPercentile(0.99) / 1000.0,
+                    histogram.GetMax() / 1000.0);
+        // Log2 buckets from 1 us on the left to 0.5 s on the right
+        ImGui::PushID(label);
+        ImGui::PlotHistogram("##Buckets", counts, LatencyHistogram::BucketCount, 0, nullptr,
+                             0.0f, std::max(highest, 1.0f), ImVec2(-1.0f, 50.0f));
+        ImGui::PopID();
+    }
+}
+
 NetworkUI::NetworkUI() {
     // Initialize with a default player name
     static int playerCounter = 1;
@@ -262,6 +282,16 @@ void NetworkUI::DrawNetworkStats() {
         ImGui::Text("%u", manager.GetPacketsReceived());
         ImGui::NextColumn();
         
+        ImGui::Text("Messages Sent:");
+        ImGui::NextColumn();
+        ImGui::Text("%u", manager.GetMessagesSent());
+        ImGui::NextColumn();
+        
+        ImGui::Text("Messages Received:");
+        ImGui::NextColumn();
+        ImGui::Text("%u", manager.GetMessagesReceived());
+        ImGui::NextColumn();
+        
         ImGui::Text("Bytes Sent:");
         ImGui::NextColumn();
         ImGui::Text("%.2f KB", manager.GetBytesSent() / 1024.0f);
@@ -324,6 +354,12 @@ void NetworkUI::DrawNetworkStats() {
         ImGui::Text("Connection Quality:");
         ImGui::SameLine();
         ImGui::TextColored(qualityColor, "%s", qualityText.c_str());
+        
+        // The network thread services ENet on its own clock; only dispatch waits for the frame
+        ImGui::Separator();
+        ImGui::Text("Network Thread");
+        DrawLatencyHistogram("Service interval", manager.GetServiceIntervalHistogram());
+        DrawLatencyHistogram("Dispatch delay", manager.GetDispatchDelayHistogram());
     }
     ImGui::EndChild();
 }
@@ -354,8 +390,8 @@ void NetworkUI::DrawConnectedPeers() {
             ImGui::Text("%s:%u", peer.address.c_str(), peer.port);
             
             ImGui::TableNextColumn();
-            if (peer.enetPeer) {
-                ImGui::Text("%u ms", peer.enetPeer->roundTripTime);
+            if (peer.roundTripTime > 0) {
+                ImGui::Text("%u ms", peer.roundTripTime);
             } else {
                 ImGui::Text("N/A");
             }
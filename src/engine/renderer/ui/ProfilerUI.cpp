@@ -0,0 +1,138 @@
+#include "ProfilerUI.h"
+#include <engine/utils/Profiler.h>
+#include <engine/renderer/GpuProfiler.h>
+#include <algorithm>
+#include <imgui.h>
+
+void ProfilerUI::Render() {
+    if (!m_showWindow) {
+        return;
+    }
+
+    ImGui::SetNextWindowSize(ImVec2(520, 480), ImGuiCond_FirstUseEver);
+    if (ImGui::Begin("Profiler", &m_showWindow)) {
+        bool enabled = Profiler::IsEnabled();
+        if (ImGui::Checkbox("Enabled", &enabled)) {
+            Profiler::SetEnabled(enabled);
+        }
+
+        ImGui::SameLine();
+        if (ImGui::Button("Save Chrome Trace")) {
+            SaveTrace();
+        }
+        if (!m_lastSaveMessage.empty()) {
+            ImGui::SameLine();
+            ImGui::TextUnformatted(m_lastSaveMessage.c_str());
+        }
+
+        DrawFrameGraph();
+        ImGui::Separator();
+
+        if (ImGui::BeginTabBar("ProfilerTabs")) {
+            if (ImGui::BeginTabItem("CPU")) {
+                DrawCpuZones();
+                ImGui::EndTabItem();
+            }
+            if (ImGui::BeginTabItem("GPU")) {
+                DrawGpuZones();
+                ImGui::EndTabItem();
+            }
+            ImGui::EndTabBar();
+        }
+    }
+    ImGui::End();
+}
+
+bool ProfilerUI::SaveTrace() {
+    bool ok = Profiler::WriteChromeTrace(m_tracePath);
+    m_lastSaveMessage = ok ? "Saved " + m_tracePath : "Save failed";
+    return ok;
+}
+
+void ProfilerUI::DrawFrameGraph() {
+    const auto& frameTimes = Profiler::GetFrameTimesMs();
+
+    float worst = 0.0f;
+    for (float ms : frameTimes) {
+        worst = std::max(worst, ms);
+    }
+
+    ImGui::Text("CPU frame: %.2f ms   GPU: %.2f ms   Worst: %.2f ms",
+                Profiler::GetLastFrameMs(), GpuProfiler::GetLastFrameMs(), worst);
+
+    if (!frameTimes.empty()) {
+        // Scale to at least 33 ms so a steady 60 Hz frame sits in the lower half
+        ImGui::PlotLines("##FrameTimes", frameTimes.data(), (int)frameTimes.size(), 0, nullptr,
+                         0.0f, std::max(worst, 33.3f), ImVec2(-1.0f, 60.0f));
+    }
+}
+
+void ProfilerUI::DrawCpuZones() {
+    const auto& zones = Profiler::GetZoneStats();
+    if (zones.empty()) {
+        ImGui::TextDisabled("No zones recorded");
+        return;
+    }
+
+    if (ImGui::BeginTable("CpuZones", 5, ImGuiTableFlags_Borders | ImGuiTableFlags_RowBg | ImGuiTableFlags_ScrollY)) {
+        ImGui::TableSetupScrollFreeze(0, 1);
+        ImGui::TableSetupColumn("Zone");
+        ImGui::TableSetupColumn("Calls", ImGuiTableColumnFlags_WidthFixed, 45.0f);
+        ImGui::TableSetupColumn("ms", ImGuiTableColumnFlags_WidthFixed, 55.0f);
+        ImGui::TableSetupColumn("Avg", ImGuiTableColumnFlags_WidthFixed, 55.0f);
+        ImGui::TableSetupColumn("Max", ImGuiTableColumnFlags_WidthFixed, 55.0f);
+        ImGui::TableHeadersRow();
+
+        uint32_t currentThread = 0;
+        for (const auto& zone : zones) {
+            if (zone.threadId == Profiler::GpuThreadId) continue;
+
+            if (zone.threadId != currentThread) {
+                currentThread = zone.threadId;
+                ImGui::TableNextRow();
+                ImGui::TableNextColumn();
+                ImGui::TextColored(ImVec4(0.6f, 0.8f, 1.0f, 1.0f), "%s", Profiler::GetThreadName(currentThread).c_str());
+            }
+
+            ImGui::TableNextRow();
+            ImGui::TableNextColumn();
+            ImGui::Indent(8.0f * (zone.depth + 1));
+            ImGui::TextUnformatted(zone.name);
+            ImGui::Unindent(8.0f * (zone.depth + 1));
+            ImGui::TableNextColumn();
+            ImGui::Text("%u", zone.calls);
+            ImGui::TableNextColumn();
+            ImGui::Text("%.3f", zone.totalMs);
+            ImGui::TableNextColumn();
+            ImGui::Text("%.3f", zone.averageMs);
+            ImGui::TableNextColumn();
+            ImGui::Text("%.3f", zone.maxMs);
+        }
+        ImGui::EndTable();
+    }
+}
+
+void ProfilerUI::DrawGpuZones() {
+    const auto& results = GpuProfiler::GetLastResults();
+    ImGui::Text("Dropped frames: %u", GpuProfiler::GetDroppedFrames());
+
+    if (results.empty()) {
+        ImGui::TextDisabled("No GPU zones resolved yet");
+        return;
+    }
+
+    if (ImGui::BeginTable("GpuZones", 2, ImGuiTableFlags_Borders | ImGuiTableFlags_RowBg)) {
+        ImGui::TableSetupColumn("Pass");
+        ImGui::TableSetupColumn("ms", ImGuiTableColumnFlags_WidthFixed, 60.0f);
+        ImGui::TableHeadersRow();
+
+        for (const auto& result : results) {
+            ImGui::TableNextRow();
+            ImGui::TableNextColumn();
+            ImGui::TextUnformatted(result.name);
+            ImGui::TableNextColumn();
+            ImGui::Text("%.3f", result.ms);
+        }
+        ImGui::EndTable();
+    }
+}
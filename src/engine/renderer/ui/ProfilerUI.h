@@ -0,0 +1,31 @@
+#pragma once
+
+#include <string>
+
+// Live view of the CPU and GPU profilers with a Chrome trace export button
+class ProfilerUI {
+public:
+    ProfilerUI() = default;
+
+    // Must be called inside an ImGui frame
+    void Render();
+
+    // Writes the profiler's frame history to m_tracePath
+    bool SaveTrace();
+
+    // State management
+    void SetVisible(bool visible) { m_showWindow = visible; }
+    bool IsVisible() const { return m_showWindow; }
+    void ToggleVisibility() { m_showWindow = !m_showWindow; }
+
+    void SetTracePath(const std::string& path) { m_tracePath = path; }
+
+private:
+    void DrawFrameGraph();
+    void DrawCpuZones();
+    void DrawGpuZones();
+
+    bool m_showWindow = false;
+    std::string m_tracePath = "profile_trace.json";
+    std::string m_lastSaveMessage;
+};
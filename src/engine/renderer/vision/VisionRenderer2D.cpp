@@ -1,24 +1,42 @@
 #include "VisionRenderer2D.h"
 #include <glm/gtc/matrix_transform.hpp>
 #include <engine/utils/Logger.h>
+#include <engine/utils/Profiler.h>
 #include <algorithm>
 #include <cmath>
+#include "../shadow/ShadowMap2D.h"
 
 VisionRenderer2D::VisionRenderer2D(int windowWidth, int windowHeight)
-    : m_WindowWidth(windowWidth), m_WindowHeight(windowHeight), m_DebugMode(false)
+    : m_WindowWidth(windowWidth), m_WindowHeight(windowHeight), m_ObstacleWorld(nullptr), m_ShadowMap(nullptr),
+      m_VisibilityDirty(true), m_VisibilityRevision(0), m_DebugMode(false)
 {
     m_VisionShader = new Shader("shaders/VisionVertex.vert.glsl", "shaders/VisionFrag.frag.glsl");
     m_QuadBatch = new QuadBatch();
+    m_OverlayTarget = new OverlayTarget2D(RenderTargetFormat::RGBA8);
     Logger::Info("Vision shader created with ID: " + std::to_string(m_VisionShader->GetID()));
 }
 
 VisionRenderer2D::~VisionRenderer2D() {
+    delete m_OverlayTarget;
     delete m_QuadBatch;
     delete m_VisionShader;
 }
 
 void VisionRenderer2D::DrawVisionOverlay(const glm::vec2& playerPos, const glm::vec2& playerDirection, 
                                         const VisionConfig& config) {
+    // Shade at the configured scale; composited back in OverlayTarget2D::End()
+    bool scaled = m_OverlayTarget->Begin(m_WindowWidth, m_WindowHeight, config.renderScale);
+    
+    ShadeVisionOverlay(playerPos, playerDirection, config);
+    
+    if (scaled) {
+        m_OverlayTarget->End();
+    }
+}
+
+void VisionRenderer2D::ShadeVisionOverlay(const glm::vec2& playerPos, const glm::vec2& playerDirection, 
+                                         const VisionConfig& config) {
+    PROFILE_SCOPE("VisionRenderer2D::ShadeVisionOverlay");
     // Start the quad batch with our vision shader
     m_QuadBatch->Begin(m_VisionShader);
     
@@ -34,7 +52,7 @@ void VisionRenderer2D::DrawVisionOverlay(const glm::vec2& playerPos, const glm::
     // Create a quad that covers the entire screen
     QuadInstance visionInstance;
     visionInstance.position = glm::vec2(m_WindowWidth * 0.5f, m_WindowHeight * 0.5f);
-    visionInstance.size = glm::vec2(m_WindowWidth + 100.0f, m_WindowHeight + 100.0f); // Slightly larger for full coverage
+    visionInstance.size = glm::vec2((float)m_WindowWidth, (float)m_WindowHeight); // Exactly covers the window
     visionInstance.rotation = 0.0f;
     visionInstance.color = glm::vec4(1.0f); // White color (actual color handled in shader)
     visionInstance.texIndex = 0.0f;
@@ -43,22 +61,21 @@ void VisionRenderer2D::DrawVisionOverlay(const glm::vec2& playerPos, const glm::
     m_QuadBatch->End();
 }
 
-void VisionRenderer2D::AddObstacle(const glm::vec2& position, const glm::vec2& size) {
-    m_Obstacles.emplace_back(position, size);
+void VisionRenderer2D::SetObstacleWorld(const ObstacleWorld* world) {
+    m_ObstacleWorld = world;
+    m_VisibilityDirty = true;
 }
 
-void VisionRenderer2D::AddObstacle(const Obstacle& obstacle) {
-    m_Obstacles.push_back(obstacle);
+const ObstacleWorld* VisionRenderer2D::GetObstacleWorld() const {
+    return m_ObstacleWorld;
 }
 
-void VisionRenderer2D::ClearObstacles() {
-    m_Obstacles.clear();
+void VisionRenderer2D::SetShadowMap(ShadowMap2D* shadowMap) {
+    m_ShadowMap = shadowMap;
 }
 
-void VisionRenderer2D::RemoveObstacle(size_t index) {
-    if (index < m_Obstacles.size()) {
-        m_Obstacles.erase(m_Obstacles.begin() + index);
-    }
+ShadowMap2D* VisionRenderer2D::GetShadowMap() const {
+    return m_ShadowMap;
 }
 
 void VisionRenderer2D::SetVisionConfig(const VisionConfig& config) {
@@ -88,17 +105,9 @@ float VisionRenderer2D::GetVisibilityAtPosition(const glm::vec2& position, const
     // 2. Check vision cone
     if (!IsInVisionCone(position, playerPos, playerDirection, config.angle)) return 0.0f;
     
-    // 3. Check line of sight
-    glm::vec2 rayDir = glm::normalize(position - playerPos);
-    float rayLength = distance;
-    
-    for (const auto& obstacle : m_Obstacles) {
-        float hitDistance;
-        if (RayIntersectsBox(playerPos, rayDir, obstacle.position, obstacle.size, hitDistance)) {
-            if (hitDistance < rayLength) {
-                return 0.0f; // Blocked by obstacle
-            }
-        }
+    // 3. Check line of sight against the cached visibility polygon
+    if (!GetVisibilityPolygon(playerPos, config.range).Contains(position)) {
+        return 0.0f; // Blocked by obstacle
     }
     
     // 4. Apply distance falloff
@@ -106,6 +115,20 @@ float VisionRenderer2D::GetVisibilityAtPosition(const glm::vec2& position, const
     return falloff;
 }
 
+const VisibilityPolygon2D& VisionRenderer2D::GetVisibilityPolygon(const glm::vec2& playerPos, float range) const {
+    uint32_t revision = m_ObstacleWorld ? m_ObstacleWorld->GetRevision() : 0;
+    if (m_VisibilityDirty || revision != m_VisibilityRevision || !m_VisibilityPolygon.IsBuiltFor(playerPos, range)) {
+        if (m_ObstacleWorld) {
+            m_VisibilityPolygon.Build(playerPos, range, *m_ObstacleWorld);
+        } else {
+            m_VisibilityPolygon.Build(playerPos, range, std::vector<Obstacle>());
+        }
+        m_VisibilityRevision = revision;
+        m_VisibilityDirty = false;
+    }
+    return m_VisibilityPolygon;
+}
+
 void VisionRenderer2D::SetDebugMode(bool enabled) {
     m_DebugMode = enabled;
 }
@@ -115,11 +138,8 @@ void VisionRenderer2D::DrawObstaclesDebug() {
     
     // This method can be used with a separate debug renderer if needed
     // For now, we'll rely on the shader's debug visualization
-    Logger::Info("Drawing " + std::to_string(m_Obstacles.size()) + " obstacles");
-}
-
-void VisionRenderer2D::AddObstacles(const std::vector<Obstacle>& obstacles) {
-    m_Obstacles.insert(m_Obstacles.end(), obstacles.begin(), obstacles.end());
+    size_t obstacleCount = m_ObstacleWorld ? m_ObstacleWorld->GetCount() : 0;
+    Logger::Info("Drawing " + std::to_string(obstacleCount) + " obstacles");
 }
 
 void VisionRenderer2D::UpdateShaderUniforms(const glm::vec2& playerPos, const glm::vec2& playerDirection, 
@@ -135,42 +155,13 @@ void VisionRenderer2D::UpdateShaderUniforms(const glm::vec2& playerPos, const gl
     m_VisionShader->SetFloat("uShadowLength", config.shadowLength);
     m_VisionShader->SetFloat("uShadowSoftness", config.shadowSoftness);
     
-    // Obstacle parameters
-    int obstacleCount = std::min((int)m_Obstacles.size(), 32); // Limit to 32 obstacles
-    m_VisionShader->SetInt("uObstacleCount", obstacleCount);
-    
-    // Set obstacle positions and sizes
-    for (int i = 0; i < obstacleCount; i++) {
-        std::string posUniform = "uObstacles[" + std::to_string(i) + "]";
-        std::string sizeUniform = "uObstacleSizes[" + std::to_string(i) + "]";
-        
-        m_VisionShader->SetVec2(posUniform, m_Obstacles[i].position);
-        m_VisionShader->SetVec2(sizeUniform, m_Obstacles[i].size);
+    // Occlusion parameters - the player is one caster in the shared occlusion map
+    int playerRow = -1;
+    if (m_ShadowMap) {
+        playerRow = m_ShadowMap->RequestCaster(playerPos);
+        m_ShadowMap->ApplyUniforms(m_VisionShader);
     }
-}
-
-bool VisionRenderer2D::RayIntersectsBox(const glm::vec2& rayStart, const glm::vec2& rayDir, 
-                                       const glm::vec2& boxCenter, const glm::vec2& boxSize, 
-                                       float& hitDistance) const {
-    glm::vec2 boxMin = boxCenter - boxSize * 0.5f;
-    glm::vec2 boxMax = boxCenter + boxSize * 0.5f;
-    
-    // Handle division by zero
-    glm::vec2 invDir;
-    invDir.x = (rayDir.x != 0.0f) ? 1.0f / rayDir.x : 1e30f;
-    invDir.y = (rayDir.y != 0.0f) ? 1.0f / rayDir.y : 1e30f;
-    
-    glm::vec2 t1 = (boxMin - rayStart) * invDir;
-    glm::vec2 t2 = (boxMax - rayStart) * invDir;
-    
-    glm::vec2 tMin = glm::min(t1, t2);
-    glm::vec2 tMax = glm::max(t1, t2);
-    
-    float tNear = std::max(tMin.x, tMin.y);
-    float tFar = std::min(tMax.x, tMax.y);
-    
-    hitDistance = tNear;
-    return tNear >= 0.0f && tNear <= tFar;
+    m_VisionShader->SetInt("uPlayerShadowRow", playerRow);
 }
 
 bool VisionRenderer2D::IsInVisionCone(const glm::vec2& worldPos, const glm::vec2& playerPos, 
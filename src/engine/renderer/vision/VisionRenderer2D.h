@@ -3,15 +3,11 @@
 #include <vector>
 #include "../QuadBatch.h"
 #include "../Shader.h"
+#include "../OverlayTarget2D.h"
+#include "../../core/spatial/VisibilityPolygon2D.h"
+#include "../../core/spatial/ObstacleWorld.h"
 
-// Structure to represent obstacles that block vision
-struct Obstacle {
-    glm::vec2 position;
-    glm::vec2 size;
-    
-    Obstacle(const glm::vec2& pos, const glm::vec2& sz) 
-        : position(pos), size(sz) {}
-};
+class ShadowMap2D;
 
 // Structure to hold vision parameters
 struct VisionConfig {
@@ -20,6 +16,7 @@ struct VisionConfig {
     float shadowLength = 500.0f;    // How far shadows extend
     float shadowSoftness = 0.5f;    // Edge softness for shadows
     glm::vec4 darkColor = glm::vec4(0.0f, 0.0f, 0.0f, 0.8f); // Color for dark areas
+    float renderScale = 1.0f;       // Overlay resolution scale (1.0 full, 0.5 half, 0.25 quarter)
 };
 
 class VisionRenderer2D {
@@ -31,12 +28,16 @@ public:
     void DrawVisionOverlay(const glm::vec2& playerPos, const glm::vec2& playerDirection, 
                           const VisionConfig& config = VisionConfig{});
     
-    // Obstacle management
-    void AddObstacle(const glm::vec2& position, const glm::vec2& size);
-    void AddObstacles(const std::vector<Obstacle>& obstacles);
-    void AddObstacle(const Obstacle& obstacle);
-    void ClearObstacles();
-    void RemoveObstacle(size_t index);
+    // Shades the overlay into the bound target as-is (no scaling or compositing - the render graph does that)
+    void ShadeVisionOverlay(const glm::vec2& playerPos, const glm::vec2& playerDirection, const VisionConfig& config);
+    
+    // Shared obstacle set (nothing blocks vision when none is set)
+    void SetObstacleWorld(const ObstacleWorld* world);
+    const ObstacleWorld* GetObstacleWorld() const;
+    
+    // Shared occlusion map (line of sight is skipped when none is set)
+    void SetShadowMap(ShadowMap2D* shadowMap);
+    ShadowMap2D* GetShadowMap() const;
     
     // Vision configuration
     void SetVisionConfig(const VisionConfig& config);
@@ -51,6 +52,9 @@ public:
     float GetVisibilityAtPosition(const glm::vec2& position, const glm::vec2& playerPos, 
                                  const glm::vec2& playerDirection, const VisionConfig& config) const;
     
+    // Visibility polygon around the player, rebuilt only when the player, range or obstacles change
+    const VisibilityPolygon2D& GetVisibilityPolygon(const glm::vec2& playerPos, float range) const;
+    
     // Debug functions
     void SetDebugMode(bool enabled);
     void DrawObstaclesDebug();
@@ -59,6 +63,7 @@ private:
     // Core rendering components
     QuadBatch* m_QuadBatch;
     Shader* m_VisionShader;
+    OverlayTarget2D* m_OverlayTarget;
     
     // Window properties
     int m_WindowWidth, m_WindowHeight;
@@ -67,7 +72,13 @@ private:
     VisionConfig m_Config;
     
     // Obstacles
-    std::vector<Obstacle> m_Obstacles;
+    const ObstacleWorld* m_ObstacleWorld;
+    ShadowMap2D* m_ShadowMap;
+    
+    // Cached line of sight for CPU queries
+    mutable VisibilityPolygon2D m_VisibilityPolygon;
+    mutable bool m_VisibilityDirty;
+    mutable uint32_t m_VisibilityRevision; // Obstacle world revision the polygon was built from
     
     // Debug mode
     bool m_DebugMode;
@@ -75,9 +86,6 @@ private:
     // Helper functions
     void UpdateShaderUniforms(const glm::vec2& playerPos, const glm::vec2& playerDirection, 
                              const VisionConfig& config);
-    bool RayIntersectsBox(const glm::vec2& rayStart, const glm::vec2& rayDir, 
-                         const glm::vec2& boxCenter, const glm::vec2& boxSize, 
-                         float& hitDistance) const;
     bool IsInVisionCone(const glm::vec2& worldPos, const glm::vec2& playerPos, 
                        const glm::vec2& playerDir, float visionAngle) const;
 }; 
\ No newline at end of file
@@ -10,7 +10,7 @@
 #include "entity/EntityManager.h"
 #include "component/ComponentManager.h"
 #include "system/System.h"
-#include "..\utils\Logger.h"
+#include "../utils/Logger.h"
 
 class Scene {
 private:
@@ -5,6 +5,7 @@
 #include <glm/gtc/matrix_transform.hpp>
 #include <string>
 #include "../../renderer/lighting/Light.h"
+#include "../../renderer/particles/Particle.h"
 
 // Transform Component - Position, rotation, scale
 class TransformComponent : public Component {
@@ -320,6 +321,7 @@ public:
         node["innerAngle"] = light.innerAngle;
         node["outerAngle"] = light.outerAngle;
         node["bloom"] = light.bloom;
+        node["isStatic"] = light.isStatic;
         return node;
     }
 
@@ -343,5 +345,93 @@ public:
         light.innerAngle = node["innerAngle"].as<float>(0.0f);
         light.outerAngle = node["outerAngle"].as<float>(0.0f);
         light.bloom = node["bloom"].as<float>(0.0f);
+        light.isStatic = node["isStatic"].as<bool>(false);
+    }
+};
+
+// Particle Emitter Component - Continuous emission plus one-shot bursts, simulated on the GPU
+class ParticleEmitterComponent : public Component {
+public:
+    ParticleEmitParams params;          // params.position is relative to the transform
+    float emitRate = 100.0f;            // Particles per second
+    uint32_t burst = 0;                 // Emitted once on the next update, then reset
+    bool enabled = true;
+    float emitAccumulator = 0.0f;       // Fractional particles carried between frames (not serialized)
+
+    COMPONENT_TYPE(ParticleEmitterComponent)
+
+    ParticleEmitterComponent() = default;
+    ParticleEmitterComponent(const ParticleEmitParams& emitParams, float rate)
+        : params(emitParams), emitRate(rate) {}
+
+    YAML::Node Serialize() const override {
+        YAML::Node node;
+        node["offset_x"] = params.position.x;
+        node["offset_y"] = params.position.y;
+        node["positionJitter"] = params.positionJitter;
+        node["direction"] = params.direction;
+        node["spread"] = params.spread;
+        node["speedMin"] = params.speedMin;
+        node["speedMax"] = params.speedMax;
+        node["lifetimeMin"] = params.lifetimeMin;
+        node["lifetimeMax"] = params.lifetimeMax;
+        node["startSize"] = params.startSize;
+        node["endSize"] = params.endSize;
+        for (int i = 0; i < 4; i++) {
+            node["startColor"].push_back(params.startColor[i]);
+            node["endColor"].push_back(params.endColor[i]);
+        }
+        node["acceleration_x"] = params.acceleration.x;
+        node["acceleration_y"] = params.acceleration.y;
+        node["emitRate"] = emitRate;
+        node["burst"] = burst;
+        node["enabled"] = enabled;
+        return node;
+    }
+
+    void Deserialize(const YAML::Node& node) override {
+        ParticleEmitParams defaults;
+        params.position = glm::vec2(node["offset_x"].as<float>(0.0f), node["offset_y"].as<float>(0.0f));
+        params.positionJitter = node["positionJitter"].as<float>(defaults.positionJitter);
+        params.direction = node["direction"].as<float>(defaults.direction);
+        params.spread = node["spread"].as<float>(defaults.spread);
+        params.speedMin = node["speedMin"].as<float>(defaults.speedMin);
+        params.speedMax = node["speedMax"].as<float>(defaults.speedMax);
+        params.lifetimeMin = node["lifetimeMin"].as<float>(defaults.lifetimeMin);
+        params.lifetimeMax = node["lifetimeMax"].as<float>(defaults.lifetimeMax);
+        params.startSize = node["startSize"].as<float>(defaults.startSize);
+        params.endSize = node["endSize"].as<float>(defaults.endSize);
+        if (node["startColor"] && node["endColor"]) {
+            for (int i = 0; i < 4; i++) {
+                params.startColor[i] = node["startColor"][i].as<float>(defaults.startColor[i]);
+                params.endColor[i] = node["endColor"][i].as<float>(defaults.endColor[i]);
+            }
+        }
+        params.acceleration = glm::vec2(node["acceleration_x"].as<float>(0.0f), node["acceleration_y"].as<float>(0.0f));
+        emitRate = node["emitRate"].as<float>(100.0f);
+        burst = node["burst"].as<uint32_t>(0);
+        enabled = node["enabled"].as<bool>(true);
+        emitAccumulator = 0.0f;
+    }
+};
+
+// Replicated Component - Marks an entity for snapshot replication from the server
+class ReplicatedComponent : public Component {
+public:
+    uint32_t networkID = 0;     // Same on every peer; players use their peer ID
+
+    COMPONENT_TYPE(ReplicatedComponent)
+
+    ReplicatedComponent() = default;
+    explicit ReplicatedComponent(uint32_t id) : networkID(id) {}
+
+    YAML::Node Serialize() const override {
+        YAML::Node node;
+        node["networkID"] = networkID;
+        return node;
+    }
+
+    void Deserialize(const YAML::Node& node) override {
+        networkID = node["networkID"].as<uint32_t>(0);
     }
 };
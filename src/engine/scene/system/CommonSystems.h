@@ -2,8 +2,12 @@
 
 #include "System.h"
 #include "../component/CommonComponents.h"
+#include "../../core/spatial/SpatialHash2D.h"
 #include <glm/glm.hpp>
 #include <algorithm>
+#include <functional>
+#include <cmath>
+#include <cfloat>
 #include <vector>
 
 // Physics System - Updates physics components
@@ -196,6 +200,141 @@ public:
     }
 };
 
+// Culling System - Keeps renderable bounds in a spatial hash so drawing only visits what is on screen
+class CullingSystem : public ECSSystem<CullingSystem> {
+public:
+    // World-space size an entity is drawn at; defaults to the transform scale
+    using BoundsProvider = std::function<glm::vec2(EntityID)>;
+
+private:
+    SpatialHash2D m_spatialHash;
+    BoundsProvider m_boundsProvider;
+    std::vector<uint32_t> m_queryResults;
+    std::vector<std::pair<int, EntityID>> m_sortKeys;   // (render layer, entity)
+    std::vector<EntityID> m_visibleEntities;
+
+public:
+    SYSTEM_TYPE(CullingSystem)
+
+    CullingSystem(float cellSize = 256.0f) : m_spatialHash(cellSize) {}
+
+    void Update(float deltaTime) override {
+        auto entities = GetEntitiesWith<TransformComponent, RenderableComponent>();
+        
+        // Entities that disappeared or were hidden drop out of the hash at EndSweep. Insert only
+        // re-bins an entity whose box moved into different cells; the rest just get stamped
+        m_spatialHash.BeginSweep();
+        for (EntityID entityID : entities) {
+            auto* transform = GetComponent<TransformComponent>(entityID);
+            auto* renderable = GetComponent<RenderableComponent>(entityID);
+            
+            if (!transform || !renderable || !renderable->visible) continue;
+            
+            glm::vec2 size = m_boundsProvider ? m_boundsProvider(entityID) : glm::vec2(transform->scale);
+            glm::vec2 halfExtents = glm::abs(size) * 0.5f;
+            
+            // Rotated quads: use the box around the rotated rectangle
+            if (transform->rotation.z != 0.0f) {
+                float c = std::abs(std::cos(transform->rotation.z));
+                float s = std::abs(std::sin(transform->rotation.z));
+                halfExtents = glm::vec2(c * halfExtents.x + s * halfExtents.y,
+                                        s * halfExtents.x + c * halfExtents.y);
+            }
+            
+            glm::vec2 center(transform->position);
+            m_spatialHash.Insert(entityID, center - halfExtents, center + halfExtents);
+        }
+        m_spatialHash.EndSweep();
+    }
+
+    void SetBoundsProvider(BoundsProvider provider) {
+        m_boundsProvider = std::move(provider);
+    }
+
+    // Visible entities inside a world-space view rect, sorted by render layer then entity ID
+    const std::vector<EntityID>& QueryVisible(const glm::vec2& viewMin, const glm::vec2& viewMax) {
+        m_queryResults.clear();
+        m_spatialHash.Query(viewMin, viewMax, m_queryResults);
+        
+        // Look the layers up once instead of inside the comparator
+        m_sortKeys.clear();
+        for (EntityID entityID : m_queryResults) {
+            auto* renderable = GetComponent<RenderableComponent>(entityID);
+            m_sortKeys.emplace_back(renderable ? renderable->renderLayer : 0, entityID);
+        }
+        std::sort(m_sortKeys.begin(), m_sortKeys.end());
+        
+        m_visibleEntities.clear();
+        for (const auto& key : m_sortKeys) {
+            m_visibleEntities.push_back(key.second);
+        }
+        return m_visibleEntities;
+    }
+
+    // Same, with the view rect taken from a 2D view-projection (e.g. CameraSystem::GetViewProjectionMatrix)
+    const std::vector<EntityID>& QueryVisible(const glm::mat4& viewProjection) {
+        glm::mat4 inverse = glm::inverse(viewProjection);
+        glm::vec2 viewMin(FLT_MAX), viewMax(-FLT_MAX);
+        const glm::vec2 corners[4] = { {-1.0f, -1.0f}, {1.0f, -1.0f}, {-1.0f, 1.0f}, {1.0f, 1.0f} };
+        for (const auto& corner : corners) {
+            glm::vec4 world = inverse * glm::vec4(corner, 0.0f, 1.0f);
+            glm::vec2 point = glm::vec2(world) / world.w;
+            viewMin = glm::min(viewMin, point);
+            viewMax = glm::max(viewMax, point);
+        }
+        return QueryVisible(viewMin, viewMax);
+    }
+
+    size_t GetTrackedCount() const {
+        return m_spatialHash.GetCount();
+    }
+
+    size_t GetVisibleCount() const {
+        return m_visibleEntities.size();
+    }
+};
+
+// Particle Emitter System - Turns emitter components into bursts for the GPU particle simulation.
+// Work is per emitter, never per particle.
+class ParticleEmitterSystem : public ECSSystem<ParticleEmitterSystem> {
+public:
+    // Receives each frame's bursts (e.g. ParticleRenderer2D::Emit)
+    using EmitCallback = std::function<void(const ParticleEmitParams&, uint32_t)>;
+
+private:
+    EmitCallback m_emitCallback;
+
+public:
+    SYSTEM_TYPE(ParticleEmitterSystem)
+
+    void Update(float deltaTime) override {
+        if (!m_emitCallback) return;
+        
+        auto entities = GetEntitiesWith<TransformComponent, ParticleEmitterComponent>();
+        for (EntityID entityID : entities) {
+            auto* transform = GetComponent<TransformComponent>(entityID);
+            auto* emitter = GetComponent<ParticleEmitterComponent>(entityID);
+            if (!transform || !emitter || !emitter->enabled) continue;
+            
+            // Whole particles only; the remainder carries over so low rates still emit
+            emitter->emitAccumulator += std::max(emitter->emitRate, 0.0f) * deltaTime;
+            uint32_t count = (uint32_t)emitter->emitAccumulator;
+            emitter->emitAccumulator -= (float)count;
+            count += emitter->burst;
+            emitter->burst = 0;
+            if (count == 0) continue;
+            
+            ParticleEmitParams params = emitter->params;
+            params.position += glm::vec2(transform->position);
+            m_emitCallback(params, count);
+        }
+    }
+
+    void SetEmitCallback(EmitCallback callback) {
+        m_emitCallback = std::move(callback);
+    }
+};
+
 // Audio System - Manages audio playback
 class AudioSystem : public ECSSystem<AudioSystem> {
 public:
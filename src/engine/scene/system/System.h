@@ -7,6 +7,7 @@
 #include <type_traits>
 #include "../entity/EntityManager.h"
 #include "../component/ComponentManager.h"
+#include "../../utils/Profiler.h"
 
 // Base system interface
 class ISystem {
@@ -16,6 +17,7 @@ public:
     virtual void OnDestroy() {}
     virtual void Update(float deltaTime) = 0;
     virtual std::string GetSystemName() const = 0;
+    virtual const char* GetProfileName() const { return "System"; }   // Static string for profiler zones
     
     bool IsEnabled() const { return m_enabled; }
     void SetEnabled(bool enabled) { m_enabled = enabled; }
@@ -50,7 +52,8 @@ std::size_t System<Derived>::s_counter = 0;
 
 // Helper macro for system type identification
 #define SYSTEM_TYPE(ClassName) \
-    std::string GetSystemName() const override { return #ClassName; }
+    std::string GetSystemName() const override { return #ClassName; } \
+    const char* GetProfileName() const override { return #ClassName; }
 
 // SFINAE helpers for detecting methods
 template<typename T, typename = void>
@@ -132,6 +135,7 @@ public:
     void UpdateSystems(float deltaTime) {
         for (auto& system : m_systems) {
             if (system->IsEnabled()) {
+                PROFILE_SCOPE(system->GetProfileName());
                 system->Update(deltaTime);
             }
         }
@@ -0,0 +1,316 @@
+#include "Profiler.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <deque>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string_view>
+#include <unordered_set>
+#include <engine/utils/Logger.h>
+
+namespace {
+    using Clock = std::chrono::steady_clock;
+    const Clock::time_point s_Start = Clock::now();
+
+    // Peaks are kept over two windows of this many frames
+    constexpr uint64_t PeakWindowFrames = 120;
+    constexpr double AverageSmoothing = 0.1;
+
+    struct OpenZone {
+        const char* name;       // nullptr when the profiler was disabled at BeginZone
+        uint64_t startNs;
+    };
+
+    struct ThreadBuffer {
+        uint32_t id = 0;
+        std::string name;
+        std::mutex mutex;                   // Guards events (owner thread vs. BeginFrame)
+        std::vector<ProfileEvent> events;   // Closed zones not collected yet
+        std::vector<OpenZone> stack;        // Owner thread only
+    };
+
+    struct Frame {
+        uint64_t startNs = 0;
+        uint64_t endNs = 0;
+        std::vector<ProfileEvent> events;
+    };
+
+    struct ZoneAccumulator {
+        ProfileZoneStats stats;
+        double windowPeakMs = 0.0;
+        double previousWindowPeakMs = 0.0;
+        uint64_t lastSeenFrame = 0;
+    };
+
+    // Buffers are never freed: threads keep a raw pointer to theirs until they exit
+    std::mutex s_RegistryMutex;
+    std::vector<std::unique_ptr<ThreadBuffer>> s_Threads;
+    std::unordered_set<std::string> s_InternedNames;
+    std::atomic<bool> s_Enabled{ true };
+    thread_local ThreadBuffer* t_Buffer = nullptr;
+
+    // Main thread only
+    std::deque<Frame> s_History;
+    std::vector<ProfileEvent> s_GpuEvents;
+    std::map<std::pair<std::string_view, uint32_t>, ZoneAccumulator> s_Zones;
+    std::vector<ProfileZoneStats> s_Stats;
+    std::vector<float> s_FrameTimesMs;
+    uint64_t s_FrameStartNs = 0;
+    uint64_t s_FrameIndex = 0;
+    double s_LastFrameMs = 0.0;
+
+    // Zones are only buffered once someone collects frames
+    std::atomic<bool> s_FrameStarted{ false };
+
+    ThreadBuffer* GetThreadBuffer() {
+        if (!t_Buffer) {
+            std::lock_guard<std::mutex> lock(s_RegistryMutex);
+            auto buffer = std::make_unique<ThreadBuffer>();
+            buffer->id = (uint32_t)s_Threads.size() + 1;
+            buffer->name = "Thread " + std::to_string(buffer->id);
+            t_Buffer = buffer.get();
+            s_Threads.push_back(std::move(buffer));
+        }
+        return t_Buffer;
+    }
+
+    void UpdateStats(const Frame& frame) {
+        for (auto& [key, zone] : s_Zones) {
+            zone.stats.totalMs = 0.0;
+            zone.stats.calls = 0;
+        }
+
+        for (const auto& event : frame.events) {
+            ZoneAccumulator& zone = s_Zones[{ std::string_view(event.name), event.threadId }];
+            if (zone.stats.calls == 0) {
+                zone.stats.name = event.name;
+                zone.stats.threadId = event.threadId;
+                zone.stats.depth = event.depth;
+            }
+            zone.stats.totalMs += event.durationNs / 1e6;
+            zone.stats.calls++;
+            zone.lastSeenFrame = s_FrameIndex;
+        }
+
+        bool newWindow = s_FrameIndex % PeakWindowFrames == 0;
+        s_Stats.clear();
+        for (auto it = s_Zones.begin(); it != s_Zones.end();) {
+            ZoneAccumulator& zone = it->second;
+
+            // Zones that stopped appearing drop out of the panel after a while
+            if (s_FrameIndex - zone.lastSeenFrame > Profiler::MaxHistoryFrames) {
+                it = s_Zones.erase(it);
+                continue;
+            }
+
+            zone.stats.averageMs += (zone.stats.totalMs - zone.stats.averageMs) * AverageSmoothing;
+            if (newWindow) {
+                zone.previousWindowPeakMs = zone.windowPeakMs;
+                zone.windowPeakMs = 0.0;
+            }
+            zone.windowPeakMs = std::max(zone.windowPeakMs, zone.stats.totalMs);
+            zone.stats.maxMs = std::max(zone.windowPeakMs, zone.previousWindowPeakMs);
+
+            s_Stats.push_back(zone.stats);
+            ++it;
+        }
+
+        std::sort(s_Stats.begin(), s_Stats.end(), [](const ProfileZoneStats& a, const ProfileZoneStats& b) {
+            if (a.threadId != b.threadId) return a.threadId < b.threadId;
+            return a.averageMs > b.averageMs;
+        });
+    }
+
+    void WriteEscaped(FILE* file, const char* text) {
+        for (const char* c = text; *c; c++) {
+            if (*c == '"' || *c == '\\') {
+                fputc('\\', file);
+                fputc(*c, file);
+            } else if ((unsigned char)*c < 0x20) {
+                fprintf(file, "\\u%04x", (unsigned int)(unsigned char)*c);
+            } else {
+                fputc(*c, file);
+            }
+        }
+    }
+}
+
+void Profiler::BeginFrame() {
+    uint64_t now = NowNs();
+    ThreadBuffer* mainBuffer = GetThreadBuffer();
+
+    if (!s_FrameStarted) {
+        // The thread driving frames is the main thread
+        std::lock_guard<std::mutex> lock(s_RegistryMutex);
+        mainBuffer->name = "Main";
+        s_FrameStarted.store(true);
+        s_FrameStartNs = now;
+        return;
+    }
+
+    Frame frame;
+    frame.startNs = s_FrameStartNs;
+    frame.endNs = now;
+    {
+        std::lock_guard<std::mutex> lock(s_RegistryMutex);
+        for (auto& buffer : s_Threads) {
+            std::lock_guard<std::mutex> bufferLock(buffer->mutex);
+            frame.events.insert(frame.events.end(), buffer->events.begin(), buffer->events.end());
+            buffer->events.clear();
+        }
+    }
+    frame.events.insert(frame.events.end(), s_GpuEvents.begin(), s_GpuEvents.end());
+    s_GpuEvents.clear();
+
+    s_FrameIndex++;
+    s_LastFrameMs = (now - s_FrameStartNs) / 1e6;
+    UpdateStats(frame);
+
+    s_FrameTimesMs.push_back((float)s_LastFrameMs);
+    if (s_FrameTimesMs.size() > MaxHistoryFrames) {
+        s_FrameTimesMs.erase(s_FrameTimesMs.begin());
+    }
+
+    s_History.push_back(std::move(frame));
+    if (s_History.size() > MaxHistoryFrames) {
+        s_History.pop_front();
+    }
+
+    s_FrameStartNs = now;
+}
+
+void Profiler::BeginZone(const char* name) {
+    ThreadBuffer* buffer = GetThreadBuffer();
+    if (!s_Enabled.load(std::memory_order_relaxed) || !s_FrameStarted.load(std::memory_order_relaxed)) {
+        buffer->stack.push_back({ nullptr, 0 });
+        return;
+    }
+    buffer->stack.push_back({ name, NowNs() });
+}
+
+void Profiler::EndZone() {
+    ThreadBuffer* buffer = GetThreadBuffer();
+    if (buffer->stack.empty()) return;
+
+    OpenZone zone = buffer->stack.back();
+    buffer->stack.pop_back();
+    if (!zone.name) return;
+
+    ProfileEvent event;
+    event.name = zone.name;
+    event.startNs = zone.startNs;
+    event.durationNs = NowNs() - zone.startNs;
+    event.threadId = buffer->id;
+    event.depth = (uint32_t)buffer->stack.size();
+
+    std::lock_guard<std::mutex> lock(buffer->mutex);
+    buffer->events.push_back(event);
+}
+
+void Profiler::RecordGpuZone(const char* name, uint64_t cpuStartNs, uint64_t durationNs) {
+    if (!s_Enabled.load(std::memory_order_relaxed)) return;
+
+    ProfileEvent event;
+    event.name = name;
+    event.startNs = cpuStartNs;
+    event.durationNs = durationNs;
+    event.threadId = GpuThreadId;
+    event.depth = 0;
+    s_GpuEvents.push_back(event);
+}
+
+void Profiler::SetThreadName(const std::string& name) {
+    ThreadBuffer* buffer = GetThreadBuffer();
+    std::lock_guard<std::mutex> lock(s_RegistryMutex);
+    buffer->name = name;
+}
+
+const char* Profiler::InternName(const std::string& name) {
+    std::lock_guard<std::mutex> lock(s_RegistryMutex);
+    return s_InternedNames.insert(name).first->c_str();
+}
+
+void Profiler::SetEnabled(bool enabled) {
+    s_Enabled.store(enabled, std::memory_order_relaxed);
+}
+
+bool Profiler::IsEnabled() {
+    return s_Enabled.load(std::memory_order_relaxed);
+}
+
+uint64_t Profiler::NowNs() {
+    return (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - s_Start).count();
+}
+
+const std::vector<ProfileZoneStats>& Profiler::GetZoneStats() {
+    return s_Stats;
+}
+
+double Profiler::GetLastFrameMs() {
+    return s_LastFrameMs;
+}
+
+const std::vector<float>& Profiler::GetFrameTimesMs() {
+    return s_FrameTimesMs;
+}
+
+std::string Profiler::GetThreadName(uint32_t threadId) {
+    if (threadId == GpuThreadId) return "GPU";
+
+    std::lock_guard<std::mutex> lock(s_RegistryMutex);
+    for (const auto& buffer : s_Threads) {
+        if (buffer->id == threadId) return buffer->name;
+    }
+    return "Thread " + std::to_string(threadId);
+}
+
+bool Profiler::WriteChromeTrace(const std::string& path) {
+    FILE* file = fopen(path.c_str(), "w");
+    if (!file) {
+        Logger::Error<std::string>("Profiler - Could not open trace file: " + path);
+        return false;
+    }
+
+    fprintf(file, "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n");
+
+    // Track names; frames get their own track so spikes are easy to spot
+    fprintf(file, "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":0,\"tid\":0,\"args\":{\"name\":\"Frames\"}}");
+    fprintf(file, ",\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":0,\"tid\":%u,\"args\":{\"name\":\"GPU\"}}", GpuThreadId);
+    {
+        std::lock_guard<std::mutex> lock(s_RegistryMutex);
+        for (const auto& buffer : s_Threads) {
+            fprintf(file, ",\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":0,\"tid\":%u,\"args\":{\"name\":\"", buffer->id);
+            WriteEscaped(file, buffer->name.c_str());
+            fprintf(file, "\"}}");
+        }
+    }
+
+    uint64_t frameNumber = s_FrameIndex - s_History.size();
+    for (const auto& frame : s_History) {
+        frameNumber++;
+        fprintf(file, ",\n{\"name\":\"Frame %llu\",\"cat\":\"frame\",\"ph\":\"X\",\"pid\":0,\"tid\":0,\"ts\":%.3f,\"dur\":%.3f}",
+                (unsigned long long)frameNumber, frame.startNs / 1e3, (frame.endNs - frame.startNs) / 1e3);
+
+        for (const auto& event : frame.events) {
+            fprintf(file, ",\n{\"name\":\"");
+            WriteEscaped(file, event.name);
+            fprintf(file, "\",\"cat\":\"%s\",\"ph\":\"X\",\"pid\":0,\"tid\":%u,\"ts\":%.3f,\"dur\":%.3f}",
+                    event.threadId == GpuThreadId ? "gpu" : "cpu", event.threadId,
+                    event.startNs / 1e3, event.durationNs / 1e3);
+        }
+    }
+
+    fprintf(file, "\n]}\n");
+    bool ok = ferror(file) == 0;
+    fclose(file);
+
+    if (ok) {
+        Logger::Info("Profiler - Wrote " + std::to_string(s_History.size()) + " frames to " + path);
+    } else {
+        Logger::Error<std::string>("Profiler - Failed writing trace file: " + path);
+    }
+    return ok;
+}
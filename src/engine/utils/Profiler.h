@@ -0,0 +1,89 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Compile with PRISM_PROFILER_ENABLED=0 to strip every zone from the build
+#ifndef PRISM_PROFILER_ENABLED
+#define PRISM_PROFILER_ENABLED 1
+#endif
+
+// One closed zone. Names must outlive the profiler (string literals or Profiler::InternName)
+struct ProfileEvent {
+    const char* name;
+    uint64_t startNs;       // Since profiler start
+    uint64_t durationNs;
+    uint32_t threadId;
+    uint32_t depth;
+};
+
+// Per-frame totals for one zone name on one thread
+struct ProfileZoneStats {
+    const char* name = nullptr;
+    uint32_t threadId = 0;
+    uint32_t depth = 0;         // Depth of the first occurrence
+    uint32_t calls = 0;
+    double totalMs = 0.0;       // Last frame
+    double averageMs = 0.0;     // Smoothed over recent frames
+    double maxMs = 0.0;         // Worst frame in the history window
+};
+
+// Scoped CPU zone profiler. Any thread can open zones; the main thread closes a frame with
+// BeginFrame(), which gathers every thread's zones into a history of recent frames.
+// Recording a zone is two clock reads and a push into a per-thread buffer.
+class Profiler {
+public:
+    static constexpr uint32_t GpuThreadId = 0xFFFF;
+    static constexpr size_t MaxHistoryFrames = 600;
+
+    // Main thread, once per frame: collects the finished frame and starts the next one
+    static void BeginFrame();
+
+    static void BeginZone(const char* name);
+    static void EndZone();
+
+    // Adds a zone measured on the GPU, placed at the CPU time its commands were issued
+    static void RecordGpuZone(const char* name, uint64_t cpuStartNs, uint64_t durationNs);
+
+    // Label for the calling thread in the panel and trace (e.g. "Audio")
+    static void SetThreadName(const std::string& name);
+
+    // Stable copy of a runtime string (pass names, ...), safe to use as a zone name
+    static const char* InternName(const std::string& name);
+
+    static void SetEnabled(bool enabled);
+    static bool IsEnabled();
+
+    static uint64_t NowNs();
+
+    // Results of the last complete frame
+    static const std::vector<ProfileZoneStats>& GetZoneStats();
+    static double GetLastFrameMs();
+    static const std::vector<float>& GetFrameTimesMs();   // Oldest first
+    static std::string GetThreadName(uint32_t threadId);
+
+    // Writes the frame history as Chrome trace JSON (chrome://tracing, Perfetto)
+    static bool WriteChromeTrace(const std::string& path);
+};
+
+// Opens a zone for the lifetime of the object
+class ProfileScope {
+public:
+    explicit ProfileScope(const char* name) { Profiler::BeginZone(name); }
+    ~ProfileScope() { Profiler::EndZone(); }
+
+    ProfileScope(const ProfileScope&) = delete;
+    ProfileScope& operator=(const ProfileScope&) = delete;
+};
+
+#define PRISM_PROFILE_CONCAT_INNER(a, b) a##b
+#define PRISM_PROFILE_CONCAT(a, b) PRISM_PROFILE_CONCAT_INNER(a, b)
+
+#if PRISM_PROFILER_ENABLED
+#define PROFILE_SCOPE(name) ProfileScope PRISM_PROFILE_CONCAT(profileScope, __LINE__)(name)
+#define PROFILE_FUNCTION() PROFILE_SCOPE(__FUNCTION__)
+#else
+#define PROFILE_SCOPE(name) ((void)0)
+#define PROFILE_FUNCTION() ((void)0)
+#endif
@@ -9,6 +9,9 @@
 #include <engine/renderer/lighting/Light.h>
 #include <engine/renderer/QuadBatch.h>
 #include <engine/renderer/Shader.h>
+#include <engine/renderer/GLStateCache.h>
+#include <engine/renderer/TextureLoader.h>
+#include <engine/utils/Profiler.h>
 #include <glm/glm.hpp>
 #include <algorithm>
 #include <cmath>
@@ -121,16 +124,13 @@ void framebufferSizeCallback(GLFWwindow* window, int width, int height) {
 }
 
 void Game::setupObstacles() {
-    visionRenderer->ClearObstacles();
-    lightRenderer->ClearObstacles();
-    fogRenderer->ClearObstacles();
-    m_Obstacles.push_back(Obstacle(glm::vec2(400, 300), glm::vec2(100, 200)));
-    m_Obstacles.push_back(Obstacle(glm::vec2(800, 400), glm::vec2(150, 80)));
-    m_Obstacles.push_back(Obstacle(glm::vec2(200, 500), glm::vec2(120, 120)));
-    m_Obstacles.push_back(Obstacle(glm::vec2(1000, 200), glm::vec2(80, 300)));
-    visionRenderer->AddObstacles(m_Obstacles);
-    lightRenderer->AddObstacles(m_Obstacles);
-    fogRenderer->AddObstacles(m_Obstacles);
+    std::vector<Obstacle> obstacles;
+    obstacles.push_back(Obstacle(glm::vec2(400, 300), glm::vec2(100, 200)));
+    obstacles.push_back(Obstacle(glm::vec2(800, 400), glm::vec2(150, 80)));
+    obstacles.push_back(Obstacle(glm::vec2(200, 500), glm::vec2(120, 120)));
+    obstacles.push_back(Obstacle(glm::vec2(1000, 200), glm::vec2(80, 300)));
+    obstacleWorld->SetObstacles(obstacles);
+    m_ObstacleHandles.clear();
 }
 
 void Game::setupLights() {
@@ -138,6 +138,7 @@ void Game::setupLights() {
     
     // Single point light with good dispersion
     m_Lights.emplace_back(glm::vec2(640, 360), 1204.0f, glm::vec3(1.0f, 1.0f, 1.0f), 5.25f);
+    m_Lights.back().isStatic = true; // Never moves - baked once
 }
 
 Game::Game(int width, int height, const char* title)
@@ -149,8 +150,17 @@ Game::Game(int width, int height, const char* title)
       fogRenderer(nullptr),
       visionRenderer(nullptr),
       lightRenderer(nullptr),
+      shadowMap(nullptr),
+      renderGraph(nullptr),
+      obstacleWorld(nullptr),
+      staticBatch(nullptr),
+      particleRenderer(nullptr),
+      textRenderer(nullptr),
+      nameplateFont(nullptr),
       m_RenderMode(RenderMode::LIGHTING),
       m_playerMovementSystem(nullptr),
+      m_cullingSystem(nullptr),
+      m_particleEmitterSystem(nullptr),
       m_localPlayerNetworkID(0),
       m_selectedEntityID(INVALID_ENTITY_ID)
 {
@@ -160,6 +170,21 @@ Game::Game(int width, int height, const char* title)
     fogRenderer = new FogRenderer2D(width, height);
     visionRenderer = new VisionRenderer2D(width, height);
     lightRenderer = new LightRenderer2D(width, height);
+    shadowMap = new ShadowMap2D();
+    fogRenderer->SetShadowMap(shadowMap);
+    visionRenderer->SetShadowMap(shadowMap);
+    lightRenderer->SetShadowMap(shadowMap);
+    renderGraph = new RenderGraph2D();
+    obstacleWorld = new ObstacleWorld();
+    staticBatch = new StaticBatch();
+    particleRenderer = new ParticleRenderer2D();
+    textRenderer = new TextRenderer2D();
+    textRenderer->SetOutline(0.12f, glm::vec4(0.0f, 0.0f, 0.0f, 0.85f));
+    nameplateFont = new Font("fonts/Roboto-Medium.ttf");
+    fogRenderer->SetObstacleWorld(obstacleWorld);
+    visionRenderer->SetObstacleWorld(obstacleWorld);
+    lightRenderer->SetObstacleWorld(obstacleWorld);
+    shadowMap->SetObstacleWorld(obstacleWorld);
     pseudo3DShader = new Shader("shaders/Pseudo3D.vert.glsl", "shaders/Pseudo3D.frag.glsl");
     // Create ECS scene
     m_scene = std::make_unique<Scene>("GameScene", 1);
@@ -168,15 +193,13 @@ Game::Game(int width, int height, const char* title)
     setupObstacles();
     setupLights();
     
-    // Setup fog system with obstacles
-    fogRenderer->AddObstacles(m_Obstacles);
-    
     // Configure vision system
     m_VisionConfig.range = 1024.0f;
     m_VisionConfig.angle = 1.0472f; // 60 degrees in radians
     m_VisionConfig.shadowLength = 900.0f;
     m_VisionConfig.shadowSoftness = 0.82f;
     m_VisionConfig.darkColor = glm::vec4(0.0f, 0.0f, 0.0f, 0.85f);
+    m_VisionConfig.renderScale = 0.5f;
     
     // Configure lighting system
     m_LightConfig.ambientLight = 0.45f;
@@ -186,6 +209,7 @@ Game::Game(int width, int height, const char* title)
     m_LightConfig.enableShadows = true;
     m_LightConfig.lightType = LightType::DIRECTIONAL_LIGHT;
     m_LightConfig.bloom = 0.5f;
+    m_LightConfig.renderScale = 0.5f;
     
     // Setup ImGui
     IMGUI_CHECKVERSION();
@@ -219,6 +243,7 @@ Game::Game(int width, int height, const char* title)
     // m_EcsInspector = std::make_unique<GuiLayout>("ecs_inspector");
     // m_NetworkManager = std::make_unique<GuiLayout>("network_manager");
     m_DebugInspector = std::make_unique<GuiLayout>("debug_inspector");
+    m_ProfilerUI = std::make_unique<ProfilerUI>();
 
     
     // Setup ECS systems and entities
@@ -234,6 +259,8 @@ void Game::OnInit() {
     Logger::Info("Press TAB to cycle between Fog, Vision, and Lighting systems");
     Logger::Info("Use WASD to move and change facing direction");
     Logger::Info("Press F5 to save scene, F9 to load scene");
+    Logger::Info("Press F3 to toggle the profiler, F4 to save a Chrome trace");
+    Logger::Info("Press F8 for a 250k particle burst from every emitter");
     Logger::Info("Press F1 to toggle ECS Inspector");
     Logger::Info("Press F6 to toggle Network UI");
     Logger::Info("Press F7 to disconnect from server");
@@ -439,6 +466,9 @@ void Game::SetupNetworkingHandlers() {
             // Add Tag component with joining player id
             newPlayer.AddComponent<TagComponent>("network_player_" + std::to_string(actualPlayerID));
             
+            // Players are replicated under their peer ID
+            newPlayer.AddComponent<ReplicatedComponent>(actualPlayerID);
+            
             // Store the mapping of network ID to entity
             m_networkPlayers[actualPlayerID] = newPlayer;
             
@@ -493,82 +523,61 @@ void Game::SetupNetworkingHandlers() {
                 
                 m_scene->DestroyEntity(it->second.GetID());
                 m_networkPlayers.erase(it);
+                m_interpolator.Remove(playerID);
                 Logger::Info("Network player disconnected (ID: " + std::to_string(playerID) + ")");
             }
         });
     
-    // Handle player movement updates
-    manager.RegisterPacketHandler(PacketType::PLAYER_MOVE,
+    // Client input commands; the server moves their player by simulating each one once
+    manager.RegisterPacketHandler(PacketType::PLAYER_INPUT,
         [this](const Packet& packet, uint32_t senderID) {
-            PacketData::PlayerMove moveData;
-            Packet mutablePacket = packet;
-            moveData.ReadFrom(mutablePacket);
-            
-            // Use senderID instead of packet playerID for consistency
-            uint32_t actualPlayerID = senderID;
-            
-            // Debug logging
-            static int moveLogCounter = 0;
-            if (moveLogCounter++ % 60 == 0) { // Log every 60 frames
-                Logger::Info("PLAYER_MOVE received: senderID=" + std::to_string(senderID) + 
-                            ", packetPlayerID=" + std::to_string(moveData.playerID) + 
-                            ", pos=(" + std::to_string(moveData.position.x) + "," + std::to_string(moveData.position.y) + ")" +
-                            ", networkPlayers.size=" + std::to_string(m_networkPlayers.size()));
+            auto it = m_networkPlayers.find(senderID);
+            if (it == m_networkPlayers.end() || !m_playerMovementSystem) {
+                return;
             }
             
-            // If we're the server and this is from a client, broadcast to all clients using proper broadcast
-            if (Network::GetManager().IsServer() && senderID != 0) {
-                // Create a new movement packet with correct player ID and send to other clients
-                PacketData::PlayerMove relayMoveData;
-                relayMoveData.playerID = actualPlayerID; // Use the actual sender's peer ID
-                relayMoveData.position = moveData.position;
-                relayMoveData.velocity = moveData.velocity;
-                relayMoveData.rotation = moveData.rotation;
-                
-                Packet relayPacket = PacketFactory::CreatePlayerMovePacket(relayMoveData);
-                
-                // Send to all clients EXCEPT the original sender
-                auto& relayManager = Network::GetManager();
-                for (const auto& peerInfo : relayManager.GetConnectedPeers()) {
-                    if (peerInfo.id != senderID) { // Don't send back to sender
-                        relayManager.SendPacket(relayPacket, peerInfo.id);
-                    }
-                }
-                
-                if (moveLogCounter % 60 == 0) {
-                    Logger::Info("Server broadcasting movement from client " + std::to_string(senderID) + " to other clients");
-                }
+            auto* transform = it->second.GetComponent<TransformComponent>();
+            auto* playerComp = it->second.GetComponent<PlayerComponent>();
+            if (!transform || !playerComp) {
+                return;
             }
             
-            auto it = m_networkPlayers.find(actualPlayerID);
-            if (it != m_networkPlayers.end()) {
-                auto* transform = it->second.GetComponent<TransformComponent>();
-                auto* playerComp = it->second.GetComponent<PlayerComponent>();
-                
-                if (transform && playerComp) {
-                    // Update position smoothly
-                    transform->position = glm::vec3(moveData.position.x, moveData.position.y, 0.0f);
-                    transform->rotation.z = moveData.rotation;
-                    
-                    // Update player direction
-                    float dirX = cos(moveData.rotation);
-                    float dirY = sin(moveData.rotation);
-                    playerComp->direction = glm::vec2(dirX, dirY);
-                    
-                    if (moveLogCounter % 60 == 0) {
-                        Logger::Info("Updated player " + std::to_string(actualPlayerID) + " position to (" + 
-                                    std::to_string(transform->position.x) + "," + std::to_string(transform->position.y) + ")");
-                    }
-                }
-            } else {
-                Logger::Warn<Game>("Received movement for unknown player ID: " + std::to_string(actualPlayerID) + 
-                                   " (available players: ", this);
-                for (const auto& pair : m_networkPlayers) {
-                    Logger::Info("  - Player ID: " + std::to_string(pair.first));
+            PacketData::PlayerInput input;
+            Packet mutablePacket = packet;
+            input.ReadFrom(mutablePacket);
+            
+            // Commands are resent until acked, so most of each packet was applied already
+            InputBudget& budget = m_inputBudgets[senderID];
+            budget.Refill(Time::TotalTimeDouble());
+            PlayerMovement::World world = m_playerMovementSystem->GetWorld();
+            glm::vec2 position(transform->position);
+            for (const PacketData::InputCommand& command : input.commands) {
+                if (!budget.Accept(command.sequence)) {
+                    continue;
                 }
+                position = PlayerMovement::Step(position, command.buttons, playerComp->size, world, m_inputScratch);
+                transform->rotation.z = command.aim;
+            }
+            transform->position.x = position.x;
+            transform->position.y = position.y;
+            playerComp->direction = glm::vec2(cos(transform->rotation.z), sin(transform->rotation.z));
+        });
+    
+    // Server world state, delta compressed against the last snapshot we acked
+    manager.RegisterPacketHandler(PacketType::GAME_STATE_UPDATE,
+        [this](const Packet& packet, uint32_t senderID) {
+            Snapshot snapshot;
+            if (m_replicationClient.Receive(Network::GetManager(), packet, snapshot)) {
+                ApplySnapshot(snapshot);
             }
         });
     
+    manager.RegisterPacketHandler(PacketType::SNAPSHOT_ACK,
+        [this](const Packet& packet, uint32_t senderID) {
+            BitReader bits = packet.ReadBits();
+            m_replicationServer.Acknowledge(senderID, bits.ReadVarUint());
+        });
+    
     // Set up network event handler for connection management
     manager.SetEventCallback([this](const NetworkEvent& event) {
         switch (event.type) {
@@ -580,6 +589,8 @@ void Game::SetupNetworkingHandlers() {
                 // If we're the server, handle new client connection
                 if (Network::GetManager().IsServer()) {
                     Logger::Info("Server handling new client connection...");
+                    m_replicationServer.AddClient(event.peerID);
+                    m_interestManager.AddClient(event.peerID);
                     
                     // Send ALL existing players to the new client
                     SendAllPlayersToClient(event.peerID);
@@ -597,6 +608,9 @@ void Game::SetupNetworkingHandlers() {
                 // If we're the server, handle the disconnection
                 if (Network::GetManager().IsServer()) {
                     Logger::Info("Server handling client disconnection...");
+                    m_replicationServer.RemoveClient(event.peerID);
+                    m_interestManager.RemoveClient(event.peerID);
+                    m_inputBudgets.erase(event.peerID);
                     // Remove the player from the network players map
                     auto it = m_networkPlayers.find(event.peerID);
                     if (it != m_networkPlayers.end()) {
@@ -618,6 +632,13 @@ void Game::SetupNetworkingHandlers() {
                 Logger::Info("Server started on " + event.message);
                 // Server always has ID 0
                 m_localPlayerNetworkID = 0;
+                m_replicationServer.Clear();
+                m_interestManager.Clear();
+                m_inputBudgets.clear();
+                m_snapshotTick = 0;
+                if (m_playerEntity.IsValid() && !m_playerEntity.HasComponent<ReplicatedComponent>()) {
+                    m_playerEntity.AddComponent<ReplicatedComponent>(0);
+                }
                 break;
                 
             case NetworkEventType::SERVER_CONNECTED:
@@ -625,6 +646,10 @@ void Game::SetupNetworkingHandlers() {
                 Logger::Info("Connected to server: " + event.message);
                 // Client gets their peer ID from the event
                 m_localPlayerNetworkID = event.peerID;
+                if (m_playerMovementSystem) {
+                    // The server numbers our commands from scratch for this connection
+                    m_playerMovementSystem->GetPredictor().Reset();
+                }
                 Logger::Info("Assigned client network ID: " + std::to_string(m_localPlayerNetworkID));
                 Logger::Info("Current network players at connection: " + std::to_string(m_networkPlayers.size()));
                 
@@ -641,6 +666,7 @@ void Game::SetupNetworkingHandlers() {
                 
                 // Reset our network ID
                 m_localPlayerNetworkID = 0;
+                m_replicationClient.Reset();
                 Logger::Info("Reset network ID to 0");
                 
                 // Clear all network players (this should remove server player if still present)
@@ -783,54 +809,85 @@ void Game::SendAllPlayersToClient(uint32_t clientID) {
     Logger::Info("=== FINISHED SENDING ALL PLAYERS TO CLIENT " + std::to_string(clientID) + " ===");
 }
 
-void Game::SendPlayerMovement() {
+void Game::SendPlayerInput() {
+    // The server's own player reaches clients through snapshots
     auto& manager = Network::GetManager();
-    if (!manager.IsServer() && !manager.IsClient()) {
+    if (!manager.IsClient() || !m_playerMovementSystem) {
         return;
     }
     
-    if (!m_playerEntity.IsValid()) {
+    // Until the server has assigned our ID it has no player to apply input to
+    if (manager.GetLocalPeerID() == 0) {
         return;
     }
     
-    auto* transform = m_playerEntity.GetComponent<TransformComponent>();
-    auto* playerComp = m_playerEntity.GetComponent<PlayerComponent>();
-    
-    if (!transform || !playerComp) {
+    // The newest commands the server hasn't applied yet, so a lost packet is covered by the next;
+    // after a longer outage the older ones are left to reconciliation
+    PacketData::PlayerInput input;
+    m_playerMovementSystem->GetPredictor().FillInput(input);
+    if (input.commands.empty()) {
         return;
     }
     
-    // Create movement packet
-    PacketData::PlayerMove moveData;
-    moveData.playerID = manager.GetLocalPeerID(); // Use NetworkManager's assigned peer ID
-    moveData.position = glm::vec2(transform->position);
-    moveData.velocity = glm::vec2(0.0f); // Could calculate velocity
-    moveData.rotation = transform->rotation.z;
-    
-    // Debug: Check if we have a valid peer ID before sending (server can have ID 0)
-    if (moveData.playerID == 0 && !manager.IsServer()) {
-        static int warningCounter = 0;
-        if (warningCounter++ % 120 == 0) { // Log every 2 seconds
-            Logger::Warn<Game>("CLIENT SendPlayerMovement called with peer ID 0! " +
-                              std::string("NetworkManager localPeerID: ") + std::to_string(manager.GetLocalPeerID()), this);
-        }
-        return; // Don't send movement with invalid peer ID for clients
+    PacketWriter inputPacket(PacketType::PLAYER_INPUT, PacketReliability::UNRELIABLE);
+    input.WriteTo(inputPacket);
+    manager.SendPacket(inputPacket);
+}
+
+void Game::SendSnapshots() {
+    auto& manager = Network::GetManager();
+    if (!manager.IsServer() || manager.GetPeerCount() == 0) {
+        return;
     }
     
-    Packet movePacket = PacketFactory::CreatePlayerMovePacket(moveData);
+    // Each client only gets the entities around its own player, within its byte budget
+    Snapshot world = Snapshot::Capture(*m_scene, ++m_snapshotTick);
+    world.rate = SnapshotRate;
+    m_interestManager.BeginTick(std::move(world));
+    for (const auto& peerInfo : manager.GetConnectedPeers()) {
+        Snapshot clientSnapshot = m_interestManager.BuildClientSnapshot(peerInfo.id);
+        auto input = m_inputBudgets.find(peerInfo.id);
+        clientSnapshot.inputAck = (input != m_inputBudgets.end()) ? input->second.GetLastApplied() : 0;
+        m_replicationServer.SendSnapshot(manager, peerInfo.id, clientSnapshot);
+    }
+}
+
+void Game::ApplySnapshot(const Snapshot& snapshot) {
+    // Our own player is predicted locally; the server only corrects it
+    const EntityState* self = snapshot.Find(m_localPlayerNetworkID);
+    if (self && m_playerMovementSystem && m_playerEntity.IsValid()) {
+        m_playerMovementSystem->Reconcile(m_playerEntity.GetID(), snapshot.inputAck, glm::vec2(self->position));
+    }
     
-    // Debug logging
-    static int logCounter = 0;
-    if (logCounter++ % 60 == 0) { // Log every 60 frames (about 1 second)
-        Logger::Info("SendPlayerMovement: playerID=" + std::to_string(moveData.playerID) + 
-                    ", pos=(" + std::to_string(moveData.position.x) + "," + std::to_string(moveData.position.y) + ")" +
-                    ", mode=" + std::string(manager.IsServer() ? "SERVER" : "CLIENT"));
+    // Everyone else is shown from the interpolation buffer, see UpdateRemotePlayers
+    m_interpolator.AddSnapshot(snapshot, Time::TotalTimeDouble());
+}
+
+void Game::UpdateRemotePlayers() {
+    if (!Network::GetManager().IsClient()) {
+        return;
     }
     
-    if (manager.IsServer()) {
-        manager.BroadcastPacket(movePacket);
-    } else {
-        manager.SendPacket(movePacket);
+    m_interpolator.Update(Time::TotalTimeDouble());
+    for (auto& [networkID, player] : m_networkPlayers) {
+        EntityState state;
+        if (networkID == m_localPlayerNetworkID || !m_interpolator.Sample(networkID, state)) {
+            continue;
+        }
+        
+        auto* transform = player.GetComponent<TransformComponent>();
+        auto* playerComp = player.GetComponent<PlayerComponent>();
+        auto* renderable = player.GetComponent<RenderableComponent>();
+        if (transform) {
+            transform->position = state.position;
+            transform->rotation = state.rotation;
+        }
+        if (playerComp) {
+            playerComp->direction = glm::vec2(cos(state.rotation.z), sin(state.rotation.z));
+        }
+        if (renderable) {
+            renderable->visible = state.visible;
+        }
     }
 }
 
@@ -850,6 +907,7 @@ void Game::ClearNetworkPlayers() {
         }
     }
     m_networkPlayers.clear();
+    m_interpolator.Clear();
     Logger::Info("All network players cleared");
 }
 
@@ -888,6 +946,9 @@ void Game::DisconnectFromServer() {
 void Game::SetupECSScene() {
     // Register all systems
     m_playerMovementSystem = m_scene->RegisterSystem<PlayerMovementSystem>(windowWidth, windowHeight);
+    m_playerMovementSystem->SetObstacleWorld(obstacleWorld);
+    SetupCulling(); // After movement so bounds are current when drawing
+    SetupParticles();
     
     // Create player entity
     m_playerEntity = m_scene->CreateEntity("Player");
@@ -912,16 +973,18 @@ void Game::SetupECSScene() {
     // Setup obstacles and lights
     SetupECSObstacles();
     SetupECSLights();
+    SetupECSParticles();
     
     Logger::Info("ECS Scene setup complete with " + 
                 std::to_string(m_scene->GetAllEntities().size()) + " entities");
 }
 
 void Game::SetupECSObstacles() {
-    // Clear old obstacle data from renderers
-    visionRenderer->ClearObstacles();
-    lightRenderer->ClearObstacles();
-    fogRenderer->ClearObstacles();
+    // Drop the legacy obstacles, the ECS entities below replace them
+    obstacleWorld->Clear();
+    m_ObstacleHandles.clear();
+    staticBatch->Clear();
+    m_StaticQuadHandles.clear();
     
     // Create obstacle entities matching the original positions
     struct ObstacleData {
@@ -960,32 +1023,140 @@ void Game::SetupECSLights() {
     
     // Create a proper Light struct for the LightComponent
     Light lightData(glm::vec2(640, 360), 1204.0f, glm::vec3(1.0f, 1.0f, 1.0f), 5.25f);
+    lightData.isStatic = true; // Never moves - baked into the lightmap
     light.AddComponent<LightComponent>(lightData);
     
     light.AddComponent<TagComponent>("light");
 }
 
-void Game::UpdateRenderersFromECS() {
-    // Update renderer obstacle lists from ECS entities
-    std::vector<Obstacle> obstacles;
+void Game::SetupECSParticles() {
+    // Sparks rising off the main light
+    Entity sparks = m_scene->CreateEntity("Sparks");
+    sparks.AddComponent<TransformComponent>(glm::vec3(640, 360, 0.0f));
+    
+    ParticleEmitParams params;
+    params.positionJitter = 12.0f;
+    params.direction = -1.5707963f;
+    params.spread = 1.2f;
+    params.speedMin = 60.0f;
+    params.speedMax = 220.0f;
+    params.lifetimeMin = 0.8f;
+    params.lifetimeMax = 2.0f;
+    params.startSize = 5.0f;
+    params.endSize = 1.0f;
+    params.startColor = glm::vec4(1.0f, 0.8f, 0.3f, 1.0f);
+    params.endColor = glm::vec4(1.0f, 0.2f, 0.05f, 0.0f);
+    params.acceleration = glm::vec2(0.0f, 90.0f);
+    sparks.AddComponent<ParticleEmitterComponent>(params, 400.0f);
+    
+    sparks.AddComponent<TagComponent>("particles");
+}
+
+void Game::SetupParticles() {
+    m_particleEmitterSystem = m_scene->GetSystem<ParticleEmitterSystem>();
+    if (!m_particleEmitterSystem) {
+        m_particleEmitterSystem = m_scene->RegisterSystem<ParticleEmitterSystem>();
+    }
+    
+    // Emitters only hand over bursts; spawning and simulation happen on the GPU
+    ParticleRenderer2D* particles = particleRenderer;
+    m_particleEmitterSystem->SetEmitCallback([particles](const ParticleEmitParams& params, uint32_t count) {
+        particles->Emit(params, count);
+    });
+}
+
+void Game::SetupCulling() {
+    m_cullingSystem = m_scene->GetSystem<CullingSystem>();
+    if (!m_cullingSystem) {
+        m_cullingSystem = m_scene->RegisterSystem<CullingSystem>();
+    }
+    
+    // Draw sizes live on the game components rather than the transform scale
+    ComponentManager* components = m_scene->GetComponentManager();
+    m_cullingSystem->SetBoundsProvider([components](EntityID entityID) -> glm::vec2 {
+        if (auto* player = components->GetComponent<PlayerComponent>(entityID)) {
+            // Include the direction indicator drawn around the player
+            return player->size + glm::vec2(56.0f);
+        }
+        if (auto* obstacle = components->GetComponent<ObstacleComponent>(entityID)) {
+            return obstacle->size;
+        }
+        auto* transform = components->GetComponent<TransformComponent>(entityID);
+        return transform ? glm::vec2(transform->scale) : glm::vec2(1.0f);
+    });
+}
+
+void Game::SyncObstacleWorld() {
+    // Obstacles are matched to their entities, so only moved, resized, added or
+    // removed ones touch the world (and its dependent caches)
+    uint32_t pass = ++m_ObstacleSyncPass;
     
     auto obstacleEntities = m_scene->GetEntitiesWith<TransformComponent, ObstacleComponent>();
     for (const Entity& entity : obstacleEntities) {
         auto* transform = entity.GetComponent<TransformComponent>();
         auto* obstacleComp = entity.GetComponent<ObstacleComponent>();
+        if (!transform || !obstacleComp) continue;
         
-        if (transform && obstacleComp) {
-            obstacles.emplace_back(
-                glm::vec2(transform->position), 
-                obstacleComp->size
-            );
+        Obstacle obstacle(glm::vec2(transform->position), obstacleComp->size);
+        ObstacleEntry& entry = m_ObstacleHandles[entity.GetID()];
+        if (!obstacleWorld->Update(entry.handle, obstacle)) {
+            entry.handle = obstacleWorld->Add(obstacle);
+        }
+        entry.seen = pass;
+    }
+    
+    // Entries not seen this pass belong to entities that no longer exist
+    for (auto it = m_ObstacleHandles.begin(); it != m_ObstacleHandles.end();) {
+        if (it->second.seen != pass) {
+            obstacleWorld->Remove(it->second.handle);
+            it = m_ObstacleHandles.erase(it);
+        } else {
+            ++it;
         }
     }
+}
+
+void Game::SyncStaticGeometry() {
+    // Same matching as SyncObstacleWorld: untouched obstacles leave their chunks clean,
+    // so nothing is re-uploaded on frames where the level does not change
+    uint32_t pass = ++m_StaticSyncPass;
     
-    // Update all renderers
-    visionRenderer->AddObstacles(obstacles);
-    lightRenderer->AddObstacles(obstacles);
-    fogRenderer->AddObstacles(obstacles);
+    auto obstacleEntities = m_scene->GetEntitiesWith<TransformComponent, ObstacleComponent, RenderableComponent>();
+    for (const Entity& entity : obstacleEntities) {
+        auto* transform = entity.GetComponent<TransformComponent>();
+        auto* obstacleComp = entity.GetComponent<ObstacleComponent>();
+        auto* renderable = entity.GetComponent<RenderableComponent>();
+        if (!transform || !obstacleComp || !renderable) continue;
+        // Hidden obstacles go unmarked, so their quads are removed below
+        if (!renderable->visible) continue;
+        
+        QuadInstance instance;
+        instance.position = glm::vec2(transform->position);
+        instance.size = obstacleComp->size;
+        instance.rotation = 0.0f;
+        instance.color = renderable->color;
+        instance.texIndex = 0.0f;
+        
+        StaticQuadEntry& entry = m_StaticQuadHandles[entity.GetID()];
+        if (!staticBatch->Update(entry.handle, instance)) {
+            entry.handle = staticBatch->Add(instance);
+        }
+        entry.seen = pass;
+    }
+    
+    for (auto it = m_StaticQuadHandles.begin(); it != m_StaticQuadHandles.end();) {
+        if (it->second.seen != pass) {
+            staticBatch->Remove(it->second.handle);
+            it = m_StaticQuadHandles.erase(it);
+        } else {
+            ++it;
+        }
+    }
+}
+
+void Game::UpdateRenderersFromECS() {
+    // Update the shared obstacle world from ECS entities
+    SyncObstacleWorld();
     
     // Update lights
     m_Lights.clear();
@@ -1001,6 +1172,7 @@ void Game::UpdateRenderersFromECS() {
                 lightComp->light.color,
                 lightComp->light.intensity
             );
+            m_Lights.back().isStatic = lightComp->light.isStatic;
         }
     }
 }
@@ -1016,11 +1188,12 @@ void Game::OnUpdate() {
     
     // Cycle between rendering systems
     if (Input::IsKeyPressed(GLFW_KEY_TAB)) {
-        m_RenderMode = static_cast<RenderMode>((static_cast<int>(m_RenderMode) + 1) % 3);
+        m_RenderMode = static_cast<RenderMode>((static_cast<int>(m_RenderMode) + 1) % 4);
         switch(m_RenderMode) {
             case RenderMode::FOG: Logger::Info("Fog system enabled"); break;
             case RenderMode::VISION: Logger::Info("Vision system enabled"); break;
             case RenderMode::LIGHTING: Logger::Info("Lighting system enabled"); break;
+            case RenderMode::COMBINED: Logger::Info("Lighting, fog and vision enabled"); break;
         }
     }
     
@@ -1106,6 +1279,22 @@ void Game::OnUpdate() {
         minusKeyPressed = false;
     }
     
+    // Profiler panel and trace capture of the last few seconds
+    if (Input::IsKeyPressed(GLFW_KEY_F3) && m_ProfilerUI) {
+        m_ProfilerUI->ToggleVisibility();
+    }
+    if (Input::IsKeyPressed(GLFW_KEY_F4) && m_ProfilerUI) {
+        m_ProfilerUI->SaveTrace();
+    }
+    
+    // Particle stress test: a large burst from every emitter
+    if (Input::IsKeyPressed(GLFW_KEY_F8)) {
+        ComponentManager* components = m_scene->GetComponentManager();
+        for (const Entity& entity : m_scene->GetEntitiesWith<ParticleEmitterComponent>()) {
+            components->GetComponent<ParticleEmitterComponent>(entity.GetID())->burst += 250000;
+        }
+    }
+    
     // Save/Load scene
     if (Input::IsKeyPressed(GLFW_KEY_F5)) {
         bool success = m_scene->SaveToFile("game_scene.yaml");
@@ -1121,6 +1310,10 @@ void Game::OnUpdate() {
             if (!m_playerMovementSystem) {
                 m_playerMovementSystem = m_scene->RegisterSystem<PlayerMovementSystem>(windowWidth, windowHeight);
             }
+            m_playerMovementSystem->SetObstacleWorld(obstacleWorld);
+            SetupCulling();
+            SetupParticles();
+            particleRenderer->Clear();
             
             // Find the player entity again
             auto playerEntities = m_scene->GetEntitiesWith<PlayerComponent>();
@@ -1134,20 +1327,53 @@ void Game::OnUpdate() {
         }
     }
     
+    // Pick up obstacles moved or edited since last frame before anything collides with them
+    {
+        PROFILE_SCOPE("Game::SyncObstacleWorld");
+        SyncObstacleWorld();
+    }
+    {
+        PROFILE_SCOPE("Game::SyncStaticGeometry");
+        SyncStaticGeometry();
+    }
+    
     // Update ECS scene
-    m_scene->Update(deltaTime);
+    {
+        PROFILE_SCOPE("Scene::Update");
+        m_scene->Update(deltaTime);
+    }
+    
+    // Spawn this frame's bursts and step every particle on the GPU
+    particleRenderer->Simulate(deltaTime);
     
     // Update Audio System
     Audio::Update();
     
-    // Send movement updates if connected to network
+    // Remote players trail the server by the interpolation delay
+    UpdateRemotePlayers();
+    
+    // Send input commands if connected to network
     static float movementUpdateTimer = 0.0f;
     movementUpdateTimer += deltaTime;
-    if (movementUpdateTimer >= 0.0078125f) { // Send movement updates 128 times per second
-        SendPlayerMovement();
+    if (movementUpdateTimer >= PlayerMovement::StepTime) { // Send input once per movement step
+        PROFILE_SCOPE("Game::SendPlayerInput");
+        SendPlayerInput();
         movementUpdateTimer = 0.0f;
     }
     
+    // Server snapshots at a fixed rate, independent of the client send rate
+    static float snapshotTimer = 0.0f;
+    snapshotTimer += deltaTime;
+    if (snapshotTimer >= SnapshotInterval) {
+        PROFILE_SCOPE("Game::SendSnapshots");
+        SendSnapshots();
+        // Keep the remainder so snapshots stay evenly spaced in server time
+        snapshotTimer = std::min(snapshotTimer - SnapshotInterval, SnapshotInterval);
+    }
+    
+    // This tick's messages leave as one datagram per peer rather than one each
+    Network::GetManager().Flush();
+    
     // Update network UI if it exists
     // if (m_networkUI && m_networkUI->IsVisible()) {
     //     // Don't call Render() here, we'll handle all ImGui rendering in OnDraw
@@ -1161,35 +1387,25 @@ void Game::OnUpdate() {
 
 std::unordered_map<std::string, std::string> variables;
 
-void Game::OnDraw() {
-    if (m_isShuttingDown) {
-        Logger::Info("Game is shutting down, skipping draw");
-        return;
-    }
-
-    glClearColor(0.2f, 0.2f, 0.2f, 1.0f);
-    glClear(GL_COLOR_BUFFER_BIT);
-
-    // Begin batch rendering
+void Game::DrawScene() {
+    // The render graph sets the blend state for the scene pass
     renderer->BeginBatch(renderer->GetBaseShader());
     
-    // Draw player from ECS
-    auto playerEntities = m_scene->GetEntitiesWith<TransformComponent, PlayerComponent, RenderableComponent>();
+    // Only entities inside the view reach the batch
+    const std::vector<EntityID>& visibleEntities = m_cullingSystem->QueryVisible(renderer->GetViewMin(), renderer->GetViewMax());
+    ComponentManager* components = m_scene->GetComponentManager();
     
     // Debug: Log how many player entities we found
     static int lastPlayerCount = -1;
-    int currentPlayerCount = static_cast<int>(playerEntities.size());
-    if (currentPlayerCount != lastPlayerCount) {
-        Logger::Info("Found " + std::to_string(currentPlayerCount) + " player entities to render");
-        lastPlayerCount = currentPlayerCount;
-    }
+    int currentPlayerCount = 0;
     
-    for (const Entity& entity : playerEntities) {
-        auto* transform = entity.GetComponent<TransformComponent>();
-        auto* player = entity.GetComponent<PlayerComponent>();
-        auto* renderable = entity.GetComponent<RenderableComponent>();
+    // Draw players from ECS
+    for (EntityID entityID : visibleEntities) {
+        auto* transform = components->GetComponent<TransformComponent>(entityID);
+        auto* player = components->GetComponent<PlayerComponent>(entityID);
+        auto* renderable = components->GetComponent<RenderableComponent>(entityID);
         
-        if (transform && player && renderable && renderable->visible) {
+        if (transform && player && renderable) {
             glm::vec2 position(transform->position);
             renderer->DrawRectRot(position, player->size, transform->rotation.z, renderable->color);
             
@@ -1197,32 +1413,49 @@ void Game::OnDraw() {
             glm::vec2 directionPos = player->GetDirectionIndicatorPos(position);
             glm::vec4 indicatorColor(-renderable->color.x, -renderable->color.y, -renderable->color.z, 1.0f);
             renderer->DrawRect(directionPos, glm::vec2(8, 8), indicatorColor);
-        } else {
-            // Debug: Log why entity wasn't rendered
-            if (!transform) Logger::Info("Entity " + std::to_string(entity.GetID()) + " missing TransformComponent");
-            if (!player) Logger::Info("Entity " + std::to_string(entity.GetID()) + " missing PlayerComponent");
-            if (!renderable) Logger::Info("Entity " + std::to_string(entity.GetID()) + " missing RenderableComponent");
-            if (renderable && !renderable->visible) Logger::Info("Entity " + std::to_string(entity.GetID()) + " not visible");
+            currentPlayerCount++;
         }
     }
     
-    // Draw obstacles from ECS
-    auto obstacleEntities = m_scene->GetEntitiesWith<TransformComponent, ObstacleComponent, RenderableComponent>();
-    for (const Entity& entity : obstacleEntities) {
-        auto* transform = entity.GetComponent<TransformComponent>();
-        auto* obstacle = entity.GetComponent<ObstacleComponent>();
-        auto* renderable = entity.GetComponent<RenderableComponent>();
-        
-        if (transform && obstacle && renderable && renderable->visible) {
-            renderer->DrawRect(glm::vec2(transform->position), obstacle->size, renderable->color);
-        }
+    if (currentPlayerCount != lastPlayerCount) {
+        Logger::Info("Found " + std::to_string(currentPlayerCount) + " player entities to render");
+        lastPlayerCount = currentPlayerCount;
     }
     
+    // Obstacles are static geometry: one draw per visible chunk, drawn over the players as before
+    renderer->DrawStaticBatch(*staticBatch);
+    renderer->DrawParticles(*particleRenderer);
+    
     renderer->EndBatch();
-
-    // Enable blending for overlays
-    glEnable(GL_BLEND);
     
+    // Nameplates over remote players: cached string layouts, one draw call for all of them
+    textRenderer->Begin(renderer->GetProjection());
+    const glm::vec2& viewMin = renderer->GetViewMin();
+    const glm::vec2& viewMax = renderer->GetViewMax();
+    for (const auto& [networkID, entity] : m_networkPlayers) {
+        auto* transform = components->GetComponent<TransformComponent>(entity.GetID());
+        auto* player = components->GetComponent<PlayerComponent>(entity.GetID());
+        if (!transform || !player) continue;
+        
+        glm::vec2 anchor = glm::vec2(transform->position) - glm::vec2(0.0f, player->size.y * 0.5f + 10.0f);
+        if (anchor.x < viewMin.x - 200.0f || anchor.x > viewMax.x + 200.0f ||
+            anchor.y < viewMin.y || anchor.y > viewMax.y + 40.0f) {
+            continue;
+        }
+        textRenderer->DrawString(*nameplateFont, "Player " + std::to_string(networkID), anchor, 16.0f,
+                                 glm::vec4(1.0f), TextAlign::Center);
+    }
+    textRenderer->End();
+}
+
+void Game::OnDraw() {
+    if (m_isShuttingDown) {
+        Logger::Info("Game is shutting down, skipping draw");
+        return;
+    }
+
+    GLStateCache::BeginFrame();
+
     // Get player position for rendering systems
     glm::vec2 playerPos(0.0f);
     glm::vec2 playerDirection(0.0f, -1.0f);
@@ -1236,27 +1469,64 @@ void Game::OnDraw() {
         }
     }
     
-    switch(m_RenderMode) {
-        case RenderMode::FOG: {
-            glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
-            FogConfig fogConfig;
-            fogConfig.range = 500.0f;
-            fogConfig.shadowSoftness = 0.4f;
-            fogConfig.fogColor = glm::vec4(0.0f, 0.0f, 0.0f, 0.9f);
-            
-            fogRenderer->DrawFogQuad(playerPos, fogConfig);
-            break;
-        }
-        case RenderMode::VISION:
-            glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
-            visionRenderer->DrawVisionOverlay(playerPos, playerDirection, m_VisionConfig);
-            break;
-            
-        case RenderMode::LIGHTING:
-            glBlendFunc(GL_DST_COLOR, GL_ZERO);
-            lightRenderer->DrawLightingOverlay(m_Lights, m_LightConfig);
-            break;
+    // Occlusion rows are cached across frames; this only releases last frame's casters
+    shadowMap->BeginFrame();
+    
+    renderGraph->Begin(renderer->GetWindowWidth(), renderer->GetWindowHeight());
+    RenderGraphResource backbuffer = renderGraph->GetBackbuffer();
+    
+    // Alpha blended so anti-aliased shape edges blend with what is underneath
+    renderGraph->AddPass("Scene")
+        .Write(backbuffer, RenderGraphBlend::Alpha)
+        .Clear(glm::vec4(0.2f, 0.2f, 0.2f, 1.0f))
+        .Execute([this](const RenderGraphContext&) { DrawScene(); });
+    
+    // Every overlay is declared; the graph culls the ones that are not composited this frame.
+    // Fog takes the vision scale and both use the default format, so their targets alias to one texture.
+    bool showLighting = m_RenderMode == RenderMode::LIGHTING || m_RenderMode == RenderMode::COMBINED;
+    bool showFog = m_RenderMode == RenderMode::FOG || m_RenderMode == RenderMode::COMBINED;
+    bool showVision = m_RenderMode == RenderMode::VISION || m_RenderMode == RenderMode::COMBINED;
+    
+    RenderGraphTargetDesc lightDesc;
+    lightDesc.scale = m_LightConfig.renderScale;
+    lightDesc.format = RenderTargetFormat::RGBA16F; // Keeps values above 1.0
+    RenderGraphResource lightOverlay = renderGraph->CreateTarget("LightOverlay", lightDesc);
+    renderGraph->AddPass("Lighting")
+        .Write(lightOverlay)
+        .Execute([this](const RenderGraphContext&) { lightRenderer->ShadeLightingOverlay(m_Lights, m_LightConfig); });
+    if (showLighting) {
+        renderGraph->AddCompositePass("LightingComposite", lightOverlay, backbuffer, RenderGraphBlend::Multiply);
+    }
+    
+    FogConfig fogConfig;
+    fogConfig.range = 500.0f;
+    fogConfig.shadowSoftness = 0.4f;
+    fogConfig.fogColor = glm::vec4(0.0f, 0.0f, 0.0f, 0.9f);
+    fogConfig.renderScale = m_VisionConfig.renderScale;
+    
+    RenderGraphTargetDesc fogDesc;
+    fogDesc.scale = fogConfig.renderScale;
+    RenderGraphResource fogOverlay = renderGraph->CreateTarget("FogOverlay", fogDesc);
+    renderGraph->AddPass("Fog")
+        .Write(fogOverlay)
+        .Execute([this, playerPos, fogConfig](const RenderGraphContext&) { fogRenderer->ShadeFog(playerPos, fogConfig); });
+    if (showFog) {
+        renderGraph->AddCompositePass("FogComposite", fogOverlay, backbuffer, RenderGraphBlend::Alpha);
+    }
+    
+    RenderGraphTargetDesc visionDesc;
+    visionDesc.scale = m_VisionConfig.renderScale;
+    RenderGraphResource visionOverlay = renderGraph->CreateTarget("VisionOverlay", visionDesc);
+    renderGraph->AddPass("Vision")
+        .Write(visionOverlay)
+        .Execute([this, playerPos, playerDirection](const RenderGraphContext&) {
+            visionRenderer->ShadeVisionOverlay(playerPos, playerDirection, m_VisionConfig);
+        });
+    if (showVision) {
+        renderGraph->AddCompositePass("VisionComposite", visionOverlay, backbuffer, RenderGraphBlend::Alpha);
     }
+    
+    renderGraph->Execute();
 
     // Render ImGui
 
@@ -1296,16 +1566,20 @@ void Game::OnDraw() {
     // End ImGui frame
 
 
-    glDisable(GL_BLEND);
+    GLStateCache::SetBlendEnabled(false);
     
     // Render UI - centralized ImGui frame handling
     if (m_ImGuiInitialized) {
+        PROFILE_SCOPE("ImGui");
         ImGui_ImplOpenGL3_NewFrame();
         ImGui_ImplGlfw_NewFrame();
         ImGui::NewFrame();
         RenderUI();
         ImGui::Render();
         ImGui_ImplOpenGL3_RenderDrawData(ImGui::GetDrawData());
+
+        // ImGui drives GL directly, so the state cache no longer matches
+        GLStateCache::Invalidate();
     }
 }
 void Game::RenderUI() {
@@ -1313,7 +1587,29 @@ void Game::RenderUI() {
     std::unordered_map<std::string, std::string> variables;
     variables["fps"] = std::to_string(static_cast<int>(1.0f / Time::DeltaTime()));
     variables["render_mode"] = m_RenderMode == RenderMode::FOG ? "Fog" :
-                             (m_RenderMode == RenderMode::VISION ? "Vision" : "Lighting");
+                             (m_RenderMode == RenderMode::VISION ? "Vision" :
+                             (m_RenderMode == RenderMode::LIGHTING ? "Lighting" : "Combined"));
+
+    const GLStateStats& glStats = GLStateCache::GetStats();
+    variables["gl_state_issued"] = std::to_string(glStats.TotalIssued());
+    variables["gl_state_elided"] = std::to_string(glStats.TotalElided());
+
+    const StaticBatchStats& staticStats = staticBatch->GetStats();
+    variables["static_chunks"] = std::to_string(staticStats.visibleChunks) + "/" + std::to_string(staticStats.chunks);
+    variables["static_rebuilt"] = std::to_string(staticStats.rebuiltChunks);
+    variables["particle_slots"] = std::to_string(particleRenderer->GetStats().simulated);
+
+    TextureLoader::Stats textureStats = TextureLoader::GetStats();
+    variables["texture_pending"] = std::to_string(textureStats.pendingDecodes + textureStats.pendingUploads);
+    variables["texture_upload_kb"] = std::to_string(textureStats.bytesUploadedLastFrame / 1024);
+
+    const ReplicationServer::Stats& replicationStats = m_replicationServer.GetStats();
+    variables["snapshot_kb"] = std::to_string(replicationStats.bytesSent / 1024);
+    variables["snapshot_deltas"] = std::to_string(replicationStats.deltaSnapshots) + "/" +
+                                   std::to_string(replicationStats.deltaSnapshots + replicationStats.fullSnapshots);
+    const InterestManager::Stats& interestStats = m_interestManager.GetStats();
+    variables["interest_relevant"] = std::to_string(interestStats.relevant);
+    variables["interest_deferred"] = std::to_string(interestStats.deferred);
 
     // Get all entities for the entity list
     auto entities = m_scene->GetAllEntities();
@@ -1344,6 +1640,10 @@ void Game::RenderUI() {
     if (m_DebugInspector) {
         m_DebugInspector->Render(variables);
     }
+    
+    if (m_ProfilerUI) {
+        m_ProfilerUI->Render();
+    }
 
     // if (m_EcsInspector) {
     //     // If there's a selected entity, update its components first
@@ -1443,6 +1743,47 @@ void Game::OnShutdown() {
             lightRenderer = nullptr;
         }
         
+        if (renderGraph) {
+            Logger::Info("Cleaning up render graph");
+            delete renderGraph;
+            renderGraph = nullptr;
+        }
+        
+        if (shadowMap) {
+            Logger::Info("Cleaning up shadow map");
+            delete shadowMap;
+            shadowMap = nullptr;
+        }
+        
+        if (textRenderer) {
+            Logger::Info("Cleaning up text renderer");
+            delete textRenderer;
+            textRenderer = nullptr;
+        }
+        
+        if (nameplateFont) {
+            delete nameplateFont;
+            nameplateFont = nullptr;
+        }
+        
+        if (particleRenderer) {
+            Logger::Info("Cleaning up particle renderer");
+            delete particleRenderer;
+            particleRenderer = nullptr;
+        }
+        
+        if (staticBatch) {
+            Logger::Info("Cleaning up static batch");
+            delete staticBatch;
+            staticBatch = nullptr;
+        }
+        
+        if (obstacleWorld) {
+            Logger::Info("Cleaning up obstacle world");
+            delete obstacleWorld;
+            obstacleWorld = nullptr;
+        }
+        
         Logger::Info("Renderers cleaned up successfully");
     }
     catch (const std::exception& e) {
@@ -1478,8 +1819,11 @@ glm::vec2 Game::ResolveCollision(const Player& player, const glm::vec2& newPos)
     Player tempPlayer = player;
     tempPlayer.position = resolvedPos;
     
-    // Check collision with all obstacles
-    for (const auto& obstacle : m_Obstacles) {
+    // Check collision with the obstacles near the player
+    std::vector<ObstacleHandle> nearby;
+    obstacleWorld->QueryAABB(newPos - player.size, newPos + player.size, nearby);
+    for (ObstacleHandle handle : nearby) {
+        const Obstacle& obstacle = *obstacleWorld->Get(handle);
         if (CheckCollision(tempPlayer, obstacle)) {
             // Calculate overlap and resolve collision
             glm::vec2 playerMin = tempPlayer.GetMinBounds();
@@ -11,13 +11,21 @@
 // Engine Includes
 #include "../engine/core/Engine.h"
 #include "../engine/renderer/Renderer2D.h"
+#include "../engine/renderer/RenderGraph2D.h"
 #include "../engine/renderer/Shader.h"
 #include "../engine/renderer/fog/FogRenderer2D.h"
 #include "../engine/renderer/vision/VisionRenderer2D.h"
 #include "../engine/renderer/lighting/LightRenderer2D.h"
+#include "../engine/renderer/shadow/ShadowMap2D.h"
+#include "../engine/renderer/text/TextRenderer2D.h"
+#include "../engine/core/spatial/ObstacleWorld.h"
 #include "../engine/utils/Time.h"
 #include "../engine/core/networking/NetworkManager.h"
 #include "../engine/core/networking/Packet.h"
+#include "../engine/core/networking/Snapshot.h"
+#include "../engine/core/networking/InterestManager.h"
+#include "../engine/core/networking/Prediction.h"
+#include "../engine/core/networking/Interpolation.h"
 #include "../engine/core/audio/AudioManager.h"
 #include "../engine/core/audio/Sound.h"
 
@@ -34,11 +42,13 @@
 
 // GUI
 #include "../engine/renderer/ui/GuiLayout.h"
+#include "../engine/renderer/ui/ProfilerUI.h"
 
 enum class RenderMode {
     FOG,
     VISION,
-    LIGHTING
+    LIGHTING,
+    COMBINED    // Lighting, fog and vision together
 };
 
 // Custom ECS components for the game
@@ -154,10 +164,18 @@ public:
     }
 };
 
-// Game-specific ECS system for player movement and collision
+// Game-specific ECS system for player movement and collision. Movement runs in fixed
+// input steps shared with the server (PlayerMovement::Step); each step's input is recorded
+// so the server can simulate it and the client can replay it after a correction.
 class PlayerMovementSystem : public ECSSystem<PlayerMovementSystem> {
 private:
+    static constexpr int MaxStepsPerFrame = 16;   // A long hitch drops input time instead of catching up
+    
     int windowWidth, windowHeight;
+    const ObstacleWorld* m_obstacleWorld = nullptr;
+    std::vector<ObstacleHandle> m_nearbyObstacles;
+    InputPredictor m_predictor;
+    float m_stepAccumulator = 0.0f;
     
 public:
     SYSTEM_TYPE(PlayerMovementSystem)
@@ -168,65 +186,76 @@ public:
     void Update(float deltaTime) override {
         auto entities = GetEntitiesWith<TransformComponent, PlayerComponent, InputComponent>();
         
-        for (EntityID entityID : entities) {
-            auto* transform = GetComponent<TransformComponent>(entityID);
-            auto* player = GetComponent<PlayerComponent>(entityID);
-            auto* input = GetComponent<InputComponent>(entityID);
-            
-            if (!transform || !player || !input || !input->enabled) continue;
+        m_stepAccumulator = std::min(m_stepAccumulator + deltaTime, PlayerMovement::StepTime * MaxStepsPerFrame);
+        while (m_stepAccumulator >= PlayerMovement::StepTime) {
+            m_stepAccumulator -= PlayerMovement::StepTime;
             
-            // Store old position for collision resolution
-            glm::vec3 oldPosition = transform->position;
-            glm::vec2 movementDelta(0.0f);
+            PacketData::InputCommand command;
+            command.buttons = SampleButtons();
             
-            // Handle movement input
-            if (Input::IsKeyHeld(GLFW_KEY_W)) {
-                movementDelta.y -= player->speed * deltaTime;
-                PlayFootstepSound(entityID);
-            }
-            if (Input::IsKeyHeld(GLFW_KEY_S)) {
-                movementDelta.y += player->speed * deltaTime;
-                PlayFootstepSound(entityID);
-            }
-            if (Input::IsKeyHeld(GLFW_KEY_A)) {
-                movementDelta.x -= player->speed * deltaTime;
-                PlayFootstepSound(entityID);
-            }
-            if (Input::IsKeyHeld(GLFW_KEY_D)) {
-                movementDelta.x += player->speed * deltaTime;
-                PlayFootstepSound(entityID);
+            bool moved = false;
+            glm::vec2 predicted(0.0f);
+            for (EntityID entityID : entities) {
+                auto* transform = GetComponent<TransformComponent>(entityID);
+                auto* player = GetComponent<PlayerComponent>(entityID);
+                auto* input = GetComponent<InputComponent>(entityID);
+                
+                if (!transform || !player || !input || !input->enabled) continue;
+                
+                if (command.buttons) {
+                    PlayFootstepSound(entityID);
+                }
+                
+                predicted = PlayerMovement::Step(glm::vec2(transform->position), command.buttons,
+                                                 player->size, GetWorld(), m_nearbyObstacles);
+                transform->position.x = predicted.x;
+                transform->position.y = predicted.y;
+                command.aim = transform->rotation.z;
+                moved = true;
             }
             
-            // Normalize movement delta
-            if (glm::length(movementDelta) > 0.001f) {
-                movementDelta = glm::normalize(movementDelta);
+            if (moved) {
+                m_predictor.Record(command, predicted);
             }
-
-            // Apply movement
-            glm::vec2 newPosition2D = glm::vec2(transform->position) + movementDelta;
-            
-            // Resolve collisions
-            newPosition2D = ResolveCollision(entityID, newPosition2D, player);
+        }
+        
+        // Handle mouse look every frame; the aim rides along with the next step's command
+        for (EntityID entityID : entities) {
+            auto* transform = GetComponent<TransformComponent>(entityID);
+            auto* player = GetComponent<PlayerComponent>(entityID);
+            auto* input = GetComponent<InputComponent>(entityID);
             
-            // Update position
-            transform->position.x = newPosition2D.x;
-            transform->position.y = newPosition2D.y;
+            if (!transform || !player || !input || !input->enabled) continue;
             
-            // Handle mouse look
             glm::vec2 mousePos(Input::GetMouseX(), Input::GetMouseY());
             player->UpdateDirectionFromMouse(glm::vec2(transform->position), mousePos);
             transform->rotation.z = atan2(mousePos.y - transform->position.y, 
                                         -(mousePos.x - transform->position.x));
-            
-            // Clamp to screen bounds
-            float halfWidth = player->size.x * 0.5f;
-            float halfHeight = player->size.y * 0.5f;
-            transform->position.x = glm::clamp(transform->position.x, halfWidth, 
-                                              (float)windowWidth - halfWidth);
-            transform->position.y = glm::clamp(transform->position.y, halfHeight, 
-                                              (float)windowHeight - halfHeight);
         }
     }
+    
+    // Applies the server's position for a locally controlled player after the given command
+    void Reconcile(EntityID entityID, uint32_t ackedSequence, const glm::vec2& serverPosition) {
+        auto* transform = GetComponent<TransformComponent>(entityID);
+        auto* player = GetComponent<PlayerComponent>(entityID);
+        if (!transform || !player) return;
+        
+        glm::vec2 position(transform->position);
+        if (m_predictor.Reconcile(ackedSequence, serverPosition, position, player->size, GetWorld())) {
+            transform->position.x = position.x;
+            transform->position.y = position.y;
+        }
+    }
+    
+    InputPredictor& GetPredictor() { return m_predictor; }
+    
+    PlayerMovement::World GetWorld() const {
+        PlayerMovement::World world;
+        world.obstacles = m_obstacleWorld;
+        world.bounds = glm::vec2(windowWidth, windowHeight);
+        return world;
+    }
+    
     void PlayFootstepSound(EntityID entityID) {
         auto* player = m_componentManager->GetComponent<PlayerComponent>(entityID);
         if (!player) return;
@@ -243,70 +272,24 @@ public:
         windowHeight = height;
     }
 
-private:
-    glm::vec2 ResolveCollision(EntityID playerID, const glm::vec2& newPos, PlayerComponent* player) {
-        auto obstacles = GetEntitiesWith<TransformComponent, ObstacleComponent>();
-        glm::vec2 resolvedPos = newPos;
-        
-        for (EntityID obstacleID : obstacles) {
-            if (obstacleID == playerID) continue; // Skip self
-            
-            auto* obstacleTransform = GetComponent<TransformComponent>(obstacleID);
-            auto* obstacle = GetComponent<ObstacleComponent>(obstacleID);
-            
-            if (!obstacleTransform || !obstacle) continue;
-            
-            if (CheckCollision(resolvedPos, player->size, 
-                            glm::vec2(obstacleTransform->position), obstacle->size)) {
-                
-                // Calculate bounds
-                glm::vec2 playerMin = resolvedPos - player->size * 0.5f;
-                glm::vec2 playerMax = resolvedPos + player->size * 0.5f;
-                
-                glm::vec2 obstaclePos = glm::vec2(obstacleTransform->position);
-                glm::vec2 obstacleMin = obstaclePos - obstacle->size * 0.5f;
-                glm::vec2 obstacleMax = obstaclePos + obstacle->size * 0.5f;
-                
-                // Calculate overlap
-                float overlapX = std::min(playerMax.x - obstacleMin.x, obstacleMax.x - playerMin.x);
-                float overlapY = std::min(playerMax.y - obstacleMin.y, obstacleMax.y - playerMin.y);
-                
-                // Resolve collision
-                if (overlapX < overlapY) {
-                    if (resolvedPos.x < obstaclePos.x) {
-                        resolvedPos.x = obstacleMin.x - player->size.x * 0.5f;
-                    } else {
-                        resolvedPos.x = obstacleMax.x + player->size.x * 0.5f;
-                    }
-                } else {
-                    if (resolvedPos.y < obstaclePos.y) {
-                        resolvedPos.y = obstacleMin.y - player->size.y * 0.5f;
-                    } else {
-                        resolvedPos.y = obstacleMax.y + player->size.y * 0.5f;
-                    }
-                }
-            }
-        }
-        
-        return resolvedPos;
+    // Obstacles the player collides with (kept in sync with ObstacleComponents by Game)
+    void SetObstacleWorld(const ObstacleWorld* world) {
+        m_obstacleWorld = world;
     }
-    
-    bool CheckCollision(const glm::vec2& pos1, const glm::vec2& size1,
-                       const glm::vec2& pos2, const glm::vec2& size2) {
-        glm::vec2 min1 = pos1 - size1 * 0.5f;
-        glm::vec2 max1 = pos1 + size1 * 0.5f;
-        glm::vec2 min2 = pos2 - size2 * 0.5f;
-        glm::vec2 max2 = pos2 + size2 * 0.5f;
-        
-        return (min1.x < max2.x && max1.x > min2.x &&
-                min1.y < max2.y && max1.y > min2.y);
+
+private:
+    static uint8_t SampleButtons() {
+        uint8_t buttons = 0;
+        if (Input::IsKeyHeld(GLFW_KEY_W)) buttons |= PacketData::INPUT_UP;
+        if (Input::IsKeyHeld(GLFW_KEY_S)) buttons |= PacketData::INPUT_DOWN;
+        if (Input::IsKeyHeld(GLFW_KEY_A)) buttons |= PacketData::INPUT_LEFT;
+        if (Input::IsKeyHeld(GLFW_KEY_D)) buttons |= PacketData::INPUT_RIGHT;
+        return buttons;
     }
 };
 
 class Game : public Engine {
 protected:
-    unsigned int sceneFBO = 0;
-    unsigned int sceneTexture = 0;
     int windowWidth = 1280;
     int windowHeight = 720;
 
@@ -327,7 +310,10 @@ public:
     void SendPlayerLeaveToClients(uint32_t playerID);
     void SendPlayerJoinToClients();
     void SendAllPlayersToClient(uint32_t clientID);
-    void SendPlayerMovement();
+    void SendPlayerInput();
+    void SendSnapshots();
+    void ApplySnapshot(const Snapshot& snapshot);
+    void UpdateRemotePlayers();
     void ClearNetworkPlayers();
     void DisconnectFromServer();
     void RenderUI();
@@ -440,7 +426,6 @@ if (selectedEntity == INVALID_ENTITY_ID) {
 }
 
 
-    std::vector<Obstacle> m_Obstacles;
     void setupObstacles();
     void setupLights();
     
@@ -454,6 +439,13 @@ protected:
     FogRenderer2D* fogRenderer;
     VisionRenderer2D* visionRenderer;
     LightRenderer2D* lightRenderer;
+    ShadowMap2D* shadowMap;         // Occlusion shared by fog, vision and lighting
+    RenderGraph2D* renderGraph;     // Scene and overlay passes, rebuilt every frame
+    ObstacleWorld* obstacleWorld;   // Obstacles shared by rendering and collision
+    StaticBatch* staticBatch;       // Obstacle quads, re-uploaded per chunk only when they change
+    ParticleRenderer2D* particleRenderer;   // GPU particle pool fed by ParticleEmitterComponents
+    TextRenderer2D* textRenderer;   // In-world text (nameplates)
+    Font* nameplateFont;
     VisionConfig m_VisionConfig;    // Vision system configuration
     LightConfig m_LightConfig;      // Lighting system configuration
     std::vector<Light> m_Lights;    // Scene lights
@@ -470,22 +462,59 @@ private:
     std::unique_ptr<Scene> m_scene;
     Entity m_playerEntity;
     PlayerMovementSystem* m_playerMovementSystem;
+    CullingSystem* m_cullingSystem;
+    ParticleEmitterSystem* m_particleEmitterSystem;
     
     // Networking
+    // Clients interpolate remote players, so 30Hz looks as smooth as sending every frame did
+    static constexpr uint32_t SnapshotRate = 30;
+    static constexpr float SnapshotInterval = 1.0f / SnapshotRate;
     uint32_t m_localPlayerNetworkID;
     std::unordered_map<uint32_t, Entity> m_networkPlayers;
+    ReplicationServer m_replicationServer;
+    ReplicationClient m_replicationClient;
+    SnapshotInterpolator m_interpolator;
+    InterestManager m_interestManager;
+    uint32_t m_snapshotTick = 0;
+    std::unordered_map<uint32_t, InputBudget> m_inputBudgets;     // Server: peer ID -> commands simulated and allowed
+    std::vector<ObstacleHandle> m_inputScratch;
     
     // ECS setup methods
     void SetupECSScene();
     void SetupECSObstacles();
     void SetupECSLights();
+    void SetupECSParticles();
     void UpdateRenderersFromECS();
+    void SyncObstacleWorld();
+    void SyncStaticGeometry();
+    void SetupCulling();
+    void SetupParticles();
+    void DrawScene();
+    
+    // ObstacleComponent entities and their obstacles in the shared world, kept across
+    // frames; seen is the last sync pass that found the entity
+    struct ObstacleEntry {
+        ObstacleHandle handle = InvalidObstacleHandle;
+        uint32_t seen = 0;
+    };
+    std::unordered_map<EntityID, ObstacleEntry> m_ObstacleHandles;
+    uint32_t m_ObstacleSyncPass = 0;
+    
+    // Visible renderable obstacle entities and their quads in the static batch, kept the
+    // same way as m_ObstacleHandles
+    struct StaticQuadEntry {
+        StaticQuadHandle handle = InvalidStaticQuadHandle;
+        uint32_t seen = 0;
+    };
+    std::unordered_map<EntityID, StaticQuadEntry> m_StaticQuadHandles;
+    uint32_t m_StaticSyncPass = 0;
 
     // GUIs
     std::unique_ptr<GuiLayout> m_GameInspector;
     std::unique_ptr<GuiLayout> m_EcsInspector;
     std::unique_ptr<GuiLayout> m_NetworkManager;
     std::unique_ptr<GuiLayout> m_DebugInspector;
+    std::unique_ptr<ProfilerUI> m_ProfilerUI;
 
     bool m_ImGuiInitialized = false;
 
@@ -0,0 +1,334 @@
+#include "DedicatedServer.h"
+#include <algorithm>
+#include <sstream>
+#include <iomanip>
+#include <thread>
+#include <engine/core/networking/NetworkManager.h>
+#include <engine/scene/component/CommonComponents.h>
+#include <engine/utils/Logger.h>
+#include <engine/utils/Profiler.h>
+
+#ifdef _WIN32
+#include <timeapi.h>
+#endif
+
+namespace {
+    double Milliseconds(std::chrono::steady_clock::duration duration) {
+        return std::chrono::duration<double, std::milli>(duration).count();
+    }
+
+    std::string FormatMs(double ms) {
+        std::ostringstream stream;
+        stream << std::fixed << std::setprecision(2) << ms << "ms";
+        return stream.str();
+    }
+}
+
+DedicatedServer::DedicatedServer(const Settings& settings)
+    : m_Settings(settings), m_Running(false), m_SnapshotTick(0), m_SnapshotTimer(0.0f),
+      m_TotalWorkMs(0.0), m_TotalLatenessMs(0.0), m_SpinMargin(MaxSpinMargin)
+{
+    m_Settings.tickRate = std::max<uint32_t>(m_Settings.tickRate, 1);
+    m_Settings.snapshotRate = std::clamp<uint32_t>(m_Settings.snapshotRate, 1, m_Settings.tickRate);
+    m_Scene = std::make_unique<Scene>("ServerScene");
+    m_World.bounds = glm::vec2(m_Settings.worldWidth, m_Settings.worldHeight);
+
+#ifdef _WIN32
+    // The default 15.6ms scheduler quantum is longer than a 128Hz tick
+    timeBeginPeriod(1);
+#endif
+}
+
+DedicatedServer::~DedicatedServer() {
+    Network::Shutdown();
+
+#ifdef _WIN32
+    timeEndPeriod(1);
+#endif
+}
+
+bool DedicatedServer::Start() {
+    if (!Network::Initialize()) {
+        Logger::Error<DedicatedServer>("Failed to initialize networking: " + NetworkManager::GetLastError(), this);
+        return false;
+    }
+
+    SetupNetworkingHandlers();
+    if (!Network::StartServer(m_Settings.port, m_Settings.maxClients)) {
+        Logger::Error<DedicatedServer>("Failed to start server: " + NetworkManager::GetLastError(), this);
+        return false;
+    }
+
+    Logger::Info("Dedicated server listening on port " + std::to_string(m_Settings.port) +
+                 " at " + std::to_string(m_Settings.tickRate) + "Hz (snapshots at " +
+                 std::to_string(m_Settings.snapshotRate) + "Hz, up to " +
+                 std::to_string(m_Settings.maxClients) + " clients)");
+    return true;
+}
+
+void DedicatedServer::Run() {
+    const Clock::duration period = std::chrono::duration_cast<Clock::duration>(
+        std::chrono::duration<double>(1.0 / m_Settings.tickRate));
+    const float deltaTime = 1.0f / m_Settings.tickRate;
+    const Clock::duration statsInterval = std::chrono::duration_cast<Clock::duration>(
+        std::chrono::duration<double>(m_Settings.statsInterval));
+
+    Profiler::SetThreadName("Server");
+    Clock::time_point nextTick = Clock::now();
+    Clock::time_point lastReport = nextTick;
+    m_Running = true;
+
+    while (m_Running) {
+        WaitUntil(nextTick);
+
+        Clock::time_point start = Clock::now();
+        Tick(deltaTime);
+        Clock::time_point end = Clock::now();
+        RecordTick(Milliseconds(end - start), Milliseconds(start - nextTick), end - start > period);
+
+        // Deadlines advance by whole periods so the tick rate doesn't drift; a short hitch is
+        // caught up by running the next ticks back to back
+        nextTick += period;
+        if (end - nextTick > period * MaxCatchUpTicks) {
+            auto behind = (end - nextTick) / period;
+            nextTick += period * behind;
+            m_Stats.droppedTicks += static_cast<uint32_t>(behind);
+        }
+
+        if (end - lastReport >= statsInterval) {
+            ReportStats();
+            lastReport = end;
+        }
+    }
+
+    Logger::Info("Dedicated server stopping");
+}
+
+void DedicatedServer::SetupNetworkingHandlers() {
+    auto& manager = Network::GetManager();
+
+    // A client announcing its player; only then does it get an entity
+    manager.RegisterPacketHandler(PacketType::PLAYER_JOIN,
+        [this](const Packet& packet, uint32_t senderID) {
+            if (m_Players.count(senderID)) {
+                return;
+            }
+
+            PacketData::PlayerJoin joinData;
+            Packet mutablePacket = packet;
+            joinData.ReadFrom(mutablePacket);
+
+            Entity player = m_Scene->CreateEntity("NetworkPlayer_" + std::to_string(senderID));
+            player.AddComponent<TransformComponent>(glm::vec3(joinData.spawnPosition, 0.0f));
+            player.AddComponent<TagComponent>("network_player_" + std::to_string(senderID));
+            player.AddComponent<ReplicatedComponent>(senderID);
+            m_Players[senderID] = player;
+
+            // Other clients create the player now; its movement reaches them through snapshots
+            PacketData::PlayerJoin broadcastData;
+            broadcastData.playerID = senderID;
+            broadcastData.playerName = "Player_" + std::to_string(senderID);
+            broadcastData.spawnPosition = joinData.spawnPosition;
+
+            Packet broadcastPacket = PacketFactory::CreatePlayerJoinPacket(broadcastData);
+            auto& manager = Network::GetManager();
+            for (const auto& peerInfo : manager.GetConnectedPeers()) {
+                if (peerInfo.id != senderID) {
+                    manager.SendPacket(broadcastPacket, peerInfo.id);
+                }
+            }
+
+            Logger::Info("Player " + std::to_string(senderID) + " joined (" +
+                         std::to_string(m_Players.size()) + " players)");
+        });
+
+    // Players move only by the server simulating their input commands, each exactly once
+    manager.RegisterPacketHandler(PacketType::PLAYER_INPUT,
+        [this](const Packet& packet, uint32_t senderID) {
+            auto it = m_Players.find(senderID);
+            if (it == m_Players.end()) {
+                return;
+            }
+            
+            auto* transform = it->second.GetComponent<TransformComponent>();
+            if (!transform) {
+                return;
+            }
+            
+            PacketData::PlayerInput input;
+            Packet mutablePacket = packet;
+            input.ReadFrom(mutablePacket);
+            
+            // Clients derive the facing direction from the replicated rotation
+            InputBudget& budget = m_InputBudgets[senderID];
+            budget.Refill(std::chrono::duration<double>(Clock::now().time_since_epoch()).count());
+            glm::vec2 position(transform->position);
+            for (const PacketData::InputCommand& command : input.commands) {
+                if (!budget.Accept(command.sequence)) {
+                    continue;
+                }
+                position = PlayerMovement::Step(position, command.buttons, glm::vec2(PlayerMovement::DefaultSize),
+                                                m_World, m_InputScratch);
+                transform->rotation.z = command.aim;
+            }
+            transform->position.x = position.x;
+            transform->position.y = position.y;
+        });
+
+    manager.RegisterPacketHandler(PacketType::SNAPSHOT_ACK,
+        [this](const Packet& packet, uint32_t senderID) {
+            BitReader bits = packet.ReadBits();
+            m_ReplicationServer.Acknowledge(senderID, bits.ReadVarUint());
+        });
+
+    manager.SetEventCallback([this](const NetworkEvent& event) {
+        switch (event.type) {
+            case NetworkEventType::CLIENT_CONNECTED:
+                Logger::Info("Client " + std::to_string(event.peerID) + " connected from " + event.message);
+                OnClientConnected(event.peerID);
+                break;
+
+            case NetworkEventType::CLIENT_DISCONNECTED:
+                Logger::Info("Client " + std::to_string(event.peerID) + " disconnected: " + event.message);
+                OnClientDisconnected(event.peerID);
+                break;
+
+            case NetworkEventType::SERVER_STARTED:
+                m_ReplicationServer.Clear();
+                m_InterestManager.Clear();
+                m_InputBudgets.clear();
+                m_SnapshotTick = 0;
+                break;
+
+            default:
+                break;
+        }
+    });
+}
+
+void DedicatedServer::OnClientConnected(uint32_t peerID) {
+    m_ReplicationServer.AddClient(peerID);
+    m_InterestManager.AddClient(peerID);
+
+    // The new client creates entities for everyone already playing; it then sends its own PLAYER_JOIN
+    for (const auto& [playerID, player] : m_Players) {
+        auto* transform = player.GetComponent<TransformComponent>();
+        if (!transform) {
+            continue;
+        }
+
+        PacketData::PlayerJoin joinData;
+        joinData.playerID = playerID;
+        joinData.playerName = "Player_" + std::to_string(playerID);
+        joinData.spawnPosition = glm::vec2(transform->position);
+        Network::GetManager().SendPacket(PacketFactory::CreatePlayerJoinPacket(joinData), peerID);
+    }
+}
+
+void DedicatedServer::OnClientDisconnected(uint32_t peerID) {
+    m_ReplicationServer.RemoveClient(peerID);
+    m_InterestManager.RemoveClient(peerID);
+    m_InputBudgets.erase(peerID);
+
+    auto it = m_Players.find(peerID);
+    if (it == m_Players.end()) {
+        return;
+    }
+
+    m_Scene->DestroyEntity(it->second.GetID());
+    m_Players.erase(it);
+    Network::GetManager().BroadcastPacket(PacketFactory::CreatePlayerLeavePacket(peerID));
+}
+
+void DedicatedServer::Tick(float deltaTime) {
+    Profiler::BeginFrame();
+    PROFILE_SCOPE("DedicatedServer::Tick");
+
+    Network::Update();
+    m_Scene->Update(deltaTime);
+
+    m_SnapshotTimer += deltaTime;
+    float snapshotInterval = 1.0f / m_Settings.snapshotRate;
+    if (m_SnapshotTimer >= snapshotInterval * 0.999f) {
+        m_SnapshotTimer = std::max(m_SnapshotTimer - snapshotInterval, 0.0f);
+        SendSnapshots();
+    }
+    Network::GetManager().Flush();
+}
+
+void DedicatedServer::SendSnapshots() {
+    auto& manager = Network::GetManager();
+    if (manager.GetPeerCount() == 0) {
+        return;
+    }
+
+    PROFILE_SCOPE("DedicatedServer::SendSnapshots");
+    Snapshot world = Snapshot::Capture(*m_Scene, ++m_SnapshotTick);
+    world.rate = m_Settings.snapshotRate;
+    m_InterestManager.BeginTick(std::move(world));
+    for (const auto& peerInfo : manager.GetConnectedPeers()) {
+        Snapshot clientSnapshot = m_InterestManager.BuildClientSnapshot(peerInfo.id);
+        auto input = m_InputBudgets.find(peerInfo.id);
+        clientSnapshot.inputAck = (input != m_InputBudgets.end()) ? input->second.GetLastApplied() : 0;
+        m_ReplicationServer.SendSnapshot(manager, peerInfo.id, clientSnapshot);
+    }
+}
+
+void DedicatedServer::WaitUntil(Clock::time_point deadline) {
+    if (Clock::now() + m_SpinMargin < deadline) {
+        Clock::time_point wake = deadline - m_SpinMargin;
+        std::this_thread::sleep_until(wake);
+
+        // Grow straight to a late wakeup, shrink slowly while wakeups are on time
+        Clock::duration wanted = std::clamp<Clock::duration>(Clock::now() - wake + MinSpinMargin,
+                                                             MinSpinMargin, MaxSpinMargin);
+        if (wanted > m_SpinMargin) {
+            m_SpinMargin = wanted;
+        } else {
+            m_SpinMargin -= (m_SpinMargin - wanted) / 16;
+        }
+    }
+    while (Clock::now() < deadline) {
+        std::this_thread::yield();
+    }
+}
+
+void DedicatedServer::RecordTick(double workMs, double latenessMs, bool overrun) {
+    m_Stats.ticks++;
+    m_Stats.maxMs = std::max(m_Stats.maxMs, workMs);
+    if (overrun) {
+        m_Stats.overruns++;
+    }
+    m_TotalWorkMs += workMs;
+    m_TotalLatenessMs += std::max(latenessMs, 0.0);
+}
+
+void DedicatedServer::ReportStats() {
+    if (m_Stats.ticks == 0) {
+        return;
+    }
+
+    m_Stats.averageMs = m_TotalWorkMs / m_Stats.ticks;
+    m_Stats.averageLatenessMs = m_TotalLatenessMs / m_Stats.ticks;
+    m_Stats.spinMarginMs = Milliseconds(m_SpinMargin);
+    m_LastStats = m_Stats;
+
+    const ReplicationServer::Stats& replication = m_ReplicationServer.GetStats();
+    double snapshotKBps = replication.bytesSent / 1024.0 / m_Settings.statsInterval;
+
+    Logger::Info("Server ticks: " + std::to_string(m_Stats.ticks) +
+                 " avg " + FormatMs(m_Stats.averageMs) +
+                 " max " + FormatMs(m_Stats.maxMs) +
+                 " (budget " + FormatMs(1000.0 / m_Settings.tickRate) + ")" +
+                 ", late " + FormatMs(m_Stats.averageLatenessMs) +
+                 ", overruns " + std::to_string(m_Stats.overruns) +
+                 ", dropped " + std::to_string(m_Stats.droppedTicks) +
+                 ", spin margin " + FormatMs(m_Stats.spinMarginMs) +
+                 " | " + std::to_string(Network::GetManager().GetPeerCount()) + " clients, snapshots " +
+                 std::to_string(static_cast<int>(snapshotKBps)) + " KB/s");
+
+    m_Stats = TickStats();
+    m_TotalWorkMs = 0.0;
+    m_TotalLatenessMs = 0.0;
+    m_ReplicationServer.ResetStats();
+}
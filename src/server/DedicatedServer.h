@@ -0,0 +1,93 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+#include <engine/core/networking/InterestManager.h>
+#include <engine/core/networking/Prediction.h>
+#include <engine/core/networking/Snapshot.h>
+#include <engine/scene/Scene.h>
+#include <engine/scene/entity/Entity.h>
+
+// Headless authoritative server: no window, renderer or audio. Runs the scene and the
+// network at a fixed tick rate, replicating players to clients through snapshots.
+// Between ticks it sleeps to just short of the deadline and yields the rest, since OS
+// sleeps are only accurate to the scheduler quantum. The margin left for yielding follows
+// how late sleeps actually wake up, so on a fine-grained scheduler it stays near the minimum.
+class DedicatedServer {
+public:
+    struct Settings {
+        uint16_t port = 7777;
+        size_t maxClients = 32;
+        uint32_t tickRate = 60;         // Hz; 60 and 128 are the usual choices
+        uint32_t snapshotRate = 30;     // Hz, capped at the tick rate; clients interpolate between snapshots
+        float statsInterval = 5.0f;     // Seconds between tick stat reports
+        float worldWidth = 1280.0f;     // Players are kept inside the world; clients use their window size,
+        float worldHeight = 720.0f;     // so these match the default window
+    };
+
+    // Over the last reporting window
+    struct TickStats {
+        uint64_t ticks = 0;
+        double averageMs = 0.0;         // Work per tick, excluding the wait
+        double maxMs = 0.0;
+        double averageLatenessMs = 0.0; // How late ticks started against their deadline
+        uint32_t overruns = 0;          // Ticks whose work took longer than the tick period
+        uint32_t droppedTicks = 0;      // Skipped after falling too far behind
+        double spinMarginMs = 0.0;      // Time before each deadline spent yielding instead of sleeping
+    };
+
+    explicit DedicatedServer(const Settings& settings);
+    ~DedicatedServer();
+
+    bool Start();
+    // Blocks until Stop()
+    void Run();
+    // Safe from other threads and signal handlers
+    void Stop() { m_Running = false; }
+
+    const TickStats& GetTickStats() const { return m_LastStats; }
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    // Behind by more than this many ticks, the server skips ahead instead of catching up
+    static constexpr uint32_t MaxCatchUpTicks = 5;
+    // Bounds of the yield margin; it starts at the maximum and shrinks once sleeps prove accurate
+    static constexpr auto MinSpinMargin = std::chrono::microseconds(100);
+    static constexpr auto MaxSpinMargin = std::chrono::microseconds(2000);
+
+    Settings m_Settings;
+    std::atomic<bool> m_Running;
+    std::unique_ptr<Scene> m_Scene;
+    std::unordered_map<uint32_t, Entity> m_Players;     // Peer ID -> player entity
+
+    ReplicationServer m_ReplicationServer;
+    InterestManager m_InterestManager;
+    uint32_t m_SnapshotTick;
+    
+    // Server-side movement: the world players move in and each client's input budget
+    PlayerMovement::World m_World;
+    std::unordered_map<uint32_t, InputBudget> m_InputBudgets;
+    std::vector<ObstacleHandle> m_InputScratch;
+    float m_SnapshotTimer;
+
+    TickStats m_Stats;
+    TickStats m_LastStats;
+    double m_TotalWorkMs;
+    double m_TotalLatenessMs;
+    Clock::duration m_SpinMargin;
+
+    // Helper functions
+    void SetupNetworkingHandlers();
+    void OnClientConnected(uint32_t peerID);
+    void OnClientDisconnected(uint32_t peerID);
+    void Tick(float deltaTime);
+    void SendSnapshots();
+    void WaitUntil(Clock::time_point deadline);
+    void RecordTick(double workMs, double latenessMs, bool overrun);
+    void ReportStats();
+};
@@ -0,0 +1,69 @@
+#include <csignal>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <engine/utils/Logger.h>
+#include "DedicatedServer.h"
+
+namespace {
+    DedicatedServer* s_Server = nullptr;
+
+    void HandleSignal(int) {
+        if (s_Server) {
+            s_Server->Stop();
+        }
+    }
+
+    void PrintUsage() {
+        std::cout << "Usage: prism_server [--port N] [--tick HZ] [--snapshot-rate HZ] [--max-clients N]" << std::endl;
+    }
+}
+
+int main(int argc, char** argv) {
+    Logger::Initialize("PrismServer.log");
+
+    DedicatedServer::Settings settings;
+    for (int i = 1; i < argc; i++) {
+        const char* arg = argv[i];
+        const char* value = (i + 1 < argc) ? argv[i + 1] : nullptr;
+
+        if (std::strcmp(arg, "--help") == 0) {
+            PrintUsage();
+            return 0;
+        }
+        if (!value) {
+            PrintUsage();
+            return 1;
+        }
+
+        if (std::strcmp(arg, "--port") == 0) {
+            settings.port = static_cast<uint16_t>(std::atoi(value));
+        } else if (std::strcmp(arg, "--tick") == 0) {
+            settings.tickRate = static_cast<uint32_t>(std::atoi(value));
+        } else if (std::strcmp(arg, "--snapshot-rate") == 0) {
+            settings.snapshotRate = static_cast<uint32_t>(std::atoi(value));
+        } else if (std::strcmp(arg, "--max-clients") == 0) {
+            settings.maxClients = static_cast<size_t>(std::atoi(value));
+        } else {
+            PrintUsage();
+            return 1;
+        }
+        i++;
+    }
+
+    DedicatedServer server(settings);
+    if (!server.Start()) {
+        return 1;
+    }
+
+    s_Server = &server;
+    std::signal(SIGINT, HandleSignal);
+    std::signal(SIGTERM, HandleSignal);
+
+    server.Run();
+
+    s_Server = nullptr;
+    Logger::Info("Server Closing");
+    return 0;
+}